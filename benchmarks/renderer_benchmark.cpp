@@ -0,0 +1,443 @@
+#include "asr.h"
+#ifdef ASR_EGL
+#include "window/es2_egl_window.h"
+#endif
+
+#include <new>
+#include <atomic>
+#include <random>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <functional>
+
+/* Every allocation of the process goes through here, so that the allocations of a frame can be counted. */
+static std::atomic<unsigned long long> allocation_count{0};
+
+void *operator new(std::size_t size)
+{
+    ++allocation_count;
+    if (void *pointer = std::malloc(size == 0 ? 1 : size)) {
+        return pointer;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+namespace
+{
+    using namespace asr;
+
+    /* Stands in for the EGL window when GL calls go to the null backend, so the benchmark needs no GPU. */
+    class NullWindow final : public Window
+    {
+    public:
+        NullWindow(const std::string &name, unsigned int width, unsigned int height)
+            : Window(name, width, height)
+        {}
+
+        void poll() final {}
+
+        void swap() final {}
+
+        void finish() {}
+    };
+
+    struct Benchmark
+    {
+        const char *name;
+        std::function<std::shared_ptr<Scene>()> create_scene;
+    };
+
+    struct Result
+    {
+        std::string name;
+        unsigned int frame_count;
+        double mean_frame_time;
+        double median_frame_time;
+        double p95_frame_time;
+        double minimum_frame_time;
+        double allocations;
+        double gl_calls;
+        Profiler::FrameStatistics statistics;
+    };
+
+    const unsigned int WIDTH{640};
+    const unsigned int HEIGHT{360};
+    const unsigned int WARM_UP_FRAME_COUNT{30};
+    const unsigned int DEFAULT_FRAME_COUNT{300};
+
+    /* Scenes are generated from a fixed seed, so that every run renders exactly the same frames. */
+    glm::vec3 random_position(std::mt19937 &generator, float extent)
+    {
+        std::uniform_real_distribution<float> distribution{-extent, extent};
+        return glm::vec3{distribution(generator), distribution(generator), distribution(generator) - extent * 2.0f};
+    }
+
+    std::shared_ptr<Scene> create_mesh_scene(unsigned int mesh_count, bool shared_geometry)
+    {
+        std::mt19937 generator{42};
+        auto[box_indices, box_vertices] = geometry_generators::generate_box_geometry_data(0.5f, 0.5f, 0.5f, 1, 1, 1);
+        auto box_geometry = std::make_shared<ES2Geometry>(box_indices, box_vertices);
+        auto material = std::make_shared<ES2ConstantMaterial>();
+
+        auto scene = std::make_shared<Scene>(std::vector<std::shared_ptr<Object>>{});
+        for (unsigned int i = 0; i < mesh_count; ++i) {
+            auto geometry = shared_geometry ? box_geometry : std::make_shared<ES2Geometry>(box_indices, box_vertices);
+            auto mesh = std::make_shared<Mesh>(geometry, material);
+            mesh->set_position(random_position(generator, 20.0f));
+            scene->get_root()->add_child(mesh);
+        }
+
+        return scene;
+    }
+
+    std::shared_ptr<Scene> create_hierarchy_scene(unsigned int depth, unsigned int width)
+    {
+        auto[box_indices, box_vertices] = geometry_generators::generate_box_geometry_data(0.2f, 0.2f, 0.2f, 1, 1, 1);
+        auto geometry = std::make_shared<ES2Geometry>(box_indices, box_vertices);
+        auto material = std::make_shared<ES2ConstantMaterial>();
+
+        auto scene = std::make_shared<Scene>(std::vector<std::shared_ptr<Object>>{});
+        scene->get_root()->set_z(-30.0f);
+        std::vector<std::shared_ptr<Object>> level{scene->get_root()};
+        for (unsigned int i = 0; i < depth; ++i) {
+            std::vector<std::shared_ptr<Object>> next_level;
+            for (const auto &parent : level) {
+                for (unsigned int j = 0; j < width; ++j) {
+                    auto mesh = std::make_shared<Mesh>(geometry, material);
+                    mesh->set_x(static_cast<float>(j) - static_cast<float>(width) * 0.5f);
+                    mesh->set_y(0.1f);
+                    mesh->set_rotation_z(0.05f);
+                    parent->add_child(mesh);
+                    next_level.push_back(mesh);
+                }
+            }
+            level = std::move(next_level);
+        }
+
+        return scene;
+    }
+
+    std::shared_ptr<Scene> create_lighting_scene(unsigned int mesh_count, unsigned int light_count)
+    {
+        std::mt19937 generator{42};
+        auto[sphere_indices, sphere_vertices] = geometry_generators::generate_sphere_geometry_data(0.5f, 16, 16);
+        auto geometry = std::make_shared<ES2Geometry>(sphere_indices, sphere_vertices);
+        auto material = std::make_shared<ES2PhongMaterial>();
+
+        auto scene = std::make_shared<Scene>(std::vector<std::shared_ptr<Object>>{});
+        for (unsigned int i = 0; i < mesh_count; ++i) {
+            auto mesh = std::make_shared<Mesh>(geometry, material);
+            mesh->set_position(random_position(generator, 15.0f));
+            scene->get_root()->add_child(mesh);
+        }
+        for (unsigned int i = 0; i < light_count; ++i) {
+            auto point_light = std::make_shared<PointLight>();
+            point_light->set_intensity(1.0f / static_cast<float>(light_count));
+            point_light->set_position(random_position(generator, 15.0f));
+            scene->get_root()->add_child(point_light);
+            scene->get_point_lights().push_back(point_light);
+        }
+
+        return scene;
+    }
+
+    /* Small spheres spread far into the distance, most of them only a few pixels high. All levels are generated
+       into one shared allocation that their geometries map. */
+    std::shared_ptr<Scene> create_lod_scene(unsigned int mesh_count, bool lod)
+    {
+        std::mt19937 generator{42};
+        const std::pair<unsigned int, float> level_descriptions[]{{20u, 64.0f}, {10u, 16.0f}, {5u, 0.0f}};
+
+        auto level_data = std::make_shared<geometry_generators::geometry_data_type>();
+        for (const auto &description : level_descriptions) {
+            auto size = geometry_generators::get_sphere_geometry_data_size(description.first, description.first);
+            level_data->first.resize(level_data->first.size() + size.index_count);
+            level_data->second.resize(level_data->second.size() + size.vertex_count);
+        }
+
+        std::vector<LODMesh::Level> levels;
+        size_t index_offset{0}, vertex_offset{0};
+        for (auto[segment_count, minimum_screen_size] : level_descriptions) {
+            auto size = geometry_generators::get_sphere_geometry_data_size(segment_count, segment_count);
+            unsigned int *indices = level_data->first.data() + index_offset;
+            Vertex *vertices = level_data->second.data() + vertex_offset;
+            geometry_generators::generate_sphere_geometry_data(0.25f, segment_count, segment_count, indices, vertices);
+            levels.push_back(LODMesh::Level{
+                std::make_shared<ES2Geometry>(Geometry::MappedData{level_data, indices, size.index_count, vertices, size.vertex_count}),
+                minimum_screen_size
+            });
+            index_offset += size.index_count;
+            vertex_offset += size.vertex_count;
+        }
+        auto material = std::make_shared<ES2ConstantMaterial>();
+
+        auto scene = std::make_shared<Scene>(std::vector<std::shared_ptr<Object>>{});
+        for (unsigned int i = 0; i < mesh_count; ++i) {
+            std::shared_ptr<Mesh> mesh;
+            if (lod) {
+                mesh = std::make_shared<LODMesh>(levels, material);
+            } else {
+                mesh = std::make_shared<Mesh>(levels.front().geometry, material);
+            }
+            mesh->set_position(random_position(generator, 40.0f));
+            scene->get_root()->add_child(mesh);
+        }
+
+        return scene;
+    }
+
+    std::shared_ptr<Scene> create_transparency_scene(unsigned int mesh_count)
+    {
+        std::mt19937 generator{42};
+        auto[plane_indices, plane_vertices] = geometry_generators::generate_plane_geometry_data(4.0f, 4.0f, 1, 1);
+        auto geometry = std::make_shared<ES2Geometry>(plane_indices, plane_vertices);
+
+        auto scene = std::make_shared<Scene>(std::vector<std::shared_ptr<Object>>{});
+        for (unsigned int i = 0; i < mesh_count; ++i) {
+            auto material = std::make_shared<ES2ConstantMaterial>();
+            material->set_emission_color(glm::vec4{1.0f, 0.5f, 0.25f, 0.1f});
+            material->set_blending_enabled(true);
+            material->set_transparent(true);
+            material->set_face_culling_enabled(false);
+            auto mesh = std::make_shared<Mesh>(geometry, material);
+            mesh->set_position(random_position(generator, 5.0f));
+            scene->get_root()->add_child(mesh);
+        }
+
+        return scene;
+    }
+
+    std::shared_ptr<Scene> create_texture_scene(unsigned int mesh_count, unsigned int texture_size)
+    {
+        std::mt19937 generator{42};
+        auto[plane_indices, plane_vertices] = geometry_generators::generate_plane_geometry_data(1.0f, 1.0f, 1, 1);
+        auto geometry = std::make_shared<ES2Geometry>(plane_indices, plane_vertices);
+
+        auto scene = std::make_shared<Scene>(std::vector<std::shared_ptr<Object>>{});
+        for (unsigned int i = 0; i < mesh_count; ++i) {
+            std::vector<uint8_t> image_data(static_cast<size_t>(texture_size) * texture_size * 4);
+            for (size_t j = 0; j < image_data.size(); ++j) {
+                image_data[j] = static_cast<uint8_t>(generator());
+            }
+            auto texture = std::make_shared<ES2Texture>(std::move(image_data), texture_size, texture_size, 4);
+            auto material = std::make_shared<ES2ConstantMaterial>();
+            material->set_texture_1(texture);
+            auto mesh = std::make_shared<Mesh>(geometry, material);
+            mesh->set_position(random_position(generator, 10.0f));
+            scene->get_root()->add_child(mesh);
+        }
+
+        return scene;
+    }
+
+    template<typename W>
+    Result run_benchmark(const std::shared_ptr<W> &window, const Benchmark &benchmark, unsigned int frame_count)
+    {
+        auto scene = benchmark.create_scene();
+
+        Profiler &profiler = Profiler::get_shared_instance();
+        profiler.set_enabled(true);
+
+        ES2Renderer renderer(scene, window);
+        renderer.finish_shader_compilation();
+        for (unsigned int frame = 0; frame < WARM_UP_FRAME_COUNT; ++frame) {
+            window->poll();
+            scene->get_root()->add_to_rotation_y(0.01f);
+            renderer.render();
+        }
+        window->finish();
+
+        /* Moving the root invalidates the world transformations of the whole hierarchy every frame. */
+        std::vector<double> frame_times;
+        frame_times.reserve(frame_count);
+        unsigned long long allocations = allocation_count;
+        auto *recording_backend = dynamic_cast<gl::RecordingBackend *>(&gl::get_backend());
+        if (recording_backend) {
+            recording_backend->reset();
+        }
+        for (unsigned int frame = 0; frame < frame_count; ++frame) {
+            auto frame_begin = std::chrono::steady_clock::now();
+            window->poll();
+            scene->get_root()->add_to_rotation_y(0.01f);
+            renderer.render();
+            frame_times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frame_begin).count());
+        }
+        allocations = allocation_count - allocations;
+        window->finish();
+
+        Result result;
+        result.name = benchmark.name;
+        result.frame_count = frame_count;
+        result.statistics = profiler.get_frame_statistics();
+        result.allocations = static_cast<double>(allocations) / frame_count;
+        result.gl_calls = recording_backend ? static_cast<double>(recording_backend->get_total_call_count()) / frame_count : 0.0;
+        profiler.set_enabled(false);
+
+        result.mean_frame_time = 0.0;
+        for (double frame_time : frame_times) {
+            result.mean_frame_time += frame_time;
+        }
+        result.mean_frame_time /= frame_count;
+        std::sort(std::begin(frame_times), std::end(frame_times));
+        result.median_frame_time = frame_times[frame_times.size() / 2];
+        result.p95_frame_time = frame_times[std::min(frame_times.size() - 1, frame_times.size() * 95 / 100)];
+        result.minimum_frame_time = frame_times.front();
+
+        return result;
+    }
+
+    std::string escape(const std::string &text)
+    {
+        std::string escaped;
+        for (char character : text) {
+            if (character == '"' || character == '\\') {
+                escaped += '\\';
+            }
+            escaped += character;
+        }
+
+        return escaped;
+    }
+
+    void write_results(std::ostream &stream, const std::vector<Result> &results, bool null_gl)
+    {
+        auto gl_string = [null_gl](GLenum name) {
+            const auto *value = null_gl ? "null" : reinterpret_cast<const char *>(glGetString(name));
+            return escape(value ? value : "");
+        };
+
+        stream << "{\n";
+        stream << "  \"context\": {\n";
+        stream << "    \"gl_renderer\": \"" << gl_string(GL_RENDERER) << "\",\n";
+        stream << "    \"gl_version\": \"" << gl_string(GL_VERSION) << "\",\n";
+        stream << "    \"width\": " << WIDTH << ",\n";
+        stream << "    \"height\": " << HEIGHT << "\n";
+        stream << "  },\n";
+        stream << "  \"benchmarks\": [";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const Result &result = results[i];
+            const auto &counters = result.statistics.counters;
+            stream << (i == 0 ? "\n" : ",\n");
+            stream << "    {\n";
+            stream << "      \"name\": \"" << escape(result.name) << "\",\n";
+            stream << "      \"iterations\": " << result.frame_count << ",\n";
+            stream << "      \"time_unit\": \"ms\",\n";
+            stream << "      \"real_time\": " << result.mean_frame_time << ",\n";
+            stream << "      \"median_time\": " << result.median_frame_time << ",\n";
+            stream << "      \"p95_time\": " << result.p95_frame_time << ",\n";
+            stream << "      \"min_time\": " << result.minimum_frame_time << ",\n";
+            stream << "      \"gpu_time\": " << result.statistics.gpu_time << ",\n";
+            stream << "      \"allocations\": " << result.allocations << ",\n";
+            if (null_gl) {
+                stream << "      \"gl_calls\": " << result.gl_calls << ",\n";
+            }
+            stream << "      \"draw_calls\": " << counters[Profiler::DrawCalls] << ",\n";
+            stream << "      \"state_changes\": " << counters[Profiler::StateChanges] << ",\n";
+            stream << "      \"uniform_uploads\": " << counters[Profiler::UniformUploads] << ",\n";
+            stream << "      \"triangles\": " << counters[Profiler::Triangles] << ",\n";
+            stream << "      \"uploaded_bytes\": " << counters[Profiler::UploadedBytes] << ",\n";
+            stream << "      \"saved_triangles\": " << counters[Profiler::SavedTriangles] << "\n";
+            stream << "    }";
+        }
+        stream << "\n  ]\n";
+        stream << "}\n";
+    }
+}
+
+/* Renders synthetic scenes offscreen and prints the per-frame costs as JSON, e.g. to compare nightly runs.
+   With --null-gl, GL calls are recorded instead of executed to measure the CPU side of the renderer alone.
+   Builds without EGL (ASR_EGL undefined) support only --null-gl, e.g. on machines without a GPU.
+   Usage: renderer_benchmark [--frames <count>] [--filter <substring>] [--output <path>] [--null-gl] */
+int main(int argc, char **argv)
+{
+    unsigned int frame_count{DEFAULT_FRAME_COUNT};
+    std::string filter, output_path;
+    bool null_gl{false};
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frame_count = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (std::strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            output_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--null-gl") == 0) {
+            null_gl = true;
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--frames <count>] [--filter <substring>] [--output <path>] [--null-gl]" << std::endl;
+            return -1;
+        }
+    }
+
+    const std::vector<Benchmark> benchmarks{
+        {"meshes/shared_geometry/1000", [] { return create_mesh_scene(1000, true); }},
+        {"meshes/unique_geometry/1000", [] { return create_mesh_scene(1000, false); }},
+        {"hierarchy/deep/512", [] { return create_hierarchy_scene(512, 1); }},
+        {"hierarchy/wide/2000", [] { return create_hierarchy_scene(1, 2000); }},
+        {"hierarchy/tree/4x4x4x4", [] { return create_hierarchy_scene(4, 4); }},
+        {"lighting/200/1", [] { return create_lighting_scene(200, 1); }},
+        {"lighting/200/8", [] { return create_lighting_scene(200, 8); }},
+        {"lod/spheres/2000/full", [] { return create_lod_scene(2000, false); }},
+        {"lod/spheres/2000/selected", [] { return create_lod_scene(2000, true); }},
+        {"transparency/500", [] { return create_transparency_scene(500); }},
+        {"textures/200/256", [] { return create_texture_scene(200, 256); }}
+    };
+
+    std::shared_ptr<NullWindow> null_window;
+#ifdef ASR_EGL
+    std::shared_ptr<ES2EGLWindow> window;
+#endif
+    if (null_gl) {
+        gl::set_backend(std::make_shared<gl::RecordingBackend>());
+        null_window = std::make_shared<NullWindow>("asr", WIDTH, HEIGHT);
+    } else {
+#ifdef ASR_EGL
+        window = std::make_shared<ES2EGLWindow>("asr", WIDTH, HEIGHT);
+#else
+        std::cerr << "The benchmark was built without EGL, so it can only run with --null-gl" << std::endl;
+        return -1;
+#endif
+    }
+
+    std::vector<Result> results;
+    for (const auto &benchmark : benchmarks) {
+        if (!filter.empty() && std::string{benchmark.name}.find(filter) == std::string::npos) {
+            continue;
+        }
+        std::cerr << "Running " << benchmark.name << std::endl;
+#ifdef ASR_EGL
+        results.push_back(null_gl ? run_benchmark(null_window, benchmark, frame_count) : run_benchmark(window, benchmark, frame_count));
+#else
+        results.push_back(run_benchmark(null_window, benchmark, frame_count));
+#endif
+    }
+
+    if (output_path.empty()) {
+        write_results(std::cout, results, null_gl);
+    } else {
+        std::ofstream file_stream{output_path, std::ios::trunc};
+        write_results(file_stream, results, null_gl);
+        if (!file_stream) {
+            std::cerr << "Failed to write the file: '" << output_path << "'" << std::endl;
+            return -1;
+        }
+    }
+
+    return 0;
+}
@@ -3,6 +3,7 @@
 
 #include "objects/object.h"
 #include "objects/mesh.h"
+#include "objects/lod_mesh.h"
 #include "objects/camera.h"
 #include "lights/light.h"
 #include "lights/ambient_light.h"
@@ -13,25 +14,56 @@
 #include "geometries/geometry.h"
 #include "geometries/es2_geometry.h"
 #include "geometries/geometry_generators.h"
+#include "geometries/geometry_simplifier.h"
+#include "geometries/geometry_optimizers.h"
+#include "geometries/mesh_file.h"
+#include "geometries/mesh_loader.h"
+#include "geometries/es2_mesh_loader.h"
 #include "textures/texture.h"
 #include "textures/es2_texture.h"
+#include "textures/mipmap_generator.h"
+#include "textures/texture_loader.h"
+#include "textures/es2_texture_loader.h"
+#include "textures/texture_view.h"
+#include "textures/texture_atlas.h"
+#include "textures/es2_texture_atlas.h"
 #include "materials/material.h"
 #include "materials/constant_material.h"
 #include "materials/es2_constant_material.h"
 #include "materials/phong_material.h"
 #include "materials/es2_phong_material.h"
+#include "objects/model_importer.h"
+#include "objects/es2_model_importer.h"
 #include "scene/scene.h"
 #include "window/window.h"
 #include "window/es2_sdl_window.h"
 #include "renderer/shader.h"
+#include "renderer/gl_dispatch.h"
 #include "renderer/es2_shader.h"
+#include "renderer/shader_compile_queue.h"
+#include "renderer/shader_reloader.h"
+#include "renderer/residency_manager.h"
+#include "renderer/render_target.h"
+#include "renderer/es2_render_target.h"
+#include "renderer/es2_gpu_timer.h"
+#include "renderer/es2_command_buffer.h"
+#include "renderer/resolution_scaler.h"
 #include "renderer/renderer.h"
 #include "renderer/es2_renderer.h"
 #include "math/ray.h"
 #include "math/plane.h"
 #include "math/aabb.h"
 #include "math/sphere.h"
+#include "utilities/image_buffer.h"
 #include "utilities/utilities.h"
+#include "utilities/compressed_image_utilities.h"
+#include "utilities/file_watcher.h"
+#include "utilities/thread_pool.h"
+#include "utilities/gpu_resource.h"
+#include "utilities/trace_recorder.h"
+#include "utilities/profiler.h"
+#include "utilities/mapped_file.h"
+#include "utilities/json.h"
 
 #include <imgui.h>
 
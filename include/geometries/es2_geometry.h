@@ -2,12 +2,15 @@
 #define ES2_GEOMETRY_HPP
 
 #include "geometries/geometry.h"
+#include "utilities/profiler.h"
+#include "renderer/gl_dispatch.h"
 
 #include <GL/glew.h>
 #define SDL_MAIN_HANDLED
 #include <SDL.h>
 
 #include <string>
+#include <utility>
 #include <iostream>
 
 namespace asr
@@ -15,8 +18,11 @@ namespace asr
     class ES2Geometry final : public Geometry
     {
     public:
-        explicit ES2Geometry(std::vector<unsigned int> &indices, const std::vector<Vertex> &vertices)
-                : Geometry(indices, vertices) {}
+        explicit ES2Geometry(std::vector<unsigned int> indices, std::vector<Vertex> vertices)
+                : Geometry(std::move(indices), std::move(vertices)) {}
+
+        explicit ES2Geometry(MappedData mapped_data)
+                : Geometry(std::move(mapped_data)) {}
 
         ES2Geometry(const ES2Geometry &other) = delete;
         ES2Geometry& operator=(const ES2Geometry &other) = delete;
@@ -24,57 +30,65 @@ namespace asr
         ~ES2Geometry() final
         {
             if (_vertex_array_object != 0) {
-#ifdef __APPLE__
-                glDeleteVertexArraysAPPLE(1, &_vertex_array_object);
-#else
-                glDeleteVertexArrays(1, &_vertex_array_object);
-#endif
+                gl::DeleteVertexArrays(1, &_vertex_array_object);
             }
 
             if (_index_buffer_object != 0) {
-                glDeleteBuffers(1, &_index_buffer_object);
+                gl::DeleteBuffers(1, &_index_buffer_object);
             }
 
             if (_vertex_buffer_object != 0) {
-                glDeleteBuffers(1, &_vertex_buffer_object);
+                gl::DeleteBuffers(1, &_vertex_buffer_object);
             }
         }
 
+        [[nodiscard]] size_t get_gpu_size() const final
+        {
+            return _gpu_size;
+        }
+
+        void evict() final
+        {
+            if (_vertex_array_object == 0 && _index_buffer_object == 0 && _vertex_buffer_object == 0) {
+                return;
+            }
+
+            gl::DeleteVertexArrays(1, &_vertex_array_object);
+            gl::DeleteBuffers(1, &_index_buffer_object);
+            gl::DeleteBuffers(1, &_vertex_buffer_object);
+            _vertex_array_object = _index_buffer_object = _vertex_buffer_object = 0;
+            _gpu_size = 0;
+            _requires_indices_update = true;
+            _requires_vertices_update = true;
+        }
+
         void update(const Material &material) final
         {
             if (!(_requires_indices_update || _requires_vertices_update)) {
                 return;
             }
 
-#ifdef __APPLE__
-            glBindVertexArrayAPPLE(0);
-#else
-            glBindVertexArray(0);
-#endif
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-            glBindBuffer(GL_ARRAY_BUFFER, 0);
+            gl::BindVertexArray(0);
+            gl::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+            gl::BindBuffer(GL_ARRAY_BUFFER, 0);
 
             if (_vertex_array_object != 0) {
-#ifdef __APPLE__
-                glDeleteVertexArraysAPPLE(1, &_vertex_array_object);
-#else
-                glDeleteVertexArrays(1, &_vertex_array_object);
-#endif
+                gl::DeleteVertexArrays(1, &_vertex_array_object);
             }
             if (_index_buffer_object != 0) {
-                glDeleteBuffers(1, &_index_buffer_object);
+                gl::DeleteBuffers(1, &_index_buffer_object);
             }
             if (_vertex_buffer_object != 0) {
-                glDeleteBuffers(1, &_vertex_buffer_object);
+                gl::DeleteBuffers(1, &_vertex_buffer_object);
             }
 
-            const auto *index_data = reinterpret_cast<const unsigned int *>(_indices.data());
-            const size_t index_data_size{_indices.size() * sizeof(unsigned int)};
+            const auto *index_data = get_index_data();
+            const size_t index_data_size{get_index_count() * sizeof(unsigned int)};
 
             GLuint index_buffer_object{0};
-            glGenBuffers(1, &index_buffer_object);
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer_object);
-            glBufferData(
+            gl::GenBuffers(1, &index_buffer_object);
+            gl::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer_object);
+            gl::BufferData(
                 GL_ELEMENT_ARRAY_BUFFER,
                 static_cast<GLsizeiptr>(index_data_size), index_data,
                 _convert_usage_strategy_to_es2_buffer_usage_strategy(_indices_usage_strategy)
@@ -83,13 +97,13 @@ namespace asr
 
             _requires_indices_update = false;
 
-            const auto *vertex_data = reinterpret_cast<const float *>(_vertices.data());
-            const size_t vertex_data_size{_vertices.size() * sizeof(Vertex)};
+            const auto *vertex_data = reinterpret_cast<const float *>(get_vertex_data());
+            const size_t vertex_data_size{get_vertex_count() * sizeof(Vertex)};
 
             GLuint vertex_buffer_object{0};
-            glGenBuffers(1, &vertex_buffer_object);
-            glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer_object);
-            glBufferData(
+            gl::GenBuffers(1, &vertex_buffer_object);
+            gl::BindBuffer(GL_ARRAY_BUFFER, vertex_buffer_object);
+            gl::BufferData(
                 GL_ARRAY_BUFFER,
                 static_cast<GLsizeiptr>(vertex_data_size), vertex_data,
                 _convert_usage_strategy_to_es2_buffer_usage_strategy(_vertices_usage_strategy)
@@ -98,16 +112,14 @@ namespace asr
 
             _requires_vertices_update = false;
 
+            _gpu_size = index_data_size + vertex_data_size;
+            Profiler::count(Profiler::UploadedBytes, _gpu_size);
+
             GLuint vertex_array_object{0};
-#ifdef __APPLE__
-            glGenVertexArraysAPPLE(1, &vertex_array_object);
-            glBindVertexArrayAPPLE(vertex_array_object);
-#else
-            glGenVertexArrays(1, &vertex_array_object);
-            glBindVertexArray(vertex_array_object);
-#endif
-            glBindBuffer(GL_ARRAY_BUFFER, _vertex_buffer_object);
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _index_buffer_object);
+            gl::GenVertexArrays(1, &vertex_array_object);
+            gl::BindVertexArray(vertex_array_object);
+            gl::BindBuffer(GL_ARRAY_BUFFER, _vertex_buffer_object);
+            gl::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, _index_buffer_object);
 
             auto &attributes = material.get_shader()->get_attributes();
 
@@ -115,8 +127,8 @@ namespace asr
 
             int position_attribute_location{attributes.count("position") > 0 ? attributes.at("position") : -1};
             if (position_attribute_location != -1) {
-                glEnableVertexAttribArray(static_cast<GLuint>(position_attribute_location));
-                glVertexAttribPointer(
+                gl::EnableVertexAttribArray(static_cast<GLuint>(position_attribute_location));
+                gl::VertexAttribPointer(
                     static_cast<GLuint>(position_attribute_location),
                     3, GL_FLOAT, GL_FALSE, stride, static_cast<const GLvoid *>(nullptr)
                 );
@@ -124,8 +136,8 @@ namespace asr
 
             int color_attribute_location{attributes.count("color") > 0 ? attributes.at("color") : -1};
             if (color_attribute_location != -1) {
-                glEnableVertexAttribArray(static_cast<GLuint>(color_attribute_location));
-                glVertexAttribPointer(
+                gl::EnableVertexAttribArray(static_cast<GLuint>(color_attribute_location));
+                gl::VertexAttribPointer(
                     static_cast<GLuint>(color_attribute_location),
                     4, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const GLvoid *>(sizeof(GLfloat) * 3)
                 );
@@ -133,8 +145,8 @@ namespace asr
 
             int normal_attribute_location{attributes.count("normal") > 0 ? attributes.at("normal") : -1};
             if (normal_attribute_location != -1) {
-                glEnableVertexAttribArray(static_cast<GLuint>(normal_attribute_location));
-                glVertexAttribPointer(
+                gl::EnableVertexAttribArray(static_cast<GLuint>(normal_attribute_location));
+                gl::VertexAttribPointer(
                     static_cast<GLuint>(normal_attribute_location),
                     3, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const GLvoid *>(sizeof(GLfloat) * 7)
                 );
@@ -142,8 +154,8 @@ namespace asr
 
             int tangent_attribute_location{attributes.count("tangent") > 0 ? attributes.at("tangent") : -1};
             if (tangent_attribute_location != -1) {
-                glEnableVertexAttribArray(static_cast<GLuint>(tangent_attribute_location));
-                glVertexAttribPointer(
+                gl::EnableVertexAttribArray(static_cast<GLuint>(tangent_attribute_location));
+                gl::VertexAttribPointer(
                     static_cast<GLuint>(tangent_attribute_location),
                     4, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const GLvoid *>(sizeof(GLfloat) * 10)
                 );
@@ -151,8 +163,8 @@ namespace asr
 
             int binormal_attribute_location{attributes.count("binormal") > 0 ? attributes.at("binormal") : -1};
             if (binormal_attribute_location != -1) {
-                glEnableVertexAttribArray(static_cast<GLuint>(binormal_attribute_location));
-                glVertexAttribPointer(
+                gl::EnableVertexAttribArray(static_cast<GLuint>(binormal_attribute_location));
+                gl::VertexAttribPointer(
                     static_cast<GLuint>(binormal_attribute_location),
                     3, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const GLvoid *>(sizeof(GLfloat) * 14)
                 );
@@ -160,8 +172,8 @@ namespace asr
 
             int texture1_coordinates_attribute_location{attributes.count("texture1_coordinates") > 0 ? attributes.at("texture1_coordinates") : -1};
             if (texture1_coordinates_attribute_location != -1) {
-                glEnableVertexAttribArray(static_cast<GLuint>(texture1_coordinates_attribute_location));
-                glVertexAttribPointer(
+                gl::EnableVertexAttribArray(static_cast<GLuint>(texture1_coordinates_attribute_location));
+                gl::VertexAttribPointer(
                     static_cast<GLuint>(texture1_coordinates_attribute_location),
                     4, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const GLvoid *>(sizeof(GLfloat) * 17)
                 );
@@ -169,31 +181,24 @@ namespace asr
 
             int texture2_coordinates_attribute_location{attributes.count("texture2_coordinates") > 0 ? attributes.at("texture2_coordinates") : -1};
             if (texture2_coordinates_attribute_location != -1) {
-                glEnableVertexAttribArray(static_cast<GLuint>(texture2_coordinates_attribute_location));
-                glVertexAttribPointer(
+                gl::EnableVertexAttribArray(static_cast<GLuint>(texture2_coordinates_attribute_location));
+                gl::VertexAttribPointer(
                     static_cast<GLuint>(texture2_coordinates_attribute_location),
                     4, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const GLvoid *>(sizeof(GLfloat) * 21)
                 );
             }
-#ifdef __APPLE__
-                glBindVertexArrayAPPLE(0);
-#else
-            glBindVertexArray(0);
-#endif
-            glBindBuffer(GL_ARRAY_BUFFER, 0);
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+            gl::BindVertexArray(0);
+            gl::BindBuffer(GL_ARRAY_BUFFER, 0);
+            gl::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
             _vertex_array_object = vertex_array_object;
         }
 
         void use() final
         {
+            mark_used();
             if (_vertex_array_object != 0) {
-#ifdef __APPLE__
-                glBindVertexArrayAPPLE(_vertex_array_object);
-#else
-                glBindVertexArray(_vertex_array_object);
-#endif
+                gl::BindVertexArray(_vertex_array_object);
             }
         }
 
@@ -201,6 +206,7 @@ namespace asr
         GLuint _vertex_array_object{0};
         GLuint _index_buffer_object{0};
         GLuint _vertex_buffer_object{0};
+        size_t _gpu_size{0};
 
         static GLenum _convert_usage_strategy_to_es2_buffer_usage_strategy(Geometry::UsageStrategy usage_strategy)
         {
@@ -0,0 +1,25 @@
+#ifndef ES2_MESH_LOADER_H
+#define ES2_MESH_LOADER_H
+
+#include "geometries/mesh_loader.h"
+#include "geometries/es2_geometry.h"
+
+#include <memory>
+#include <utility>
+
+namespace asr
+{
+    class ES2MeshLoader final : public MeshLoader
+    {
+    public:
+        using MeshLoader::MeshLoader;
+
+    protected:
+        std::shared_ptr<Geometry> _create_geometry(Geometry::MappedData mapped_data) final
+        {
+            return std::make_shared<ES2Geometry>(std::move(mapped_data));
+        }
+    };
+}
+
+#endif
@@ -3,15 +3,26 @@
 
 #include "materials/material.h"
 #include "geometries/vertex.h"
+#include "utilities/gpu_resource.h"
+#include "utilities/thread_pool.h"
 
+#include <cmath>
 #include <vector>
+#include <memory>
+#include <limits>
 #include <utility>
+#include <algorithm>
 
 #include <glm/glm.hpp>
 
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define ASR_GEOMETRY_SSE
+#endif
+
 namespace asr
 {
-    class Geometry
+    class Geometry : public GPUResource
     {
     public:
         enum Type
@@ -32,10 +43,26 @@ namespace asr
             StreamStrategy
         };
 
+        /* Index and vertex data that the geometry does not own, e.g. ranges of a memory-mapped mesh file, which
+           `owner` keeps alive. It is uploaded as it is; everything that modifies the geometry copies it into the
+           index and vertex vectors first. */
+        struct MappedData
+        {
+            std::shared_ptr<const void> owner;
+            const unsigned int *indices;
+            size_t index_count;
+            const Vertex *vertices;
+            size_t vertex_count;
+        };
+
         explicit Geometry(std::vector<unsigned int> indices, std::vector<Vertex> vertices)
                 : _indices(std::move(indices)), _vertices(std::move(vertices))
         {}
 
+        explicit Geometry(MappedData mapped_data)
+                : _mapped_data(std::move(mapped_data))
+        {}
+
         virtual ~Geometry() = default;
 
         [[nodiscard]] Type get_type() const
@@ -48,38 +75,71 @@ namespace asr
             _type = type;
         }
 
+        [[nodiscard]] bool is_mapped() const
+        {
+            return _mapped_data.owner != nullptr;
+        }
+
+        /* Empty while the geometry is mapped, `get_index_data` and `get_index_count` work in both cases. */
         [[nodiscard]] const std::vector<unsigned int> &get_indices() const
         {
             return _indices;
         }
 
-        [[nodiscard]] std::vector<unsigned int> &get_indices()
+        /* Copies the indices of a mapped geometry into the vector first, so it should only be used to change them. */
+        [[nodiscard]] std::vector<unsigned int> &get_mutable_indices()
         {
+            _unmap();
             return _indices;
         }
 
         void set_indices(const std::vector<unsigned int> &indices)
         {
+            _unmap();
             _indices = indices;
             _requires_indices_update = true;
         }
 
+        [[nodiscard]] const unsigned int *get_index_data() const
+        {
+            return is_mapped() ? _mapped_data.indices : _indices.data();
+        }
+
+        [[nodiscard]] size_t get_index_count() const
+        {
+            return is_mapped() ? _mapped_data.index_count : _indices.size();
+        }
+
+        /* Empty while the geometry is mapped, `get_vertex_data` and `get_vertex_count` work in both cases. */
         [[nodiscard]] const std::vector<Vertex> &get_vertices() const
         {
             return _vertices;
         }
 
-        [[nodiscard]] std::vector<Vertex> &get_vertices()
+        /* Copies the vertices of a mapped geometry into the vector first, so it should only be used to change them. */
+        [[nodiscard]] std::vector<Vertex> &get_mutable_vertices()
         {
+            _unmap();
             return _vertices;
         }
 
         void set_vertices(const std::vector<Vertex> &vertices)
         {
+            _unmap();
             _vertices = vertices;
             _requires_vertices_update = true;
         }
 
+        [[nodiscard]] const Vertex *get_vertex_data() const
+        {
+            return is_mapped() ? _mapped_data.vertices : _vertices.data();
+        }
+
+        [[nodiscard]] size_t get_vertex_count() const
+        {
+            return is_mapped() ? _mapped_data.vertex_count : _vertices.size();
+        }
+
         void set_requires_indices_update(bool requires_indices_update)
         {
             _requires_indices_update = requires_indices_update;
@@ -116,6 +176,12 @@ namespace asr
             }
         }
 
+        /* Indices and vertices always stay in CPU memory. */
+        [[nodiscard]] bool is_restorable() const override
+        {
+            return !_vertices.empty() || is_mapped();
+        }
+
         [[nodiscard]] float get_line_width() const
         {
             return _line_width;
@@ -126,93 +192,129 @@ namespace asr
             _line_width = lineWidth;
         }
 
-        void transform(glm::mat4 transformation_matrix)
+        /* Bakes an affine transformation into the vertices. Positions get the full matrix, tangents and binormals
+           its upper 3x3 part and normals the normal matrix, and all three are normalized again. Mirroring
+           transformations flip the handedness in `tangent.w`. Large geometries are split across the thread pool. */
+        void transform(glm::mat4 transformation_matrix, ThreadPool &thread_pool = ThreadPool::get_shared_instance())
         {
-            for (auto &vertex : _vertices) {
-                vertex.position = glm::vec3(transformation_matrix * glm::vec4(vertex.position, 1.0f));
-            }
+            _unmap();
+
+            /* The cofactor matrix is the inverse transpose scaled by the determinant, so it gives the same directions
+               without a division and stays finite for singular matrices. */
+            glm::vec3 columns[3]{
+                glm::vec3{transformation_matrix[0]}, glm::vec3{transformation_matrix[1]}, glm::vec3{transformation_matrix[2]}
+            };
+            float determinant = glm::dot(columns[0], glm::cross(columns[1], columns[2]));
+            float handedness = determinant < 0.0f ? -1.0f : 1.0f;
+            glm::mat4 normal_matrix{glm::mat3{
+                glm::cross(columns[1], columns[2]) * handedness,
+                glm::cross(columns[2], columns[0]) * handedness,
+                glm::cross(columns[0], columns[1]) * handedness
+            }};
+            glm::mat4 direction_matrix{glm::mat3{transformation_matrix}};
+
+            /* Four-component products, so that compilers can keep one matrix column per SIMD register. */
+            thread_pool.parallel_for(0, _vertices.size(), TRANSFORM_CHUNK_SIZE, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    Vertex &vertex = _vertices[i];
+                    vertex.position = glm::vec3{transformation_matrix * glm::vec4{vertex.position, 1.0f}};
+                    vertex.normal = _normalize_direction(glm::vec3{normal_matrix * glm::vec4{vertex.normal, 0.0f}});
+                    vertex.binormal = _normalize_direction(glm::vec3{direction_matrix * glm::vec4{vertex.binormal, 0.0f}});
+                    glm::vec3 tangent = _normalize_direction(glm::vec3{direction_matrix * glm::vec4{glm::vec3{vertex.tangent}, 0.0f}});
+                    vertex.tangent = glm::vec4{tangent, vertex.tangent.w * handedness};
+                }
+            });
+
             _requires_vertices_update = true;
         }
 
-        void calculate_tangents_and_binormals()
+        /* MikkTSpace-style tangent frames. Every triangle adds its direction of increasing s, projected onto the
+           normal of each of its corners and weighted by the corner angle, to the vertices it uses. Vertices shared
+           by mirrored and unmirrored triangles follow the larger side. Triangles with degenerate positions or
+           texture coordinates add nothing, and vertices left without a tangent get one orthogonal to their normal.
+           `tangent.w` is the handedness, with binormal = cross(normal, tangent) * tangent.w.
+           Corners are computed in parallel and summed per vertex in a fixed order, so the result does not depend
+           on the number of threads. */
+        void calculate_tangents_and_binormals(ThreadPool &thread_pool = ThreadPool::get_shared_instance())
         {
             if (_type != Triangles && _type != TriangleStrip && _type != TriangleFan) {
                 return;
             }
+            _unmap();
 
-            for (auto &vertex : _vertices) {
-                vertex.tangent = glm::vec4(0.0f);
-                vertex.binormal = glm::vec3(0.0f);
-            }
-
-            std::vector<unsigned int>::size_type index = _type == TriangleFan ? 1 : 0;
-            while (index < _indices.size()) {
-                std::vector<unsigned int>::size_type a_index, b_index, c_index;
-                switch (_type) {
-                    case Triangles:
-                        a_index = index;
-                        b_index = index + 1;
-                        c_index = index + 2;
-                        index += 3;
-                        break;
-                    case TriangleStrip:
-                        a_index = index;
-                        b_index = index + 1;
-                        c_index = index + 2;
-                        ++index;
-                        break;
-                    case TriangleFan:
-                        a_index = 0;
-                        b_index = index;
-                        c_index = index + 1;
-                        ++index;
-                        break;
-                    default:
-                        return;
+            std::vector<unsigned int> triangle_list;
+            if (_type != Triangles) {
+                triangle_list = _get_triangle_list();
+            }
+            const std::vector<unsigned int> &triangle_indices = _type == Triangles ? _indices : triangle_list;
+            const size_t triangle_count = triangle_indices.size() / 3;
+            const size_t vertex_count = _vertices.size();
+
+            /* The angle-weighted tangent of every corner, with a negative weight for mirrored triangles. */
+            std::vector<glm::vec4> corner_tangents(triangle_count * 3);
+            thread_pool.parallel_for(0, triangle_count, TANGENT_CHUNK_SIZE, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    _calculate_corner_tangents(&triangle_indices[i * 3], &corner_tangents[i * 3]);
                 }
+            });
 
-                Vertex &a = _vertices[_indices[a_index]];
-                Vertex &b = _vertices[_indices[b_index]];
-                Vertex &c = _vertices[_indices[c_index]];
-
-                glm::vec4 a_texture_coordinates = a.texture1_coordinates;
-                glm::vec4 b_texture_coordinates = b.texture1_coordinates;
-                glm::vec4 c_texture_coordinates = c.texture1_coordinates;
-
-                glm::vec3 q1 = b.position - a.position;
-                glm::vec3 q2 = c.position - a.position;
-
-                float s1 = b_texture_coordinates.s - a_texture_coordinates.s;
-                float s2 = c_texture_coordinates.s - a_texture_coordinates.s;
-                float t1 = b_texture_coordinates.t - a_texture_coordinates.t;
-                float t2 = c_texture_coordinates.t - a_texture_coordinates.t;
-
-                glm::vec3 tangent = glm::normalize((q1 * t2) - (q2 * t1));
-                glm::vec3 binormal = glm::normalize((q2 * s1) - (q1 * s2));
-
-                a.tangent += glm::vec4(tangent, 0.0f);
-                b.tangent += glm::vec4(tangent, 0.0f);
-                c.tangent += glm::vec4(tangent, 0.0f);
-
-                a.binormal += binormal;
-                b.binormal += binormal;
-                c.binormal += binormal;
+            /* The corners of every vertex, so that vertices can be summed up without writing to shared data. */
+            std::vector<size_t> corner_offsets(vertex_count + 1, 0);
+            for (size_t i = 0; i < corner_tangents.size(); ++i) {
+                if (triangle_indices[i] < vertex_count) {
+                    ++corner_offsets[triangle_indices[i] + 1];
+                }
             }
-
-            for (auto &vertex : _vertices) {
-                glm::vec3 normal = vertex.normal;
-                glm::vec3 tangent = vertex.tangent;
-                glm::vec3 binormal = vertex.binormal;
-
-                tangent = glm::normalize(tangent - (normal * glm::dot(tangent, normal)));
-                glm::vec4 tangent_with_determinant = glm::vec4(tangent, 0.0f);
-
-                bool mirrored = glm::dot(glm::cross(normal, tangent), binormal) < 0.0f;
-                tangent_with_determinant[3] = mirrored ? 1.0f : -1.0f;
-
-                vertex.tangent = tangent_with_determinant;
-                vertex.binormal = glm::cross(normal, tangent) * tangent_with_determinant[3];
+            for (size_t i = 0; i < vertex_count; ++i) {
+                corner_offsets[i + 1] += corner_offsets[i];
             }
+            std::vector<size_t> vertex_corners(corner_offsets.back());
+            std::vector<size_t> next_corners(std::begin(corner_offsets), std::end(corner_offsets) - 1);
+            for (size_t i = 0; i < corner_tangents.size(); ++i) {
+                if (triangle_indices[i] < vertex_count) {
+                    vertex_corners[next_corners[triangle_indices[i]]++] = i;
+                }
+            }
+
+            /* Chunks hold whole groups of four vertices, so that every vertex takes the same path for any number of
+               threads. */
+            thread_pool.parallel_for(0, (vertex_count + 3) / 4, TANGENT_CHUNK_SIZE / 4, [&](size_t begin_group, size_t end_group) {
+                size_t begin = begin_group * 4, end = std::min(end_group * 4, vertex_count);
+                auto sum_tangent = [&](size_t vertex, float &handedness) {
+                    glm::vec3 sums[2]{glm::vec3{0.0f}, glm::vec3{0.0f}};
+                    float weights[2]{0.0f, 0.0f};
+                    for (size_t i = corner_offsets[vertex]; i < corner_offsets[vertex + 1]; ++i) {
+                        const glm::vec4 &corner_tangent = corner_tangents[vertex_corners[i]];
+                        size_t side = corner_tangent.w < 0.0f ? 1 : 0;
+                        sums[side] += glm::vec3{corner_tangent};
+                        weights[side] += std::abs(corner_tangent.w);
+                    }
+                    size_t side = weights[1] > weights[0] ? 1 : 0;
+                    handedness = side == 1 ? -1.0f : 1.0f;
+                    return sums[side];
+                };
+
+                size_t i = begin;
+#ifdef ASR_GEOMETRY_SSE
+                for (; i + 4 <= end; i += 4) {
+                    alignas(16) float tangents[3][4], normals[3][4], handedness[4];
+                    for (size_t j = 0; j < 4; ++j) {
+                        glm::vec3 tangent = sum_tangent(i + j, handedness[j]);
+                        const glm::vec3 &normal = _vertices[i + j].normal;
+                        for (int k = 0; k < 3; ++k) {
+                            tangents[k][j] = tangent[k];
+                            normals[k][j] = normal[k];
+                        }
+                    }
+                    _orthogonalize_tangents(&_vertices[i], tangents, normals, handedness);
+                }
+#endif
+                for (; i < end; ++i) {
+                    float handedness;
+                    glm::vec3 tangent = sum_tangent(i, handedness);
+                    _orthogonalize_tangent(_vertices[i], tangent, handedness);
+                }
+            });
 
             _requires_vertices_update = true;
         }
@@ -233,6 +335,176 @@ namespace asr
         UsageStrategy _indices_usage_strategy{StaticStrategy};
 
         float _line_width{1.0f};
+
+        MappedData _mapped_data{};
+
+        /* Triangles, or vertices, per task of the tangent calculation. */
+        static const size_t TANGENT_CHUNK_SIZE{4096};
+
+        /* Vertices per task of `transform`. */
+        static const size_t TRANSFORM_CHUNK_SIZE{16384};
+
+        /* Zero vectors, e.g. tangents that were never calculated, stay zero. */
+        static glm::vec3 _normalize_direction(const glm::vec3 &direction)
+        {
+            float length = glm::length(direction);
+            return length > std::numeric_limits<float>::min() ? direction / length : direction;
+        }
+
+        /* The triangles of a strip or fan as a list, without the ones that repeat an index. */
+        /* Every other triangle of a strip is flipped so that all of them keep the winding of the first one. */
+        [[nodiscard]] std::vector<unsigned int> _get_triangle_list() const
+        {
+            std::vector<unsigned int> triangle_list;
+            for (size_t i = 0; i + 2 < _indices.size(); ++i) {
+                unsigned int a = _type == TriangleFan ? _indices[0] : _indices[i];
+                unsigned int b = _indices[i + 1], c = _indices[i + 2];
+                if (_type == TriangleStrip && i % 2 == 1) {
+                    std::swap(a, b);
+                }
+                if (a != b && b != c && a != c) {
+                    triangle_list.insert(std::end(triangle_list), {a, b, c});
+                }
+            }
+
+            return triangle_list;
+        }
+
+        void _calculate_corner_tangents(const unsigned int *triangle, glm::vec4 *corner_tangents) const
+        {
+            corner_tangents[0] = corner_tangents[1] = corner_tangents[2] = glm::vec4{0.0f};
+            if (triangle[0] >= _vertices.size() || triangle[1] >= _vertices.size() || triangle[2] >= _vertices.size()) {
+                return;
+            }
+
+            const Vertex *corners[3]{&_vertices[triangle[0]], &_vertices[triangle[1]], &_vertices[triangle[2]]};
+            glm::vec3 edges[3]{
+                corners[1]->position - corners[0]->position,
+                corners[2]->position - corners[1]->position,
+                corners[0]->position - corners[2]->position
+            };
+            float edge_lengths[3]{glm::length(edges[0]), glm::length(edges[1]), glm::length(edges[2])};
+
+            float s1 = corners[1]->texture1_coordinates.s - corners[0]->texture1_coordinates.s;
+            float s2 = corners[2]->texture1_coordinates.s - corners[0]->texture1_coordinates.s;
+            float t1 = corners[1]->texture1_coordinates.t - corners[0]->texture1_coordinates.t;
+            float t2 = corners[2]->texture1_coordinates.t - corners[0]->texture1_coordinates.t;
+            float determinant = s1 * t2 - s2 * t1;
+
+            /* Written so that NaNs count as degenerate, too. */
+            const float minimum = std::numeric_limits<float>::min();
+            if (!(std::abs(determinant) > minimum && edge_lengths[0] > minimum && edge_lengths[1] > minimum && edge_lengths[2] > minimum)) {
+                return;
+            }
+            float handedness = determinant > 0.0f ? 1.0f : -1.0f;
+            glm::vec3 tangent = (edges[0] * t2 + edges[2] * t1) * handedness;
+
+            float angles[3];
+            for (int i = 0; i < 2; ++i) {
+                int previous = (i + 2) % 3;
+                float cosine = -glm::dot(edges[i], edges[previous]) / (edge_lengths[i] * edge_lengths[previous]);
+                angles[i] = std::acos(std::clamp(cosine, -1.0f, 1.0f));
+            }
+            angles[2] = std::max(static_cast<float>(M_PI) - angles[0] - angles[1], 0.0f);
+
+            for (int i = 0; i < 3; ++i) {
+                const glm::vec3 &normal = corners[i]->normal;
+                glm::vec3 projected_tangent = tangent - normal * glm::dot(normal, tangent);
+                float projected_length = glm::length(projected_tangent);
+                if (projected_length > minimum) {
+                    corner_tangents[i] = glm::vec4{projected_tangent * (angles[i] / projected_length), angles[i] * handedness};
+                }
+            }
+        }
+
+        static void _orthogonalize_tangent(Vertex &vertex, glm::vec3 tangent, float handedness)
+        {
+            glm::vec3 normal{0.0f};
+            float normal_length_squared = glm::dot(vertex.normal, vertex.normal);
+            if (normal_length_squared > std::numeric_limits<float>::min()) {
+                normal = vertex.normal / std::sqrt(normal_length_squared);
+            }
+
+            tangent -= normal * glm::dot(normal, tangent);
+            float tangent_length = glm::length(tangent);
+            if (tangent_length > MINIMUM_TANGENT_LENGTH) {
+                tangent /= tangent_length;
+            } else {
+                glm::vec3 axis = std::abs(normal.x) < 0.9f ? glm::vec3{1.0f, 0.0f, 0.0f} : glm::vec3{0.0f, 1.0f, 0.0f};
+                tangent = glm::normalize(axis - normal * glm::dot(normal, axis));
+            }
+
+            vertex.tangent = glm::vec4{tangent, handedness};
+            vertex.binormal = glm::cross(normal, tangent) * handedness;
+        }
+
+        /* Below this, the summed tangents have cancelled each other out and give no direction. */
+        static constexpr float MINIMUM_TANGENT_LENGTH{1e-6f};
+
+#ifdef ASR_GEOMETRY_SSE
+        /* The same as `_orthogonalize_tangent` for four vertices, given as columns. Vertices without a usable
+           tangent or normal are left to the scalar version. */
+        static void _orthogonalize_tangents(
+            Vertex *vertices, const float (&tangents)[3][4], const float (&normals)[3][4], const float (&handedness)[4]
+        )
+        {
+            const __m128 minimum = _mm_set1_ps(std::numeric_limits<float>::min());
+            __m128 tx = _mm_load_ps(tangents[0]), ty = _mm_load_ps(tangents[1]), tz = _mm_load_ps(tangents[2]);
+            __m128 nx = _mm_load_ps(normals[0]), ny = _mm_load_ps(normals[1]), nz = _mm_load_ps(normals[2]);
+
+            __m128 normal_length_squared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, nx), _mm_mul_ps(ny, ny)), _mm_mul_ps(nz, nz));
+            __m128 valid = _mm_cmpgt_ps(normal_length_squared, minimum);
+            __m128 inverse_normal_length = _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(_mm_max_ps(normal_length_squared, minimum)));
+            nx = _mm_mul_ps(nx, inverse_normal_length);
+            ny = _mm_mul_ps(ny, inverse_normal_length);
+            nz = _mm_mul_ps(nz, inverse_normal_length);
+
+            __m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, tx), _mm_mul_ps(ny, ty)), _mm_mul_ps(nz, tz));
+            tx = _mm_sub_ps(tx, _mm_mul_ps(nx, dot));
+            ty = _mm_sub_ps(ty, _mm_mul_ps(ny, dot));
+            tz = _mm_sub_ps(tz, _mm_mul_ps(nz, dot));
+
+            __m128 tangent_length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(tx, tx), _mm_mul_ps(ty, ty)), _mm_mul_ps(tz, tz)));
+            valid = _mm_and_ps(valid, _mm_cmpgt_ps(tangent_length, _mm_set1_ps(MINIMUM_TANGENT_LENGTH)));
+            __m128 inverse_tangent_length = _mm_div_ps(_mm_set1_ps(1.0f), _mm_max_ps(tangent_length, minimum));
+            tx = _mm_mul_ps(tx, inverse_tangent_length);
+            ty = _mm_mul_ps(ty, inverse_tangent_length);
+            tz = _mm_mul_ps(tz, inverse_tangent_length);
+
+            __m128 w = _mm_load_ps(handedness);
+            __m128 bx = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(ny, tz), _mm_mul_ps(nz, ty)), w);
+            __m128 by = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(nz, tx), _mm_mul_ps(nx, tz)), w);
+            __m128 bz = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(nx, ty), _mm_mul_ps(ny, tx)), w);
+
+            alignas(16) float results[6][4];
+            _mm_store_ps(results[0], tx);
+            _mm_store_ps(results[1], ty);
+            _mm_store_ps(results[2], tz);
+            _mm_store_ps(results[3], bx);
+            _mm_store_ps(results[4], by);
+            _mm_store_ps(results[5], bz);
+            int valid_mask = _mm_movemask_ps(valid);
+            for (int i = 0; i < 4; ++i) {
+                if (valid_mask & (1 << i)) {
+                    vertices[i].tangent = glm::vec4{results[0][i], results[1][i], results[2][i], handedness[i]};
+                    vertices[i].binormal = glm::vec3{results[3][i], results[4][i], results[5][i]};
+                } else {
+                    _orthogonalize_tangent(vertices[i], glm::vec3{tangents[0][i], tangents[1][i], tangents[2][i]}, handedness[i]);
+                }
+            }
+        }
+#endif
+
+        void _unmap()
+        {
+            if (!is_mapped()) {
+                return;
+            }
+
+            _indices.assign(_mapped_data.indices, _mapped_data.indices + _mapped_data.index_count);
+            _vertices.assign(_mapped_data.vertices, _mapped_data.vertices + _mapped_data.vertex_count);
+            _mapped_data = MappedData{};
+        }
     };
 }
 
@@ -2,22 +2,97 @@
 #define GEOMETRY_GENERATORS_H
 
 #include "geometries/vertex.h"
+#include "utilities/thread_pool.h"
 
 #include <utility>
 #include <vector>
 #include <cmath>
+#include <cstddef>
+#include <algorithm>
 
 #include <glm/glm.hpp>
 
+/* Every generator comes in two forms: one that returns new vectors, and one that writes into index and vertex
+   buffers of the caller, e.g. reused arrays or mapped GPU buffers, which must hold the counts returned by the
+   matching `get_*_geometry_data_size`. Grids are generated in parallel rows for high segment counts. */
 namespace asr::geometry_generators
 {
     typedef std::pair<std::vector<unsigned int>, std::vector<Vertex>> geometry_data_type;
 
-    static geometry_data_type generate_triangle_geometry_data(float size = 1.0f)
+    struct GeometryDataSize
     {
-        std::vector<unsigned int> indices;
-        std::vector<Vertex> vertices;
+        size_t index_count;
+        size_t vertex_count;
+    };
+
+    /* Vertices per task when grids are split across the thread pool. */
+    static const size_t GRID_CHUNK_VERTEX_COUNT{4096};
 
+    /* The triangles of a grid quad as corners a (i, j), b (i, j + 1), c (i + 1, j) and d (i + 1, j + 1). */
+    typedef unsigned int grid_winding_type[6];
+    static const grid_winding_type COUNTER_CLOCKWISE_GRID_WINDING{0, 1, 2, 1, 3, 2};
+    static const grid_winding_type CLOCKWISE_GRID_WINDING{0, 2, 1, 1, 2, 3};
+
+    static GeometryDataSize get_grid_geometry_data_size(unsigned int row_count, unsigned int column_count)
+    {
+        return GeometryDataSize{
+            static_cast<size_t>(row_count) * column_count * 6,
+            static_cast<size_t>(row_count + 1) * (column_count + 1)
+        };
+    }
+
+    /* Writes (row_count + 1) x (column_count + 1) vertices made by `generate_vertex(row, column)` and two triangles
+       per quad, with indices starting at `first_vertex`. */
+    template<typename VertexGenerator>
+    static void generate_grid_geometry_data(
+        unsigned int row_count, unsigned int column_count, const grid_winding_type &winding,
+        unsigned int first_vertex, unsigned int *indices, Vertex *vertices,
+        VertexGenerator &&generate_vertex, ThreadPool &thread_pool = ThreadPool::get_shared_instance()
+    )
+    {
+        const unsigned int row_size{column_count + 1};
+        size_t grain = std::max<size_t>(1, GRID_CHUNK_VERTEX_COUNT / row_size);
+        thread_pool.parallel_for(0, static_cast<size_t>(row_count) + 1, grain, [&](size_t begin, size_t end) {
+            for (size_t row = begin; row < end; ++row) {
+                auto i = static_cast<unsigned int>(row);
+                Vertex *row_vertices = vertices + row * row_size;
+                for (unsigned int j = 0; j <= column_count; ++j) {
+                    row_vertices[j] = generate_vertex(i, j);
+                }
+                if (i == row_count) {
+                    continue;
+                }
+
+                unsigned int *row_indices = indices + row * column_count * 6;
+                for (unsigned int j = 0; j < column_count; ++j) {
+                    unsigned int index_a{first_vertex + i * row_size + j};
+                    const unsigned int corners[4]{index_a, index_a + 1, index_a + row_size, index_a + row_size + 1};
+                    for (unsigned int k = 0; k < 6; ++k) {
+                        *row_indices++ = corners[winding[k]];
+                    }
+                }
+            }
+        });
+    }
+
+    /* Fills vectors of the exact size through one of the buffer versions below. */
+    template<typename Generator>
+    static geometry_data_type _generate_geometry_data(const GeometryDataSize &size, Generator &&generate)
+    {
+        std::vector<unsigned int> indices(size.index_count);
+        std::vector<Vertex> vertices(size.vertex_count);
+        generate(indices.data(), vertices.data());
+
+        return std::make_pair(std::move(indices), std::move(vertices));
+    }
+
+    static GeometryDataSize get_triangle_geometry_data_size()
+    {
+        return GeometryDataSize{3, 3};
+    }
+
+    static void generate_triangle_geometry_data(float size, unsigned int *indices, Vertex *vertices)
+    {
         const float radius = size * 0.5f;
         for (int i = 0; i < 3; ++i) {
             float angle{static_cast<float>(i) / 3.0f * 2.0f * static_cast<float>(M_PI) - static_cast<float>(M_PI) / 6.0f};
@@ -25,7 +100,7 @@ namespace asr::geometry_generators
             float y{sinf(angle) * radius};
             float u{x};
             float v{y};
-            vertices.push_back(Vertex{
+            vertices[i] = Vertex{
                 glm::vec3{x, y, 0.0f},
                 glm::vec4{1.0f},
                 glm::vec3{0.0f, 0.0f, 1.0f},
@@ -33,24 +108,32 @@ namespace asr::geometry_generators
                 glm::vec3{0.0f, 1.0f, 0.0f},
                 glm::vec4{u, v, 0.0f, 1.0f},
                 glm::vec4{u, v, 0.0f, 1.0f}
-            });
-            indices.push_back(static_cast<unsigned int>(i));
+            };
+            indices[i] = static_cast<unsigned int>(i);
         }
+    }
 
-        return std::make_pair(indices, vertices);
+    static geometry_data_type generate_triangle_geometry_data(float size = 1.0f)
+    {
+        return _generate_geometry_data(get_triangle_geometry_data_size(), [&](unsigned int *indices, Vertex *vertices) {
+            generate_triangle_geometry_data(size, indices, vertices);
+        });
     }
 
-    static geometry_data_type generate_circle_geometry_data(float radius, unsigned int segment_count)
+    static GeometryDataSize get_circle_geometry_data_size(unsigned int segment_count)
+    {
+        return GeometryDataSize{segment_count, segment_count};
+    }
+
+    static void generate_circle_geometry_data(float radius, unsigned int segment_count, unsigned int *indices, Vertex *vertices)
     {
-        std::vector<unsigned int> indices;
-        std::vector<Vertex> vertices;
         for (unsigned int i = 0; i < segment_count; ++i) {
             float angle{static_cast<float>(i) / static_cast<float>(segment_count) * 2.0f * static_cast<float>(M_PI)};
             float x{cosf(angle) * radius};
             float y{sinf(angle) * radius};
             float u{x};
             float v{y};
-            vertices.push_back(Vertex{
+            vertices[i] = Vertex{
                 glm::vec3{x, y, 0.0f},
                 glm::vec4{1.0f},
                 glm::vec3{0.0f, 0.0f, 1.0f},
@@ -58,17 +141,29 @@ namespace asr::geometry_generators
                 glm::vec3{0.0f, 1.0f, 0.0f},
                 glm::vec4{u, v, 0.0f, 1.0f},
                 glm::vec4{u, v, 0.0f, 1.0f}
-            });
-            indices.push_back(i);
+            };
+            indices[i] = i;
         }
+    }
 
-        return std::make_pair(indices, vertices);
+    static geometry_data_type generate_circle_geometry_data(float radius, unsigned int segment_count)
+    {
+        return _generate_geometry_data(get_circle_geometry_data_size(segment_count), [&](unsigned int *indices, Vertex *vertices) {
+            generate_circle_geometry_data(radius, segment_count, indices, vertices);
+        });
     }
 
-    static geometry_data_type generate_plane_geometry_data(float width, float height, unsigned int width_segments_count, unsigned int height_segments_count)
+    static GeometryDataSize get_plane_geometry_data_size(unsigned int width_segments_count, unsigned int height_segments_count)
+    {
+        return get_grid_geometry_data_size(height_segments_count, width_segments_count);
+    }
+
+    static void generate_plane_geometry_data(
+        float width, float height, unsigned int width_segments_count, unsigned int height_segments_count,
+        unsigned int *indices, Vertex *vertices, ThreadPool &thread_pool = ThreadPool::get_shared_instance()
+    )
     {
-        std::vector<unsigned int> indices;
-        std::vector<Vertex> vertices;
+        static const grid_winding_type PLANE_WINDING{2, 1, 0, 2, 3, 1};
 
         float half_height{height * 0.5f};
         float segment_height{height / static_cast<float>(height_segments_count)};
@@ -76,15 +171,14 @@ namespace asr::geometry_generators
         float half_width{width * 0.5f};
         float segment_width{width / static_cast<float>(width_segments_count)};
 
-        for (unsigned int i = 0; i <= height_segments_count; ++i) {
-            float y{static_cast<float>(i) * segment_height - half_height};
-            float v{1.0f - static_cast<float>(i) / static_cast<float>(height_segments_count)};
-
-            for (unsigned int j = 0; j <= width_segments_count; ++j) {
+        generate_grid_geometry_data(height_segments_count, width_segments_count, PLANE_WINDING, 0, indices, vertices,
+            [&](unsigned int i, unsigned int j) {
+                float y{static_cast<float>(i) * segment_height - half_height};
+                float v{1.0f - static_cast<float>(i) / static_cast<float>(height_segments_count)};
                 float x{static_cast<float>(j) * segment_width - half_width};
                 float u{static_cast<float>(j) / static_cast<float>(width_segments_count)};
 
-                vertices.push_back(Vertex{
+                return Vertex{
                     glm::vec3{x, y, 0.0f},
                     glm::vec4{1.0f},
                     glm::vec3{0.0f, 0.0f, 1.0f},
@@ -92,53 +186,44 @@ namespace asr::geometry_generators
                     glm::vec3{0.0f, 1.0f, 0.0f},
                     glm::vec4{u, v, 0.0f, 1.0f},
                     glm::vec4{u, v, 0.0f, 1.0f}
-                });
-            }
-        }
-
-        for (unsigned int i = 0; i < height_segments_count; ++i) {
-            for (unsigned int j = 0; j < width_segments_count; ++j) {
-                unsigned int index_a{i * (width_segments_count + 1) + j};
-                unsigned int index_b{index_a + 1};
-                unsigned int index_c{index_a + (width_segments_count + 1)};
-                unsigned int index_d{index_c + 1};
-
-                indices.push_back(index_c);
-                indices.push_back(index_b);
-                indices.push_back(index_a);
-
-                indices.push_back(index_c);
-                indices.push_back(index_d);
-                indices.push_back(index_b);
-            }
-        }
+                };
+            },
+            thread_pool
+        );
+    }
 
-        return std::make_pair(indices, vertices);
+    static geometry_data_type generate_plane_geometry_data(float width, float height, unsigned int width_segments_count, unsigned int height_segments_count)
+    {
+        GeometryDataSize size = get_plane_geometry_data_size(width_segments_count, height_segments_count);
+        return _generate_geometry_data(size, [&](unsigned int *indices, Vertex *vertices) {
+            generate_plane_geometry_data(width, height, width_segments_count, height_segments_count, indices, vertices);
+        });
     }
 
-    static geometry_data_type generate_rectangle_geometry_data(
-                                  float width,float height,
-                                  unsigned int width_segments_count,
-                                  unsigned int height_segments_count
-                              )
+    static GeometryDataSize get_rectangle_geometry_data_size(unsigned int width_segments_count, unsigned int height_segments_count)
     {
-        std::vector<asr::Vertex> vertices;
-        std::vector<unsigned int> indices;
+        return get_grid_geometry_data_size(height_segments_count, width_segments_count);
+    }
 
+    static void generate_rectangle_geometry_data(
+        float width, float height, unsigned int width_segments_count, unsigned int height_segments_count,
+        unsigned int *indices, Vertex *vertices, ThreadPool &thread_pool = ThreadPool::get_shared_instance()
+    )
+    {
         float half_height{height * 0.5f};
         float segment_height{height / static_cast<float>(height_segments_count)};
 
         float half_width{width * 0.5f};
         float segment_width{width / static_cast<float>(width_segments_count)};
 
-        for (unsigned int i = 0; i <= height_segments_count; ++i) {
-            float y{static_cast<float>(i) * segment_height - half_height};
-            float v{1.0f - static_cast<float>(i) / static_cast<float>(height_segments_count)};
-            for (unsigned int j = 0; j <= width_segments_count; ++j) {
+        generate_grid_geometry_data(height_segments_count, width_segments_count, COUNTER_CLOCKWISE_GRID_WINDING, 0, indices, vertices,
+            [&](unsigned int i, unsigned int j) {
+                float y{static_cast<float>(i) * segment_height - half_height};
+                float v{1.0f - static_cast<float>(i) / static_cast<float>(height_segments_count)};
                 float x{static_cast<float>(j) * segment_width - half_width};
                 float u{static_cast<float>(j) / static_cast<float>(width_segments_count)};
 
-                vertices.push_back(Vertex{
+                return Vertex{
                     glm::vec3{x, y, 0.0f},
                     glm::vec4{1.0f},
                     glm::vec3{0.0f, 0.0f, 1.0f},
@@ -146,40 +231,50 @@ namespace asr::geometry_generators
                     glm::vec3{0.0f, 1.0f, 0.0f},
                     glm::vec4{u, v, 0.0f, 1.0f},
                     glm::vec4{u, v, 0.0f, 1.0f}
-                });
-            }
-        }
-
-        for (unsigned int i = 0; i < height_segments_count; ++i) {
-            for (unsigned int j = 0; j < width_segments_count; ++j) {
-                unsigned int index_a{i * (width_segments_count + 1) + j};
-                unsigned int index_b{index_a + 1};
-                unsigned int index_c{index_a + (width_segments_count + 1)};
-                unsigned int index_d{index_c + 1};
-
-                indices.push_back(index_a);
-                indices.push_back(index_b);
-                indices.push_back(index_c);
-
-                indices.push_back(index_b);
-                indices.push_back(index_d);
-                indices.push_back(index_c);
-            }
-        }
-
-        return std::make_pair(indices, vertices);
+                };
+            },
+            thread_pool
+        );
     }
 
-    static geometry_data_type generate_box_geometry_data(
-                                  float width, float height, float depth,
+    static geometry_data_type generate_rectangle_geometry_data(
+                                  float width,float height,
                                   unsigned int width_segments_count,
-                                  unsigned int height_segments_count,
-                                  unsigned int depth_segments_count
+                                  unsigned int height_segments_count
                               )
     {
-        std::vector<asr::Vertex> vertices;
-        std::vector<unsigned int> indices;
+        GeometryDataSize size = get_rectangle_geometry_data_size(width_segments_count, height_segments_count);
+        return _generate_geometry_data(size, [&](unsigned int *indices, Vertex *vertices) {
+            generate_rectangle_geometry_data(width, height, width_segments_count, height_segments_count, indices, vertices);
+        });
+    }
+
+    static GeometryDataSize get_box_geometry_data_size(
+                                unsigned int width_segments_count,
+                                unsigned int height_segments_count,
+                                unsigned int depth_segments_count
+                            )
+    {
+        GeometryDataSize front = get_grid_geometry_data_size(height_segments_count, width_segments_count);
+        GeometryDataSize side = get_grid_geometry_data_size(height_segments_count, depth_segments_count);
+        GeometryDataSize top = get_grid_geometry_data_size(depth_segments_count, width_segments_count);
+
+        return GeometryDataSize{
+            (front.index_count + side.index_count + top.index_count) * 2,
+            (front.vertex_count + side.vertex_count + top.vertex_count) * 2
+        };
+    }
 
+    /* The faces follow each other in the order front, right, back, left, bottom and top. */
+    static void generate_box_geometry_data(
+                    float width, float height, float depth,
+                    unsigned int width_segments_count,
+                    unsigned int height_segments_count,
+                    unsigned int depth_segments_count,
+                    unsigned int *indices, Vertex *vertices,
+                    ThreadPool &thread_pool = ThreadPool::get_shared_instance()
+                )
+    {
         float half_height{height * 0.5f};
         float segment_height{height / static_cast<float>(height_segments_count)};
 
@@ -189,209 +284,155 @@ namespace asr::geometry_generators
         float half_depth{depth * 0.5f};
         float segment_depth{depth / static_cast<float>(depth_segments_count)};
 
-        unsigned int offset;
+        unsigned int offset{0};
+        auto add_face = [&](unsigned int row_count, unsigned int column_count, const grid_winding_type &winding, auto &&generate_vertex) {
+            generate_grid_geometry_data(row_count, column_count, winding, offset, indices, vertices, generate_vertex, thread_pool);
+
+            GeometryDataSize size = get_grid_geometry_data_size(row_count, column_count);
+            indices += size.index_count;
+            vertices += size.vertex_count;
+            offset += static_cast<unsigned int>(size.vertex_count);
+        };
 
         // Front Face of the Box
 
-        for (unsigned int i = 0; i <= height_segments_count; ++i) {
+        add_face(height_segments_count, width_segments_count, COUNTER_CLOCKWISE_GRID_WINDING, [&](unsigned int i, unsigned int j) {
             float y{static_cast<float>(i) * segment_height - half_height};
             float v{1.0f/3.0f + (1.0f - static_cast<float>(i) / static_cast<float>(height_segments_count)) / 3.0f};
-            for (unsigned int j = 0; j <= width_segments_count; ++j) {
-                float x{static_cast<float>(j) * segment_width - half_width};
-                float u{0.25f + static_cast<float>(j) / static_cast<float>(width_segments_count) * 0.25f};
-                vertices.push_back(Vertex{
-                    glm::vec3{x, y, half_depth},
-                    glm::vec4{1.0f},
-                    glm::vec3{0.0f, 0.0f, 1.0f},
-                    glm::vec4{1.0f, 0.0f, 0.0f, 1.0f},
-                    glm::vec3{0.0f, 1.0f, 0.0f},
-                    glm::vec4{u, v, 0.0f, 1.0f},
-                    glm::vec4{u, v, 0.0f, 1.0f}
-                });
-            }
-        }
-
-        for (unsigned int i = 0; i < height_segments_count; ++i) {
-            for (unsigned int j = 0; j < width_segments_count; ++j) {
-                unsigned int index_a{i * (width_segments_count + 1) + j};   unsigned int index_b{index_a + 1};
-                unsigned int index_c{index_a + (width_segments_count + 1)}; unsigned int index_d{index_c + 1};
-
-                indices.push_back(index_a); indices.push_back(index_b); indices.push_back(index_c);
-                indices.push_back(index_b); indices.push_back(index_d); indices.push_back(index_c);
-            }
-        }
-
-        offset = vertices.size();
+            float x{static_cast<float>(j) * segment_width - half_width};
+            float u{0.25f + static_cast<float>(j) / static_cast<float>(width_segments_count) * 0.25f};
+            return Vertex{
+                glm::vec3{x, y, half_depth},
+                glm::vec4{1.0f},
+                glm::vec3{0.0f, 0.0f, 1.0f},
+                glm::vec4{1.0f, 0.0f, 0.0f, 1.0f},
+                glm::vec3{0.0f, 1.0f, 0.0f},
+                glm::vec4{u, v, 0.0f, 1.0f},
+                glm::vec4{u, v, 0.0f, 1.0f}
+            };
+        });
 
         // Right Face of the Box
 
-        for (unsigned int i = 0; i <= height_segments_count; ++i) {
+        add_face(height_segments_count, depth_segments_count, CLOCKWISE_GRID_WINDING, [&](unsigned int i, unsigned int j) {
             float y{static_cast<float>(i) * segment_height - half_height};
             float v{1.0f/3.0f + (1.0f - static_cast<float>(i) / static_cast<float>(height_segments_count)) / 3.0f};
-            for (unsigned int j = 0; j <= depth_segments_count; ++j) {
-                float z{static_cast<float>(j) * segment_depth - half_depth};
-                float u{0.5f + (1.0f - static_cast<float>(j) / static_cast<float>(depth_segments_count)) * 0.25f};
-                vertices.push_back(Vertex{
-                    glm::vec3{half_width, y, z},
-                    glm::vec4{1.0f},
-                    glm::vec3{1.0f, 0.0f, 0.0f},
-                    glm::vec4{0.0f, 0.0f, -1.0f, 1.0f},
-                    glm::vec3{0.0f, 1.0f, 0.0f},
-                    glm::vec4{u, v, 0.0f, 1.0f},
-                    glm::vec4{u, v, 0.0f, 1.0f}
-                });
-            }
-        }
-
-        for (unsigned int i = 0; i < height_segments_count; ++i) {
-            for (unsigned int j = 0; j < depth_segments_count; ++j) {
-                unsigned int index_a{i * (depth_segments_count + 1) + j};   unsigned int index_b{index_a + 1};
-                unsigned int index_c{index_a + (depth_segments_count + 1)}; unsigned int index_d{index_c + 1};
-
-                indices.push_back(index_a + offset); indices.push_back(index_c + offset); indices.push_back(index_b + offset);
-                indices.push_back(index_b + offset); indices.push_back(index_c + offset); indices.push_back(index_d + offset);
-            }
-        }
-
-        offset = vertices.size();
+            float z{static_cast<float>(j) * segment_depth - half_depth};
+            float u{0.5f + (1.0f - static_cast<float>(j) / static_cast<float>(depth_segments_count)) * 0.25f};
+            return Vertex{
+                glm::vec3{half_width, y, z},
+                glm::vec4{1.0f},
+                glm::vec3{1.0f, 0.0f, 0.0f},
+                glm::vec4{0.0f, 0.0f, -1.0f, 1.0f},
+                glm::vec3{0.0f, 1.0f, 0.0f},
+                glm::vec4{u, v, 0.0f, 1.0f},
+                glm::vec4{u, v, 0.0f, 1.0f}
+            };
+        });
 
         // Back Face of the Box
 
-        for (unsigned int i = 0; i <= height_segments_count; ++i) {
+        add_face(height_segments_count, width_segments_count, CLOCKWISE_GRID_WINDING, [&](unsigned int i, unsigned int j) {
             float y{static_cast<float>(i) * segment_height - half_height};
             float v{1.0f/3.0f + (1.0f - static_cast<float>(i) / static_cast<float>(height_segments_count)) / 3.0f};
-            for (unsigned int j = 0; j <= width_segments_count; ++j) {
-                float x{static_cast<float>(j) * segment_width - half_width};
-                float u{0.75f + (1.0f - static_cast<float>(j) / static_cast<float>(width_segments_count)) * 0.25f};
-                vertices.push_back(Vertex{
-                    glm::vec3{x, y, -half_depth},
-                    glm::vec4{1.0f},
-                    glm::vec3{0.0f, 0.0f, -1.0f},
-                    glm::vec4{-1.0f, 0.0f, 0.0f, 1.0f},
-                    glm::vec3{0.0f, 1.0f, 0.0f},
-                    glm::vec4{u, v, 0.0f, 1.0f},
-                    glm::vec4{u, v, 0.0f, 1.0f}
-                });
-            }
-        }
-
-        for (unsigned int i = 0; i < height_segments_count; ++i) {
-            for (unsigned int j = 0; j < width_segments_count; ++j) {
-                unsigned int index_a{i * (width_segments_count + 1) + j};   unsigned int index_b{index_a + 1};
-                unsigned int index_c{index_a + (width_segments_count + 1)}; unsigned int index_d{index_c + 1};
-
-                indices.push_back(index_a + offset); indices.push_back(index_c + offset); indices.push_back(index_b + offset);
-                indices.push_back(index_b + offset); indices.push_back(index_c + offset); indices.push_back(index_d + offset);
-            }
-        }
-
-        offset = vertices.size();
+            float x{static_cast<float>(j) * segment_width - half_width};
+            float u{0.75f + (1.0f - static_cast<float>(j) / static_cast<float>(width_segments_count)) * 0.25f};
+            return Vertex{
+                glm::vec3{x, y, -half_depth},
+                glm::vec4{1.0f},
+                glm::vec3{0.0f, 0.0f, -1.0f},
+                glm::vec4{-1.0f, 0.0f, 0.0f, 1.0f},
+                glm::vec3{0.0f, 1.0f, 0.0f},
+                glm::vec4{u, v, 0.0f, 1.0f},
+                glm::vec4{u, v, 0.0f, 1.0f}
+            };
+        });
 
         // Left Face of the Box
 
-        for (unsigned int i = 0; i <= height_segments_count; ++i) {
+        add_face(height_segments_count, depth_segments_count, COUNTER_CLOCKWISE_GRID_WINDING, [&](unsigned int i, unsigned int j) {
             float y{static_cast<float>(i) * segment_height - half_height};
             float v{1.0f/3.0f + (1.0f - static_cast<float>(i) / static_cast<float>(height_segments_count)) / 3.0f};
-            for (unsigned int j = 0; j <= depth_segments_count; ++j) {
-                float z{static_cast<float>(j) * segment_depth - half_depth};
-                float u{static_cast<float>(j) / static_cast<float>(depth_segments_count) * 0.25f};
-                vertices.push_back(Vertex{
-                    glm::vec3{-half_width, y, z},
-                    glm::vec4{1.0f},
-                    glm::vec3{-1.0f, 0.0f, 0.0f},
-                    glm::vec4{0.0f, 0.0f, 1.0f, 1.0f},
-                    glm::vec3{0.0f, 1.0f, 0.0f},
-                    glm::vec4{u, v, 0.0f, 1.0f},
-                    glm::vec4{u, v, 0.0f, 1.0f}
-                });
-            }
-        }
-
-        for (unsigned int i = 0; i < height_segments_count; ++i) {
-            for (unsigned int j = 0; j < depth_segments_count; ++j) {
-                unsigned int index_a{i * (depth_segments_count + 1) + j};   unsigned int index_b{index_a + 1};
-                unsigned int index_c{index_a + (depth_segments_count + 1)}; unsigned int index_d{index_c + 1};
-
-                indices.push_back(index_a + offset); indices.push_back(index_b + offset); indices.push_back(index_c + offset);
-                indices.push_back(index_b + offset); indices.push_back(index_d + offset); indices.push_back(index_c + offset);
-            }
-        }
-
-        offset = vertices.size();
+            float z{static_cast<float>(j) * segment_depth - half_depth};
+            float u{static_cast<float>(j) / static_cast<float>(depth_segments_count) * 0.25f};
+            return Vertex{
+                glm::vec3{-half_width, y, z},
+                glm::vec4{1.0f},
+                glm::vec3{-1.0f, 0.0f, 0.0f},
+                glm::vec4{0.0f, 0.0f, 1.0f, 1.0f},
+                glm::vec3{0.0f, 1.0f, 0.0f},
+                glm::vec4{u, v, 0.0f, 1.0f},
+                glm::vec4{u, v, 0.0f, 1.0f}
+            };
+        });
 
         // Bottom Face of the Box
 
-        for (unsigned int i = 0; i <= depth_segments_count; ++i) {
+        add_face(depth_segments_count, width_segments_count, COUNTER_CLOCKWISE_GRID_WINDING, [&](unsigned int i, unsigned int j) {
             float z{static_cast<float>(i) * segment_depth - half_depth};
             float v{2.0f/3.0f + (1.0f - static_cast<float>(i) / static_cast<float>(depth_segments_count)) / 3.0f};
-            for (unsigned int j = 0; j <= width_segments_count; ++j) {
-                float x{static_cast<float>(j) * segment_width - half_width};
-                float u{0.25f + static_cast<float>(j) / static_cast<float>(width_segments_count) * 0.25f};
-                vertices.push_back(Vertex{
-                    glm::vec3{x, -half_height, z},
-                    glm::vec4{1.0f},
-                    glm::vec3{0.0f, -1.0f, 0.0f},
-                    glm::vec4{1.0f, 0.0f, 0.0f, 1.0f},
-                    glm::vec3{0.0f, 0.0f, 1.0f},
-                    glm::vec4{u, v, 0.0f, 1.0f},
-                    glm::vec4{u, v, 0.0f, 1.0f}
-                });
-            }
-        }
-
-        for (unsigned int i = 0; i < depth_segments_count; ++i) {
-            for (unsigned int j = 0; j < width_segments_count; ++j) {
-                unsigned int index_a{i * (width_segments_count + 1) + j};   unsigned int index_b{index_a + 1};
-                unsigned int index_c{index_a + (width_segments_count + 1)}; unsigned int index_d{index_c + 1};
-
-                indices.push_back(index_a + offset); indices.push_back(index_b + offset); indices.push_back(index_c + offset);
-                indices.push_back(index_b + offset); indices.push_back(index_d + offset); indices.push_back(index_c + offset);
-            }
-        }
-
-        offset = vertices.size();
+            float x{static_cast<float>(j) * segment_width - half_width};
+            float u{0.25f + static_cast<float>(j) / static_cast<float>(width_segments_count) * 0.25f};
+            return Vertex{
+                glm::vec3{x, -half_height, z},
+                glm::vec4{1.0f},
+                glm::vec3{0.0f, -1.0f, 0.0f},
+                glm::vec4{1.0f, 0.0f, 0.0f, 1.0f},
+                glm::vec3{0.0f, 0.0f, 1.0f},
+                glm::vec4{u, v, 0.0f, 1.0f},
+                glm::vec4{u, v, 0.0f, 1.0f}
+            };
+        });
 
         // Top Face of the Box
 
-        for (unsigned int i = 0; i <= depth_segments_count; ++i) {
+        add_face(depth_segments_count, width_segments_count, CLOCKWISE_GRID_WINDING, [&](unsigned int i, unsigned int j) {
             float z{static_cast<float>(i) * segment_depth - half_depth};
             float v{static_cast<float>(i) / static_cast<float>(depth_segments_count) / 3.0f};
-            for (unsigned int j = 0; j <= width_segments_count; ++j) {
-                float x{static_cast<float>(j) * segment_width - half_width};
-                float u{0.25f + static_cast<float>(j) / static_cast<float>(width_segments_count) * 0.25f};
-                vertices.push_back(Vertex{
-                    glm::vec3{x, half_height, z},
-                    glm::vec4{1.0f},
-                    glm::vec3{0.0f, 1.0f, 0.0f},
-                    glm::vec4{1.0f, 0.0f, 0.0f, 1.0f},
-                    glm::vec3{0.0f, 0.0f, -1.0f},
-                    glm::vec4{u, v, 0.0f, 1.0f},
-                    glm::vec4{u, v, 0.0f, 1.0f}
-                });
-            }
-        }
-
-        for (unsigned int i = 0; i < height_segments_count; ++i) {
-            for (unsigned int j = 0; j < width_segments_count; ++j) {
-                unsigned int index_a{i * (width_segments_count + 1) + j};   unsigned int index_b{index_a + 1};
-                unsigned int index_c{index_a + (width_segments_count + 1)}; unsigned int index_d{index_c + 1};
+            float x{static_cast<float>(j) * segment_width - half_width};
+            float u{0.25f + static_cast<float>(j) / static_cast<float>(width_segments_count) * 0.25f};
+            return Vertex{
+                glm::vec3{x, half_height, z},
+                glm::vec4{1.0f},
+                glm::vec3{0.0f, 1.0f, 0.0f},
+                glm::vec4{1.0f, 0.0f, 0.0f, 1.0f},
+                glm::vec3{0.0f, 0.0f, -1.0f},
+                glm::vec4{u, v, 0.0f, 1.0f},
+                glm::vec4{u, v, 0.0f, 1.0f}
+            };
+        });
+    }
 
-                indices.push_back(index_a + offset); indices.push_back(index_c + offset); indices.push_back(index_b + offset);
-                indices.push_back(index_b + offset); indices.push_back(index_c + offset); indices.push_back(index_d + offset);
-            }
-        }
+    static geometry_data_type generate_box_geometry_data(
+                                  float width, float height, float depth,
+                                  unsigned int width_segments_count,
+                                  unsigned int height_segments_count,
+                                  unsigned int depth_segments_count
+                              )
+    {
+        GeometryDataSize size = get_box_geometry_data_size(width_segments_count, height_segments_count, depth_segments_count);
+        return _generate_geometry_data(size, [&](unsigned int *indices, Vertex *vertices) {
+            generate_box_geometry_data(
+                width, height, depth, width_segments_count, height_segments_count, depth_segments_count, indices, vertices
+            );
+        });
+    }
 
-        return std::make_pair(indices, vertices);
+    static GeometryDataSize get_sphere_geometry_data_size(unsigned int segment_count, unsigned int ring_count)
+    {
+        return get_grid_geometry_data_size(ring_count, segment_count);
     }
 
-    static geometry_data_type generate_sphere_geometry_data(float radius, unsigned int segment_count, unsigned int ring_count)
+    static void generate_sphere_geometry_data(
+        float radius, unsigned int segment_count, unsigned int ring_count,
+        unsigned int *indices, Vertex *vertices, ThreadPool &thread_pool = ThreadPool::get_shared_instance()
+    )
     {
-        std::vector<unsigned int> indices;
-        std::vector<Vertex> vertices;
+        static const grid_winding_type SPHERE_WINDING{0, 2, 1, 2, 3, 1};
 
-        for (unsigned int ring = 0; ring <= ring_count; ++ring) {
-            float v{static_cast<float>(ring) / static_cast<float>(ring_count)};
-            for (unsigned int segment = 0; segment <= segment_count; ++segment) {
+        generate_grid_geometry_data(ring_count, segment_count, SPHERE_WINDING, 0, indices, vertices,
+            [&](unsigned int ring, unsigned int segment) {
+                float v{static_cast<float>(ring) / static_cast<float>(ring_count)};
                 float u{static_cast<float>(segment) / static_cast<float>(segment_count)};
 
                 float theta{u * static_cast<float>(M_PI) * 2.0f};
@@ -406,7 +447,7 @@ namespace asr::geometry_generators
                 float y{cos_phi};
                 float z{sin_theta * sin_phi};
 
-                vertices.push_back(Vertex{
+                return Vertex{
                     glm::vec3{x * radius, y * radius, z * radius},
                     glm::vec4{1.0f},
                     glm::vec3{x, y, z},
@@ -414,28 +455,18 @@ namespace asr::geometry_generators
                     glm::vec3{0.0f, 0.0f, 0.0f},
                     glm::vec4{u, 1.0f - v, 0.0f, 1.0f},
                     glm::vec4{u, 1.0f - v, 0.0f, 1.0f}
-                });
-            }
-        }
-
-        for (unsigned int ring = 0; ring < ring_count; ++ring) {
-            for (unsigned int segment = 0; segment < segment_count; ++segment) {
-                unsigned int index_a{ring * (segment_count + 1) + segment};
-                unsigned int index_b{index_a + (segment_count + 1)};
-                unsigned int index_c{index_a + 1};
-                unsigned int index_d{index_b + 1};
-
-                indices.push_back(index_a);
-                indices.push_back(index_b);
-                indices.push_back(index_c);
-
-                indices.push_back(index_b);
-                indices.push_back(index_d);
-                indices.push_back(index_c);
-            }
-        }
+                };
+            },
+            thread_pool
+        );
+    }
 
-        return std::make_pair(indices, vertices);
+    static geometry_data_type generate_sphere_geometry_data(float radius, unsigned int segment_count, unsigned int ring_count)
+    {
+        GeometryDataSize size = get_sphere_geometry_data_size(segment_count, ring_count);
+        return _generate_geometry_data(size, [&](unsigned int *indices, Vertex *vertices) {
+            generate_sphere_geometry_data(radius, segment_count, ring_count, indices, vertices);
+        });
     }
 }
 
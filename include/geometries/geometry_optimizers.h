@@ -0,0 +1,324 @@
+#ifndef GEOMETRY_OPTIMIZERS_H
+#define GEOMETRY_OPTIMIZERS_H
+
+#include "geometries/geometry.h"
+#include "geometries/vertex.h"
+
+#include <glm/glm.hpp>
+
+#include <utility>
+#include <vector>
+#include <limits>
+#include <numeric>
+#include <algorithm>
+
+namespace asr::geometry_optimizers
+{
+    typedef std::pair<std::vector<unsigned int>, std::vector<Vertex>> geometry_data_type;
+
+    /* A typical size of the post-transform vertex cache. */
+    static const unsigned int DEFAULT_CACHE_SIZE{16};
+
+    /* How much worse than the cache-optimized order a cluster may get to be split for overdraw. */
+    static const float DEFAULT_OVERDRAW_THRESHOLD{1.05f};
+
+    struct OptimizationReport
+    {
+        float acmr_before;
+        float acmr_after;
+    };
+
+    /* The average cache miss ratio, the vertices transformed per triangle with a FIFO cache of `cache_size`
+       entries. It lies between about 0.5 for ideal orders of large meshes and 3. */
+    static float calculate_acmr(const std::vector<unsigned int> &indices, size_t vertex_count, unsigned int cache_size = DEFAULT_CACHE_SIZE)
+    {
+        if (indices.size() < 3) {
+            return 0.0f;
+        }
+
+        std::vector<size_t> cache_timestamps(vertex_count, 0);
+        size_t timestamp{cache_size + 1};
+        size_t misses{0};
+        for (unsigned int index : indices) {
+            if (timestamp - cache_timestamps[index] > cache_size) {
+                cache_timestamps[index] = timestamp++;
+                ++misses;
+            }
+        }
+
+        return static_cast<float>(misses) / static_cast<float>(indices.size() / 3);
+    }
+
+    /* Reorders triangles for the post-transform vertex cache with Tipsify (Sander et al., "Fast Triangle
+       Reordering for Vertex Locality and Reduced Overdraw"). The offsets where the walk had to start over
+       far away from the previous triangles are written to `cluster_offsets` if it is given. */
+    static std::vector<unsigned int> optimize_vertex_cache(
+        const std::vector<unsigned int> &indices, size_t vertex_count, unsigned int cache_size = DEFAULT_CACHE_SIZE,
+        std::vector<size_t> *cluster_offsets = nullptr
+    ) {
+        size_t triangle_count = indices.size() / 3;
+        std::vector<unsigned int> result;
+        result.reserve(triangle_count * 3);
+        if (cluster_offsets) {
+            cluster_offsets->clear();
+        }
+
+        std::vector<unsigned int> adjacency_offsets(vertex_count + 1, 0);
+        for (size_t i = 0; i < triangle_count * 3; ++i) {
+            ++adjacency_offsets[indices[i] + 1];
+        }
+        for (size_t i = 1; i <= vertex_count; ++i) {
+            adjacency_offsets[i] += adjacency_offsets[i - 1];
+        }
+        std::vector<unsigned int> adjacency(triangle_count * 3);
+        std::vector<unsigned int> live_triangle_counts(vertex_count, 0);
+        for (size_t i = 0; i < triangle_count * 3; ++i) {
+            unsigned int index = indices[i];
+            adjacency[adjacency_offsets[index] + live_triangle_counts[index]++] = static_cast<unsigned int>(i / 3);
+        }
+
+        std::vector<size_t> cache_timestamps(vertex_count, 0);
+        std::vector<bool> emitted(triangle_count, false);
+        std::vector<unsigned int> dead_ends;
+        std::vector<unsigned int> candidates;
+        size_t timestamp{cache_size + 1};
+        size_t cursor{0};
+
+        auto next_vertex = [&]() -> long long {
+            long long best_vertex{-1};
+            size_t best_priority{0};
+            for (unsigned int candidate : candidates) {
+                if (live_triangle_counts[candidate] == 0) {
+                    continue;
+                }
+                /* Vertices whose remaining triangles would still find them in the cache are preferred,
+                   the oldest first. */
+                size_t priority{0};
+                if (timestamp - cache_timestamps[candidate] + 2 * live_triangle_counts[candidate] <= cache_size) {
+                    priority = timestamp - cache_timestamps[candidate];
+                }
+                if (best_vertex == -1 || priority > best_priority) {
+                    best_vertex = candidate;
+                    best_priority = priority;
+                }
+            }
+            if (best_vertex != -1) {
+                return best_vertex;
+            }
+
+            while (!dead_ends.empty()) {
+                unsigned int dead_end = dead_ends.back();
+                dead_ends.pop_back();
+                if (live_triangle_counts[dead_end] > 0) {
+                    return dead_end;
+                }
+            }
+
+            while (cursor < vertex_count) {
+                if (live_triangle_counts[cursor] > 0) {
+                    if (cluster_offsets) {
+                        cluster_offsets->push_back(result.size() / 3);
+                    }
+                    return static_cast<long long>(cursor);
+                }
+                ++cursor;
+            }
+
+            return -1;
+        };
+
+        for (long long fanning_vertex = next_vertex(); fanning_vertex != -1; fanning_vertex = next_vertex()) {
+            candidates.clear();
+            for (unsigned int k = adjacency_offsets[fanning_vertex]; k < adjacency_offsets[fanning_vertex + 1]; ++k) {
+                unsigned int triangle = adjacency[k];
+                if (emitted[triangle]) {
+                    continue;
+                }
+                emitted[triangle] = true;
+
+                for (size_t j = 0; j < 3; ++j) {
+                    unsigned int index = indices[triangle * 3 + j];
+                    result.push_back(index);
+                    dead_ends.push_back(index);
+                    candidates.push_back(index);
+                    --live_triangle_counts[index];
+                    if (timestamp - cache_timestamps[index] > cache_size) {
+                        cache_timestamps[index] = timestamp++;
+                    }
+                }
+            }
+        }
+
+        return result;
+    }
+
+    /* Reorders the clusters of a cache-optimized order so that the ones facing outwards the most are drawn first
+       and are likely to occlude the others. Clusters are split further where the cache efficiency stays within
+       `threshold` of the whole cluster's. `cluster_offsets` are the triangle offsets `optimize_vertex_cache`
+       reports, an empty list treats the whole order as a single cluster. */
+    static std::vector<unsigned int> optimize_overdraw(
+        const std::vector<unsigned int> &indices, const std::vector<Vertex> &vertices,
+        const std::vector<size_t> &cluster_offsets, unsigned int cache_size = DEFAULT_CACHE_SIZE,
+        float threshold = DEFAULT_OVERDRAW_THRESHOLD
+    ) {
+        size_t triangle_count = indices.size() / 3;
+        if (triangle_count == 0) {
+            return {};
+        }
+
+        std::vector<size_t> hard_offsets{cluster_offsets};
+        if (hard_offsets.empty() || hard_offsets.front() != 0) {
+            hard_offsets.insert(std::begin(hard_offsets), 0);
+        }
+        hard_offsets.push_back(triangle_count);
+
+        std::vector<size_t> offsets;
+        std::vector<size_t> cache_timestamps(vertices.size(), 0);
+        size_t timestamp{cache_size + 1};
+        auto count_misses = [&](size_t triangle) {
+            size_t misses{0};
+            for (size_t j = 0; j < 3; ++j) {
+                unsigned int index = indices[triangle * 3 + j];
+                if (timestamp - cache_timestamps[index] > cache_size) {
+                    cache_timestamps[index] = timestamp++;
+                    ++misses;
+                }
+            }
+            return misses;
+        };
+        for (size_t i = 0; i + 1 < hard_offsets.size(); ++i) {
+            size_t begin = hard_offsets[i], end = hard_offsets[i + 1];
+            if (begin >= end) {
+                continue;
+            }
+
+            timestamp += cache_size + 1;
+            size_t cluster_misses{0};
+            for (size_t triangle = begin; triangle < end; ++triangle) {
+                cluster_misses += count_misses(triangle);
+            }
+            float cluster_acmr = static_cast<float>(cluster_misses) / static_cast<float>(end - begin);
+
+            offsets.push_back(begin);
+            timestamp += cache_size + 1;
+            size_t misses{0}, start{begin};
+            for (size_t triangle = begin; triangle < end; ++triangle) {
+                misses += count_misses(triangle);
+                float acmr = static_cast<float>(misses) / static_cast<float>(triangle - start + 1);
+                if (triangle + 1 < end && acmr <= cluster_acmr * threshold) {
+                    offsets.push_back(triangle + 1);
+                    timestamp += cache_size + 1;
+                    misses = 0;
+                    start = triangle + 1;
+                }
+            }
+        }
+        offsets.push_back(triangle_count);
+
+        glm::vec3 mesh_centroid{0.0f};
+        for (unsigned int index : indices) {
+            mesh_centroid += vertices[index].position;
+        }
+        mesh_centroid /= static_cast<float>(triangle_count * 3);
+
+        size_t cluster_count = offsets.size() - 1;
+        std::vector<float> sort_keys(cluster_count);
+        for (size_t i = 0; i < cluster_count; ++i) {
+            glm::vec3 centroid{0.0f}, normal{0.0f};
+            float area{0.0f};
+            for (size_t triangle = offsets[i]; triangle < offsets[i + 1]; ++triangle) {
+                const glm::vec3 &a = vertices[indices[triangle * 3]].position;
+                const glm::vec3 &b = vertices[indices[triangle * 3 + 1]].position;
+                const glm::vec3 &c = vertices[indices[triangle * 3 + 2]].position;
+                glm::vec3 triangle_normal = glm::cross(b - a, c - a);
+                float triangle_area = glm::length(triangle_normal);
+                centroid += (a + b + c) * (triangle_area / 3.0f);
+                normal += triangle_normal;
+                area += triangle_area;
+            }
+            float normal_length = glm::length(normal);
+            sort_keys[i] = area > 0.0f && normal_length > 0.0f ?
+                glm::dot(centroid / area - mesh_centroid, normal / normal_length) : 0.0f;
+        }
+
+        std::vector<size_t> cluster_order(cluster_count);
+        std::iota(std::begin(cluster_order), std::end(cluster_order), 0);
+        std::stable_sort(std::begin(cluster_order), std::end(cluster_order), [&](size_t a, size_t b) {
+            return sort_keys[a] > sort_keys[b];
+        });
+
+        std::vector<unsigned int> result;
+        result.reserve(triangle_count * 3);
+        for (size_t cluster : cluster_order) {
+            result.insert(std::end(result), std::begin(indices) + offsets[cluster] * 3, std::begin(indices) + offsets[cluster + 1] * 3);
+        }
+
+        return result;
+    }
+
+    /* Reorders vertices in the order the indices first use them, so that vertex fetches read memory
+       sequentially, and remaps the indices. Unused vertices are moved to the end. */
+    static void optimize_vertex_fetch(std::vector<unsigned int> &indices, std::vector<Vertex> &vertices)
+    {
+        std::vector<unsigned int> vertex_remap(vertices.size(), std::numeric_limits<unsigned int>::max());
+        std::vector<Vertex> result;
+        result.reserve(vertices.size());
+        for (auto &index : indices) {
+            if (vertex_remap[index] == std::numeric_limits<unsigned int>::max()) {
+                vertex_remap[index] = static_cast<unsigned int>(result.size());
+                result.push_back(vertices[index]);
+            }
+            index = vertex_remap[index];
+        }
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            if (vertex_remap[i] == std::numeric_limits<unsigned int>::max()) {
+                result.push_back(vertices[i]);
+            }
+        }
+        vertices = std::move(result);
+    }
+
+    /* Runs all passes on a triangle list. */
+    static OptimizationReport optimize_geometry_data(
+        geometry_data_type &geometry_data, unsigned int cache_size = DEFAULT_CACHE_SIZE,
+        float overdraw_threshold = DEFAULT_OVERDRAW_THRESHOLD
+    ) {
+        auto &[indices, vertices] = geometry_data;
+        indices.resize(indices.size() - indices.size() % 3);
+
+        OptimizationReport report{};
+        report.acmr_before = calculate_acmr(indices, vertices.size(), cache_size);
+
+        std::vector<size_t> cluster_offsets;
+        indices = optimize_vertex_cache(indices, vertices.size(), cache_size, &cluster_offsets);
+        indices = optimize_overdraw(indices, vertices, cluster_offsets, cache_size, overdraw_threshold);
+        optimize_vertex_fetch(indices, vertices);
+
+        report.acmr_after = calculate_acmr(indices, vertices.size(), cache_size);
+
+        return report;
+    }
+
+    /* Geometries that are not triangle lists are left unchanged. */
+    static OptimizationReport optimize_geometry(
+        Geometry &geometry, unsigned int cache_size = DEFAULT_CACHE_SIZE,
+        float overdraw_threshold = DEFAULT_OVERDRAW_THRESHOLD
+    ) {
+        geometry_data_type geometry_data{
+            std::vector<unsigned int>(geometry.get_index_data(), geometry.get_index_data() + geometry.get_index_count()),
+            std::vector<Vertex>(geometry.get_vertex_data(), geometry.get_vertex_data() + geometry.get_vertex_count())
+        };
+        if (geometry.get_type() != Geometry::Type::Triangles) {
+            float acmr = calculate_acmr(geometry_data.first, geometry_data.second.size(), cache_size);
+            return OptimizationReport{acmr, acmr};
+        }
+
+        OptimizationReport report = optimize_geometry_data(geometry_data, cache_size, overdraw_threshold);
+        geometry.set_indices(geometry_data.first);
+        geometry.set_vertices(geometry_data.second);
+
+        return report;
+    }
+}
+
+#endif
@@ -0,0 +1,565 @@
+#ifndef GEOMETRY_SIMPLIFIER_H
+#define GEOMETRY_SIMPLIFIER_H
+
+#include "geometries/geometry.h"
+#include "geometries/vertex.h"
+#include "utilities/thread_pool.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <vector>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace asr
+{
+    /* Reduces triangle lists by edge collapses ordered by their quadric error (Garland and Heckbert). A vertex is
+       always collapsed onto one of its neighbours, so the remaining vertices keep their original UVs, normals and
+       tangents. Vertices sharing a position, e.g. along UV seams, are collapsed together and only along the seam,
+       and open borders only along themselves. Collapses that would flip a triangle or break the link condition,
+       and so pinch the surface or leave duplicate triangles on thin features, are skipped. */
+    class GeometrySimplifier
+    {
+    public:
+        typedef std::pair<std::vector<unsigned int>, std::vector<Vertex>> geometry_data_type;
+
+        explicit GeometrySimplifier(ThreadPool &thread_pool = ThreadPool::get_shared_instance())
+            : _thread_pool{thread_pool}
+        {}
+
+        GeometrySimplifier(const GeometrySimplifier &other) = delete;
+        GeometrySimplifier& operator=(const GeometrySimplifier &other) = delete;
+
+        /* How much more than a surface deviation it costs to move an open border, which keeps outlines in shape. */
+        [[nodiscard]] float get_border_weight() const
+        {
+            return _border_weight;
+        }
+
+        void set_border_weight(float border_weight)
+        {
+            _border_weight = border_weight;
+        }
+
+        /* Stops at `target_triangle_count` or before the first collapse whose error exceeds `maximum_error`, given
+           relative to the radius of the geometry's bounding box. Unused vertices are removed from the result. */
+        [[nodiscard]] geometry_data_type simplify(
+            const std::vector<unsigned int> &indices, const std::vector<Vertex> &vertices, size_t target_triangle_count,
+            float maximum_error = std::numeric_limits<float>::max()
+        ) const {
+            Simplification simplification{indices, vertices, _border_weight};
+            simplification.run(target_triangle_count, maximum_error);
+
+            return simplification.get_result();
+        }
+
+        /* Geometries that are not triangle lists are returned unchanged. */
+        [[nodiscard]] geometry_data_type simplify(const Geometry &geometry, float target_ratio, float maximum_error = std::numeric_limits<float>::max()) const
+        {
+            std::vector<unsigned int> indices(geometry.get_index_data(), geometry.get_index_data() + geometry.get_index_count());
+            std::vector<Vertex> vertices(geometry.get_vertex_data(), geometry.get_vertex_data() + geometry.get_vertex_count());
+            if (geometry.get_type() != Geometry::Type::Triangles) {
+                return {std::move(indices), std::move(vertices)};
+            }
+
+            auto target_triangle_count = static_cast<size_t>(static_cast<float>(indices.size() / 3) * target_ratio);
+            return simplify(indices, vertices, target_triangle_count, maximum_error);
+        }
+
+        /* Simplifies every geometry on its own thread of the pool. */
+        [[nodiscard]] std::vector<geometry_data_type> simplify(
+            const std::vector<std::shared_ptr<Geometry>> &geometries, float target_ratio,
+            float maximum_error = std::numeric_limits<float>::max()
+        ) const {
+            std::vector<geometry_data_type> results(geometries.size());
+            _thread_pool.parallel_for(0, geometries.size(), 1, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    results[i] = simplify(*geometries[i], target_ratio, maximum_error);
+                }
+            });
+
+            return results;
+        }
+
+    private:
+        ThreadPool &_thread_pool;
+        float _border_weight{10.0f};
+
+        /* The symmetric matrix of a sum of squared plane distances, weighted by the area the planes stand for. */
+        struct Quadric
+        {
+            double a00{0}, a01{0}, a02{0}, a11{0}, a12{0}, a22{0}, b0{0}, b1{0}, b2{0}, c{0};
+            double weight{0};
+
+            static Quadric from_plane(const glm::vec3 &normal, const glm::vec3 &point, double weight)
+            {
+                double x = normal.x, y = normal.y, z = normal.z;
+                double d = -glm::dot(normal, point);
+
+                Quadric quadric;
+                quadric.a00 = x * x * weight; quadric.a01 = x * y * weight; quadric.a02 = x * z * weight;
+                quadric.a11 = y * y * weight; quadric.a12 = y * z * weight; quadric.a22 = z * z * weight;
+                quadric.b0 = x * d * weight; quadric.b1 = y * d * weight; quadric.b2 = z * d * weight;
+                quadric.c = d * d * weight;
+                quadric.weight = weight;
+
+                return quadric;
+            }
+
+            Quadric &operator+=(const Quadric &other)
+            {
+                a00 += other.a00; a01 += other.a01; a02 += other.a02;
+                a11 += other.a11; a12 += other.a12; a22 += other.a22;
+                b0 += other.b0; b1 += other.b1; b2 += other.b2;
+                c += other.c;
+                weight += other.weight;
+
+                return *this;
+            }
+
+            /* The mean squared distance of `point` to the planes. */
+            [[nodiscard]] double get_error(const glm::vec3 &point) const
+            {
+                double x = point.x, y = point.y, z = point.z;
+                double error =
+                    a00 * x * x + 2.0 * a01 * x * y + 2.0 * a02 * x * z +
+                    a11 * y * y + 2.0 * a12 * y * z + a22 * z * z +
+                    2.0 * (b0 * x + b1 * y + b2 * z) + c;
+
+                return weight > 0.0 ? std::fabs(error) / weight : 0.0;
+            }
+        };
+
+        struct Collapse
+        {
+            unsigned int position;
+            unsigned int target;
+            double error;
+        };
+
+        /* The state of simplifying one geometry. Vertices with the same position are `wedges` of one position,
+           which is what the quadrics, the adjacency and the collapses work on. */
+        class Simplification
+        {
+        public:
+            Simplification(const std::vector<unsigned int> &indices, const std::vector<Vertex> &vertices, float border_weight)
+                : _indices{indices}, _vertices{vertices}
+            {
+                _indices.resize(_indices.size() - _indices.size() % 3);
+                _weld_positions();
+                _compute_quadrics(border_weight);
+            }
+
+            void run(size_t target_triangle_count, float maximum_error)
+            {
+                double error_limit = static_cast<double>(maximum_error) * static_cast<double>(_radius);
+                error_limit = maximum_error < std::numeric_limits<float>::max() ? error_limit * error_limit : std::numeric_limits<double>::max();
+
+                std::vector<Collapse> collapses;
+                std::vector<unsigned int> wedge_targets(_vertices.size());
+                std::vector<bool> locked(_positions.size());
+                while (_indices.size() / 3 > target_triangle_count) {
+                    _build_adjacency();
+
+                    collapses.clear();
+                    for (size_t i = 0; i < _indices.size(); i += 3) {
+                        for (size_t j = 0; j < 3; ++j) {
+                            unsigned int a = _wedge_positions[_indices[i + j]];
+                            unsigned int b = _wedge_positions[_indices[i + (j + 1) % 3]];
+                            _add_collapse(collapses, a, b);
+                            _add_collapse(collapses, b, a);
+                        }
+                    }
+                    std::sort(std::begin(collapses), std::end(collapses), [](const auto &a, const auto &b) {
+                        return a.error < b.error;
+                    });
+
+                    /* Every collapse removes about two triangles, and the neighbourhood of a collapse is locked for the
+                       rest of the pass, since the checks of the other collapses rely on the triangles before it. */
+                    for (size_t i = 0; i < wedge_targets.size(); ++i) {
+                        wedge_targets[i] = static_cast<unsigned int>(i);
+                    }
+                    std::fill(std::begin(locked), std::end(locked), false);
+                    size_t removable_triangle_count = _indices.size() / 3 - target_triangle_count;
+                    size_t removed_triangle_count{0};
+                    for (const auto &collapse : collapses) {
+                        if (removed_triangle_count >= removable_triangle_count || collapse.error > error_limit) {
+                            break;
+                        }
+                        if (locked[collapse.position] || locked[collapse.target]) {
+                            continue;
+                        }
+
+                        size_t collapsed_triangle_count{0};
+                        if (!_try_collapse(collapse, wedge_targets, collapsed_triangle_count)) {
+                            continue;
+                        }
+                        removed_triangle_count += collapsed_triangle_count;
+
+                        locked[collapse.target] = true;
+                        for (unsigned int k = _adjacency_offsets[collapse.position]; k < _adjacency_offsets[collapse.position + 1]; ++k) {
+                            unsigned int triangle = _adjacency[k];
+                            for (size_t j = 0; j < 3; ++j) {
+                                locked[_wedge_positions[_indices[triangle * 3 + j]]] = true;
+                            }
+                        }
+                    }
+
+                    if (removed_triangle_count == 0) {
+                        break;
+                    }
+                    _apply_collapses(wedge_targets);
+                }
+            }
+
+            [[nodiscard]] geometry_data_type get_result() const
+            {
+                std::vector<unsigned int> vertex_remap(_vertices.size(), std::numeric_limits<unsigned int>::max());
+                std::vector<unsigned int> indices;
+                std::vector<Vertex> vertices;
+                indices.reserve(_indices.size());
+                for (unsigned int index : _indices) {
+                    if (vertex_remap[index] == std::numeric_limits<unsigned int>::max()) {
+                        vertex_remap[index] = static_cast<unsigned int>(vertices.size());
+                        vertices.push_back(_vertices[index]);
+                    }
+                    indices.push_back(vertex_remap[index]);
+                }
+
+                return {std::move(indices), std::move(vertices)};
+            }
+
+        private:
+            std::vector<unsigned int> _indices;
+            const std::vector<Vertex> &_vertices;
+
+            std::vector<unsigned int> _wedge_positions;
+            std::vector<glm::vec3> _positions;
+            std::vector<Quadric> _quadrics;
+            float _radius{0.0f};
+
+            std::vector<unsigned int> _adjacency_offsets;
+            std::vector<unsigned int> _adjacency;
+            std::unordered_set<uint64_t> _edges;
+
+            struct PositionHash
+            {
+                size_t operator()(const glm::vec3 &position) const
+                {
+                    uint32_t bits[3];
+                    std::memcpy(bits, &position.x, sizeof(float));
+                    std::memcpy(bits + 1, &position.y, sizeof(float));
+                    std::memcpy(bits + 2, &position.z, sizeof(float));
+
+                    return (bits[0] * 73856093u) ^ (bits[1] * 19349663u) ^ (bits[2] * 83492791u);
+                }
+            };
+
+            struct PositionEqual
+            {
+                bool operator()(const glm::vec3 &a, const glm::vec3 &b) const
+                {
+                    return a.x == b.x && a.y == b.y && a.z == b.z;
+                }
+            };
+
+            void _weld_positions()
+            {
+                std::unordered_map<glm::vec3, unsigned int, PositionHash, PositionEqual> position_indices;
+                position_indices.reserve(_vertices.size());
+                _wedge_positions.resize(_vertices.size());
+
+                glm::vec3 minimum{std::numeric_limits<float>::max()}, maximum{std::numeric_limits<float>::lowest()};
+                for (size_t i = 0; i < _vertices.size(); ++i) {
+                    const glm::vec3 &position = _vertices[i].position;
+                    auto result = position_indices.emplace(position, static_cast<unsigned int>(_positions.size()));
+                    if (result.second) {
+                        _positions.push_back(position);
+                        minimum = glm::min(minimum, position);
+                        maximum = glm::max(maximum, position);
+                    }
+                    _wedge_positions[i] = result.first->second;
+                }
+                _radius = _positions.empty() ? 0.0f : glm::length(maximum - minimum) * 0.5f;
+            }
+
+            void _compute_quadrics(float border_weight)
+            {
+                _quadrics.assign(_positions.size(), Quadric{});
+                _build_adjacency();
+
+                for (size_t i = 0; i < _indices.size(); i += 3) {
+                    unsigned int triangle_positions[3];
+                    for (size_t j = 0; j < 3; ++j) {
+                        triangle_positions[j] = _wedge_positions[_indices[i + j]];
+                    }
+                    const glm::vec3 &a = _positions[triangle_positions[0]];
+                    glm::vec3 normal = glm::cross(_positions[triangle_positions[1]] - a, _positions[triangle_positions[2]] - a);
+                    float length = glm::length(normal);
+                    if (length <= 0.0f) {
+                        continue;
+                    }
+                    normal /= length;
+
+                    Quadric quadric = Quadric::from_plane(normal, a, static_cast<double>(length) * 0.5);
+                    for (unsigned int position : triangle_positions) {
+                        _quadrics[position] += quadric;
+                    }
+
+                    /* An open edge gets a plane through it perpendicular to the triangle, which holds the border in place. */
+                    for (size_t j = 0; j < 3; ++j) {
+                        unsigned int from = triangle_positions[j], to = triangle_positions[(j + 1) % 3];
+                        if (!_is_open_edge(from, to)) {
+                            continue;
+                        }
+                        glm::vec3 edge = _positions[to] - _positions[from];
+                        float edge_length = glm::length(edge);
+                        if (edge_length <= 0.0f) {
+                            continue;
+                        }
+                        glm::vec3 border_normal = glm::normalize(glm::cross(edge, normal));
+                        Quadric border_quadric = Quadric::from_plane(
+                            border_normal, _positions[from], static_cast<double>(edge_length * edge_length * border_weight)
+                        );
+                        _quadrics[from] += border_quadric;
+                        _quadrics[to] += border_quadric;
+                    }
+                }
+            }
+
+            /* The triangles around every position, and the directed edges between positions. */
+            void _build_adjacency()
+            {
+                _adjacency_offsets.assign(_positions.size() + 1, 0);
+                for (unsigned int index : _indices) {
+                    ++_adjacency_offsets[_wedge_positions[index] + 1];
+                }
+                for (size_t i = 1; i < _adjacency_offsets.size(); ++i) {
+                    _adjacency_offsets[i] += _adjacency_offsets[i - 1];
+                }
+                _adjacency.resize(_indices.size());
+                std::vector<unsigned int> next(std::begin(_adjacency_offsets), std::end(_adjacency_offsets) - 1);
+                for (size_t i = 0; i < _indices.size(); ++i) {
+                    _adjacency[next[_wedge_positions[_indices[i]]]++] = static_cast<unsigned int>(i / 3);
+                }
+
+                _edges.clear();
+                _edges.reserve(_indices.size());
+                for (size_t i = 0; i < _indices.size(); i += 3) {
+                    for (size_t j = 0; j < 3; ++j) {
+                        _edges.insert(_get_edge_key(_wedge_positions[_indices[i + j]], _wedge_positions[_indices[i + (j + 1) % 3]]));
+                    }
+                }
+            }
+
+            static uint64_t _get_edge_key(unsigned int from, unsigned int to)
+            {
+                return (static_cast<uint64_t>(from) << 32u) | to;
+            }
+
+            [[nodiscard]] bool _is_open_edge(unsigned int from, unsigned int to) const
+            {
+                return _edges.find(_get_edge_key(to, from)) == std::end(_edges);
+            }
+
+            /* Positions with one pair of open edges lie on a border, more make the surface non-manifold there. */
+            [[nodiscard]] unsigned int _count_open_edges(unsigned int position) const
+            {
+                unsigned int open_edge_count{0};
+                for (unsigned int k = _adjacency_offsets[position]; k < _adjacency_offsets[position + 1]; ++k) {
+                    size_t triangle = _adjacency[k] * 3;
+                    for (size_t j = 0; j < 3; ++j) {
+                        unsigned int from = _wedge_positions[_indices[triangle + j]];
+                        unsigned int to = _wedge_positions[_indices[triangle + (j + 1) % 3]];
+                        if ((from == position || to == position) && _is_open_edge(from, to)) {
+                            ++open_edge_count;
+                        }
+                    }
+                }
+
+                return open_edge_count;
+            }
+
+            void _add_collapse(std::vector<Collapse> &collapses, unsigned int position, unsigned int target) const
+            {
+                if (position == target) {
+                    return;
+                }
+
+                unsigned int open_edge_count = _count_open_edges(position);
+                if (open_edge_count > 2) {
+                    return;
+                }
+                if (open_edge_count == 2 && !_is_open_edge(position, target) && !_is_open_edge(target, position)) {
+                    return;
+                }
+
+                Quadric quadric = _quadrics[position];
+                quadric += _quadrics[target];
+                collapses.push_back(Collapse{position, target, quadric.get_error(_positions[target])});
+            }
+
+            /* The sorted positions that share a triangle with `position`. */
+            void _collect_ring(unsigned int position, std::vector<unsigned int> &ring) const
+            {
+                ring.clear();
+                for (unsigned int k = _adjacency_offsets[position]; k < _adjacency_offsets[position + 1]; ++k) {
+                    size_t triangle = _adjacency[k] * 3;
+                    for (size_t j = 0; j < 3; ++j) {
+                        unsigned int corner_position = _wedge_positions[_indices[triangle + j]];
+                        if (corner_position != position) {
+                            ring.push_back(corner_position);
+                        }
+                    }
+                }
+                std::sort(std::begin(ring), std::end(ring));
+                ring.erase(std::unique(std::begin(ring), std::end(ring)), std::end(ring));
+            }
+
+            /* The positions next to both ends of the edge have to be exactly the opposite corners of the triangles on
+               the edge. Any other common neighbour would end up joined to the merged position by two edges. */
+            bool _is_link_condition_met(unsigned int position, unsigned int target)
+            {
+                _collect_ring(position, _position_ring);
+                _collect_ring(target, _target_ring);
+                _shared_ring.clear();
+                std::set_intersection(
+                    std::begin(_position_ring), std::end(_position_ring), std::begin(_target_ring), std::end(_target_ring),
+                    std::back_inserter(_shared_ring)
+                );
+
+                _opposite_corners.clear();
+                for (unsigned int k = _adjacency_offsets[position]; k < _adjacency_offsets[position + 1]; ++k) {
+                    size_t triangle = _adjacency[k] * 3;
+                    unsigned int corner_positions[3];
+                    bool has_target{false};
+                    for (size_t j = 0; j < 3; ++j) {
+                        corner_positions[j] = _wedge_positions[_indices[triangle + j]];
+                        has_target = has_target || corner_positions[j] == target;
+                    }
+                    if (!has_target) {
+                        continue;
+                    }
+                    for (unsigned int corner_position : corner_positions) {
+                        if (corner_position != position && corner_position != target) {
+                            _opposite_corners.push_back(corner_position);
+                        }
+                    }
+                }
+                std::sort(std::begin(_opposite_corners), std::end(_opposite_corners));
+                _opposite_corners.erase(std::unique(std::begin(_opposite_corners), std::end(_opposite_corners)), std::end(_opposite_corners));
+
+                return _shared_ring == _opposite_corners;
+            }
+
+            /* Every wedge of the collapsed position has to move to a wedge of the target it shares a triangle with,
+               which keeps seams intact, no remaining triangle may turn over and the link condition has to hold. */
+            bool _try_collapse(const Collapse &collapse, std::vector<unsigned int> &wedge_targets, size_t &collapsed_triangle_count)
+            {
+                unsigned int position = collapse.position, target = collapse.target;
+                const glm::vec3 &target_position = _positions[target];
+                if (!_is_link_condition_met(position, target)) {
+                    return false;
+                }
+
+                std::vector<std::pair<unsigned int, unsigned int>> &wedge_pairs = _wedge_pairs;
+                wedge_pairs.clear();
+                collapsed_triangle_count = 0;
+                for (unsigned int k = _adjacency_offsets[position]; k < _adjacency_offsets[position + 1]; ++k) {
+                    size_t triangle = _adjacency[k] * 3;
+                    unsigned int wedge{0}, target_wedge{0};
+                    bool has_target{false};
+                    for (size_t j = 0; j < 3; ++j) {
+                        unsigned int index = _indices[triangle + j];
+                        if (_wedge_positions[index] == position) {
+                            wedge = index;
+                        } else if (_wedge_positions[index] == target) {
+                            target_wedge = index;
+                            has_target = true;
+                        }
+                    }
+                    if (has_target) {
+                        wedge_pairs.emplace_back(wedge, target_wedge);
+                        ++collapsed_triangle_count;
+                        continue;
+                    }
+
+                    glm::vec3 corners[3], moved_corners[3];
+                    for (size_t j = 0; j < 3; ++j) {
+                        unsigned int corner_position = _wedge_positions[_indices[triangle + j]];
+                        corners[j] = _positions[corner_position];
+                        moved_corners[j] = corner_position == position ? target_position : corners[j];
+                    }
+                    glm::vec3 normal = glm::cross(corners[1] - corners[0], corners[2] - corners[0]);
+                    glm::vec3 moved_normal = glm::cross(moved_corners[1] - moved_corners[0], moved_corners[2] - moved_corners[0]);
+                    if (glm::dot(normal, moved_normal) <= 0.0f) {
+                        return false;
+                    }
+                }
+
+                for (unsigned int k = _adjacency_offsets[position]; k < _adjacency_offsets[position + 1]; ++k) {
+                    size_t triangle = _adjacency[k] * 3;
+                    for (size_t j = 0; j < 3; ++j) {
+                        unsigned int index = _indices[triangle + j];
+                        if (_wedge_positions[index] != position) {
+                            continue;
+                        }
+                        auto pair = std::find_if(std::begin(wedge_pairs), std::end(wedge_pairs), [&](const auto &pair) {
+                            return pair.first == index;
+                        });
+                        if (pair == std::end(wedge_pairs)) {
+                            return false;
+                        }
+                    }
+                }
+                for (const auto &pair : wedge_pairs) {
+                    for (const auto &other_pair : wedge_pairs) {
+                        if (pair.first == other_pair.first && pair.second != other_pair.second) {
+                            return false;
+                        }
+                    }
+                }
+
+                for (const auto &pair : wedge_pairs) {
+                    wedge_targets[pair.first] = pair.second;
+                }
+                _quadrics[target] += _quadrics[position];
+
+                return true;
+            }
+
+            /* Rewrites the indices and drops the triangles that collapsed to a line. */
+            void _apply_collapses(const std::vector<unsigned int> &wedge_targets)
+            {
+                size_t index_count{0};
+                for (size_t i = 0; i < _indices.size(); i += 3) {
+                    unsigned int a = wedge_targets[_indices[i]], b = wedge_targets[_indices[i + 1]], c = wedge_targets[_indices[i + 2]];
+                    unsigned int position_a = _wedge_positions[a], position_b = _wedge_positions[b], position_c = _wedge_positions[c];
+                    if (position_a == position_b || position_b == position_c || position_a == position_c) {
+                        continue;
+                    }
+                    _indices[index_count++] = a;
+                    _indices[index_count++] = b;
+                    _indices[index_count++] = c;
+                }
+                _indices.resize(index_count);
+            }
+
+            std::vector<std::pair<unsigned int, unsigned int>> _wedge_pairs;
+            std::vector<unsigned int> _position_ring;
+            std::vector<unsigned int> _target_ring;
+            std::vector<unsigned int> _shared_ring;
+            std::vector<unsigned int> _opposite_corners;
+        };
+    };
+}
+
+#endif
@@ -0,0 +1,316 @@
+#ifndef MESH_FILE_H
+#define MESH_FILE_H
+
+#include "geometries/geometry.h"
+#include "geometries/vertex.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <limits>
+#include <fstream>
+#include <algorithm>
+
+/* The asr binary mesh format. A file holds any number of meshes, each as a layout, an index, a vertex and a bounds
+   chunk. A table after the header lists the chunks, whose data starts at multiples of `ALIGNMENT` bytes, so that
+   indices and vertices can be used directly from a mapped file. All values are little-endian. */
+namespace asr::mesh_file
+{
+    static const char MAGIC[4]{'A', 'S', 'R', 'M'};
+    static const uint32_t VERSION{1};
+    static const uint64_t ALIGNMENT{64};
+
+    enum ChunkType : uint32_t
+    {
+        LayoutChunk = 1,
+        IndexChunk,
+        VertexChunk,
+        BoundsChunk
+    };
+
+    enum Semantic : uint32_t
+    {
+        Position,
+        Color,
+        Normal,
+        Tangent,
+        Binormal,
+        Texture1Coordinates,
+        Texture2Coordinates
+    };
+
+    enum ComponentType : uint32_t
+    {
+        Float32
+    };
+
+    struct Header
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t mesh_count;
+        uint32_t chunk_count;
+    };
+
+    struct ChunkHeader
+    {
+        uint32_t type;
+        uint32_t mesh;
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    struct Attribute
+    {
+        uint32_t semantic;
+        uint32_t component_type;
+        uint32_t component_count;
+        uint32_t offset;
+    };
+
+    /* Followed by `attribute_count` attributes. */
+    struct Layout
+    {
+        uint32_t geometry_type;
+        uint32_t stride;
+        uint32_t attribute_count;
+        uint32_t reserved;
+    };
+
+    struct Bounds
+    {
+        float minimum[3];
+        float maximum[3];
+    };
+
+    /* A mesh to write or one read from a file, whose data stays where it is. */
+    struct MeshView
+    {
+        Geometry::Type type;
+        const unsigned int *indices;
+        size_t index_count;
+        const Vertex *vertices;
+        size_t vertex_count;
+        glm::vec3 minimum;
+        glm::vec3 maximum;
+    };
+
+    /* The layout of `Vertex`, the only one geometries can use without converting every vertex. */
+    static std::vector<Attribute> get_vertex_attributes()
+    {
+        return {
+            {Position, Float32, 3, offsetof(Vertex, position)},
+            {Color, Float32, 4, offsetof(Vertex, color)},
+            {Normal, Float32, 3, offsetof(Vertex, normal)},
+            {Tangent, Float32, 4, offsetof(Vertex, tangent)},
+            {Binormal, Float32, 3, offsetof(Vertex, binormal)},
+            {Texture1Coordinates, Float32, 4, offsetof(Vertex, texture1_coordinates)},
+            {Texture2Coordinates, Float32, 4, offsetof(Vertex, texture2_coordinates)}
+        };
+    }
+
+    /* Fills in the bounds of `mesh` from its vertices. */
+    static void calculate_bounds(MeshView &mesh)
+    {
+        mesh.minimum = glm::vec3{std::numeric_limits<float>::max()};
+        mesh.maximum = glm::vec3{std::numeric_limits<float>::lowest()};
+        for (size_t i = 0; i < mesh.vertex_count; ++i) {
+            mesh.minimum = glm::min(mesh.minimum, mesh.vertices[i].position);
+            mesh.maximum = glm::max(mesh.maximum, mesh.vertices[i].position);
+        }
+        if (mesh.vertex_count == 0) {
+            mesh.minimum = mesh.maximum = glm::vec3{0.0f};
+        }
+    }
+
+    static bool write(const std::string &path, const std::vector<MeshView> &meshes, std::string &error)
+    {
+        std::vector<Attribute> attributes = get_vertex_attributes();
+        Layout layout{0, sizeof(Vertex), static_cast<uint32_t>(attributes.size()), 0};
+        const uint64_t layout_size = sizeof(Layout) + attributes.size() * sizeof(Attribute);
+
+        Header header{};
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.mesh_count = static_cast<uint32_t>(meshes.size());
+        header.chunk_count = static_cast<uint32_t>(meshes.size() * 4);
+
+        auto align = [](uint64_t offset) {
+            return (offset + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+        };
+
+        std::vector<ChunkHeader> chunks;
+        uint64_t offset = align(sizeof(Header) + header.chunk_count * sizeof(ChunkHeader));
+        auto add_chunk = [&](ChunkType type, size_t mesh, uint64_t size) {
+            chunks.push_back(ChunkHeader{type, static_cast<uint32_t>(mesh), offset, size});
+            offset = align(offset + size);
+        };
+        for (size_t i = 0; i < meshes.size(); ++i) {
+            add_chunk(LayoutChunk, i, layout_size);
+            add_chunk(IndexChunk, i, meshes[i].index_count * sizeof(unsigned int));
+            add_chunk(VertexChunk, i, meshes[i].vertex_count * sizeof(Vertex));
+            add_chunk(BoundsChunk, i, sizeof(Bounds));
+        }
+
+        std::ofstream stream{path, std::ios::binary | std::ios::trunc};
+        if (!stream) {
+            error = "Failed to open '" + path + "' for writing";
+            return false;
+        }
+
+        uint64_t position{0};
+        auto write_data = [&](const void *data, uint64_t size) {
+            stream.write(static_cast<const char *>(data), static_cast<std::streamsize>(size));
+            position += size;
+        };
+        auto pad = [&](uint64_t target) {
+            static const char zeros[ALIGNMENT]{};
+            while (position < target) {
+                write_data(zeros, std::min(target - position, ALIGNMENT));
+            }
+        };
+
+        write_data(&header, sizeof(Header));
+        write_data(chunks.data(), chunks.size() * sizeof(ChunkHeader));
+        for (size_t i = 0; i < meshes.size(); ++i) {
+            const MeshView &mesh = meshes[i];
+
+            pad(chunks[i * 4].offset);
+            layout.geometry_type = static_cast<uint32_t>(mesh.type);
+            write_data(&layout, sizeof(Layout));
+            write_data(attributes.data(), attributes.size() * sizeof(Attribute));
+
+            pad(chunks[i * 4 + 1].offset);
+            write_data(mesh.indices, mesh.index_count * sizeof(unsigned int));
+
+            pad(chunks[i * 4 + 2].offset);
+            write_data(mesh.vertices, mesh.vertex_count * sizeof(Vertex));
+
+            pad(chunks[i * 4 + 3].offset);
+            Bounds bounds{
+                {mesh.minimum.x, mesh.minimum.y, mesh.minimum.z},
+                {mesh.maximum.x, mesh.maximum.y, mesh.maximum.z}
+            };
+            write_data(&bounds, sizeof(Bounds));
+        }
+
+        if (!stream) {
+            error = "Failed to write '" + path + "'";
+            return false;
+        }
+
+        return true;
+    }
+
+    /* Validates the file in `data` and points the returned meshes into it. Nothing is copied, so `data` has to
+       outlive the meshes. */
+    static bool read(const uint8_t *data, size_t size, std::vector<MeshView> &meshes, std::string &error)
+    {
+        if (size < sizeof(Header)) {
+            error = "The file is too small for a mesh file";
+            return false;
+        }
+
+        Header header{};
+        std::memcpy(&header, data, sizeof(Header));
+        if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+            error = "The file is not a mesh file";
+            return false;
+        }
+        if (header.version != VERSION) {
+            error = "Unsupported mesh file version " + std::to_string(header.version);
+            return false;
+        }
+        if (static_cast<uint64_t>(header.chunk_count) * sizeof(ChunkHeader) > size - sizeof(Header)) {
+            error = "The chunk table exceeds the file";
+            return false;
+        }
+
+        const std::vector<Attribute> vertex_attributes = get_vertex_attributes();
+        meshes.assign(header.mesh_count, MeshView{Geometry::Triangles, nullptr, 0, nullptr, 0, glm::vec3{0.0f}, glm::vec3{0.0f}});
+        std::vector<bool> has_layout(header.mesh_count, false);
+        for (uint32_t i = 0; i < header.chunk_count; ++i) {
+            ChunkHeader chunk{};
+            std::memcpy(&chunk, data + sizeof(Header) + i * sizeof(ChunkHeader), sizeof(ChunkHeader));
+            if (chunk.mesh >= header.mesh_count || chunk.offset > size || chunk.size > size - chunk.offset || chunk.offset % 4 != 0) {
+                error = "Chunk " + std::to_string(i) + " is out of bounds";
+                return false;
+            }
+
+            MeshView &mesh = meshes[chunk.mesh];
+            const uint8_t *chunk_data = data + chunk.offset;
+            switch (chunk.type) {
+                case LayoutChunk: {
+                    Layout layout{};
+                    if (chunk.size < sizeof(Layout)) {
+                        error = "The layout of mesh " + std::to_string(chunk.mesh) + " is truncated";
+                        return false;
+                    }
+                    std::memcpy(&layout, chunk_data, sizeof(Layout));
+
+                    bool native_layout =
+                        layout.stride == sizeof(Vertex) &&
+                        layout.attribute_count == vertex_attributes.size() &&
+                        chunk.size >= sizeof(Layout) + layout.attribute_count * sizeof(Attribute) &&
+                        std::memcmp(chunk_data + sizeof(Layout), vertex_attributes.data(), vertex_attributes.size() * sizeof(Attribute)) == 0;
+                    if (!native_layout) {
+                        error = "The vertex layout of mesh " + std::to_string(chunk.mesh) + " is not supported";
+                        return false;
+                    }
+                    if (layout.geometry_type > Geometry::TriangleStrip) {
+                        error = "The geometry type of mesh " + std::to_string(chunk.mesh) + " is not supported";
+                        return false;
+                    }
+                    mesh.type = static_cast<Geometry::Type>(layout.geometry_type);
+                    has_layout[chunk.mesh] = true;
+                    break;
+                }
+                case IndexChunk:
+                    mesh.indices = reinterpret_cast<const unsigned int *>(chunk_data);
+                    mesh.index_count = static_cast<size_t>(chunk.size / sizeof(unsigned int));
+                    break;
+                case VertexChunk:
+                    mesh.vertices = reinterpret_cast<const Vertex *>(chunk_data);
+                    mesh.vertex_count = static_cast<size_t>(chunk.size / sizeof(Vertex));
+                    break;
+                case BoundsChunk: {
+                    Bounds bounds{};
+                    if (chunk.size < sizeof(Bounds)) {
+                        error = "The bounds of mesh " + std::to_string(chunk.mesh) + " are truncated";
+                        return false;
+                    }
+                    std::memcpy(&bounds, chunk_data, sizeof(Bounds));
+                    mesh.minimum = glm::vec3{bounds.minimum[0], bounds.minimum[1], bounds.minimum[2]};
+                    mesh.maximum = glm::vec3{bounds.maximum[0], bounds.maximum[1], bounds.maximum[2]};
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+
+        for (uint32_t i = 0; i < header.mesh_count; ++i) {
+            if (!has_layout[i]) {
+                error = "Mesh " + std::to_string(i) + " has no vertex layout";
+                return false;
+            }
+        }
+
+        /* Indices are checked once here, so that a damaged file can not make the GPU read outside the vertices. */
+        for (uint32_t i = 0; i < header.mesh_count; ++i) {
+            const MeshView &mesh = meshes[i];
+            if (mesh.index_count > 0 && *std::max_element(mesh.indices, mesh.indices + mesh.index_count) >= mesh.vertex_count) {
+                error = "Mesh " + std::to_string(i) + " has indices outside of its vertices";
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
+
+#endif
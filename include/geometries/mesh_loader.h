@@ -0,0 +1,76 @@
+#ifndef MESH_LOADER_H
+#define MESH_LOADER_H
+
+#include "geometries/geometry.h"
+#include "geometries/mesh_file.h"
+#include "math/aabb.h"
+#include "utilities/mapped_file.h"
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <iostream>
+#include <cstdlib>
+
+namespace asr
+{
+    /* Loads asr mesh files. The file stays mapped while any of its geometries lives, and the geometries upload
+       their indices and vertices straight from the mapping, so loading costs about as much as reading the file. */
+    class MeshLoader
+    {
+    public:
+        MeshLoader() = default;
+
+        MeshLoader(const MeshLoader &other) = delete;
+        MeshLoader& operator=(const MeshLoader &other) = delete;
+
+        virtual ~MeshLoader() = default;
+
+        /* The bounds stored for every geometry are appended to `bounds` if it is given. */
+        bool load(
+            const std::string &path, std::vector<std::shared_ptr<Geometry>> &geometries, std::string &error,
+            std::vector<AABB> *bounds = nullptr
+        ) {
+            std::shared_ptr<MappedFile> file = MappedFile::open(path, error);
+            if (!file) {
+                return false;
+            }
+
+            std::vector<mesh_file::MeshView> meshes;
+            if (!mesh_file::read(file->get_data(), file->get_size(), meshes, error)) {
+                error = "Failed to load '" + path + "': " + error;
+                return false;
+            }
+
+            for (const auto &mesh : meshes) {
+                std::shared_ptr<Geometry> geometry = _create_geometry(
+                    Geometry::MappedData{file, mesh.indices, mesh.index_count, mesh.vertices, mesh.vertex_count}
+                );
+                geometry->set_type(mesh.type);
+                geometries.push_back(geometry);
+                if (bounds) {
+                    bounds->emplace_back(mesh.minimum, mesh.maximum);
+                }
+            }
+
+            return true;
+        }
+
+        std::vector<std::shared_ptr<Geometry>> load(const std::string &path)
+        {
+            std::vector<std::shared_ptr<Geometry>> geometries;
+            std::string error;
+            if (!load(path, geometries, error)) {
+                std::cerr << error << std::endl;
+                std::exit(-1);
+            }
+
+            return geometries;
+        }
+
+    protected:
+        virtual std::shared_ptr<Geometry> _create_geometry(Geometry::MappedData mapped_data) = 0;
+    };
+}
+
+#endif
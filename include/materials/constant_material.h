@@ -41,6 +41,16 @@ namespace asr
             _texture2 = texture_2;
         }
 
+        [[nodiscard]] std::vector<std::shared_ptr<Texture>> get_textures() const override
+        {
+            std::vector<std::shared_ptr<Texture>> textures;
+            for (const auto &texture : {_texture1, _texture2}) {
+                if (texture) { textures.push_back(texture); }
+            }
+
+            return textures;
+        }
+
     protected:
         glm::vec4 _emission_color{1.0f};
 
@@ -5,6 +5,7 @@
 
 #include "utilities/utilities.h"
 #include "renderer/es2_shader.h"
+#include "renderer/gl_dispatch.h"
 
 #include <GL/glew.h>
 #define SDL_MAIN_HANDLED
@@ -21,10 +22,13 @@ namespace asr
     class ES2ConstantMaterial : public ConstantMaterial
     {
     public:
+        inline static const std::string VERTEX_SHADER_PATH{"data/shaders/es2_constant_shader.vert"};
+        inline static const std::string FRAGMENT_SHADER_PATH{"data/shaders/es2_constant_shader.frag"};
+
         ES2ConstantMaterial()
         {
-            std::string vertex_shader_source{file_utilities::read_text_file("data/shaders/es2_constant_shader.vert")};
-            std::string fragment_shader_source{file_utilities::read_text_file("data/shaders/es2_constant_shader.frag")};
+            std::string vertex_shader_source{file_utilities::read_text_file(VERTEX_SHADER_PATH)};
+            std::string fragment_shader_source{file_utilities::read_text_file(FRAGMENT_SHADER_PATH)};
             std::vector<std::string> attributes{
                 "position",
                 "color",
@@ -59,6 +63,8 @@ namespace asr
             };
 
             _shader = std::make_shared<ES2Shader>(vertex_shader_source, fragment_shader_source, attributes, uniforms);
+            _shader->set_vertex_shader_path(VERTEX_SHADER_PATH);
+            _shader->set_fragment_shader_path(FRAGMENT_SHADER_PATH);
         }
 
         void update(std::shared_ptr<Scene> scene, std::shared_ptr<Mesh> mesh) final
@@ -66,59 +72,63 @@ namespace asr
             if (_shader->is_dead()) {
                 return;
             } else if (!_shader->is_compiled()) {
-                _shader->compile();
+                if (_shader->is_pending()) {
+                    _shader->poll(true);
+                } else {
+                    _shader->compile();
+                }
                 if (_shader->is_dead()) { return; }
             }
 
             if (!_prefer_line_width_from_geometry) {
-                glLineWidth(static_cast<GLfloat>(_line_width));
+                gl::LineWidth(static_cast<GLfloat>(_line_width));
             }
 
-            glDepthMask(static_cast<GLboolean>(_depth_mask_enabled));
+            gl::DepthMask(static_cast<GLboolean>(_depth_mask_enabled));
             if (_depth_test_enabled) {
-                glEnable(GL_DEPTH_TEST);
+                gl::Enable(GL_DEPTH_TEST);
             } else {
-                glDisable(GL_DEPTH_TEST);
+                gl::Disable(GL_DEPTH_TEST);
             }
             if (_depth_test_enabled) {
-                glDepthFunc(_convert_depth_test_func_to_es2_depth_test_func(_depth_test_function));
+                gl::DepthFunc(_convert_depth_test_func_to_es2_depth_test_func(_depth_test_function));
             }
 
             if (_blending_enabled) {
-                glEnable(GL_BLEND);
+                gl::Enable(GL_BLEND);
             } else {
-                glDisable(GL_BLEND);
+                gl::Disable(GL_BLEND);
             }
             if (_blending_enabled) {
-                glBlendEquationSeparate(_convert_blending_equation_to_es2_blending_equation(_color_blending_equation),
+                gl::BlendEquationSeparate(_convert_blending_equation_to_es2_blending_equation(_color_blending_equation),
                                         _convert_blending_equation_to_es2_blending_equation(_alpha_blending_equation));
-                glBlendFuncSeparate(_convert_blending_func_to_es2_blending_func(_source_color_blending_function),
+                gl::BlendFuncSeparate(_convert_blending_func_to_es2_blending_func(_source_color_blending_function),
                                     _convert_blending_func_to_es2_blending_func(_destination_color_blending_function),
                                     _convert_blending_func_to_es2_blending_func(_source_alpha_blending_function),
                                     _convert_blending_func_to_es2_blending_func(_destination_alpha_blending_function));
-                glBlendColor(static_cast<GLclampf>(_blending_constant_color[0]),
+                gl::BlendColor(static_cast<GLclampf>(_blending_constant_color[0]),
                              static_cast<GLclampf>(_blending_constant_color[1]),
                              static_cast<GLclampf>(_blending_constant_color[2]),
                              static_cast<GLclampf>(_blending_constant_color[3]));
             }
 
             if (_face_culling_enabled) {
-                glEnable(GL_CULL_FACE);
+                gl::Enable(GL_CULL_FACE);
             } else {
-                glDisable(GL_CULL_FACE);
+                gl::Disable(GL_CULL_FACE);
             }
             if (_face_culling_enabled) {
-                glCullFace(_convert_cull_face_mode_to_es2_cull_face_mode(_cull_face_mode));
-                glCullFace(_convert_front_face_order_to_es2_front_face_order(_front_face_order));
+                gl::CullFace(_convert_cull_face_mode_to_es2_cull_face_mode(_cull_face_mode));
+                gl::CullFace(_convert_front_face_order_to_es2_front_face_order(_front_face_order));
             }
 
             if (_polygon_offset_enabled) {
-                glEnable(GL_POLYGON_OFFSET_FILL);
+                gl::Enable(GL_POLYGON_OFFSET_FILL);
             } else {
-                glDisable(GL_POLYGON_OFFSET_FILL);
+                gl::Disable(GL_POLYGON_OFFSET_FILL);
             }
             if (_polygon_offset_enabled) {
-                glPolygonOffset(static_cast<GLfloat>(_polygon_offset_factor),
+                gl::PolygonOffset(static_cast<GLfloat>(_polygon_offset_factor),
                                 static_cast<GLfloat>(_polygon_offset_units));
             }
 
@@ -132,7 +142,7 @@ namespace asr
                 model_view_matrix = camera->get_view_matrix() * mesh->get_world_matrix();
             }
             int model_view_matrix_uniform_location{_shader->get_uniforms().at("model_view_matrix")};
-            glUniformMatrix4fv(
+            gl::UniformMatrix4fv(
                 model_view_matrix_uniform_location,
                 1, GL_FALSE,
                 glm::value_ptr(model_view_matrix)
@@ -145,7 +155,7 @@ namespace asr
                 projection_matrix = camera->get_projection_matrix();
             }
             int projection_matrix_uniform_location{_shader->get_uniforms().at("projection_matrix")};
-            glUniformMatrix4fv(
+            gl::UniformMatrix4fv(
                 projection_matrix_uniform_location,
                 1, GL_FALSE,
                 glm::value_ptr(projection_matrix)
@@ -153,40 +163,40 @@ namespace asr
 
             if (_point_sizing_enabled && !_prefer_point_size_from_geometry) {
                 int point_size_uniform_location{_shader->get_uniforms().at("point_size")};
-                glUniform1f(point_size_uniform_location, _point_size);
+                gl::Uniform1f(point_size_uniform_location, _point_size);
             }
 
             int emission_color_uniform_location{_shader->get_uniforms().at("emission_color")};
-            glUniform4fv(
+            gl::Uniform4fv(
                 emission_color_uniform_location,
                 1, glm::value_ptr(_emission_color)
             );
 
             if (_texture1) {
                 int texture1_enabled_uniform_location{_shader->get_uniforms().at("texture1_enabled")};
-                glUniform1i(
+                gl::Uniform1i(
                     texture1_enabled_uniform_location,
                     static_cast<GLint>(_texture1->is_enabled())
                 );
 
                 if (_texture1->is_enabled()) {
                     int texture1_sampler_uniform_location{_shader->get_uniforms().at("texture1_sampler")};
-                    glUniform1i(texture1_sampler_uniform_location, 0);
+                    gl::Uniform1i(texture1_sampler_uniform_location, 0);
 
                     int texturing_mode1_uniform_location{_shader->get_uniforms().at("texturing_mode1")};
-                    glUniform1i(
+                    gl::Uniform1i(
                         texturing_mode1_uniform_location,
                         static_cast<GLint>(_texture1->get_mode())
                     );
 
                     int texture1_transformation_enabled_uniform_location{_shader->get_uniforms().at("texture1_transformation_enabled")};
-                    glUniform1i(
+                    gl::Uniform1i(
                         texture1_transformation_enabled_uniform_location,
                         static_cast<GLint>(_texture1->is_transformation_enabled())
                     );
 
                     int texture1_transformation_matrix_uniform_location{_shader->get_uniforms().at("texture1_transformation_matrix")};
-                    glUniformMatrix4fv(
+                    gl::UniformMatrix4fv(
                         texture1_transformation_matrix_uniform_location,
                         1, GL_FALSE,
                         glm::value_ptr(_texture1->get_transformation_matrix())
@@ -196,29 +206,29 @@ namespace asr
 
             if (_texture2) {
                 int texture2_enabled_uniform_location{_shader->get_uniforms().at("texture2_enabled")};
-                glUniform1i(
+                gl::Uniform1i(
                     texture2_enabled_uniform_location,
                     static_cast<GLint>(_texture2->is_enabled())
                 );
 
                 if (_texture2->is_enabled()) {
                     int texture2_sampler_uniform_location{_shader->get_uniforms().at("texture2_sampler")};
-                    glUniform1i(texture2_sampler_uniform_location, 1);
+                    gl::Uniform1i(texture2_sampler_uniform_location, 1);
 
                     int texturing_mode2_uniform_location{_shader->get_uniforms().at("texturing_mode2")};
-                    glUniform1i(
+                    gl::Uniform1i(
                         texturing_mode2_uniform_location,
                         static_cast<GLint>(_texture2->get_mode())
                     );
 
                     int texture2_transformation_enabled_uniform_location{_shader->get_uniforms().at("texture2_transformation_enabled")};
-                    glUniform1i(
+                    gl::Uniform1i(
                         texture2_transformation_enabled_uniform_location,
                         static_cast<GLint>(_texture2->is_transformation_enabled())
                     );
 
                     int texture2_transformation_matrix_uniform_location{_shader->get_uniforms().at("texture2_transformation_matrix")};
-                    glUniformMatrix4fv(
+                    gl::UniformMatrix4fv(
                         texture2_transformation_matrix_uniform_location,
                         1, GL_FALSE,
                         glm::value_ptr(_texture2->get_transformation_matrix())
@@ -227,28 +237,28 @@ namespace asr
             }
 
             int fog_enabled_uniform_location{_shader->get_uniforms().at("fog_enabled")};
-            glUniform1i(fog_enabled_uniform_location, static_cast<GLint>(_fog_enabled));
+            gl::Uniform1i(fog_enabled_uniform_location, static_cast<GLint>(_fog_enabled));
 
             int fog_type_uniform_location{_shader->get_uniforms().at("fog_type")};
-            glUniform1i(fog_type_uniform_location, static_cast<GLint>(_fog_type));
+            gl::Uniform1i(fog_type_uniform_location, static_cast<GLint>(_fog_type));
 
             int fog_depth_uniform_location{_shader->get_uniforms().at("fog_depth")};
-            glUniform1i(fog_depth_uniform_location, static_cast<GLint>(_fog_depth));
+            gl::Uniform1i(fog_depth_uniform_location, static_cast<GLint>(_fog_depth));
 
             int fog_color_uniform_location{_shader->get_uniforms().at("fog_color")};
-            glUniform3fv(
+            gl::Uniform3fv(
                 fog_color_uniform_location,
                 1, glm::value_ptr(_fog_color)
             );
 
             int fog_far_minus_near_plane_uniform_location{_shader->get_uniforms().at("fog_far_minus_near_plane")};
-            glUniform1f(fog_far_minus_near_plane_uniform_location, _fog_far_plane - _fog_near_plane);
+            gl::Uniform1f(fog_far_minus_near_plane_uniform_location, _fog_far_plane - _fog_near_plane);
 
             int fog_far_plane_uniform_location{_shader->get_uniforms().at("fog_far_plane")};
-            glUniform1f(fog_far_plane_uniform_location, _fog_far_plane);
+            gl::Uniform1f(fog_far_plane_uniform_location, _fog_far_plane);
 
             int fog_density_uniform_location{_shader->get_uniforms().at("fog_density")};
-            glUniform1f(fog_density_uniform_location, _fog_density);
+            gl::Uniform1f(fog_density_uniform_location, _fog_density);
         }
 
         void use() final
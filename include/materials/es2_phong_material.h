@@ -5,6 +5,7 @@
 
 #include "utilities/utilities.h"
 #include "renderer/es2_shader.h"
+#include "renderer/gl_dispatch.h"
 
 #include <GL/glew.h>
 #define SDL_MAIN_HANDLED
@@ -23,10 +24,13 @@ namespace asr
     class ES2PhongMaterial : public PhongMaterial
     {
     public:
+        inline static const std::string VERTEX_SHADER_PATH{"data/shaders/es2_phong_shader.vert"};
+        inline static const std::string FRAGMENT_SHADER_PATH{"data/shaders/es2_phong_shader.frag"};
+
         ES2PhongMaterial()
         {
-            _vertex_shader_source = file_utilities::read_text_file("data/shaders/es2_phong_shader.vert");
-            _fragment_shader_source = file_utilities::read_text_file("data/shaders/es2_phong_shader.frag");
+            std::string vertex_shader_source{file_utilities::read_text_file(VERTEX_SHADER_PATH)};
+            std::string fragment_shader_source{file_utilities::read_text_file(FRAGMENT_SHADER_PATH)};
 
             std::vector<std::string> attributes{
                 "position",
@@ -93,7 +97,9 @@ namespace asr
                 "fog_density"
             };
 
-            _shader = std::make_shared<ES2Shader>(_vertex_shader_source, _fragment_shader_source, attributes, uniforms);
+            _shader = std::make_shared<ES2Shader>(vertex_shader_source, fragment_shader_source, attributes, uniforms);
+            _shader->set_vertex_shader_path(VERTEX_SHADER_PATH);
+            _shader->set_fragment_shader_path(FRAGMENT_SHADER_PATH);
         }
 
         void update(std::shared_ptr<Scene> scene, std::shared_ptr<Mesh> mesh) final
@@ -101,64 +107,68 @@ namespace asr
             if (_shader->is_dead()) {
                 return;
             } else if (!_shader->is_compiled()) {
-                _shader->compile();
+                if (_shader->is_pending()) {
+                    _shader->poll(true);
+                } else {
+                    _shader->compile();
+                }
                 if (_shader->is_dead()) { return; }
             }
 
             if (!_prefer_line_width_from_geometry) {
-                glLineWidth(static_cast<GLfloat>(_line_width));
+                gl::LineWidth(static_cast<GLfloat>(_line_width));
             }
 
-            glDepthMask(static_cast<GLboolean>(_depth_mask_enabled));
+            gl::DepthMask(static_cast<GLboolean>(_depth_mask_enabled));
             if (_depth_test_enabled) {
-                glEnable(GL_DEPTH_TEST);
+                gl::Enable(GL_DEPTH_TEST);
             } else {
-                glDisable(GL_DEPTH_TEST);
+                gl::Disable(GL_DEPTH_TEST);
             }
             if (_depth_test_enabled) {
-                glDepthFunc(_convert_depth_test_func_to_es2_depth_test_func(_depth_test_function));
+                gl::DepthFunc(_convert_depth_test_func_to_es2_depth_test_func(_depth_test_function));
             }
 
             if (_blending_enabled) {
-                glEnable(GL_BLEND);
+                gl::Enable(GL_BLEND);
             } else {
-                glDisable(GL_BLEND);
+                gl::Disable(GL_BLEND);
             }
             if (_blending_enabled) {
-                glBlendEquationSeparate(_convert_blending_equation_to_es2_blending_equation(_color_blending_equation),
+                gl::BlendEquationSeparate(_convert_blending_equation_to_es2_blending_equation(_color_blending_equation),
                                         _convert_blending_equation_to_es2_blending_equation(_alpha_blending_equation));
-                glBlendFuncSeparate(_convert_blending_func_to_es2_blending_func(_source_color_blending_function),
+                gl::BlendFuncSeparate(_convert_blending_func_to_es2_blending_func(_source_color_blending_function),
                                     _convert_blending_func_to_es2_blending_func(_destination_color_blending_function),
                                     _convert_blending_func_to_es2_blending_func(_source_alpha_blending_function),
                                     _convert_blending_func_to_es2_blending_func(_destination_alpha_blending_function));
-                glBlendColor(static_cast<GLclampf>(_blending_constant_color[0]),
+                gl::BlendColor(static_cast<GLclampf>(_blending_constant_color[0]),
                              static_cast<GLclampf>(_blending_constant_color[1]),
                              static_cast<GLclampf>(_blending_constant_color[2]),
                              static_cast<GLclampf>(_blending_constant_color[3]));
             }
 
             if (_face_culling_enabled) {
-                glEnable(GL_CULL_FACE);
+                gl::Enable(GL_CULL_FACE);
             } else {
-                glDisable(GL_CULL_FACE);
+                gl::Disable(GL_CULL_FACE);
             }
             if (_face_culling_enabled) {
-                glCullFace(_convert_cull_face_mode_to_es2_cull_face_mode(_cull_face_mode));
-                glFrontFace(_convert_front_face_order_to_es2_front_face_order(_front_face_order));
+                gl::CullFace(_convert_cull_face_mode_to_es2_cull_face_mode(_cull_face_mode));
+                gl::FrontFace(_convert_front_face_order_to_es2_front_face_order(_front_face_order));
             }
 
             if (_polygon_offset_enabled) {
-                glEnable(GL_POLYGON_OFFSET_FILL);
+                gl::Enable(GL_POLYGON_OFFSET_FILL);
             } else {
-                glDisable(GL_POLYGON_OFFSET_FILL);
+                gl::Disable(GL_POLYGON_OFFSET_FILL);
             }
             if (_polygon_offset_enabled) {
-                glPolygonOffset(static_cast<GLfloat>(_polygon_offset_factor),
+                gl::PolygonOffset(static_cast<GLfloat>(_polygon_offset_factor),
                                 static_cast<GLfloat>(_polygon_offset_units));
             }
 
             _update_light_uniforms_if_necessary(scene);
-            if (_shader->is_dead()) { return; }
+            if (!_shader->is_compiled()) { return; }
 
             auto camera = scene->get_camera();
 
@@ -170,7 +180,7 @@ namespace asr
                 model_view_matrix = camera->get_view_matrix() * mesh->get_world_matrix();
             }
             int model_view_matrix_uniform_location{_shader->get_uniforms().at("model_view_matrix")};
-            glUniformMatrix4fv(
+            gl::UniformMatrix4fv(
                 model_view_matrix_uniform_location,
                 1, GL_FALSE,
                 glm::value_ptr(model_view_matrix)
@@ -183,7 +193,7 @@ namespace asr
                 projection_matrix = camera->get_projection_matrix();
             }
             int projection_matrix_uniform_location{_shader->get_uniforms().at("projection_matrix")};
-            glUniformMatrix4fv(
+            gl::UniformMatrix4fv(
                 projection_matrix_uniform_location,
                 1, GL_FALSE,
                 glm::value_ptr(projection_matrix)
@@ -191,7 +201,7 @@ namespace asr
 
             glm::mat3 normal_matrix = glm::inverseTranspose(glm::mat3(model_view_matrix));
             int normal_matrix_uniform_location{_shader->get_uniforms().at("normal_matrix")};
-            glUniformMatrix3fv(
+            gl::UniformMatrix3fv(
                 normal_matrix_uniform_location,
                 1, GL_FALSE,
                 glm::value_ptr(normal_matrix)
@@ -199,78 +209,78 @@ namespace asr
 
             if (_point_sizing_enabled && !_prefer_point_size_from_geometry) {
                 int point_size_uniform_location{_shader->get_uniforms().at("point_size")};
-                glUniform1f(point_size_uniform_location, _point_size);
+                gl::Uniform1f(point_size_uniform_location, _point_size);
             }
 
             int ambient_light_color_uniform_location{_shader->get_uniforms().at("ambient_light_color")};
-            glUniform3fv(
+            gl::Uniform3fv(
                 ambient_light_color_uniform_location,
                 1, glm::value_ptr(scene->get_ambient_light()->get_ambient_color())
             );
 
             int material_ambient_color_uniform_location{_shader->get_uniforms().at("material_ambient_color")};
-            glUniform3fv(
+            gl::Uniform3fv(
                 material_ambient_color_uniform_location,
                 1, glm::value_ptr(_ambient_color)
             );
 
             int material_diffuse_color_uniform_location{_shader->get_uniforms().at("material_diffuse_color")};
-            glUniform4fv(
+            gl::Uniform4fv(
                 material_diffuse_color_uniform_location,
                 1, glm::value_ptr(_diffuse_color)
             );
 
             int material_emission_color_uniform_location{_shader->get_uniforms().at("material_emission_color")};
-            glUniform4fv(
+            gl::Uniform4fv(
                 material_emission_color_uniform_location,
                 1, glm::value_ptr(_emission_color)
             );
 
             int material_specular_color_uniform_location{_shader->get_uniforms().at("material_specular_color")};
-            glUniform3fv(
+            gl::Uniform3fv(
                 material_specular_color_uniform_location,
                 1, glm::value_ptr(_specular_color)
             );
 
             int material_specular_exponent_uniform_location{_shader->get_uniforms().at("material_specular_exponent")};
-            glUniform1f(material_specular_exponent_uniform_location, _specular_exponent);
+            gl::Uniform1f(material_specular_exponent_uniform_location, _specular_exponent);
 
             auto &directional_lights = scene->get_directional_lights();
             for (std::vector<std::shared_ptr<DirectionalLight>>::size_type i = 0; i < directional_lights.size(); ++i) {
                 const auto &directional_light = directional_lights[i];
 
                 int uniform_location = _shader->get_uniforms().at(_uniform_at_index("directional_light_enabled", i));
-                glUniform1i(uniform_location, directional_light->is_enabled());
+                gl::Uniform1i(uniform_location, directional_light->is_enabled());
 
                 uniform_location = _shader->get_uniforms().at(_uniform_at_index("directional_light_two_sided", i));
-                glUniform1i(uniform_location, directional_light->is_two_sided());
+                gl::Uniform1i(uniform_location, directional_light->is_two_sided());
 
                 uniform_location = _shader->get_uniforms().at(_uniform_at_index("directional_light_view_direction", i));
-                glUniform3fv(
+                gl::Uniform3fv(
                     uniform_location,
                     1, glm::value_ptr(camera->get_view_matrix() * glm::vec4(directional_light->get_world_direction(), 0.0f))
                 );
 
                 uniform_location = _shader->get_uniforms().at(_uniform_at_index("directional_light_ambient_color", i));
-                glUniform3fv(
+                gl::Uniform3fv(
                     uniform_location,
                     1, glm::value_ptr(directional_light->get_ambient_color())
                 );
 
                 uniform_location = _shader->get_uniforms().at(_uniform_at_index("directional_light_diffuse_color", i));
-                glUniform3fv(
+                gl::Uniform3fv(
                     uniform_location,
                     1, glm::value_ptr(directional_light->get_diffuse_color())
                 );
 
                 uniform_location = _shader->get_uniforms().at(_uniform_at_index("directional_light_specular_color", i));
-                glUniform3fv(
+                gl::Uniform3fv(
                     uniform_location,
                     1, glm::value_ptr(directional_light->get_specular_color())
                 );
 
                 uniform_location = _shader->get_uniforms().at(_uniform_at_index("directional_light_intensity", i));
-                glUniform1f(uniform_location, directional_light->get_intensity());
+                gl::Uniform1f(uniform_location, directional_light->get_intensity());
             }
 
             auto &point_lights = scene->get_point_lights();
@@ -278,46 +288,46 @@ namespace asr
                 const auto &point_light = point_lights[i];
 
                 int uniform_location = _shader->get_uniforms().at(_uniform_at_index("point_light_enabled", i));
-                glUniform1i(uniform_location, point_light->is_enabled());
+                gl::Uniform1i(uniform_location, point_light->is_enabled());
 
                 uniform_location = _shader->get_uniforms().at(_uniform_at_index("point_light_two_sided", i));
-                glUniform1i(uniform_location, point_light->is_two_sided());
+                gl::Uniform1i(uniform_location, point_light->is_two_sided());
 
                 uniform_location = _shader->get_uniforms().at(_uniform_at_index("point_light_view_position", i));
-                glUniform3fv(
+                gl::Uniform3fv(
                     uniform_location,
                     1, glm::value_ptr(camera->get_view_matrix() * point_light->get_world_matrix() * glm::vec4(point_light->get_position(), 1.0f))
                 );
 
                 uniform_location = _shader->get_uniforms().at(_uniform_at_index("point_light_ambient_color", i));
-                glUniform3fv(
+                gl::Uniform3fv(
                     uniform_location,
                     1, glm::value_ptr(point_light->get_ambient_color())
                 );
 
                 uniform_location = _shader->get_uniforms().at(_uniform_at_index("point_light_diffuse_color", i));
-                glUniform3fv(
+                gl::Uniform3fv(
                     uniform_location,
                     1, glm::value_ptr(point_light->get_diffuse_color())
                 );
 
                 uniform_location = _shader->get_uniforms().at(_uniform_at_index("point_light_specular_color", i));
-                glUniform3fv(
+                gl::Uniform3fv(
                     uniform_location,
                     1, glm::value_ptr(point_light->get_specular_color())
                 );
 
                 uniform_location = _shader->get_uniforms().at(_uniform_at_index("point_light_intensity", i));
-                glUniform1f(uniform_location, point_light->get_intensity());
+                gl::Uniform1f(uniform_location, point_light->get_intensity());
 
                 uniform_location = _shader->get_uniforms().at(_uniform_at_index("point_light_constant_attenuation", i));
-                glUniform1f(uniform_location, point_light->get_constant_attenuation());
+                gl::Uniform1f(uniform_location, point_light->get_constant_attenuation());
 
                 uniform_location = _shader->get_uniforms().at(_uniform_at_index("point_light_linear_attenuation", i));
-                glUniform1f(uniform_location, point_light->get_linear_attenuation());
+                gl::Uniform1f(uniform_location, point_light->get_linear_attenuation());
 
                 uniform_location = _shader->get_uniforms().at(_uniform_at_index("point_light_quadratic_attenuation", i));
-                glUniform1f(uniform_location, point_light->get_quadratic_attenuation());
+                gl::Uniform1f(uniform_location, point_light->get_quadratic_attenuation());
             }
 
             auto &spot_lights = scene->get_spot_lights();
@@ -325,87 +335,87 @@ namespace asr
                 const auto &spot_light = spot_lights[i];
 
                 int uniform_location = _shader->get_uniforms().at(_uniform_at_index("spot_light_enabled", i));
-                glUniform1i(uniform_location, spot_light->is_enabled());
+                gl::Uniform1i(uniform_location, spot_light->is_enabled());
 
                 uniform_location = _shader->get_uniforms().at(_uniform_at_index("spot_light_two_sided", i));
-                glUniform1i(uniform_location, spot_light->is_two_sided());
+                gl::Uniform1i(uniform_location, spot_light->is_two_sided());
 
                 uniform_location = _shader->get_uniforms().at(_uniform_at_index("spot_light_view_position", i));
-                glUniform3fv(
+                gl::Uniform3fv(
                     uniform_location,
                     1, glm::value_ptr(camera->get_view_matrix() * spot_light->get_world_matrix() * glm::vec4(spot_light->get_position(), 1.0f))
                 );
 
                 uniform_location = _shader->get_uniforms().at(_uniform_at_index("spot_light_view_direction", i));
-                glUniform3fv(
+                gl::Uniform3fv(
                     uniform_location,
                     1, glm::value_ptr(camera->get_view_matrix() * glm::vec4(spot_light->get_world_direction(), 0.0f))
                 );
 
                 uniform_location = _shader->get_uniforms().at(_uniform_at_index("spot_light_ambient_color", i));
-                glUniform3fv(
+                gl::Uniform3fv(
                     uniform_location,
                     1, glm::value_ptr(spot_light->get_ambient_color())
                 );
 
                 uniform_location = _shader->get_uniforms().at(_uniform_at_index("spot_light_diffuse_color", i));
-                glUniform3fv(
+                gl::Uniform3fv(
                     uniform_location,
                     1, glm::value_ptr(spot_light->get_diffuse_color())
                 );
 
                 uniform_location = _shader->get_uniforms().at(_uniform_at_index("spot_light_specular_color", i));
-                glUniform3fv(
+                gl::Uniform3fv(
                     uniform_location,
                     1, glm::value_ptr(spot_light->get_specular_color())
                 );
 
                 uniform_location = _shader->get_uniforms().at(_uniform_at_index("spot_light_exponent", i));
-                glUniform1f(uniform_location, spot_light->get_exponent());
+                gl::Uniform1f(uniform_location, spot_light->get_exponent());
 
                 uniform_location = _shader->get_uniforms().at(_uniform_at_index("spot_light_cutoff_angle_cosine", i));
-                glUniform1f(uniform_location, spot_light->get_cutoff_angle());
+                gl::Uniform1f(uniform_location, spot_light->get_cutoff_angle());
 
                 uniform_location = _shader->get_uniforms().at(_uniform_at_index("spot_light_intensity", i));
-                glUniform1f(uniform_location, spot_light->get_intensity());
+                gl::Uniform1f(uniform_location, spot_light->get_intensity());
 
                 uniform_location = _shader->get_uniforms().at(_uniform_at_index("spot_light_constant_attenuation", i));
-                glUniform1f(uniform_location, spot_light->get_constant_attenuation());
+                gl::Uniform1f(uniform_location, spot_light->get_constant_attenuation());
 
                 uniform_location = _shader->get_uniforms().at(_uniform_at_index("spot_light_linear_attenuation", i));
-                glUniform1f(uniform_location, spot_light->get_linear_attenuation());
+                gl::Uniform1f(uniform_location, spot_light->get_linear_attenuation());
 
                 uniform_location = _shader->get_uniforms().at(_uniform_at_index("spot_light_quadratic_attenuation", i));
-                glUniform1f(uniform_location, spot_light->get_quadratic_attenuation());
+                gl::Uniform1f(uniform_location, spot_light->get_quadratic_attenuation());
             }
 
             if (_texture1) {
                 _texture1->update(0);
 
                 int texture1_enabled_uniform_location{_shader->get_uniforms().at("texture1_enabled")};
-                glUniform1i(
+                gl::Uniform1i(
                     texture1_enabled_uniform_location,
                     static_cast<GLint>(_texture1->is_enabled())
                 );
 
                 if (_texture1->is_enabled()) {
                     int texture1_sampler_uniform_location{_shader->get_uniforms().at("texture1_sampler")};
-                    glUniform1i(texture1_sampler_uniform_location, 0);
+                    gl::Uniform1i(texture1_sampler_uniform_location, 0);
 
                     int texturing_mode1_uniform_location{_shader->get_uniforms().at("texturing_mode1")};
-                    glUniform1i(
+                    gl::Uniform1i(
                         texturing_mode1_uniform_location,
                         static_cast<GLint>(_texture1->get_mode())
                     );
 
                     int texture1_transformation_enabled_uniform_location{_shader->get_uniforms().at("texture1_transformation_enabled")};
-                    glUniform1i(
+                    gl::Uniform1i(
                         texture1_transformation_enabled_uniform_location,
                         static_cast<GLint>(_texture1->is_transformation_enabled())
                     );
 
                     int texture1_transformation_matrix_uniform_location{_shader->get_uniforms().at("texture1_transformation_matrix")};
-                    glUniformMatrix4fv(
+                    gl::UniformMatrix4fv(
                         texture1_transformation_matrix_uniform_location,
                         1, GL_FALSE,
                         glm::value_ptr(_texture1->get_transformation_matrix())
@@ -417,29 +427,29 @@ namespace asr
                 _texture2->update(1);
 
                 int texture2_enabled_uniform_location{_shader->get_uniforms().at("texture2_enabled")};
-                glUniform1i(
+                gl::Uniform1i(
                     texture2_enabled_uniform_location,
                     static_cast<GLint>(_texture2->is_enabled())
                 );
 
                 if (_texture2->is_enabled()) {
                     int texture2_sampler_uniform_location{_shader->get_uniforms().at("texture2_sampler")};
-                    glUniform1i(texture2_sampler_uniform_location, 1);
+                    gl::Uniform1i(texture2_sampler_uniform_location, 1);
 
                     int texturing_mode2_uniform_location{_shader->get_uniforms().at("texturing_mode2")};
-                    glUniform1i(
+                    gl::Uniform1i(
                         texturing_mode2_uniform_location,
                         static_cast<GLint>(_texture2->get_mode())
                     );
 
                     int texture2_transformation_enabled_uniform_location{_shader->get_uniforms().at("texture2_transformation_enabled")};
-                    glUniform1i(
+                    gl::Uniform1i(
                         texture2_transformation_enabled_uniform_location,
                         static_cast<GLint>(_texture2->is_transformation_enabled())
                     );
 
                     int texture2_transformation_matrix_uniform_location{_shader->get_uniforms().at("texture2_transformation_matrix")};
-                    glUniformMatrix4fv(
+                    gl::UniformMatrix4fv(
                         texture2_transformation_matrix_uniform_location,
                         1, GL_FALSE,
                         glm::value_ptr(_texture2->get_transformation_matrix())
@@ -451,40 +461,45 @@ namespace asr
                 _texture1_normals->update(2);
 
                 int texture1_normals_enabled_uniform_location{_shader->get_uniforms().at("texture1_normals_enabled")};
-                glUniform1i(
+                gl::Uniform1i(
                     texture1_normals_enabled_uniform_location,
                     static_cast<GLint>(_texture1_normals->is_enabled())
                 );
 
                 if (_texture1_normals->is_enabled()) {
                     int texture1_normals_sampler_uniform_location{_shader->get_uniforms().at("texture1_normals_sampler")};
-                    glUniform1i(texture1_normals_sampler_uniform_location, 2);
+                    gl::Uniform1i(texture1_normals_sampler_uniform_location, 2);
                 }
             }
 
             int fog_enabled_uniform_location{_shader->get_uniforms().at("fog_enabled")};
-            glUniform1i(fog_enabled_uniform_location, static_cast<GLint>(_fog_enabled));
+            gl::Uniform1i(fog_enabled_uniform_location, static_cast<GLint>(_fog_enabled));
 
             int fog_type_uniform_location{_shader->get_uniforms().at("fog_type")};
-            glUniform1i(fog_type_uniform_location, static_cast<GLint>(_fog_type));
+            gl::Uniform1i(fog_type_uniform_location, static_cast<GLint>(_fog_type));
 
             int fog_depth_uniform_location{_shader->get_uniforms().at("fog_depth")};
-            glUniform1i(fog_depth_uniform_location, static_cast<GLint>(_fog_depth));
+            gl::Uniform1i(fog_depth_uniform_location, static_cast<GLint>(_fog_depth));
 
             int fog_color_uniform_location{_shader->get_uniforms().at("fog_color")};
-            glUniform3fv(
+            gl::Uniform3fv(
                 fog_color_uniform_location,
                 1, glm::value_ptr(_fog_color)
             );
 
             int fog_far_minus_near_plane_uniform_location{_shader->get_uniforms().at("fog_far_minus_near_plane")};
-            glUniform1f(fog_far_minus_near_plane_uniform_location, _fog_far_plane - _fog_near_plane);
+            gl::Uniform1f(fog_far_minus_near_plane_uniform_location, _fog_far_plane - _fog_near_plane);
 
             int fog_far_plane_uniform_location{_shader->get_uniforms().at("fog_far_plane")};
-            glUniform1f(fog_far_plane_uniform_location, _fog_far_plane);
+            gl::Uniform1f(fog_far_plane_uniform_location, _fog_far_plane);
 
             int fog_density_uniform_location{_shader->get_uniforms().at("fog_density")};
-            glUniform1f(fog_density_uniform_location, _fog_density);
+            gl::Uniform1f(fog_density_uniform_location, _fog_density);
+        }
+
+        void prepare_shader(const std::shared_ptr<Scene> &scene) final
+        {
+            _update_light_uniforms_if_necessary(scene);
         }
 
         void use() final
@@ -615,13 +630,13 @@ namespace asr
                     }
                 }
 
-                _shader->set_fragment_shader_source(
+                _shader->set_fragment_shader_preamble(
                     "#define DIRECTIONAL_LIGHT_COUNT " + std::to_string(directional_light_count) + "\n" +
                     "#define POINT_LIGHT_COUNT "       + std::to_string(point_light_count)       + "\n" +
-                    "#define SPOT_LIGHT_COUNT "        + std::to_string(spot_light_count)        + "\n\n" +
-                    _fragment_shader_source
+                    "#define SPOT_LIGHT_COUNT "        + std::to_string(spot_light_count)        + "\n\n"
                 );
-                _shader->compile();
+                _shader->cleanup();
+                _shader->submit();
 
                 _previous_directional_light_count = directional_light_count;
                 _previous_point_light_count = point_light_count;
@@ -731,9 +746,6 @@ namespace asr
             return GL_CW;
         }
 
-        std::string _vertex_shader_source;
-        std::string _fragment_shader_source;
-
         size_t _previous_directional_light_count{1};
         size_t _previous_point_light_count{1};
         size_t _previous_spot_light_count{0};
@@ -4,10 +4,12 @@
 #include "renderer/shader.h"
 #include "scene/scene.h"
 #include "objects/mesh.h"
+#include "textures/texture.h"
 
 #include <glm/glm.hpp>
 
 #include <memory>
+#include <vector>
 
 namespace asr
 {
@@ -359,6 +361,14 @@ namespace asr
             _overlay_priority = overlay_priority;
         }
 
+        /* The textures the material samples, e.g. to keep them resident while a recorded command buffer draws them. */
+        [[nodiscard]] virtual std::vector<std::shared_ptr<Texture>> get_textures() const
+        {
+            return {};
+        }
+
+        virtual void prepare_shader(const std::shared_ptr<Scene> &scene) {}
+
         virtual void update(std::shared_ptr<Scene> scene, std::shared_ptr<Mesh> mesh) = 0;
 
         virtual void use() = 0;
@@ -91,6 +91,16 @@ namespace asr
             _texture2 = texture_2;
         }
 
+        [[nodiscard]] std::vector<std::shared_ptr<Texture>> get_textures() const override
+        {
+            std::vector<std::shared_ptr<Texture>> textures;
+            for (const auto &texture : {_texture1, _texture1_normals, _texture2}) {
+                if (texture) { textures.push_back(texture); }
+            }
+
+            return textures;
+        }
+
     protected:
         glm::vec3 _ambient_color{0.0f};
         glm::vec4 _diffuse_color{1.0f};
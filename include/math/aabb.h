@@ -69,48 +69,22 @@ namespace asr
             return _size_halved;
         }
 
+        /* Arvo's method: every column of the matrix moves the bounds by the smaller and the larger of its products
+           with the minimum and the maximum, which gives the bounds of all eight transformed corners at the cost
+           of transforming two. Expects an affine transformation. */
         void transform(glm::mat4 transformation_matrix)
         {
-            glm::vec4 points[] = {
-                transformation_matrix * glm::vec4(_minimum, 1.0f),
-                transformation_matrix * glm::vec4(_minimum.x, _minimum.y, _maximum.z, 1.0f),
-                transformation_matrix * glm::vec4(_minimum.x, _maximum.y, _minimum.z, 1.0f),
-                transformation_matrix * glm::vec4(_minimum.x, _maximum.y, _maximum.z, 1.0f),
-                transformation_matrix * glm::vec4(_maximum.x, _minimum.y, _minimum.z, 1.0f),
-                transformation_matrix * glm::vec4(_maximum.x, _minimum.y, _maximum.z, 1.0f),
-                transformation_matrix * glm::vec4(_maximum.x, _maximum.y, _minimum.z, 1.0f),
-                transformation_matrix * glm::vec4(_maximum, 1.0f),
-            };
-
-            _minimum.x = INFINITY;
-            _minimum.y = INFINITY;
-            _minimum.z = INFINITY;
-
-            _maximum.x = -INFINITY;
-            _maximum.y = -INFINITY;
-            _maximum.z = -INFINITY;
-
-            for (auto point : points) {
-                if (_minimum.x > point.x) {
-                    _minimum.x = point.x;
-                }
-                if (_minimum.y > point.y) {
-                    _minimum.y = point.y;
-                }
-                if (_minimum.z > point.z) {
-                    _minimum.z = point.z;
-                }
-
-                if (_maximum.x < point.x) {
-                    _maximum.x = point.x;
-                }
-                if (_maximum.y < point.y) {
-                    _maximum.y = point.y;
-                }
-                if (_maximum.z < point.z) {
-                    _maximum.z = point.z;
-                }
+            glm::vec3 minimum{transformation_matrix[3]};
+            glm::vec3 maximum{minimum};
+            for (int i = 0; i < 3; ++i) {
+                glm::vec3 column{transformation_matrix[i]};
+                glm::vec3 a = column * _minimum[i];
+                glm::vec3 b = column * _maximum[i];
+                minimum += glm::min(a, b);
+                maximum += glm::max(a, b);
             }
+            _minimum = minimum;
+            _maximum = maximum;
 
             _box_was_changed = true;
         }
@@ -135,7 +109,7 @@ namespace asr
 
         void _update_supporting_values()
         {
-            _center = _maximum + _minimum * 0.5f;
+            _center = (_maximum + _minimum) * 0.5f;
             _size = _maximum - _minimum;
             _size_halved = _size * 0.5f;
 
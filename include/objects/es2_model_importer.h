@@ -0,0 +1,31 @@
+#ifndef ES2_MODEL_IMPORTER_H
+#define ES2_MODEL_IMPORTER_H
+
+#include "objects/model_importer.h"
+#include "geometries/es2_geometry.h"
+#include "materials/es2_phong_material.h"
+
+#include <memory>
+#include <utility>
+
+namespace asr
+{
+    class ES2ModelImporter final : public ModelImporter
+    {
+    public:
+        using ModelImporter::ModelImporter;
+
+    protected:
+        std::shared_ptr<Geometry> _create_geometry(std::vector<unsigned int> indices, std::vector<Vertex> vertices) final
+        {
+            return std::make_shared<ES2Geometry>(std::move(indices), std::move(vertices));
+        }
+
+        std::shared_ptr<PhongMaterial> _create_phong_material() final
+        {
+            return std::make_shared<ES2PhongMaterial>();
+        }
+    };
+}
+
+#endif
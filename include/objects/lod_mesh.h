@@ -0,0 +1,173 @@
+#ifndef LOD_MESH_H
+#define LOD_MESH_H
+
+#include "objects/mesh.h"
+#include "objects/camera.h"
+#include "math/sphere.h"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <memory>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <algorithm>
+#include <iostream>
+#include <cstdlib>
+
+namespace asr
+{
+    /* A mesh with several geometries of decreasing detail. The renderer selects one every frame from the height
+       that the bounding sphere of the mesh covers on the screen, so `get_geometry` returns the selected level. */
+    class LODMesh : public Mesh
+    {
+    public:
+        /* A level is used while the mesh covers at least `minimum_screen_size` pixels. */
+        struct Level
+        {
+            std::shared_ptr<Geometry> geometry;
+            float minimum_screen_size;
+        };
+
+        /* `levels` go from the finest to the coarsest with decreasing minimum screen sizes. The coarsest level
+           is also used below its minimum size. */
+        LODMesh(std::vector<Level> levels, std::shared_ptr<Material> material,
+                const glm::vec3 &position = glm::vec4(0.0f),
+                const glm::vec3 &rotation = glm::vec4(0.0f),
+                const glm::vec3 &scale = glm::vec4(1.0f),
+                std::weak_ptr<Object> parent = {})
+            : Mesh(_get_finest_geometry(levels), std::move(material), position, rotation, scale, std::move(parent)),
+              _levels{std::move(levels)}
+        {
+            _name = "untitled LOD mesh";
+            update_bounding_sphere();
+        }
+
+        [[nodiscard]] const std::vector<Level> &get_levels() const
+        {
+            return _levels;
+        }
+
+        [[nodiscard]] size_t get_level() const
+        {
+            return _level;
+        }
+
+        /* The relative margin around every level's minimum screen size that has to be crossed to switch levels,
+           so that a mesh at the boundary does not switch back and forth. */
+        [[nodiscard]] float get_hysteresis() const
+        {
+            return _hysteresis;
+        }
+
+        void set_hysteresis(float hysteresis)
+        {
+            _hysteresis = hysteresis;
+        }
+
+        /* The height in pixels the mesh covered at the last selection. */
+        [[nodiscard]] float get_screen_size() const
+        {
+            return _screen_size;
+        }
+
+        [[nodiscard]] const Sphere &get_bounding_sphere() const
+        {
+            return _bounding_sphere;
+        }
+
+        /* Must be called when the vertices of the finest level change. */
+        void update_bounding_sphere()
+        {
+            const Geometry &geometry = *_levels.front().geometry;
+            const Vertex *vertices = geometry.get_vertex_data();
+            size_t vertex_count = geometry.get_vertex_count();
+            if (vertex_count == 0) {
+                _bounding_sphere = Sphere{glm::vec3{0.0f}, 0.0f};
+                return;
+            }
+
+            glm::vec3 minimum{std::numeric_limits<float>::max()}, maximum{std::numeric_limits<float>::lowest()};
+            for (size_t i = 0; i < vertex_count; ++i) {
+                minimum = glm::min(minimum, vertices[i].position);
+                maximum = glm::max(maximum, vertices[i].position);
+            }
+            glm::vec3 center = (minimum + maximum) * 0.5f;
+            float squared_radius{0.0f};
+            for (size_t i = 0; i < vertex_count; ++i) {
+                glm::vec3 offset = vertices[i].position - center;
+                squared_radius = std::max(squared_radius, glm::dot(offset, offset));
+            }
+            _bounding_sphere = Sphere{center, std::sqrt(squared_radius)};
+        }
+
+        /* Projects the bounding sphere with the camera onto a viewport `viewport_height` pixels high. */
+        size_t select_level(Camera &camera, float viewport_height)
+        {
+            Sphere sphere = _bounding_sphere;
+            sphere.transform(get_world_matrix());
+
+            float size = sphere.get_radius() * camera.get_projection_matrix()[1][1] * viewport_height;
+            if (camera.is_perspective()) {
+                float distance = glm::length(sphere.get_center() - camera.get_world_position());
+                size = distance > sphere.get_radius() ? size / distance : std::numeric_limits<float>::max();
+            }
+            _screen_size = size;
+
+            while (_level > 0 && size >= _levels[_level - 1].minimum_screen_size * (1.0f + _hysteresis)) {
+                --_level;
+            }
+            while (_level + 1 < _levels.size() && size < _levels[_level].minimum_screen_size * (1.0f - _hysteresis)) {
+                ++_level;
+            }
+            _geometry = _levels[_level].geometry;
+
+            return _level;
+        }
+
+        [[nodiscard]] size_t get_triangle_count() const
+        {
+            return _count_triangles(*_levels[_level].geometry);
+        }
+
+        /* The triangles drawn at the finest level, which less the current count is what the selection saves. */
+        [[nodiscard]] size_t get_full_triangle_count() const
+        {
+            return _count_triangles(*_levels.front().geometry);
+        }
+
+    private:
+        std::vector<Level> _levels;
+        size_t _level{0};
+        float _hysteresis{0.1f};
+        float _screen_size{0.0f};
+        Sphere _bounding_sphere{glm::vec3{0.0f}, 0.0f};
+
+        static const std::shared_ptr<Geometry> &_get_finest_geometry(const std::vector<Level> &levels)
+        {
+            if (levels.empty()) {
+                std::cerr << "A LOD mesh needs at least one level" << std::endl;
+                std::exit(-1);
+            }
+
+            return levels.front().geometry;
+        }
+
+        static size_t _count_triangles(const Geometry &geometry)
+        {
+            size_t index_count = geometry.get_index_count();
+            switch (geometry.get_type()) {
+                case Geometry::Type::Triangles:
+                    return index_count / 3;
+                case Geometry::Type::TriangleFan:
+                case Geometry::Type::TriangleStrip:
+                    return index_count >= 3 ? index_count - 2 : 0;
+                default:
+                    return 0;
+            }
+        }
+    };
+}
+
+#endif
@@ -33,7 +33,7 @@ namespace asr
             return _material;
         }
 
-    private:
+    protected:
         std::shared_ptr<Geometry> _geometry;
         std::shared_ptr<Material> _material;
     };
@@ -0,0 +1,1295 @@
+#ifndef MODEL_IMPORTER_H
+#define MODEL_IMPORTER_H
+
+#include "objects/object.h"
+#include "objects/mesh.h"
+#include "geometries/geometry.h"
+#include "materials/phong_material.h"
+#include "textures/texture.h"
+#include "textures/texture_loader.h"
+#include "utilities/json.h"
+#include "utilities/mapped_file.h"
+#include "utilities/thread_pool.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <glm/gtx/matrix_decompose.hpp>
+
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <tuple>
+#include <string>
+#include <vector>
+#include <memory>
+#include <utility>
+#include <functional>
+#include <iostream>
+#include <algorithm>
+#include <filesystem>
+#include <unordered_map>
+
+namespace asr
+{
+    /* Builds object hierarchies from glTF 2.0 (.gltf and .glb) and Wavefront OBJ files. Primitives are decoded,
+       get their tangents and are turned into geometries in parallel on the thread pool, images are decoded by
+       the texture loader. Geometries and textures with the same content are shared, also between the models
+       an importer imports, as long as any of them is alive. */
+    class ModelImporter
+    {
+    public:
+        explicit ModelImporter(TextureLoader &texture_loader, ThreadPool &thread_pool = ThreadPool::get_shared_instance())
+            : _texture_loader{texture_loader}, _thread_pool{thread_pool}
+        {}
+
+        ModelImporter(const ModelImporter &other) = delete;
+        ModelImporter& operator=(const ModelImporter &other) = delete;
+
+        virtual ~ModelImporter() = default;
+
+        bool import(const std::string &path, std::shared_ptr<Object> &model, std::string &error)
+        {
+            std::string extension = std::filesystem::path{path}.extension().string();
+            std::transform(std::begin(extension), std::end(extension), std::begin(extension), [](char character) {
+                return static_cast<char>(std::tolower(character));
+            });
+
+            bool imported{false};
+            if (extension == ".gltf" || extension == ".glb") {
+                imported = _import_gltf(path, model, error);
+            } else if (extension == ".obj") {
+                imported = _import_obj(path, model, error);
+            } else {
+                error = "Unsupported model format";
+            }
+            if (!imported) {
+                error = "Failed to import '" + path + "': " + error;
+            }
+
+            return imported;
+        }
+
+        std::shared_ptr<Object> import(const std::string &path)
+        {
+            std::shared_ptr<Object> model;
+            std::string error;
+            if (!import(path, model, error)) {
+                std::cerr << error << std::endl;
+                std::exit(-1);
+            }
+
+            return model;
+        }
+
+        /* Tangents and binormals are generated for primitives with normals and texture coordinates. */
+        [[nodiscard]] bool is_tangent_generation_enabled() const
+        {
+            return _tangent_generation_enabled;
+        }
+
+        void set_tangent_generation_enabled(bool tangent_generation_enabled)
+        {
+            _tangent_generation_enabled = tangent_generation_enabled;
+        }
+
+        /* When disabled, materials get no textures and no images are read, e.g. for tools that only need geometry. */
+        [[nodiscard]] bool is_texture_loading_enabled() const
+        {
+            return _texture_loading_enabled;
+        }
+
+        void set_texture_loading_enabled(bool texture_loading_enabled)
+        {
+            _texture_loading_enabled = texture_loading_enabled;
+        }
+
+    protected:
+        /* Called on the threads of the pool. The data is moved out of the decoded primitive. */
+        virtual std::shared_ptr<Geometry> _create_geometry(std::vector<unsigned int> indices, std::vector<Vertex> vertices) = 0;
+
+        virtual std::shared_ptr<PhongMaterial> _create_phong_material() = 0;
+
+    private:
+        struct Primitive
+        {
+            std::string name;
+            Geometry::Type type{Geometry::Triangles};
+            std::vector<unsigned int> indices;
+            std::vector<Vertex> vertices;
+            bool has_normals{false};
+            bool has_texture_coordinates{false};
+            size_t material{SIZE_MAX};
+
+            uint64_t hash{0};
+            size_t duplicate_of{SIZE_MAX};
+            std::shared_ptr<Geometry> geometry;
+            std::string error;
+        };
+
+        struct Buffer
+        {
+            std::shared_ptr<const void> owner;
+            const uint8_t *data;
+            size_t size;
+        };
+
+        TextureLoader &_texture_loader;
+        ThreadPool &_thread_pool;
+        bool _tangent_generation_enabled{true};
+        bool _texture_loading_enabled{true};
+
+        std::unordered_map<std::string, std::weak_ptr<Texture>> _textures;
+        std::unordered_multimap<uint64_t, std::weak_ptr<Geometry>> _geometries;
+
+        /* glTF */
+
+        bool _import_gltf(const std::string &path, std::shared_ptr<Object> &model, std::string &error)
+        {
+            std::shared_ptr<MappedFile> file = MappedFile::open(path, error);
+            if (!file) {
+                return false;
+            }
+
+            JSONValue document;
+            std::vector<Buffer> buffers;
+            if (file->get_size() >= 12 && std::memcmp(file->get_data(), "glTF", 4) == 0) {
+                if (!_read_glb(file, document, buffers, error)) {
+                    return false;
+                }
+            } else if (!JSONValue::parse(reinterpret_cast<const char *>(file->get_data()), file->get_size(), document, error)) {
+                return false;
+            }
+
+            std::filesystem::path directory = std::filesystem::path{path}.parent_path();
+            const JSONValue &buffer_descriptions = document["buffers"];
+            for (size_t i = buffers.size(); i < buffer_descriptions.size(); ++i) {
+                Buffer buffer{};
+                if (!_read_uri(directory, buffer_descriptions[i]["uri"].get_string(), buffer, error)) {
+                    return false;
+                }
+                if (buffer.size < buffer_descriptions[i]["byteLength"].get_index(0)) {
+                    error = "Buffer " + std::to_string(i) + " is shorter than its byte length";
+                    return false;
+                }
+                buffers.push_back(std::move(buffer));
+            }
+
+            /* Every primitive of every mesh is decoded once, however many nodes use the mesh. */
+            std::vector<Primitive> primitives;
+            std::vector<size_t> mesh_offsets;
+            const JSONValue &meshes = document["meshes"];
+            for (size_t i = 0; i < meshes.size(); ++i) {
+                mesh_offsets.push_back(primitives.size());
+                const JSONValue &mesh_primitives = meshes[i]["primitives"];
+                for (size_t j = 0; j < mesh_primitives.size(); ++j) {
+                    Primitive primitive;
+                    primitive.name = meshes[i]["name"].get_string();
+                    primitive.material = mesh_primitives[j]["material"].get_index();
+                    primitives.push_back(std::move(primitive));
+                }
+            }
+            mesh_offsets.push_back(primitives.size());
+
+            _thread_pool.parallel_for(0, meshes.size(), 1, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    for (size_t j = mesh_offsets[i]; j < mesh_offsets[i + 1]; ++j) {
+                        _decode_gltf_primitive(document, buffers, meshes[i]["primitives"][j - mesh_offsets[i]], primitives[j]);
+                    }
+                }
+            });
+            if (!_create_geometries(primitives, error)) {
+                return false;
+            }
+
+            std::vector<std::shared_ptr<Texture>> textures(document["textures"].size());
+            std::vector<std::shared_ptr<PhongMaterial>> materials(document["materials"].size());
+            for (size_t i = 0; i < materials.size(); ++i) {
+                materials[i] = _create_gltf_material(path, directory, document, buffers, document["materials"][i], textures);
+            }
+            std::shared_ptr<PhongMaterial> default_material;
+
+            model = std::make_shared<Object>(std::filesystem::path{path}.stem().string());
+            auto create_meshes = [&](size_t mesh) {
+                std::vector<std::shared_ptr<Mesh>> objects;
+                for (size_t i = mesh_offsets[mesh]; i < mesh_offsets[mesh + 1]; ++i) {
+                    std::shared_ptr<Material> material;
+                    if (primitives[i].material < materials.size()) {
+                        material = materials[primitives[i].material];
+                    } else {
+                        if (!default_material) {
+                            default_material = _create_phong_material();
+                        }
+                        material = default_material;
+                    }
+                    auto object = std::make_shared<Mesh>(primitives[i].geometry, material);
+                    object->set_name(primitives[i].name);
+                    objects.push_back(object);
+                }
+                return objects;
+            };
+
+            const JSONValue &nodes = document["nodes"];
+            std::vector<bool> visited(nodes.size(), false);
+            std::function<void(const std::shared_ptr<Object> &, size_t)> add_node;
+            add_node = [&](const std::shared_ptr<Object> &parent, size_t node_index) {
+                if (node_index >= nodes.size() || visited[node_index]) {
+                    return;
+                }
+                visited[node_index] = true;
+                const JSONValue &node = nodes[node_index];
+
+                size_t mesh = node["mesh"].get_index();
+                std::vector<std::shared_ptr<Mesh>> mesh_objects;
+                if (mesh < meshes.size()) {
+                    mesh_objects = create_meshes(mesh);
+                }
+
+                std::shared_ptr<Object> object;
+                if (mesh_objects.size() == 1) {
+                    object = mesh_objects.front();
+                    mesh_objects.clear();
+                } else {
+                    object = std::make_shared<Object>();
+                }
+                object->set_name(node["name"].get_string());
+                _set_gltf_transform(*object, node);
+                parent->add_child(object);
+
+                for (const auto &mesh_object : mesh_objects) {
+                    object->add_child(mesh_object);
+                }
+                const JSONValue &children = node["children"];
+                for (size_t i = 0; i < children.size(); ++i) {
+                    add_node(object, children[i].get_index());
+                }
+            };
+
+            const JSONValue &scenes = document["scenes"];
+            if (scenes.size() > 0) {
+                size_t scene = std::min(document["scene"].get_index(0), scenes.size() - 1);
+                const JSONValue &root_nodes = scenes[scene]["nodes"];
+                for (size_t i = 0; i < root_nodes.size(); ++i) {
+                    add_node(model, root_nodes[i].get_index());
+                }
+            } else {
+                std::vector<bool> child(nodes.size(), false);
+                for (size_t i = 0; i < nodes.size(); ++i) {
+                    const JSONValue &children = nodes[i]["children"];
+                    for (size_t j = 0; j < children.size(); ++j) {
+                        size_t child_index = children[j].get_index();
+                        if (child_index < child.size()) {
+                            child[child_index] = true;
+                        }
+                    }
+                }
+                for (size_t i = 0; i < nodes.size(); ++i) {
+                    if (!child[i]) {
+                        add_node(model, i);
+                    }
+                }
+            }
+
+            return true;
+        }
+
+        static bool _read_glb(const std::shared_ptr<MappedFile> &file, JSONValue &document, std::vector<Buffer> &buffers, std::string &error)
+        {
+            const uint8_t *data = file->get_data();
+            size_t size = std::min(file->get_size(), static_cast<size_t>(_read_uint32(data + 8)));
+
+            bool has_document{false};
+            for (size_t offset = 12; offset + 8 <= size;) {
+                size_t chunk_size = _read_uint32(data + offset);
+                uint32_t chunk_type = _read_uint32(data + offset + 4);
+                offset += 8;
+                if (chunk_size > size - offset) {
+                    error = "A GLB chunk exceeds the file";
+                    return false;
+                }
+
+                if (chunk_type == 0x4E4F534Au) {
+                    if (!JSONValue::parse(reinterpret_cast<const char *>(data + offset), chunk_size, document, error)) {
+                        return false;
+                    }
+                    has_document = true;
+                } else if (chunk_type == 0x004E4942u && buffers.empty()) {
+                    buffers.push_back(Buffer{file, data + offset, chunk_size});
+                }
+                offset += (chunk_size + 3) / 4 * 4;
+            }
+            if (!has_document) {
+                error = "The GLB file has no JSON chunk";
+                return false;
+            }
+
+            return true;
+        }
+
+        static uint32_t _read_uint32(const uint8_t *data)
+        {
+            return static_cast<uint32_t>(data[0]) | static_cast<uint32_t>(data[1]) << 8u |
+                   static_cast<uint32_t>(data[2]) << 16u | static_cast<uint32_t>(data[3]) << 24u;
+        }
+
+        /* Reads a data URI or a file relative to the model. */
+        static bool _read_uri(const std::filesystem::path &directory, const std::string &uri, Buffer &buffer, std::string &error)
+        {
+            if (uri.compare(0, 5, "data:") == 0) {
+                size_t comma = uri.find(',');
+                if (comma == std::string::npos || comma < 12 || uri.compare(comma - 7, 7, ";base64") != 0) {
+                    error = "Only base64 data URIs are supported";
+                    return false;
+                }
+                auto data = std::make_shared<std::vector<uint8_t>>(_decode_base64(uri.c_str() + comma + 1, uri.size() - comma - 1));
+                buffer = Buffer{data, data->data(), data->size()};
+                return true;
+            }
+
+            std::shared_ptr<MappedFile> file = MappedFile::open((directory / _decode_uri(uri)).string(), error);
+            if (!file) {
+                return false;
+            }
+            buffer = Buffer{file, file->get_data(), file->get_size()};
+
+            return true;
+        }
+
+        static std::string _decode_uri(const std::string &uri)
+        {
+            std::string path;
+            for (size_t i = 0; i < uri.size(); ++i) {
+                if (uri[i] == '%' && i + 2 < uri.size()) {
+                    path += static_cast<char>(std::strtol(uri.substr(i + 1, 2).c_str(), nullptr, 16));
+                    i += 2;
+                } else {
+                    path += uri[i];
+                }
+            }
+
+            return path;
+        }
+
+        static std::vector<uint8_t> _decode_base64(const char *data, size_t size)
+        {
+            std::vector<uint8_t> bytes;
+            bytes.reserve(size / 4 * 3);
+
+            uint32_t bits{0};
+            unsigned int bit_count{0};
+            for (size_t i = 0; i < size; ++i) {
+                char character = data[i];
+                uint32_t value;
+                if (character >= 'A' && character <= 'Z') {
+                    value = static_cast<uint32_t>(character - 'A');
+                } else if (character >= 'a' && character <= 'z') {
+                    value = static_cast<uint32_t>(character - 'a' + 26);
+                } else if (character >= '0' && character <= '9') {
+                    value = static_cast<uint32_t>(character - '0' + 52);
+                } else if (character == '+' || character == '-') {
+                    value = 62;
+                } else if (character == '/' || character == '_') {
+                    value = 63;
+                } else {
+                    continue;
+                }
+
+                bits = (bits << 6u) | value;
+                bit_count += 6;
+                if (bit_count >= 8) {
+                    bit_count -= 8;
+                    bytes.push_back(static_cast<uint8_t>(bits >> bit_count));
+                }
+            }
+
+            return bytes;
+        }
+
+        /* Returns a pointer to the first element of an accessor, its number of components and the distance between
+           elements, or nullptr with an error if the accessor does not fit into its buffer view. */
+        static const uint8_t *_get_accessor_data(
+            const JSONValue &document, const std::vector<Buffer> &buffers, const JSONValue &accessor,
+            size_t &component_count, size_t &stride, size_t &count, std::string &error
+        ) {
+            static const std::unordered_map<std::string, size_t> component_counts{
+                {"SCALAR", 1}, {"VEC2", 2}, {"VEC3", 3}, {"VEC4", 4}
+            };
+            auto components = component_counts.find(accessor["type"].get_string());
+            if (components == std::end(component_counts)) {
+                error = "Unsupported accessor type '" + accessor["type"].get_string() + "'";
+                return nullptr;
+            }
+            component_count = components->second;
+            if (accessor.has("sparse")) {
+                error = "Sparse accessors are not supported";
+                return nullptr;
+            }
+
+            size_t component_size = _get_component_size(static_cast<unsigned int>(accessor["componentType"].get_index(0)));
+            if (component_size == 0) {
+                error = "Unsupported accessor component type";
+                return nullptr;
+            }
+
+            count = accessor["count"].get_index(0);
+            const JSONValue &buffer_view = document["bufferViews"][accessor["bufferView"].get_index()];
+            size_t buffer = buffer_view["buffer"].get_index();
+            if (buffer >= buffers.size()) {
+                error = "An accessor has no valid buffer view";
+                return nullptr;
+            }
+
+            size_t element_size = components->second * component_size;
+            stride = buffer_view["byteStride"].get_index(element_size);
+            if (stride < element_size) {
+                error = "An accessor has elements that overlap";
+                return nullptr;
+            }
+            /* Written without multiplications so that huge counts or strides can not overflow past the check. */
+            size_t view_offset = buffer_view["byteOffset"].get_index(0);
+            size_t view_length = buffer_view["byteLength"].get_index(0);
+            size_t offset = accessor["byteOffset"].get_index(0);
+            if (view_offset > buffers[buffer].size || view_length > buffers[buffer].size - view_offset ||
+                (count > 0 && (offset > view_length || element_size > view_length - offset ||
+                               count - 1 > (view_length - offset - element_size) / stride))) {
+                error = "An accessor exceeds its buffer";
+                return nullptr;
+            }
+
+            return buffers[buffer].data + view_offset + offset;
+        }
+
+        static size_t _get_component_size(unsigned int component_type)
+        {
+            switch (component_type) {
+                case 5120:
+                case 5121:
+                    return 1;
+                case 5122:
+                case 5123:
+                    return 2;
+                case 5125:
+                case 5126:
+                    return 4;
+                default:
+                    return 0;
+            }
+        }
+
+        /* Reads up to `component_count` components of every element as floats, converting normalized integers.
+           Components the accessor does not have are 0, or 1 for w, so that e.g. RGB colors are opaque. */
+        static bool _read_accessor(
+            const JSONValue &document, const std::vector<Buffer> &buffers, size_t accessor_index,
+            size_t component_count, std::vector<glm::vec4> &values, std::string &error
+        ) {
+            const JSONValue &accessor = document["accessors"][accessor_index];
+            size_t accessor_component_count{0}, stride{0}, count{0};
+            const uint8_t *data = _get_accessor_data(document, buffers, accessor, accessor_component_count, stride, count, error);
+            if (!data) {
+                return false;
+            }
+            component_count = std::min(component_count, accessor_component_count);
+
+            auto component_type = static_cast<unsigned int>(accessor["componentType"].get_index(0));
+            size_t component_size = _get_component_size(component_type);
+            bool normalized = accessor["normalized"].get_boolean();
+            values.assign(count, glm::vec4{0.0f, 0.0f, 0.0f, 1.0f});
+            for (size_t i = 0; i < count; ++i) {
+                const uint8_t *element = data + i * stride;
+                for (size_t j = 0; j < component_count; ++j) {
+                    const uint8_t *component = element + j * component_size;
+                    float value;
+                    switch (component_type) {
+                        case 5120: {
+                            auto integer = static_cast<int8_t>(*component);
+                            value = normalized ? std::max(static_cast<float>(integer) / 127.0f, -1.0f) : static_cast<float>(integer);
+                            break;
+                        }
+                        case 5121:
+                            value = normalized ? static_cast<float>(*component) / 255.0f : static_cast<float>(*component);
+                            break;
+                        case 5122: {
+                            int16_t integer;
+                            std::memcpy(&integer, component, sizeof(integer));
+                            value = normalized ? std::max(static_cast<float>(integer) / 32767.0f, -1.0f) : static_cast<float>(integer);
+                            break;
+                        }
+                        case 5123: {
+                            uint16_t integer;
+                            std::memcpy(&integer, component, sizeof(integer));
+                            value = normalized ? static_cast<float>(integer) / 65535.0f : static_cast<float>(integer);
+                            break;
+                        }
+                        case 5125: {
+                            uint32_t integer;
+                            std::memcpy(&integer, component, sizeof(integer));
+                            value = static_cast<float>(integer);
+                            break;
+                        }
+                        default:
+                            std::memcpy(&value, component, sizeof(value));
+                            break;
+                    }
+                    values[i][static_cast<int>(j)] = value;
+                }
+            }
+
+            return true;
+        }
+
+        static bool _read_indices(
+            const JSONValue &document, const std::vector<Buffer> &buffers, size_t accessor_index,
+            std::vector<unsigned int> &indices, std::string &error
+        ) {
+            const JSONValue &accessor = document["accessors"][accessor_index];
+            size_t component_count{0}, stride{0}, count{0};
+            const uint8_t *data = _get_accessor_data(document, buffers, accessor, component_count, stride, count, error);
+            if (!data) {
+                return false;
+            }
+            if (component_count != 1) {
+                error = "Unsupported index accessor type '" + accessor["type"].get_string() + "'";
+                return false;
+            }
+
+            auto component_type = static_cast<unsigned int>(accessor["componentType"].get_index(0));
+            indices.resize(count);
+            for (size_t i = 0; i < count; ++i) {
+                const uint8_t *element = data + i * stride;
+                switch (component_type) {
+                    case 5121:
+                        indices[i] = *element;
+                        break;
+                    case 5123: {
+                        uint16_t index;
+                        std::memcpy(&index, element, sizeof(index));
+                        indices[i] = index;
+                        break;
+                    }
+                    case 5125:
+                        std::memcpy(&indices[i], element, sizeof(unsigned int));
+                        break;
+                    default:
+                        error = "Unsupported index component type";
+                        return false;
+                }
+            }
+
+            return true;
+        }
+
+        static void _decode_gltf_primitive(
+            const JSONValue &document, const std::vector<Buffer> &buffers, const JSONValue &description, Primitive &primitive
+        ) {
+            static const Geometry::Type types[]{
+                Geometry::Points, Geometry::Lines, Geometry::LineLoop, Geometry::LineStrip,
+                Geometry::Triangles, Geometry::TriangleStrip, Geometry::TriangleFan
+            };
+            size_t mode = description["mode"].get_index(4);
+            if (mode >= sizeof(types) / sizeof(types[0])) {
+                primitive.error = "Unsupported primitive mode " + std::to_string(mode);
+                return;
+            }
+            primitive.type = types[mode];
+
+            const JSONValue &attributes = description["attributes"];
+            std::vector<glm::vec4> values;
+            if (!attributes.has("POSITION")) {
+                primitive.error = "A primitive has no positions";
+                return;
+            }
+            if (!_read_accessor(document, buffers, attributes["POSITION"].get_index(), 3, values, primitive.error)) {
+                return;
+            }
+            primitive.vertices.resize(values.size());
+            for (size_t i = 0; i < values.size(); ++i) {
+                primitive.vertices[i].position = glm::vec3{values[i]};
+            }
+
+            auto read_attribute = [&](const char *name, size_t component_count, auto &&assign) {
+                if (!attributes.has(name)) {
+                    return false;
+                }
+                if (!_read_accessor(document, buffers, attributes[name].get_index(), component_count, values, primitive.error)) {
+                    return false;
+                }
+                for (size_t i = 0; i < std::min(values.size(), primitive.vertices.size()); ++i) {
+                    assign(primitive.vertices[i], values[i]);
+                }
+                return true;
+            };
+            primitive.has_normals = read_attribute("NORMAL", 3, [](Vertex &vertex, const glm::vec4 &value) {
+                vertex.normal = glm::vec3{value};
+            });
+            primitive.has_texture_coordinates = read_attribute("TEXCOORD_0", 2, [](Vertex &vertex, const glm::vec4 &value) {
+                vertex.texture1_coordinates = glm::vec4{value.x, value.y, 0.0f, 1.0f};
+            });
+            read_attribute("TEXCOORD_1", 2, [](Vertex &vertex, const glm::vec4 &value) {
+                vertex.texture2_coordinates = glm::vec4{value.x, value.y, 0.0f, 1.0f};
+            });
+            read_attribute("COLOR_0", 4, [](Vertex &vertex, const glm::vec4 &value) {
+                vertex.color = value;
+            });
+            if (!primitive.error.empty()) {
+                return;
+            }
+
+            if (description.has("indices")) {
+                if (!_read_indices(document, buffers, description["indices"].get_index(), primitive.indices, primitive.error)) {
+                    return;
+                }
+                for (unsigned int index : primitive.indices) {
+                    if (index >= primitive.vertices.size()) {
+                        primitive.error = "A primitive has indices outside of its vertices";
+                        return;
+                    }
+                }
+            } else {
+                primitive.indices.resize(primitive.vertices.size());
+                for (size_t i = 0; i < primitive.indices.size(); ++i) {
+                    primitive.indices[i] = static_cast<unsigned int>(i);
+                }
+            }
+        }
+
+        std::shared_ptr<PhongMaterial> _create_gltf_material(
+            const std::string &path, const std::filesystem::path &directory, const JSONValue &document,
+            const std::vector<Buffer> &buffers, const JSONValue &description, std::vector<std::shared_ptr<Texture>> &textures
+        ) {
+            auto get_texture = [&](const JSONValue &texture_info) -> std::shared_ptr<Texture> {
+                size_t texture = texture_info["index"].get_index();
+                if (!_texture_loading_enabled || texture >= textures.size()) {
+                    return nullptr;
+                }
+                if (!textures[texture]) {
+                    textures[texture] = _load_gltf_texture(path, directory, document, buffers, texture);
+                }
+                return textures[texture];
+            };
+
+            std::shared_ptr<PhongMaterial> material = _create_phong_material();
+            const JSONValue &pbr = description["pbrMetallicRoughness"];
+            const JSONValue &base_color_factor = pbr["baseColorFactor"];
+            glm::vec4 base_color{1.0f};
+            for (size_t i = 0; i < base_color_factor.size() && i < 4; ++i) {
+                base_color[static_cast<int>(i)] = base_color_factor[i].get_float(1.0f);
+            }
+            const JSONValue &emissive_factor = description["emissiveFactor"];
+            glm::vec4 emission_color{0.0f};
+            for (size_t i = 0; i < emissive_factor.size() && i < 3; ++i) {
+                emission_color[static_cast<int>(i)] = emissive_factor[i].get_float();
+            }
+
+            /* Phong parameters that look about like the metallic-roughness description. */
+            float metallic = pbr["metallicFactor"].get_float(1.0f);
+            float roughness = std::max(pbr["roughnessFactor"].get_float(1.0f), 0.01f);
+            material->set_ambient_color(glm::vec3{base_color});
+            material->set_diffuse_color(base_color);
+            material->set_emission_color(emission_color);
+            material->set_specular_color(glm::mix(glm::vec3{0.04f}, glm::vec3{base_color}, metallic));
+            material->set_specular_exponent(std::clamp(2.0f / std::pow(roughness, 4.0f) - 2.0f, 1.0f, 256.0f));
+
+            if (pbr.has("baseColorTexture")) {
+                material->set_texture_1(get_texture(pbr["baseColorTexture"]));
+            }
+            if (description.has("normalTexture")) {
+                material->set_texture_1_normals(get_texture(description["normalTexture"]));
+            }
+            if (description["alphaMode"].get_string() == "BLEND") {
+                material->set_blending_enabled(true);
+                material->set_transparent(true);
+            }
+            if (description["doubleSided"].get_boolean()) {
+                material->set_face_culling_enabled(false);
+            }
+
+            return material;
+        }
+
+        std::shared_ptr<Texture> _load_gltf_texture(
+            const std::string &path, const std::filesystem::path &directory, const JSONValue &document,
+            const std::vector<Buffer> &buffers, size_t texture
+        ) {
+            size_t image_index = document["textures"][texture]["source"].get_index();
+            const JSONValue &image = document["images"][image_index];
+            std::shared_ptr<Texture> result;
+            if (image.has("uri") && image["uri"].get_string().compare(0, 5, "data:") != 0) {
+                result = _load_texture_file((directory / _decode_uri(image["uri"].get_string())).string());
+            } else {
+                std::string error;
+                Buffer data{};
+                if (image.has("uri")) {
+                    if (!_read_uri(directory, image["uri"].get_string(), data, error)) {
+                        std::cerr << "Failed to read image " << image_index << " of '" << path << "': " << error << std::endl;
+                        return nullptr;
+                    }
+                } else {
+                    const JSONValue &buffer_view = document["bufferViews"][image["bufferView"].get_index()];
+                    size_t buffer = buffer_view["buffer"].get_index();
+                    size_t offset = buffer_view["byteOffset"].get_index(0), length = buffer_view["byteLength"].get_index(0);
+                    if (buffer >= buffers.size() || offset > buffers[buffer].size || length > buffers[buffer].size - offset) {
+                        std::cerr << "Image " << image_index << " of '" << path << "' exceeds its buffer" << std::endl;
+                        return nullptr;
+                    }
+                    data = Buffer{buffers[buffer].owner, buffers[buffer].data + offset, length};
+                }
+                result = _load_texture_data(path + "#images/" + std::to_string(image_index), data.data, data.size);
+            }
+
+            const JSONValue &sampler = document["samplers"][document["textures"][texture]["sampler"].get_index()];
+            if (result) {
+                result->set_wrap_mode_s(_convert_gltf_wrap_mode(sampler["wrapS"].get_index(10497)));
+                result->set_wrap_mode_t(_convert_gltf_wrap_mode(sampler["wrapT"].get_index(10497)));
+            }
+
+            return result;
+        }
+
+        static Texture::WrapMode _convert_gltf_wrap_mode(size_t wrap_mode)
+        {
+            switch (wrap_mode) {
+                case 33071:
+                    return Texture::ClampToEdge;
+                case 33648:
+                    return Texture::MirroredRepeat;
+                default:
+                    return Texture::Repeat;
+            }
+        }
+
+        static void _set_gltf_transform(Object &object, const JSONValue &node)
+        {
+            const JSONValue &matrix = node["matrix"];
+            if (matrix.size() == 16) {
+                glm::mat4 transform;
+                for (size_t i = 0; i < 16; ++i) {
+                    glm::value_ptr(transform)[i] = matrix[i].get_float();
+                }
+                glm::vec3 scale, position, skew;
+                glm::quat rotation;
+                glm::vec4 perspective;
+                glm::decompose(transform, scale, rotation, position, skew, perspective);
+                object.set_position(position);
+                object.set_quaternion_rotation(rotation);
+                object.set_scale(scale);
+                return;
+            }
+
+            const JSONValue &translation = node["translation"];
+            if (translation.size() == 3) {
+                object.set_position(glm::vec3{translation[0].get_float(), translation[1].get_float(), translation[2].get_float()});
+            }
+            const JSONValue &rotation = node["rotation"];
+            if (rotation.size() == 4) {
+                object.set_quaternion_rotation(glm::quat{
+                    rotation[3].get_float(1.0f), rotation[0].get_float(), rotation[1].get_float(), rotation[2].get_float()
+                });
+            }
+            const JSONValue &scale = node["scale"];
+            if (scale.size() == 3) {
+                object.set_scale(glm::vec3{scale[0].get_float(1.0f), scale[1].get_float(1.0f), scale[2].get_float(1.0f)});
+            }
+        }
+
+        /* OBJ */
+
+        struct ObjMaterial
+        {
+            glm::vec3 ambient_color{0.0f};
+            glm::vec4 diffuse_color{1.0f};
+            glm::vec3 specular_color{0.0f};
+            glm::vec3 emission_color{0.0f};
+            float specular_exponent{1.0f};
+            std::string texture_path;
+            std::string normal_texture_path;
+        };
+
+        /* The faces of a primitive are kept as lines of the file and parsed later on the pool. */
+        struct ObjFaces
+        {
+            std::vector<std::pair<const char *, const char *>> lines;
+        };
+
+        bool _import_obj(const std::string &path, std::shared_ptr<Object> &model, std::string &error)
+        {
+            std::shared_ptr<MappedFile> file = MappedFile::open(path, error);
+            if (!file) {
+                return false;
+            }
+            std::filesystem::path directory = std::filesystem::path{path}.parent_path();
+
+            std::vector<glm::vec3> positions, normals;
+            std::vector<glm::vec2> texture_coordinates;
+            std::vector<std::string> material_names;
+            std::vector<ObjMaterial> obj_materials;
+            std::vector<Primitive> primitives;
+            std::vector<ObjFaces> faces;
+
+            std::string group_name;
+            size_t material{SIZE_MAX};
+            auto start_primitive = [&]() {
+                if (!faces.empty() && faces.back().lines.empty()) {
+                    primitives.back().name = group_name;
+                    primitives.back().material = material;
+                    return;
+                }
+                Primitive primitive;
+                primitive.name = group_name;
+                primitive.material = material;
+                primitives.push_back(std::move(primitive));
+                faces.emplace_back();
+            };
+            start_primitive();
+
+            const char *data = reinterpret_cast<const char *>(file->get_data());
+            const char *end = data + file->get_size();
+            for (const char *line = data; line < end;) {
+                const char *line_end = static_cast<const char *>(std::memchr(line, '\n', static_cast<size_t>(end - line)));
+                line_end = line_end ? line_end : end;
+                std::vector<std::string> tokens = _split_obj_line(line, line_end);
+                const char *next_line = line_end + 1;
+
+                if (tokens.empty()) {
+                    line = next_line;
+                    continue;
+                }
+                const std::string &keyword = tokens[0];
+                auto number = [&](size_t index, float default_value) {
+                    return index < tokens.size() ? std::strtof(tokens[index].c_str(), nullptr) : default_value;
+                };
+                if (keyword == "v") {
+                    positions.emplace_back(number(1, 0.0f), number(2, 0.0f), number(3, 0.0f));
+                } else if (keyword == "vt") {
+                    texture_coordinates.emplace_back(number(1, 0.0f), number(2, 0.0f));
+                } else if (keyword == "vn") {
+                    normals.emplace_back(number(1, 0.0f), number(2, 0.0f), number(3, 0.0f));
+                } else if (keyword == "f") {
+                    faces.back().lines.emplace_back(line, line_end);
+                } else if (keyword == "o" || keyword == "g") {
+                    group_name = tokens.size() > 1 ? tokens[1] : "";
+                    start_primitive();
+                } else if (keyword == "usemtl") {
+                    std::string name = tokens.size() > 1 ? tokens[1] : "";
+                    auto found = std::find(std::begin(material_names), std::end(material_names), name);
+                    material = found != std::end(material_names) ? static_cast<size_t>(found - std::begin(material_names)) : SIZE_MAX;
+                    start_primitive();
+                } else if (keyword == "mtllib") {
+                    for (size_t i = 1; i < tokens.size(); ++i) {
+                        _read_mtl_file(directory, (directory / tokens[i]).string(), material_names, obj_materials);
+                    }
+                }
+                line = next_line;
+            }
+
+            _thread_pool.parallel_for(0, primitives.size(), 1, [&](size_t begin, size_t end_index) {
+                for (size_t i = begin; i < end_index; ++i) {
+                    _decode_obj_faces(faces[i], positions, texture_coordinates, normals, primitives[i]);
+                }
+            });
+            primitives.erase(std::remove_if(std::begin(primitives), std::end(primitives), [](const Primitive &primitive) {
+                return primitive.indices.empty() && primitive.error.empty();
+            }), std::end(primitives));
+            if (!_create_geometries(primitives, error)) {
+                return false;
+            }
+
+            std::vector<std::shared_ptr<PhongMaterial>> materials(obj_materials.size());
+            std::shared_ptr<PhongMaterial> default_material;
+            model = std::make_shared<Object>(std::filesystem::path{path}.stem().string());
+            for (auto &primitive : primitives) {
+                std::shared_ptr<PhongMaterial> primitive_material;
+                if (primitive.material < materials.size()) {
+                    if (!materials[primitive.material]) {
+                        materials[primitive.material] = _create_obj_material(obj_materials[primitive.material]);
+                    }
+                    primitive_material = materials[primitive.material];
+                } else {
+                    if (!default_material) {
+                        default_material = _create_phong_material();
+                    }
+                    primitive_material = default_material;
+                }
+
+                auto mesh = std::make_shared<Mesh>(primitive.geometry, primitive_material);
+                mesh->set_name(primitive.name);
+                model->add_child(mesh);
+            }
+
+            return true;
+        }
+
+        static std::vector<std::string> _split_obj_line(const char *line, const char *end)
+        {
+            std::vector<std::string> tokens;
+            const char *position = line;
+            while (position < end) {
+                while (position < end && std::isspace(static_cast<unsigned char>(*position))) {
+                    ++position;
+                }
+                if (position == end || *position == '#') {
+                    break;
+                }
+                const char *token = position;
+                while (position < end && !std::isspace(static_cast<unsigned char>(*position))) {
+                    ++position;
+                }
+                tokens.emplace_back(token, position);
+            }
+
+            return tokens;
+        }
+
+        static void _decode_obj_faces(
+            const ObjFaces &faces, const std::vector<glm::vec3> &positions, const std::vector<glm::vec2> &texture_coordinates,
+            const std::vector<glm::vec3> &normals, Primitive &primitive
+        ) {
+            struct CornerHash
+            {
+                size_t operator()(const std::tuple<long, long, long> &corner) const
+                {
+                    return static_cast<size_t>(std::get<0>(corner)) * 73856093u ^
+                           static_cast<size_t>(std::get<1>(corner)) * 19349663u ^
+                           static_cast<size_t>(std::get<2>(corner)) * 83492791u;
+                }
+            };
+            std::unordered_map<std::tuple<long, long, long>, unsigned int, CornerHash> vertex_indices;
+            auto resolve = [](long index, size_t count) {
+                return index < 0 ? static_cast<long>(count) + index : index - 1;
+            };
+
+            primitive.has_normals = true;
+            primitive.has_texture_coordinates = true;
+            std::vector<unsigned int> polygon;
+            for (const auto &[line, line_end] : faces.lines) {
+                std::vector<std::string> tokens = _split_obj_line(line, line_end);
+                polygon.clear();
+                for (size_t i = 1; i < tokens.size(); ++i) {
+                    const char *corner = tokens[i].c_str();
+                    char *next{nullptr};
+                    long position = resolve(std::strtol(corner, &next, 10), positions.size());
+                    long coordinates{-1}, normal{-1};
+                    if (*next == '/') {
+                        corner = next + 1;
+                        long index = std::strtol(corner, &next, 10);
+                        coordinates = next != corner ? resolve(index, texture_coordinates.size()) : -1;
+                        if (*next == '/') {
+                            corner = next + 1;
+                            index = std::strtol(corner, &next, 10);
+                            normal = next != corner ? resolve(index, normals.size()) : -1;
+                        }
+                    }
+                    if (position < 0 || position >= static_cast<long>(positions.size()) ||
+                        coordinates >= static_cast<long>(texture_coordinates.size()) ||
+                        normal >= static_cast<long>(normals.size())) {
+                        primitive.error = "Invalid face '" + std::string{line, line_end} + "'";
+                        return;
+                    }
+
+                    auto key = std::make_tuple(position, coordinates, normal);
+                    auto vertex_index = vertex_indices.find(key);
+                    if (vertex_index == std::end(vertex_indices)) {
+                        Vertex vertex;
+                        vertex.position = positions[static_cast<size_t>(position)];
+                        if (coordinates >= 0) {
+                            const glm::vec2 &uv = texture_coordinates[static_cast<size_t>(coordinates)];
+                            vertex.texture1_coordinates = glm::vec4{uv.x, 1.0f - uv.y, 0.0f, 1.0f};
+                        } else {
+                            primitive.has_texture_coordinates = false;
+                        }
+                        if (normal >= 0) {
+                            vertex.normal = normals[static_cast<size_t>(normal)];
+                        } else {
+                            primitive.has_normals = false;
+                        }
+                        vertex_index = vertex_indices.emplace(key, static_cast<unsigned int>(primitive.vertices.size())).first;
+                        primitive.vertices.push_back(vertex);
+                    }
+                    polygon.push_back(vertex_index->second);
+                }
+
+                for (size_t i = 1; i + 1 < polygon.size(); ++i) {
+                    primitive.indices.push_back(polygon[0]);
+                    primitive.indices.push_back(polygon[i]);
+                    primitive.indices.push_back(polygon[i + 1]);
+                }
+            }
+        }
+
+        static void _read_mtl_file(
+            const std::filesystem::path &directory, const std::string &path,
+            std::vector<std::string> &material_names, std::vector<ObjMaterial> &materials
+        ) {
+            std::string error;
+            std::shared_ptr<MappedFile> file = MappedFile::open(path, error);
+            if (!file) {
+                std::cerr << error << std::endl;
+                return;
+            }
+
+            const char *data = reinterpret_cast<const char *>(file->get_data());
+            const char *end = data + file->get_size();
+            ObjMaterial *material{nullptr};
+            for (const char *line = data; line < end;) {
+                const char *line_end = static_cast<const char *>(std::memchr(line, '\n', static_cast<size_t>(end - line)));
+                line_end = line_end ? line_end : end;
+                std::vector<std::string> tokens = _split_obj_line(line, line_end);
+                line = line_end + 1;
+                if (tokens.empty()) {
+                    continue;
+                }
+
+                const std::string &keyword = tokens[0];
+                auto number = [&](size_t index, float default_value) {
+                    return index < tokens.size() ? std::strtof(tokens[index].c_str(), nullptr) : default_value;
+                };
+                auto color = [&]() {
+                    return glm::vec3{number(1, 0.0f), number(2, number(1, 0.0f)), number(3, number(1, 0.0f))};
+                };
+                if (keyword == "newmtl") {
+                    material_names.push_back(tokens.size() > 1 ? tokens[1] : "");
+                    materials.emplace_back();
+                    material = &materials.back();
+                } else if (!material) {
+                    continue;
+                } else if (keyword == "Ka") {
+                    material->ambient_color = color();
+                } else if (keyword == "Kd") {
+                    material->diffuse_color = glm::vec4{color(), material->diffuse_color.a};
+                } else if (keyword == "Ks") {
+                    material->specular_color = color();
+                } else if (keyword == "Ke") {
+                    material->emission_color = color();
+                } else if (keyword == "Ns") {
+                    material->specular_exponent = std::max(number(1, 1.0f), 1.0f);
+                } else if (keyword == "d") {
+                    material->diffuse_color.a = number(1, 1.0f);
+                } else if (keyword == "Tr") {
+                    material->diffuse_color.a = 1.0f - number(1, 0.0f);
+                } else if (keyword == "map_Kd" && tokens.size() > 1) {
+                    material->texture_path = (directory / tokens.back()).string();
+                } else if ((keyword == "map_Bump" || keyword == "bump" || keyword == "norm") && tokens.size() > 1) {
+                    material->normal_texture_path = (directory / tokens.back()).string();
+                }
+            }
+        }
+
+        std::shared_ptr<PhongMaterial> _create_obj_material(const ObjMaterial &description)
+        {
+            std::shared_ptr<PhongMaterial> material = _create_phong_material();
+            material->set_ambient_color(description.ambient_color);
+            material->set_diffuse_color(description.diffuse_color);
+            material->set_specular_color(description.specular_color);
+            material->set_emission_color(glm::vec4{description.emission_color, 0.0f});
+            material->set_specular_exponent(description.specular_exponent);
+            if (_texture_loading_enabled && !description.texture_path.empty()) {
+                material->set_texture_1(_load_texture_file(description.texture_path));
+            }
+            if (_texture_loading_enabled && !description.normal_texture_path.empty()) {
+                material->set_texture_1_normals(_load_texture_file(description.normal_texture_path));
+            }
+            if (description.diffuse_color.a < 1.0f) {
+                material->set_blending_enabled(true);
+                material->set_transparent(true);
+            }
+
+            return material;
+        }
+
+        /* Shared */
+
+        std::shared_ptr<Texture> _load_texture_file(const std::string &path)
+        {
+            std::error_code error_code;
+            std::string key = std::filesystem::weakly_canonical(path, error_code).string();
+            if (error_code) {
+                key = path;
+            }
+
+            auto cached = _textures.find(key);
+            if (cached != std::end(_textures)) {
+                if (auto texture = cached->second.lock()) {
+                    return texture;
+                }
+            }
+            std::shared_ptr<Texture> texture = _texture_loader.load(path);
+            _textures[key] = texture;
+
+            return texture;
+        }
+
+        /* Embedded images are identified by their content. */
+        std::shared_ptr<Texture> _load_texture_data(const std::string &name, const uint8_t *data, size_t size)
+        {
+            std::string key = "#" + std::to_string(_hash(data, size, FNV_OFFSET_BASIS)) + ":" + std::to_string(size);
+            auto cached = _textures.find(key);
+            if (cached != std::end(_textures)) {
+                if (auto texture = cached->second.lock()) {
+                    return texture;
+                }
+            }
+            std::shared_ptr<Texture> texture = _texture_loader.load(name, std::vector<uint8_t>(data, data + size));
+            _textures[key] = texture;
+
+            return texture;
+        }
+
+        static const uint64_t FNV_OFFSET_BASIS{14695981039346656037ull};
+
+        static uint64_t _hash(const void *data, size_t size, uint64_t hash)
+        {
+            const auto *bytes = static_cast<const uint8_t *>(data);
+            for (size_t i = 0; i < size; ++i) {
+                hash = (hash ^ bytes[i]) * 1099511628211ull;
+            }
+
+            return hash;
+        }
+
+        /* Everything but tangents and binormals, which are derived from the rest. */
+        static uint64_t _hash_primitive(const Primitive &primitive)
+        {
+            uint64_t hash = _hash(&primitive.type, sizeof(primitive.type), FNV_OFFSET_BASIS);
+            hash = _hash(primitive.indices.data(), primitive.indices.size() * sizeof(unsigned int), hash);
+            for (const auto &vertex : primitive.vertices) {
+                hash = _hash(&vertex.position, sizeof(vertex.position), hash);
+                hash = _hash(&vertex.color, sizeof(vertex.color), hash);
+                hash = _hash(&vertex.normal, sizeof(vertex.normal), hash);
+                hash = _hash(&vertex.texture1_coordinates, sizeof(vertex.texture1_coordinates), hash);
+                hash = _hash(&vertex.texture2_coordinates, sizeof(vertex.texture2_coordinates), hash);
+            }
+
+            return hash;
+        }
+
+        static bool _is_equal(
+            Geometry::Type type, const unsigned int *indices, size_t index_count, const Vertex *vertices, size_t vertex_count,
+            const Primitive &primitive
+        ) {
+            if (type != primitive.type || index_count != primitive.indices.size() || vertex_count != primitive.vertices.size()) {
+                return false;
+            }
+            if (!std::equal(indices, indices + index_count, std::begin(primitive.indices))) {
+                return false;
+            }
+            for (size_t i = 0; i < vertex_count; ++i) {
+                const Vertex &a = vertices[i], &b = primitive.vertices[i];
+                if (a.position != b.position || a.color != b.color || a.normal != b.normal ||
+                    a.texture1_coordinates != b.texture1_coordinates || a.texture2_coordinates != b.texture2_coordinates) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        /* Reuses the geometries of identical primitives and builds the others on the pool. */
+        bool _create_geometries(std::vector<Primitive> &primitives, std::string &error)
+        {
+            for (const auto &primitive : primitives) {
+                if (!primitive.error.empty()) {
+                    error = primitive.error;
+                    return false;
+                }
+            }
+
+            _thread_pool.parallel_for(0, primitives.size(), 1, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    primitives[i].hash = _hash_primitive(primitives[i]);
+                }
+            });
+
+            std::unordered_multimap<uint64_t, size_t> unique_primitives;
+            std::vector<bool> cached_primitives(primitives.size(), false);
+            for (size_t i = 0; i < primitives.size(); ++i) {
+                Primitive &primitive = primitives[i];
+
+                auto range = _geometries.equal_range(primitive.hash);
+                for (auto cached = range.first; cached != range.second && !primitive.geometry; ++cached) {
+                    std::shared_ptr<Geometry> geometry = cached->second.lock();
+                    if (geometry && _is_equal(
+                            geometry->get_type(), geometry->get_index_data(), geometry->get_index_count(),
+                            geometry->get_vertex_data(), geometry->get_vertex_count(), primitive)) {
+                        primitive.geometry = geometry;
+                    }
+                }
+                if (primitive.geometry) {
+                    cached_primitives[i] = true;
+                    continue;
+                }
+
+                auto unique_range = unique_primitives.equal_range(primitive.hash);
+                for (auto unique = unique_range.first; unique != unique_range.second; ++unique) {
+                    const Primitive &other = primitives[unique->second];
+                    if (_is_equal(other.type, other.indices.data(), other.indices.size(), other.vertices.data(), other.vertices.size(), primitive)) {
+                        primitive.duplicate_of = unique->second;
+                        break;
+                    }
+                }
+                if (primitive.duplicate_of == SIZE_MAX) {
+                    unique_primitives.emplace(primitive.hash, i);
+                }
+            }
+
+            bool generate_tangents = _tangent_generation_enabled;
+            _thread_pool.parallel_for(0, primitives.size(), 1, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    Primitive &primitive = primitives[i];
+                    if (primitive.geometry || primitive.duplicate_of != SIZE_MAX) {
+                        continue;
+                    }
+                    if (!primitive.has_normals) {
+                        _calculate_normals(primitive);
+                    }
+
+                    /* All comparisons with other primitives are done, so the geometry can take over the data. */
+                    primitive.geometry = _create_geometry(std::move(primitive.indices), std::move(primitive.vertices));
+                    primitive.geometry->set_type(primitive.type);
+                    if (generate_tangents && primitive.has_texture_coordinates) {
+                        primitive.geometry->calculate_tangents_and_binormals(_thread_pool);
+                    }
+                }
+            });
+
+            for (size_t i = 0; i < primitives.size(); ++i) {
+                Primitive &primitive = primitives[i];
+                if (primitive.duplicate_of != SIZE_MAX) {
+                    primitive.geometry = primitives[primitive.duplicate_of].geometry;
+                } else if (!cached_primitives[i]) {
+                    _geometries.emplace(primitive.hash, primitive.geometry);
+                }
+            }
+            for (auto cached = std::begin(_geometries); cached != std::end(_geometries);) {
+                cached = cached->second.expired() ? _geometries.erase(cached) : std::next(cached);
+            }
+
+            return true;
+        }
+
+        /* Area-weighted vertex normals for triangle lists that come without them. */
+        static void _calculate_normals(Primitive &primitive)
+        {
+            if (primitive.type != Geometry::Triangles) {
+                return;
+            }
+
+            for (size_t i = 0; i + 2 < primitive.indices.size(); i += 3) {
+                Vertex &a = primitive.vertices[primitive.indices[i]];
+                Vertex &b = primitive.vertices[primitive.indices[i + 1]];
+                Vertex &c = primitive.vertices[primitive.indices[i + 2]];
+                glm::vec3 normal = glm::cross(b.position - a.position, c.position - a.position);
+                a.normal += normal;
+                b.normal += normal;
+                c.normal += normal;
+            }
+            for (auto &vertex : primitive.vertices) {
+                float length = glm::length(vertex.normal);
+                vertex.normal = length > 0.0f ? vertex.normal / length : glm::vec3{0.0f, 0.0f, 1.0f};
+            }
+            primitive.has_normals = true;
+        }
+    };
+}
+
+#endif
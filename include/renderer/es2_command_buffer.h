@@ -0,0 +1,556 @@
+#ifndef ES2_COMMAND_BUFFER_H
+#define ES2_COMMAND_BUFFER_H
+
+#include "renderer/gl_dispatch.h"
+#include "utilities/profiler.h"
+
+#include <GL/glew.h>
+#define SDL_MAIN_HANDLED
+#include <SDL.h>
+
+#include <cstdint>
+#include <cstring>
+#include <array>
+#include <tuple>
+#include <vector>
+#include <memory>
+#include <utility>
+#include <algorithm>
+
+namespace asr
+{
+    /* Draw packets recorded from the GL calls of materials and geometries, submitted later by a replay loop
+       that skips redundant program, state and vertex array changes. A buffer can be submitted any number of
+       times while the GL objects it refers to live. Its memory is kept when cleared, so recording a similar
+       frame again does not allocate. */
+    class ES2CommandBuffer
+    {
+    public:
+        /* The fixed function state set by materials, starting at the GL defaults. */
+        struct StateBlock
+        {
+            GLfloat line_width{1.0f};
+            GLboolean depth_mask{GL_TRUE};
+            bool depth_test_enabled{false};
+            GLenum depth_function{GL_LESS};
+            bool blending_enabled{false};
+            std::array<GLenum, 2> blending_equations{GL_FUNC_ADD, GL_FUNC_ADD};
+            std::array<GLenum, 4> blending_functions{GL_ONE, GL_ZERO, GL_ONE, GL_ZERO};
+            std::array<GLfloat, 4> blending_constant_color{0.0f, 0.0f, 0.0f, 0.0f};
+            bool face_culling_enabled{false};
+            GLenum cull_face_mode{GL_BACK};
+            GLenum front_face_order{GL_CCW};
+            bool polygon_offset_enabled{false};
+            GLfloat polygon_offset_factor{0.0f};
+            GLfloat polygon_offset_units{0.0f};
+
+            [[nodiscard]] auto tie() const
+            {
+                return std::tie(
+                    line_width, depth_mask, depth_test_enabled, depth_function,
+                    blending_enabled, blending_equations, blending_functions, blending_constant_color,
+                    face_culling_enabled, cull_face_mode, front_face_order,
+                    polygon_offset_enabled, polygon_offset_factor, polygon_offset_units
+                );
+            }
+        };
+
+        friend bool operator==(const StateBlock &a, const StateBlock &b)
+        {
+            return a.tie() == b.tie();
+        }
+
+        friend bool operator!=(const StateBlock &a, const StateBlock &b)
+        {
+            return !(a == b);
+        }
+
+        enum UniformType : uint16_t
+        {
+            Float,
+            Integer,
+            Vector3,
+            Vector4,
+            Matrix3,
+            Matrix4
+        };
+
+        /* `offset` points into the payload, which holds `count` values of the type. */
+        struct UniformCommand
+        {
+            GLint location;
+            UniformType type;
+            uint16_t count;
+            uint32_t offset;
+        };
+
+        struct TextureBinding
+        {
+            GLenum unit;
+            GLenum target;
+            GLuint texture;
+        };
+
+        /* The uniforms and texture bindings of a packet are ranges that are set right before its draw. */
+        struct DrawPacket
+        {
+            GLuint program;
+            uint32_t state_block;
+            uint32_t first_uniform;
+            uint32_t uniform_count;
+            uint32_t first_texture_binding;
+            uint32_t texture_binding_count;
+            GLuint vertex_array;
+            GLenum mode;
+            GLsizei count;
+            GLenum index_type;
+            uintptr_t index_offset;
+        };
+
+        [[nodiscard]] bool is_empty() const
+        {
+            return _packets.empty();
+        }
+
+        [[nodiscard]] size_t get_packet_count() const
+        {
+            return _packets.size();
+        }
+
+        [[nodiscard]] const std::vector<DrawPacket> &get_packets() const
+        {
+            return _packets;
+        }
+
+        [[nodiscard]] const std::vector<StateBlock> &get_state_blocks() const
+        {
+            return _state_blocks;
+        }
+
+        [[nodiscard]] const std::vector<UniformCommand> &get_uniforms() const
+        {
+            return _uniforms;
+        }
+
+        [[nodiscard]] const std::vector<TextureBinding> &get_texture_bindings() const
+        {
+            return _texture_bindings;
+        }
+
+        [[nodiscard]] const std::vector<uint8_t> &get_payload() const
+        {
+            return _payload;
+        }
+
+        void clear()
+        {
+            _packets.clear();
+            _state_blocks.clear();
+            _uniforms.clear();
+            _texture_bindings.clear();
+            _payload.clear();
+        }
+
+        /* Nothing about the GL state is assumed at the start, so the first packet sets all of its state. */
+        void submit() const
+        {
+            bool profiled = Profiler::get_shared_instance().is_enabled();
+
+            const DrawPacket *previous{nullptr};
+            for (const auto &packet : _packets) {
+                if (!previous || packet.program != previous->program) {
+                    gl::UseProgram(packet.program);
+                    if (profiled) { Profiler::count(Profiler::StateChanges); }
+                }
+                if (!previous || packet.state_block != previous->state_block) {
+                    _apply_state_block(_state_blocks[packet.state_block], previous ? &_state_blocks[previous->state_block] : nullptr);
+                    if (profiled) { Profiler::count(Profiler::StateChanges); }
+                }
+                for (uint32_t i = 0; i < packet.texture_binding_count; ++i) {
+                    const TextureBinding &binding = _texture_bindings[packet.first_texture_binding + i];
+                    gl::ActiveTexture(binding.unit);
+                    gl::BindTexture(binding.target, binding.texture);
+                }
+                for (uint32_t i = 0; i < packet.uniform_count; ++i) {
+                    _upload_uniform(_uniforms[packet.first_uniform + i]);
+                }
+                if (!previous || packet.vertex_array != previous->vertex_array) {
+                    gl::BindVertexArray(packet.vertex_array);
+                    if (profiled) { Profiler::count(Profiler::StateChanges); }
+                }
+
+                gl::DrawElements(packet.mode, packet.count, packet.index_type, reinterpret_cast<const void *>(packet.index_offset));
+
+                if (profiled) {
+                    _count_draw_call(packet);
+                }
+                previous = &packet;
+            }
+        }
+
+    private:
+        friend class ES2CommandRecorder;
+
+        std::vector<DrawPacket> _packets;
+        std::vector<StateBlock> _state_blocks;
+        std::vector<UniformCommand> _uniforms;
+        std::vector<TextureBinding> _texture_bindings;
+        std::vector<uint8_t> _payload;
+
+        /* Values are stored as 4-byte words, which keeps every offset aligned for reading them back. */
+        void _add_uniform(GLint location, UniformType type, GLsizei count, const void *values, size_t size)
+        {
+            auto offset = static_cast<uint32_t>(_payload.size());
+            _payload.resize(_payload.size() + size);
+            std::memcpy(_payload.data() + offset, values, size);
+            _uniforms.push_back(UniformCommand{location, type, static_cast<uint16_t>(count), offset});
+        }
+
+        void _upload_uniform(const UniformCommand &uniform) const
+        {
+            const uint8_t *values = _payload.data() + uniform.offset;
+            auto count = static_cast<GLsizei>(uniform.count);
+            switch (uniform.type) {
+                case Float:
+                    gl::Uniform1f(uniform.location, *reinterpret_cast<const GLfloat *>(values));
+                    break;
+                case Integer:
+                    gl::Uniform1i(uniform.location, *reinterpret_cast<const GLint *>(values));
+                    break;
+                case Vector3:
+                    gl::Uniform3fv(uniform.location, count, reinterpret_cast<const GLfloat *>(values));
+                    break;
+                case Vector4:
+                    gl::Uniform4fv(uniform.location, count, reinterpret_cast<const GLfloat *>(values));
+                    break;
+                case Matrix3:
+                    gl::UniformMatrix3fv(uniform.location, count, GL_FALSE, reinterpret_cast<const GLfloat *>(values));
+                    break;
+                case Matrix4:
+                    gl::UniformMatrix4fv(uniform.location, count, GL_FALSE, reinterpret_cast<const GLfloat *>(values));
+                    break;
+            }
+        }
+
+        /* Only the parts that differ from the `previous` block are set. */
+        static void _apply_state_block(const StateBlock &block, const StateBlock *previous)
+        {
+            if (!previous || block.line_width != previous->line_width) {
+                gl::LineWidth(block.line_width);
+            }
+            if (!previous || block.depth_mask != previous->depth_mask) {
+                gl::DepthMask(block.depth_mask);
+            }
+            if (!previous || block.depth_test_enabled != previous->depth_test_enabled) {
+                _set_capability(GL_DEPTH_TEST, block.depth_test_enabled);
+            }
+            if (!previous || block.depth_function != previous->depth_function) {
+                gl::DepthFunc(block.depth_function);
+            }
+            if (!previous || block.blending_enabled != previous->blending_enabled) {
+                _set_capability(GL_BLEND, block.blending_enabled);
+            }
+            if (!previous || block.blending_equations != previous->blending_equations) {
+                gl::BlendEquationSeparate(block.blending_equations[0], block.blending_equations[1]);
+            }
+            if (!previous || block.blending_functions != previous->blending_functions) {
+                gl::BlendFuncSeparate(
+                    block.blending_functions[0], block.blending_functions[1],
+                    block.blending_functions[2], block.blending_functions[3]
+                );
+            }
+            if (!previous || block.blending_constant_color != previous->blending_constant_color) {
+                gl::BlendColor(
+                    block.blending_constant_color[0], block.blending_constant_color[1],
+                    block.blending_constant_color[2], block.blending_constant_color[3]
+                );
+            }
+            if (!previous || block.face_culling_enabled != previous->face_culling_enabled) {
+                _set_capability(GL_CULL_FACE, block.face_culling_enabled);
+            }
+            if (!previous || block.cull_face_mode != previous->cull_face_mode) {
+                gl::CullFace(block.cull_face_mode);
+            }
+            if (!previous || block.front_face_order != previous->front_face_order) {
+                gl::FrontFace(block.front_face_order);
+            }
+            if (!previous || block.polygon_offset_enabled != previous->polygon_offset_enabled) {
+                _set_capability(GL_POLYGON_OFFSET_FILL, block.polygon_offset_enabled);
+            }
+            if (!previous ||
+                block.polygon_offset_factor != previous->polygon_offset_factor ||
+                block.polygon_offset_units != previous->polygon_offset_units) {
+                gl::PolygonOffset(block.polygon_offset_factor, block.polygon_offset_units);
+            }
+        }
+
+        static void _set_capability(GLenum capability, bool enabled)
+        {
+            if (enabled) {
+                gl::Enable(capability);
+            } else {
+                gl::Disable(capability);
+            }
+        }
+
+        static void _count_draw_call(const DrawPacket &packet)
+        {
+            Profiler::count(Profiler::DrawCalls);
+            Profiler::count(Profiler::UniformUploads, packet.uniform_count);
+
+            auto count = static_cast<uint64_t>(packet.count);
+            switch (packet.mode) {
+                case GL_TRIANGLES:
+                    Profiler::count(Profiler::Triangles, count / 3);
+                    break;
+                case GL_TRIANGLE_FAN:
+                case GL_TRIANGLE_STRIP:
+                    Profiler::count(Profiler::Triangles, count >= 3 ? count - 2 : 0);
+                    break;
+                default:
+                    break;
+            }
+        }
+    };
+
+    /* Installed as the GL backend between `begin` and `end`, turning program, fixed function state, uniform and
+       draw calls into packets of a command buffer. Everything else, e.g. uploads of geometries and textures,
+       still reaches the previous backend immediately. Texture and vertex array bindings do both, since uploads
+       depend on them. */
+    class ES2CommandRecorder final : public gl::ForwardingBackend, public std::enable_shared_from_this<ES2CommandRecorder>
+    {
+    public:
+        [[nodiscard]] bool is_recording() const
+        {
+            return _command_buffer != nullptr;
+        }
+
+        /* Appends to `command_buffer`, which is not cleared. */
+        void begin(ES2CommandBuffer &command_buffer)
+        {
+            if (_command_buffer) {
+                return;
+            }
+
+            _command_buffer = &command_buffer;
+            _state = ES2CommandBuffer::StateBlock{};
+            _program = 0;
+            _vertex_array = 0;
+            _active_texture = GL_TEXTURE0;
+            _first_uniform = static_cast<uint32_t>(command_buffer._uniforms.size());
+            _first_payload = command_buffer._payload.size();
+            _touched_texture_units.clear();
+
+            auto &backend = gl::_get_backend_storage();
+            _backend = backend;
+            backend = shared_from_this();
+        }
+
+        void end()
+        {
+            if (!_command_buffer) {
+                return;
+            }
+
+            gl::_get_backend_storage() = std::move(_backend);
+            _command_buffer = nullptr;
+        }
+
+        /* Drops the uniforms recorded since the last draw, e.g. when a material turned out not to be drawable. */
+        void discard_pending()
+        {
+            if (_command_buffer) {
+                _command_buffer->_uniforms.resize(_first_uniform);
+                _command_buffer->_payload.resize(_first_payload);
+            }
+        }
+
+        void UseProgram(GLuint program) final
+        {
+            _program = program;
+        }
+
+        void Enable(GLenum capability) final
+        {
+            if (!_set_capability(capability, true)) {
+                _backend->Enable(capability);
+            }
+        }
+
+        void Disable(GLenum capability) final
+        {
+            if (!_set_capability(capability, false)) {
+                _backend->Disable(capability);
+            }
+        }
+
+        void LineWidth(GLfloat width) final
+        {
+            _state.line_width = width;
+        }
+
+        void DepthMask(GLboolean flag) final
+        {
+            _state.depth_mask = flag;
+        }
+
+        void DepthFunc(GLenum function) final
+        {
+            _state.depth_function = function;
+        }
+
+        void BlendEquationSeparate(GLenum color_mode, GLenum alpha_mode) final
+        {
+            _state.blending_equations = {color_mode, alpha_mode};
+        }
+
+        void BlendFuncSeparate(GLenum source_color, GLenum destination_color, GLenum source_alpha, GLenum destination_alpha) final
+        {
+            _state.blending_functions = {source_color, destination_color, source_alpha, destination_alpha};
+        }
+
+        void BlendColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha) final
+        {
+            _state.blending_constant_color = {red, green, blue, alpha};
+        }
+
+        void CullFace(GLenum mode) final
+        {
+            _state.cull_face_mode = mode;
+        }
+
+        void FrontFace(GLenum mode) final
+        {
+            _state.front_face_order = mode;
+        }
+
+        void PolygonOffset(GLfloat factor, GLfloat units) final
+        {
+            _state.polygon_offset_factor = factor;
+            _state.polygon_offset_units = units;
+        }
+
+        void Uniform1f(GLint location, GLfloat value) final
+        {
+            _command_buffer->_add_uniform(location, ES2CommandBuffer::Float, 1, &value, sizeof(value));
+        }
+
+        void Uniform1i(GLint location, GLint value) final
+        {
+            _command_buffer->_add_uniform(location, ES2CommandBuffer::Integer, 1, &value, sizeof(value));
+        }
+
+        void Uniform3fv(GLint location, GLsizei count, const GLfloat *values) final
+        {
+            _command_buffer->_add_uniform(location, ES2CommandBuffer::Vector3, count, values, sizeof(GLfloat) * 3 * count);
+        }
+
+        void Uniform4fv(GLint location, GLsizei count, const GLfloat *values) final
+        {
+            _command_buffer->_add_uniform(location, ES2CommandBuffer::Vector4, count, values, sizeof(GLfloat) * 4 * count);
+        }
+
+        /* Materials never transpose, so `transpose` is not kept. */
+        void UniformMatrix3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat *values) final
+        {
+            _command_buffer->_add_uniform(location, ES2CommandBuffer::Matrix3, count, values, sizeof(GLfloat) * 9 * count);
+        }
+
+        void UniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat *values) final
+        {
+            _command_buffer->_add_uniform(location, ES2CommandBuffer::Matrix4, count, values, sizeof(GLfloat) * 16 * count);
+        }
+
+        void ActiveTexture(GLenum texture) final
+        {
+            _active_texture = texture;
+            _backend->ActiveTexture(texture);
+        }
+
+        void BindTexture(GLenum target, GLuint texture) final
+        {
+            auto binding = std::find_if(std::begin(_touched_texture_units), std::end(_touched_texture_units), [&](const auto &binding) {
+                return binding.unit == _active_texture && binding.target == target;
+            });
+            if (binding == std::end(_touched_texture_units)) {
+                _touched_texture_units.push_back(ES2CommandBuffer::TextureBinding{_active_texture, target, texture});
+            } else {
+                binding->texture = texture;
+            }
+            _backend->BindTexture(target, texture);
+        }
+
+        void BindVertexArray(GLuint array) final
+        {
+            _vertex_array = array;
+            _backend->BindVertexArray(array);
+        }
+
+        /* Only the last binding of every texture unit since the previous draw is kept. */
+        void DrawElements(GLenum mode, GLsizei count, GLenum type, const void *indices) final
+        {
+            ES2CommandBuffer &command_buffer = *_command_buffer;
+
+            if (command_buffer._state_blocks.empty() || command_buffer._state_blocks.back() != _state) {
+                command_buffer._state_blocks.push_back(_state);
+            }
+
+            auto first_texture_binding = static_cast<uint32_t>(command_buffer._texture_bindings.size());
+            command_buffer._texture_bindings.insert(
+                std::end(command_buffer._texture_bindings), std::begin(_touched_texture_units), std::end(_touched_texture_units)
+            );
+            _touched_texture_units.clear();
+
+            auto uniform_count = static_cast<uint32_t>(command_buffer._uniforms.size()) - _first_uniform;
+            command_buffer._packets.push_back(ES2CommandBuffer::DrawPacket{
+                _program,
+                static_cast<uint32_t>(command_buffer._state_blocks.size() - 1),
+                _first_uniform,
+                uniform_count,
+                first_texture_binding,
+                static_cast<uint32_t>(command_buffer._texture_bindings.size()) - first_texture_binding,
+                _vertex_array,
+                mode,
+                count,
+                type,
+                reinterpret_cast<uintptr_t>(indices)
+            });
+            _first_uniform = static_cast<uint32_t>(command_buffer._uniforms.size());
+            _first_payload = command_buffer._payload.size();
+        }
+
+    private:
+        ES2CommandBuffer *_command_buffer{nullptr};
+
+        ES2CommandBuffer::StateBlock _state;
+        GLuint _program{0};
+        GLuint _vertex_array{0};
+        GLenum _active_texture{GL_TEXTURE0};
+        uint32_t _first_uniform{0};
+        size_t _first_payload{0};
+        std::vector<ES2CommandBuffer::TextureBinding> _touched_texture_units;
+
+        /* Returns false for capabilities that are not part of the state block. */
+        bool _set_capability(GLenum capability, bool enabled)
+        {
+            switch (capability) {
+                case GL_DEPTH_TEST:
+                    _state.depth_test_enabled = enabled;
+                    return true;
+                case GL_BLEND:
+                    _state.blending_enabled = enabled;
+                    return true;
+                case GL_CULL_FACE:
+                    _state.face_culling_enabled = enabled;
+                    return true;
+                case GL_POLYGON_OFFSET_FILL:
+                    _state.polygon_offset_enabled = enabled;
+                    return true;
+                default:
+                    return false;
+            }
+        }
+    };
+}
+
+#endif
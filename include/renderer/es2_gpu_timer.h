@@ -0,0 +1,120 @@
+#ifndef ES2_GPU_TIMER_H
+#define ES2_GPU_TIMER_H
+
+#include "renderer/gl_dispatch.h"
+
+#include <GL/glew.h>
+#define SDL_MAIN_HANDLED
+#include <SDL.h>
+
+#include <vector>
+
+#ifndef GL_GPU_DISJOINT_EXT
+#define GL_GPU_DISJOINT_EXT 0x8FBB
+#endif
+
+namespace asr
+{
+    /* Measures the GPU time between `begin` and `end` with timer queries. Results are read a few frames
+       later, when the GPU has caught up, so the CPU never waits for them. Intervals must not overlap. */
+    class ES2GPUTimer
+    {
+    public:
+        static const size_t QUERY_COUNT{4};
+
+        ES2GPUTimer()
+        {
+            if (is_supported()) {
+                _queries.resize(QUERY_COUNT);
+                gl::GenQueries(static_cast<GLsizei>(_queries.size()), _queries.data());
+            }
+        }
+
+        ES2GPUTimer(const ES2GPUTimer &other) = delete;
+        ES2GPUTimer& operator=(const ES2GPUTimer &other) = delete;
+
+        ~ES2GPUTimer()
+        {
+            if (!_queries.empty()) {
+                gl::DeleteQueries(static_cast<GLsizei>(_queries.size()), _queries.data());
+            }
+        }
+
+        static bool is_supported()
+        {
+            return gl::is_supported(gl::TimerQuery) || gl::is_supported(gl::DisjointTimerQuery);
+        }
+
+        void begin()
+        {
+            _poll();
+            if (_queries.empty() || _pending_count == _queries.size()) {
+                return;
+            }
+
+            gl::BeginQuery(GL_TIME_ELAPSED, _queries[(_first_pending + _pending_count) % _queries.size()]);
+            _active = true;
+        }
+
+        void end()
+        {
+            if (!_active) {
+                return;
+            }
+
+            gl::EndQuery(GL_TIME_ELAPSED);
+            ++_pending_count;
+            _active = false;
+        }
+
+        /* The latest measurement that is available, in milliseconds. */
+        [[nodiscard]] bool get_elapsed_time(float &elapsed_time)
+        {
+            _poll();
+            if (!_has_elapsed_time) {
+                return false;
+            }
+            elapsed_time = _elapsed_time;
+
+            return true;
+        }
+
+    private:
+        std::vector<GLuint> _queries;
+        size_t _first_pending{0};
+        size_t _pending_count{0};
+        bool _active{false};
+
+        float _elapsed_time{0.0f};
+        bool _has_elapsed_time{false};
+
+        void _poll()
+        {
+            while (_pending_count > 0) {
+                GLuint query = _queries[_first_pending];
+                GLint available{0};
+                gl::GetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+                if (available == 0) {
+                    break;
+                }
+
+                GLuint64 elapsed_time{0};
+                gl::GetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsed_time);
+                _first_pending = (_first_pending + 1) % _queries.size();
+                --_pending_count;
+
+                /* A disjoint event, e.g. a frequency change, makes the results in flight meaningless. */
+                GLint disjoint{0};
+                if (!gl::is_supported(gl::TimerQuery)) {
+                    gl::GetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+                }
+                if (disjoint == 0) {
+                    _elapsed_time = static_cast<float>(static_cast<double>(elapsed_time) / 1000000.0);
+                    _has_elapsed_time = true;
+                }
+            }
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,188 @@
+#ifndef ES2_RENDER_TARGET_H
+#define ES2_RENDER_TARGET_H
+
+#include "renderer/render_target.h"
+#include "textures/es2_texture.h"
+#include "renderer/gl_dispatch.h"
+
+#include <GL/glew.h>
+#define SDL_MAIN_HANDLED
+#include <SDL.h>
+
+#include <memory>
+#include <iostream>
+
+namespace asr
+{
+    class ES2RenderTarget final : public RenderTarget
+    {
+    public:
+        ES2RenderTarget(
+            unsigned int width, unsigned int height,
+            ColorFormat color_format = RGBA8, DepthFormat depth_format = Depth24, unsigned int sample_count = 1
+        ) : RenderTarget(width, height, color_format, depth_format, sample_count),
+            _es2_color_texture{std::make_shared<ES2Texture>(ImageBuffer{}, width, height, color_format == RGB8 ? 3 : 4)}
+        {
+            _color_texture = _es2_color_texture;
+        }
+
+        ~ES2RenderTarget() final
+        {
+            _delete_objects();
+        }
+
+        static bool is_blitting_supported()
+        {
+            return gl::is_supported(gl::FramebufferObject);
+        }
+
+        static bool is_multisampling_supported()
+        {
+            return is_blitting_supported();
+        }
+
+        /* Valid after the first call to `bind`. */
+        [[nodiscard]] GLuint get_framebuffer() const
+        {
+            return _framebuffer;
+        }
+
+        void bind() final
+        {
+            if (_requires_update) {
+                _update();
+            }
+            gl::BindFramebuffer(GL_FRAMEBUFFER, _framebuffer);
+        }
+
+        void resolve() final
+        {
+            if (_resolve_framebuffer != 0) {
+                gl::BindFramebuffer(GL_READ_FRAMEBUFFER, _framebuffer);
+                gl::BindFramebuffer(GL_DRAW_FRAMEBUFFER, _resolve_framebuffer);
+                gl::BlitFramebuffer(
+                    0, 0, static_cast<GLint>(_width), static_cast<GLint>(_height),
+                    0, 0, static_cast<GLint>(_width), static_cast<GLint>(_height),
+                    GL_COLOR_BUFFER_BIT, GL_NEAREST
+                );
+                gl::BindFramebuffer(GL_FRAMEBUFFER, _framebuffer);
+            }
+
+            if (_es2_color_texture->are_mipmaps_enabled()) {
+                gl::BindTexture(GL_TEXTURE_2D, _es2_color_texture->get_texture_object());
+                gl::GenerateMipmap(GL_TEXTURE_2D);
+                gl::BindTexture(GL_TEXTURE_2D, 0);
+            }
+        }
+
+    private:
+        std::shared_ptr<ES2Texture> _es2_color_texture;
+
+        GLuint _framebuffer{0};
+        GLuint _resolve_framebuffer{0};
+        GLuint _color_renderbuffer{0};
+        GLuint _depth_renderbuffer{0};
+
+        void _update()
+        {
+            _delete_objects();
+
+            unsigned int channels = _color_format == RGB8 ? 3 : 4;
+            _es2_color_texture->set_image(ImageBuffer{}, _width, _height, channels);
+            _es2_color_texture->update(0);
+
+            GLint previous_framebuffer{0};
+            gl::GetIntegerv(GL_FRAMEBUFFER_BINDING, &previous_framebuffer);
+
+            auto width = static_cast<GLsizei>(_width);
+            auto height = static_cast<GLsizei>(_height);
+            bool multisampled = _sample_count > 1 && is_multisampling_supported();
+            auto samples = static_cast<GLsizei>(multisampled ? _sample_count : 0);
+
+            gl::GenFramebuffers(1, &_framebuffer);
+            gl::BindFramebuffer(GL_FRAMEBUFFER, _framebuffer);
+            if (multisampled) {
+                gl::GenRenderbuffers(1, &_color_renderbuffer);
+                gl::BindRenderbuffer(GL_RENDERBUFFER, _color_renderbuffer);
+                gl::RenderbufferStorageMultisample(GL_RENDERBUFFER, samples, channels == 3 ? GL_RGB8 : GL_RGBA8, width, height);
+                gl::FramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, _color_renderbuffer);
+            } else {
+                gl::FramebufferTexture2D(
+                    GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, _es2_color_texture->get_texture_object(), 0
+                );
+            }
+
+            if (_depth_format != NoDepth) {
+                GLenum format = _convert_depth_format_to_es2_renderbuffer_format(_depth_format);
+                gl::GenRenderbuffers(1, &_depth_renderbuffer);
+                gl::BindRenderbuffer(GL_RENDERBUFFER, _depth_renderbuffer);
+                if (multisampled) {
+                    gl::RenderbufferStorageMultisample(GL_RENDERBUFFER, samples, format, width, height);
+                } else {
+                    gl::RenderbufferStorage(GL_RENDERBUFFER, format, width, height);
+                }
+                gl::FramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, _depth_renderbuffer);
+                if (_depth_format == Depth24Stencil8) {
+                    gl::FramebufferRenderbuffer(GL_FRAMEBUFFER, GL_STENCIL_ATTACHMENT, GL_RENDERBUFFER, _depth_renderbuffer);
+                }
+            }
+            gl::BindRenderbuffer(GL_RENDERBUFFER, 0);
+            if (gl::CheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+                std::cerr << "Failed to create a render target framebuffer." << std::endl;
+            }
+
+            if (multisampled) {
+                gl::GenFramebuffers(1, &_resolve_framebuffer);
+                gl::BindFramebuffer(GL_FRAMEBUFFER, _resolve_framebuffer);
+                gl::FramebufferTexture2D(
+                    GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, _es2_color_texture->get_texture_object(), 0
+                );
+                if (gl::CheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+                    std::cerr << "Failed to create a render target resolve framebuffer." << std::endl;
+                }
+            }
+
+            gl::BindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(previous_framebuffer));
+
+            _requires_update = false;
+        }
+
+        void _delete_objects()
+        {
+            if (_resolve_framebuffer != 0) {
+                gl::DeleteFramebuffers(1, &_resolve_framebuffer);
+                _resolve_framebuffer = 0;
+            }
+            if (_framebuffer != 0) {
+                gl::DeleteFramebuffers(1, &_framebuffer);
+                _framebuffer = 0;
+            }
+            if (_depth_renderbuffer != 0) {
+                gl::DeleteRenderbuffers(1, &_depth_renderbuffer);
+                _depth_renderbuffer = 0;
+            }
+            if (_color_renderbuffer != 0) {
+                gl::DeleteRenderbuffers(1, &_color_renderbuffer);
+                _color_renderbuffer = 0;
+            }
+        }
+
+        static GLenum _convert_depth_format_to_es2_renderbuffer_format(RenderTarget::DepthFormat depth_format)
+        {
+            switch (depth_format) {
+                case NoDepth:
+                    break;
+                case Depth16:
+                    return GL_DEPTH_COMPONENT16;
+                case Depth24:
+                    return GL_DEPTH_COMPONENT24;
+                case Depth24Stencil8:
+                    return GL_DEPTH24_STENCIL8;
+            }
+
+            return GL_DEPTH_COMPONENT16;
+        }
+    };
+}
+
+#endif
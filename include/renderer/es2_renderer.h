@@ -4,6 +4,17 @@
 #include "renderer/renderer.h"
 #include "objects/object.h"
 #include "objects/mesh.h"
+#include "objects/lod_mesh.h"
+#include "renderer/es2_shader.h"
+#include "renderer/shader_compile_queue.h"
+#include "renderer/shader_reloader.h"
+#include "renderer/render_target.h"
+#include "renderer/es2_render_target.h"
+#include "renderer/es2_gpu_timer.h"
+#include "renderer/es2_command_buffer.h"
+#include "renderer/resolution_scaler.h"
+#include "renderer/gl_dispatch.h"
+#include "utilities/profiler.h"
 
 #include <GL/glew.h>
 #define SDL_MAIN_HANDLED
@@ -11,7 +22,13 @@
 #include <glm/glm.hpp>
 
 #include <queue>
+#include <vector>
+#include <utility>
+#include <array>
 #include <memory>
+#include <chrono>
+#include <cmath>
+#include <iostream>
 
 namespace asr
 {
@@ -22,47 +39,364 @@ namespace asr
             : Renderer(scene, window)
         {
             glm::vec4 clear_color = scene->get_clear_color();
-            glClearColor(clear_color.r, clear_color.g, clear_color.b, clear_color.a);
+            gl::ClearColor(clear_color.r, clear_color.g, clear_color.b, clear_color.a);
 
-            glEnable(GL_PROGRAM_POINT_SIZE);
+            gl::Enable(GL_PROGRAM_POINT_SIZE);
+
+            if (ES2Shader::is_parallel_compilation_supported()) {
+                gl::MaxShaderCompilerThreads(0xFFFFFFFF);
+            }
 
             std::queue<std::shared_ptr<Object>> queue;
             queue.push(scene->get_root());
             while (!queue.empty()) {
                 const auto object = queue.front(); queue.pop();
                 if (auto mesh = std::dynamic_pointer_cast<Mesh>(object)) {
-                    const auto &geometry = mesh->get_geometry();
                     const auto &material = mesh->get_material();
 
-                    material->use();
-                    material->update(scene, mesh);
-                    geometry->update(*mesh->get_material());
+                    material->prepare_shader(scene);
+                    _shader_compile_queue.add(material->get_shader());
                 }
 
                 for (const auto &child: object->get_children()) { queue.push(child); }
             }
         }
 
+        [[nodiscard]] const ShaderCompileQueue &get_shader_compile_queue() const
+        {
+            return _shader_compile_queue;
+        }
+
+        void finish_shader_compilation()
+        {
+            _shader_compile_queue.finish();
+        }
+
+        [[nodiscard]] bool is_shader_hot_reload_enabled() const
+        {
+            return _shader_reloader != nullptr;
+        }
+
+        void set_shader_hot_reload_enabled(bool shader_hot_reload_enabled)
+        {
+            if (!shader_hot_reload_enabled) {
+                _shader_reloader.reset();
+            } else if (!_shader_reloader) {
+                _shader_reloader = std::make_unique<ShaderReloader>();
+
+                std::queue<std::shared_ptr<Object>> queue;
+                queue.push(scene->get_root());
+                while (!queue.empty()) {
+                    const auto object = queue.front(); queue.pop();
+                    if (auto mesh = std::dynamic_pointer_cast<Mesh>(object)) {
+                        _shader_reloader->add(mesh->get_material()->get_shader());
+                    }
+
+                    for (const auto &child: object->get_children()) { queue.push(child); }
+                }
+            }
+        }
+
+        [[nodiscard]] ShaderReloader *get_shader_reloader() const
+        {
+            return _shader_reloader.get();
+        }
+
+        [[nodiscard]] bool is_dynamic_resolution_enabled() const
+        {
+            return _dynamic_resolution_enabled;
+        }
+
+        /* Renders the scene at a fraction of the window's resolution, picked by the resolution scaler to hold
+           its target frame time, and upscales the result to the window. Requires framebuffer blitting and a
+           window without multisampling, since a scaled blit into a multisampled framebuffer is not allowed. */
+        void set_dynamic_resolution_enabled(bool dynamic_resolution_enabled)
+        {
+            if (dynamic_resolution_enabled && ES2RenderTarget::is_blitting_supported()) {
+                GLint sample_buffers{0};
+                gl::BindFramebuffer(GL_FRAMEBUFFER, window->get_framebuffer());
+                gl::GetIntegerv(GL_SAMPLE_BUFFERS, &sample_buffers);
+                if (sample_buffers != 0) {
+                    std::cerr << "Dynamic resolution is not supported for windows with multisampling" << std::endl;
+                    dynamic_resolution_enabled = false;
+                }
+            }
+            _dynamic_resolution_enabled = dynamic_resolution_enabled && ES2RenderTarget::is_blitting_supported();
+            if (!_dynamic_resolution_enabled) {
+                _scaled_target.reset();
+            } else if (!_scaled_target) {
+                _scaled_target = std::make_unique<ES2RenderTarget>(window->get_width(), window->get_height());
+                _resolution_scaler.reset();
+                _last_frame_time = std::chrono::steady_clock::now();
+            }
+        }
+
+        [[nodiscard]] ResolutionScaler &get_resolution_scaler()
+        {
+            return _resolution_scaler;
+        }
+
+        /* Meshes below a static object of the main scene are recorded once into command buffers that are replayed
+           every frame instead of being traversed and recorded again, so the subtree must not change. The buffers
+           are recorded again when the camera moves, a shader of the subtree is reloaded, one of its resources
+           was evicted or one of its textures has changes to upload, and after `invalidate_static_subtrees`, e.g. when the lights change. Static meshes are
+           drawn before the others of each pass, so transparent ones are only sorted among themselves. */
+        void add_static_subtree(const std::shared_ptr<Object> &object)
+        {
+            if (!_find_static_subtree(object)) {
+                _static_subtrees.emplace_back();
+                _static_subtrees.back().object = object;
+            }
+        }
+
+        void remove_static_subtree(const std::shared_ptr<Object> &object)
+        {
+            _static_subtrees.erase(
+                std::remove_if(std::begin(_static_subtrees), std::end(_static_subtrees), [&](const auto &static_subtree) {
+                    return static_subtree.object == object;
+                }),
+                std::end(_static_subtrees)
+            );
+        }
+
+        void invalidate_static_subtrees()
+        {
+            for (auto &static_subtree : _static_subtrees) {
+                static_subtree.recorded = false;
+            }
+        }
+
+        /* Also ends a frame of the shared profiler, if it is enabled. */
         void render() final
         {
-            glViewport(0, 0, static_cast<GLsizei>(window->get_width()), static_cast<GLsizei>(window->get_height()));
-            glClear(static_cast<unsigned int>(GL_COLOR_BUFFER_BIT) | static_cast<unsigned int>(GL_DEPTH_BUFFER_BIT));
+            Profiler &profiler = Profiler::get_shared_instance();
+
+            if (_shader_reloader) {
+                _shader_reloader->update();
+            }
+            _shader_compile_queue.poll();
+
+            _update_pass_timers();
+            float gpu_time{0.0f};
+            bool has_gpu_time = _read_pass_timers(gpu_time);
+
+            if (_dynamic_resolution_enabled) {
+                _render_scaled_scene(has_gpu_time ? gpu_time : 0.0f);
+            } else {
+                gl::BindFramebuffer(GL_FRAMEBUFFER, window->get_framebuffer());
+                _render_scene(scene, window->get_width(), window->get_height(), true);
+            }
+
+            if (profiler.is_overlay_enabled()) {
+                profiler.draw_overlay();
+            }
+            {
+                Profiler::Scope profiler_scope{"Swap"};
+                window->swap();
+            }
+
+            profiler.end_frame();
+        }
+
+        /* Renders a scene through its camera into an offscreen target. Usually called before `render`, so that
+           materials of the main scene can sample the target in the same frame. */
+        void render(const std::shared_ptr<Scene> &target_scene, RenderTarget &target) final
+        {
+            Profiler::Scope profiler_scope{"Render Target"};
+
+            target.bind();
+            _render_scene(target_scene, target.get_width(), target.get_height());
+            target.resolve();
+
+            gl::BindFramebuffer(GL_FRAMEBUFFER, window->get_framebuffer());
+        }
+
+    private:
+        enum Pass
+        {
+            OpaquePass,
+            TransparentPass,
+            OverlayPass,
+            PassCount
+        };
+
+        ShaderCompileQueue _shader_compile_queue;
+        std::unique_ptr<ShaderReloader> _shader_reloader;
+
+        bool _dynamic_resolution_enabled{false};
+        ResolutionScaler _resolution_scaler;
+        std::unique_ptr<ES2RenderTarget> _scaled_target;
+        std::chrono::steady_clock::time_point _last_frame_time;
+
+        std::array<std::unique_ptr<ES2GPUTimer>, PassCount> _pass_timers;
+
+        struct StaticSubtree
+        {
+            std::shared_ptr<Object> object;
+            std::array<ES2CommandBuffer, PassCount> command_buffers;
+            std::vector<std::shared_ptr<GPUResource>> resources;
+            std::vector<std::shared_ptr<Texture>> textures;
+            std::vector<std::pair<std::shared_ptr<Shader>, unsigned int>> shader_revisions;
+            glm::mat4 view_matrix{0.0f};
+            glm::mat4 projection_matrix{0.0f};
+            bool recorded{false};
+        };
+
+        std::shared_ptr<ES2CommandRecorder> _command_recorder{std::make_shared<ES2CommandRecorder>()};
+        ES2CommandBuffer _command_buffer;
+        std::vector<StaticSubtree> _static_subtrees;
+
+        /* Timer queries are only issued while something consumes them. */
+        void _update_pass_timers()
+        {
+            bool required = (_dynamic_resolution_enabled || Profiler::get_shared_instance().is_enabled()) &&
+                            ES2GPUTimer::is_supported();
+            for (auto &pass_timer : _pass_timers) {
+                if (!required) {
+                    pass_timer.reset();
+                } else if (!pass_timer) {
+                    pass_timer = std::make_unique<ES2GPUTimer>();
+                }
+            }
+        }
+
+        /* Sums up the latest available times of the main scene passes and reports them to the profiler. */
+        bool _read_pass_timers(float &gpu_time)
+        {
+            bool has_gpu_time{false};
+            gpu_time = 0.0f;
+            for (size_t pass = 0; pass < PassCount; ++pass) {
+                float pass_time;
+                if (_pass_timers[pass] && _pass_timers[pass]->get_elapsed_time(pass_time)) {
+                    Profiler::get_shared_instance().add_gpu_time(_get_pass_name(static_cast<Pass>(pass)), pass_time);
+                    gpu_time += pass_time;
+                    has_gpu_time = true;
+                }
+            }
+
+            return has_gpu_time;
+        }
+
+        /* The GPU time of the scene passes is used when timer queries are available, since it is the part that
+           shrinks with the resolution. Otherwise the whole frame interval is measured on the CPU. */
+        void _render_scaled_scene(float gpu_time)
+        {
+            auto now = std::chrono::steady_clock::now();
+            float frame_time = std::chrono::duration<float, std::milli>(now - _last_frame_time).count();
+            _last_frame_time = now;
+            if (_pass_timers[OpaquePass]) {
+                frame_time = gpu_time;
+            }
+            _resolution_scaler.update(frame_time);
+
+            unsigned int width = window->get_width();
+            unsigned int height = window->get_height();
+            float maximum_scale = _resolution_scaler.get_maximum_scale();
+            _scaled_target->set_size(
+                std::max(1u, static_cast<unsigned int>(std::ceil(static_cast<float>(width) * maximum_scale))),
+                std::max(1u, static_cast<unsigned int>(std::ceil(static_cast<float>(height) * maximum_scale)))
+            );
+
+            /* The target keeps the size of the largest scale and only a part of it is drawn into, so that
+               changing the scale never reallocates it. */
+            float scale = _resolution_scaler.get_scale();
+            auto scaled_width = std::min(
+                _scaled_target->get_width(), std::max(1u, static_cast<unsigned int>(std::lround(static_cast<float>(width) * scale)))
+            );
+            auto scaled_height = std::min(
+                _scaled_target->get_height(), std::max(1u, static_cast<unsigned int>(std::lround(static_cast<float>(height) * scale)))
+            );
+
+            _scaled_target->bind();
+            _render_scene(scene, scaled_width, scaled_height, glm::vec4(0, 0, width, height), true);
+
+            gl::BindFramebuffer(GL_READ_FRAMEBUFFER, _scaled_target->get_framebuffer());
+            gl::BindFramebuffer(GL_DRAW_FRAMEBUFFER, window->get_framebuffer());
+            gl::BlitFramebuffer(
+                0, 0, static_cast<GLint>(scaled_width), static_cast<GLint>(scaled_height),
+                0, 0, static_cast<GLint>(width), static_cast<GLint>(height),
+                GL_COLOR_BUFFER_BIT, GL_LINEAR
+            );
+            gl::BindFramebuffer(GL_FRAMEBUFFER, window->get_framebuffer());
+            gl::Viewport(0, 0, static_cast<GLsizei>(width), static_cast<GLsizei>(height));
+        }
+
+        void _render_scene(const std::shared_ptr<Scene> &scene, unsigned int width, unsigned int height, bool timed = false)
+        {
+            _render_scene(scene, width, height, glm::vec4(0, 0, width, height), timed);
+        }
+
+        /* `viewport` is what the camera reports for picking, which differs from the drawn area when rendering at a scale.
+           Only the main scene is `timed`, since timer queries of the passes can not overlap. */
+        void _render_scene(
+            const std::shared_ptr<Scene> &scene, unsigned int width, unsigned int height, const glm::vec4 &viewport,
+            bool timed = false
+        ) {
+            glm::vec4 clear_color = scene->get_clear_color();
+            gl::ClearColor(clear_color.r, clear_color.g, clear_color.b, clear_color.a);
+            gl::Viewport(0, 0, static_cast<GLsizei>(width), static_cast<GLsizei>(height));
+            gl::Clear(static_cast<unsigned int>(GL_COLOR_BUFFER_BIT) | static_cast<unsigned int>(GL_DEPTH_BUFFER_BIT));
 
             auto camera = scene->get_camera();
             if (camera->should_receive_aspect_ratio_from_renderer()) {
-                float aspect_ratio = fabsf(static_cast<float>(window->get_width()) / static_cast<float>(window->get_height()));
+                float aspect_ratio = fabsf(static_cast<float>(width) / static_cast<float>(height));
                 camera->set_aspect_ratio(aspect_ratio);
             }
             if (camera->should_receive_viewport_from_renderer()) {
-                camera->set_viewport(glm::vec4(0, 0, window->get_width(), window->get_height()));
+                camera->set_viewport(viewport);
             }
 
+            /* Static subtrees only belong to the main scene. */
+            bool main_scene = scene == this->scene;
+
             std::vector<std::shared_ptr<Mesh>> opaque, transparent, overlays;
+            {
+                Profiler::Scope profiler_scope{"Traversal"};
+
+                _collect_meshes(scene->get_root(), main_scene, *camera, static_cast<float>(height), opaque, transparent, overlays);
+            }
+
+            {
+                Profiler::Scope profiler_scope{"Sort"};
+
+                _sort_meshes(*camera, transparent, overlays);
+            }
+
+            if (main_scene) {
+                for (auto &static_subtree : _static_subtrees) {
+                    _update_static_subtree(scene, static_subtree, height);
+                }
+            }
+
+            _render_pass(scene, opaque, OpaquePass, timed, main_scene);
+            _render_pass(scene, transparent, TransparentPass, timed, main_scene);
+            _render_pass(scene, overlays, OverlayPass, timed, main_scene);
+        }
+
+        /* Objects below `root` that are static subtrees themselves are skipped if `skip_static_subtrees` is set.
+           Levels of detail are selected for a viewport `viewport_height` pixels high. */
+        void _collect_meshes(
+            const std::shared_ptr<Object> &root, bool skip_static_subtrees, Camera &camera, float viewport_height,
+            std::vector<std::shared_ptr<Mesh>> &opaque, std::vector<std::shared_ptr<Mesh>> &transparent,
+            std::vector<std::shared_ptr<Mesh>> &overlays
+        ) {
+            bool profiled = Profiler::get_shared_instance().is_enabled();
+
             std::queue<std::shared_ptr<Object>> queue;
-            queue.push(scene->get_root());
+            queue.push(root);
             while (!queue.empty()) {
                 const auto object = queue.front(); queue.pop();
+                if (skip_static_subtrees && object != root && _find_static_subtree(object)) {
+                    continue;
+                }
                 if (auto mesh = std::dynamic_pointer_cast<Mesh>(object)) {
+                    if (auto *lod_mesh = dynamic_cast<LODMesh *>(mesh.get())) {
+                        lod_mesh->select_level(camera, viewport_height);
+                        if (profiled) {
+                            Profiler::count(Profiler::SavedTriangles, lod_mesh->get_full_triangle_count() - lod_mesh->get_triangle_count());
+                        }
+                    }
+
                     auto material = mesh->get_material();
                     if (material->is_overlay()) {
                         overlays.push_back(mesh);
@@ -75,45 +409,206 @@ namespace asr
 
                 for (const auto &child: object->get_children()) { queue.push(child); }
             }
+        }
 
+        static void _sort_meshes(Camera &camera, std::vector<std::shared_ptr<Mesh>> &transparent, std::vector<std::shared_ptr<Mesh>> &overlays)
+        {
             std::sort(std::begin(transparent), std::end(transparent), [&](const auto &a, const auto &b) {
-                return glm::length(camera->get_world_position() - a->get_world_position()) >
-                           glm::length(camera->get_world_position() - b->get_world_position());
+                return glm::length(camera.get_world_position() - a->get_world_position()) >
+                           glm::length(camera.get_world_position() - b->get_world_position());
             });
             std::sort(std::begin(overlays), std::end(overlays), [](const auto &a, const auto &b) {
                 return a->get_material()->get_overlay_priority() > b->get_material()->get_overlay_priority();
             });
+        }
 
-            for (auto &mesh : opaque) {
-                _render_mesh(mesh);
+        StaticSubtree *_find_static_subtree(const std::shared_ptr<Object> &object)
+        {
+            for (auto &static_subtree : _static_subtrees) {
+                if (static_subtree.object == object) {
+                    return &static_subtree;
+                }
             }
-            for (auto &mesh : transparent) {
-                _render_mesh(mesh);
+
+            return nullptr;
+        }
+
+        /* Records the subtree again if its buffers went stale, otherwise keeps its resources from being evicted. */
+        void _update_static_subtree(const std::shared_ptr<Scene> &scene, StaticSubtree &static_subtree, unsigned int viewport_height)
+        {
+            auto camera = scene->get_camera();
+            if (static_subtree.recorded && _is_static_subtree_valid(*camera, static_subtree)) {
+                for (const auto &resource : static_subtree.resources) {
+                    resource->mark_used();
+                }
+                return;
             }
-            for (auto &mesh : overlays) {
-                _render_mesh(mesh);
+
+            Profiler::Scope profiler_scope{"Static Recording"};
+
+            std::array<std::vector<std::shared_ptr<Mesh>>, PassCount> meshes;
+            _collect_meshes(
+                static_subtree.object, true, *camera, static_cast<float>(viewport_height),
+                meshes[OpaquePass], meshes[TransparentPass], meshes[OverlayPass]
+            );
+            _sort_meshes(*camera, meshes[TransparentPass], meshes[OverlayPass]);
+
+            /* Meshes whose shaders are still compiling are left out, and the subtree is recorded again next frame. */
+            bool complete{true};
+            for (size_t pass = 0; pass < PassCount; ++pass) {
+                static_subtree.command_buffers[pass].clear();
+                complete = _record_meshes(scene, meshes[pass], static_subtree.command_buffers[pass]) && complete;
             }
 
-            window->swap();
+            static_subtree.resources.clear();
+            static_subtree.textures.clear();
+            static_subtree.shader_revisions.clear();
+            for (const auto &pass_meshes : meshes) {
+                for (const auto &mesh : pass_meshes) {
+                    static_subtree.resources.push_back(mesh->get_geometry());
+                    for (const auto &texture : mesh->get_material()->get_textures()) {
+                        static_subtree.resources.push_back(texture);
+                        static_subtree.textures.push_back(texture);
+                    }
+                    const auto &shader = mesh->get_material()->get_shader();
+                    static_subtree.shader_revisions.emplace_back(shader, shader->get_revision());
+                }
+            }
+            static_subtree.view_matrix = camera->get_view_matrix();
+            static_subtree.projection_matrix = camera->get_projection_matrix();
+            static_subtree.recorded = complete;
         }
 
-    private:
-        void _render_mesh(const std::shared_ptr<Mesh> &mesh) const
+        static bool _is_static_subtree_valid(Camera &camera, const StaticSubtree &static_subtree)
+        {
+            if (camera.get_view_matrix() != static_subtree.view_matrix ||
+                camera.get_projection_matrix() != static_subtree.projection_matrix) {
+                return false;
+            }
+            for (const auto &shader_revision : static_subtree.shader_revisions) {
+                if (!shader_revision.first->is_compiled() || shader_revision.first->get_revision() != shader_revision.second) {
+                    return false;
+                }
+            }
+            for (const auto &resource : static_subtree.resources) {
+                if (!resource->is_resident()) {
+                    return false;
+                }
+            }
+            /* Replaying skips `Material::update`, so pending uploads are only made by recording again. */
+            for (const auto &texture : static_subtree.textures) {
+                if (texture->requires_data_update() || texture->requires_params_update() || !texture->get_dirty_rectangles().empty()) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        void _render_pass(
+            const std::shared_ptr<Scene> &scene, const std::vector<std::shared_ptr<Mesh>> &meshes, Pass pass, bool timed,
+            bool main_scene
+        ) {
+            Profiler::Scope profiler_scope{_get_pass_name(pass)};
+
+            _command_buffer.clear();
+            _record_meshes(scene, meshes, _command_buffer);
+
+            Profiler::Scope submit_profiler_scope{"Submit"};
+
+            ES2GPUTimer *pass_timer = timed ? _pass_timers[pass].get() : nullptr;
+            if (pass_timer) {
+                pass_timer->begin();
+            }
+            if (main_scene) {
+                for (const auto &static_subtree : _static_subtrees) {
+                    static_subtree.command_buffers[pass].submit();
+                }
+            }
+            _command_buffer.submit();
+            if (pass_timer) {
+                pass_timer->end();
+            }
+        }
+
+        /* Returns false if a mesh was left out because its shader is not ready. */
+        bool _record_meshes(const std::shared_ptr<Scene> &scene, const std::vector<std::shared_ptr<Mesh>> &meshes, ES2CommandBuffer &command_buffer)
+        {
+            bool complete{true};
+
+            _command_recorder->begin(command_buffer);
+            for (const auto &mesh : meshes) {
+                complete = _record_mesh(scene, mesh) && complete;
+            }
+            _command_recorder->end();
+
+            return complete;
+        }
+
+        bool _record_mesh(const std::shared_ptr<Scene> &scene, const std::shared_ptr<Mesh> &mesh)
         {
             auto geometry = mesh->get_geometry();
             auto material = mesh->get_material();
 
-            material->use();
-            material->update(scene, mesh);
-            geometry->update(*material);
+            if (!_is_shader_ready(material->get_shader())) {
+                return false;
+            }
+
+            /* Textures are uploaded by `update` and bound by `use`, so that the units an upload leaves unbound are
+               bound again before the draw is recorded. */
+            {
+                Profiler::Scope profiler_scope{"Material Update"};
+
+                material->update(scene, mesh);
+                material->use();
+            }
+            if (!_is_shader_ready(material->get_shader())) {
+                _command_recorder->discard_pending();
+                return false;
+            }
+            {
+                Profiler::Scope profiler_scope{"Upload"};
+
+                geometry->update(*material);
+            }
             geometry->use();
 
-            glDrawElements(
+            gl::DrawElements(
                 _convert_geometry_type_to_es2_geometry_type(geometry->get_type()),
-                static_cast<GLsizei>(geometry->get_indices().size()),
+                static_cast<GLsizei>(geometry->get_index_count()),
                 GL_UNSIGNED_INT,
                 nullptr
             );
+
+            return true;
+        }
+
+        bool _is_shader_ready(const std::shared_ptr<Shader> &shader)
+        {
+            if (shader->is_dead()) {
+                return false;
+            }
+            if (shader->is_pending() || !shader->is_compiled()) {
+                _shader_compile_queue.add(shader);
+            }
+
+            return shader->is_compiled();
+        }
+
+        static const char *_get_pass_name(Pass pass)
+        {
+            switch (pass) {
+                case OpaquePass:
+                    return "Opaque";
+                case TransparentPass:
+                    return "Transparent";
+                case OverlayPass:
+                    return "Overlays";
+                case PassCount:
+                    break;
+            }
+
+            return "";
         }
 
         static GLenum _convert_geometry_type_to_es2_geometry_type(Geometry::Type type)
@@ -2,11 +2,16 @@
 #define ES2_SHADER_H
 
 #include "renderer/shader.h"
+#include "renderer/gl_dispatch.h"
 
 #include <GL/glew.h>
 #define SDL_MAIN_HANDLED
 #include <SDL.h>
 
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
 #include <string>
 #include <vector>
 #include <iostream>
@@ -27,40 +32,107 @@ namespace asr
 
         ~ES2Shader() final
         {
+            _discard_pending_program();
             if (_program != -1) {
-                glDeleteProgram(static_cast<GLuint>(_program));
+                gl::DeleteProgram(static_cast<GLuint>(_program));
             }
         }
 
         void compile() final
         {
             cleanup();
+            submit();
+            poll(true);
+        }
+
+        void submit() final
+        {
+            _discard_pending_program();
+
+            _pending_vertex_shader_object = _create_shader(GL_VERTEX_SHADER);
+            _pending_fragment_shader_object = _create_shader(GL_FRAGMENT_SHADER);
+
+            _pending_program = gl::CreateProgram();
+            gl::AttachShader(_pending_program, _pending_vertex_shader_object);
+            gl::AttachShader(_pending_program, _pending_fragment_shader_object);
+
+            /* Fixed attribute locations keep vertex array objects valid when a program is relinked. Desktop
+               compatibility contexts draw nothing unless attribute 0 is enabled, so positions always get it. */
+            GLuint attribute_location{0};
+            bool has_position_attribute = _attributes.count(POSITION_ATTRIBUTE) > 0;
+            if (has_position_attribute) {
+                gl::BindAttribLocation(_pending_program, attribute_location++, POSITION_ATTRIBUTE);
+            }
+            for (auto const &attribute : _attributes) {
+                if (!has_position_attribute || attribute.first != POSITION_ATTRIBUTE) {
+                    gl::BindAttribLocation(_pending_program, attribute_location++, attribute.first.c_str());
+                }
+            }
+            gl::LinkProgram(_pending_program);
+
+            _pending_polls = 0;
+            _pending = true;
+            _dead = false;
+        }
 
-            int vertex_shader_object = _compile_shader(GL_VERTEX_SHADER);
-            if (vertex_shader_object == -1) {
-                _dead = true;
-                return;
+        bool poll(bool wait) final
+        {
+            if (!_pending) {
+                return true;
             }
 
-            int fragment_shader_object = _compile_shader(GL_FRAGMENT_SHADER);
-            if (fragment_shader_object == -1) {
-                _dead = true;
-                return;
+            if (!wait) {
+                if (is_parallel_compilation_supported()) {
+                    GLint completed{GL_FALSE};
+                    gl::GetProgramiv(_pending_program, GL_COMPLETION_STATUS_KHR, &completed);
+                    if (completed == GL_FALSE) {
+                        return false;
+                    }
+                } else if (_pending_polls++ < DEFERRED_STATUS_POLLS) {
+                    return false;
+                }
             }
 
-            int shader_program = _link_shader(static_cast<GLuint>(vertex_shader_object), static_cast<GLuint>(fragment_shader_object));
-            if (shader_program == -1) {
-                _dead = true;
-                return;
+            bool vertex_shader_compiled = _check_shader(_pending_vertex_shader_object, GL_VERTEX_SHADER);
+            bool fragment_shader_compiled = _check_shader(_pending_fragment_shader_object, GL_FRAGMENT_SHADER);
+            if (!(vertex_shader_compiled && fragment_shader_compiled && _check_program(_pending_program))) {
+                _discard_pending_program();
+                if (_program == -1) {
+                    _dead = true;
+                }
+                return true;
             }
 
-            _program = shader_program;
+            gl::DetachShader(_pending_program, _pending_vertex_shader_object);
+            gl::DetachShader(_pending_program, _pending_fragment_shader_object);
+            gl::DeleteShader(_pending_vertex_shader_object);
+            gl::DeleteShader(_pending_fragment_shader_object);
+            _pending_vertex_shader_object = 0;
+            _pending_fragment_shader_object = 0;
+
+            for (auto const &attribute : _attributes) {
+                _attributes[attribute.first] = gl::GetAttribLocation(_pending_program, attribute.first.c_str());
+            }
+            for (auto const &uniform : _uniforms) {
+                _uniforms[uniform.first] = gl::GetUniformLocation(_pending_program, uniform.first.c_str());
+            }
+
+            if (_program != -1) {
+                gl::DeleteProgram(static_cast<GLuint>(_program));
+            }
+            _program = static_cast<int>(_pending_program);
+            _pending_program = 0;
+            _pending = false;
+            ++_revision;
+
+            return true;
         }
 
         void cleanup() final
         {
+            _discard_pending_program();
             if (_program != -1) {
-                glDeleteProgram(static_cast<GLuint>(_program));
+                gl::DeleteProgram(static_cast<GLuint>(_program));
             }
             _program = -1;
             _dead = false;
@@ -69,79 +141,101 @@ namespace asr
         void use() final
         {
             if (_program != -1) {
-                glUseProgram(static_cast<GLuint>(_program));
+                gl::UseProgram(static_cast<GLuint>(_program));
             }
         }
 
+        static bool is_parallel_compilation_supported()
+        {
+            return gl::is_supported(gl::ParallelShaderCompile);
+        }
+
     private:
-        int _compile_shader(GLenum shader_type)
+        /* Without KHR_parallel_shader_compile, status queries are postponed by a few polls to let
+           the driver finish compiling on its own threads instead of stalling on the first query. */
+        static const unsigned int DEFERRED_STATUS_POLLS{2};
+
+        static constexpr const char *POSITION_ATTRIBUTE{"position"};
+
+        GLuint _pending_vertex_shader_object{0};
+        GLuint _pending_fragment_shader_object{0};
+        GLuint _pending_program{0};
+        unsigned int _pending_polls{0};
+
+        GLuint _create_shader(GLenum shader_type)
         {
-            const char *shader_source =
+            std::string source =
                 shader_type == GL_VERTEX_SHADER ?
-                    _vertex_shader_source.c_str() :
-                    _fragment_shader_source.c_str();
+                    _vertex_shader_source :
+                    _fragment_shader_preamble + _fragment_shader_source;
+            const char *shader_source = source.c_str();
 
-            GLuint shader_object = glCreateShader(shader_type);
-            glShaderSource(shader_object, 1, static_cast<const GLchar **>(&shader_source), nullptr);
-            glCompileShader(shader_object);
+            GLuint shader_object = gl::CreateShader(shader_type);
+            gl::ShaderSource(shader_object, 1, static_cast<const GLchar **>(&shader_source), nullptr);
+            gl::CompileShader(shader_object);
 
+            return shader_object;
+        }
+
+        static bool _check_shader(GLuint shader_object, GLenum shader_type)
+        {
             GLint status;
-            glGetShaderiv(shader_object, GL_COMPILE_STATUS, &status);
+            gl::GetShaderiv(shader_object, GL_COMPILE_STATUS, &status);
             if (status == GL_FALSE) {
                 GLint info_log_length;
-                glGetShaderiv(shader_object, GL_INFO_LOG_LENGTH, &info_log_length);
+                gl::GetShaderiv(shader_object, GL_INFO_LOG_LENGTH, &info_log_length);
                 if (info_log_length > 0) {
                     auto *info_log = new GLchar[static_cast<size_t>(info_log_length)];
 
-                    glGetShaderInfoLog(shader_object, info_log_length, nullptr, info_log);
-                    std::cerr << "Failed to compile a vertex shader" << std::endl
+                    gl::GetShaderInfoLog(shader_object, info_log_length, nullptr, info_log);
+                    std::cerr << "Failed to compile a " << (shader_type == GL_VERTEX_SHADER ? "vertex" : "fragment") << " shader" << std::endl
                               << "Compilation log:\n" << info_log << std::endl << std::endl;
 
                     delete[] info_log;
                 }
-                return _program = -1;
+                return false;
             }
 
-            return static_cast<int>(shader_object);
+            return true;
         }
 
-        int _link_shader(GLuint vertex_shader_object, GLuint fragment_shader_object)
+        static bool _check_program(GLuint shader_program)
         {
-            GLuint shader_program = glCreateProgram();
-            glAttachShader(shader_program, vertex_shader_object);
-            glAttachShader(shader_program, fragment_shader_object);
-            glLinkProgram(shader_program);
-
             GLint status;
-            glGetProgramiv(shader_program, GL_LINK_STATUS, &status);
+            gl::GetProgramiv(shader_program, GL_LINK_STATUS, &status);
             if (status == GL_FALSE) {
                 GLint info_log_length;
-                glGetProgramiv(shader_program, GL_INFO_LOG_LENGTH, &info_log_length);
+                gl::GetProgramiv(shader_program, GL_INFO_LOG_LENGTH, &info_log_length);
                 if (info_log_length > 0) {
                     auto *info_log = new GLchar[static_cast<size_t>(info_log_length)];
 
-                    glGetProgramInfoLog(shader_program, info_log_length, nullptr, info_log);
+                    gl::GetProgramInfoLog(shader_program, info_log_length, nullptr, info_log);
                     std::cerr << "Failed to link a shader program" << std::endl
                               << "Linker log:\n" << info_log << std::endl << std::endl;
 
                     delete[] info_log;
                 }
-                return _program = -1;
+                return false;
             }
 
-            glDetachShader(shader_program, vertex_shader_object);
-            glDetachShader(shader_program, fragment_shader_object);
-            glDeleteShader(vertex_shader_object);
-            glDeleteShader(fragment_shader_object);
+            return true;
+        }
 
-            for (auto const &attribute : _attributes) {
-                _attributes[attribute.first] = glGetAttribLocation(shader_program, attribute.first.c_str());
+        void _discard_pending_program()
+        {
+            if (_pending_program != 0) {
+                gl::DeleteProgram(_pending_program);
+                _pending_program = 0;
             }
-            for (auto const &uniform : _uniforms) {
-                _uniforms[uniform.first] = glGetUniformLocation(shader_program, uniform.first.c_str());
+            if (_pending_vertex_shader_object != 0) {
+                gl::DeleteShader(_pending_vertex_shader_object);
+                _pending_vertex_shader_object = 0;
             }
-
-            return static_cast<int>(shader_program);
+            if (_pending_fragment_shader_object != 0) {
+                gl::DeleteShader(_pending_fragment_shader_object);
+                _pending_fragment_shader_object = 0;
+            }
+            _pending = false;
         }
     };
 }
@@ -0,0 +1,548 @@
+#ifndef GL_DISPATCH_H
+#define GL_DISPATCH_H
+
+#include <GL/glew.h>
+#define SDL_MAIN_HANDLED
+#include <SDL.h>
+
+#include <cstdint>
+#include <array>
+#include <string>
+#include <vector>
+#include <memory>
+#include <tuple>
+
+/* The GL functions used by the ES2 classes, as (return type, name without the gl prefix, parameters, arguments).
+   Functions whose entry points differ between platforms or extensions are listed separately. */
+#define ASR_GL_CORE_FUNCTIONS(F) \
+    F(void, ActiveTexture, (GLenum texture), (texture)) \
+    F(void, AttachShader, (GLuint program, GLuint shader), (program, shader)) \
+    F(void, BeginQuery, (GLenum target, GLuint id), (target, id)) \
+    F(void, BindAttribLocation, (GLuint program, GLuint index, const GLchar *name), (program, index, name)) \
+    F(void, BindBuffer, (GLenum target, GLuint buffer), (target, buffer)) \
+    F(void, BindFramebuffer, (GLenum target, GLuint framebuffer), (target, framebuffer)) \
+    F(void, BindRenderbuffer, (GLenum target, GLuint renderbuffer), (target, renderbuffer)) \
+    F(void, BindTexture, (GLenum target, GLuint texture), (target, texture)) \
+    F(void, BlendColor, (GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha), (red, green, blue, alpha)) \
+    F(void, BlendEquationSeparate, (GLenum color_mode, GLenum alpha_mode), (color_mode, alpha_mode)) \
+    F(void, BlendFuncSeparate, \
+      (GLenum source_color, GLenum destination_color, GLenum source_alpha, GLenum destination_alpha), \
+      (source_color, destination_color, source_alpha, destination_alpha)) \
+    F(void, BlitFramebuffer, \
+      (GLint source_x0, GLint source_y0, GLint source_x1, GLint source_y1, \
+       GLint destination_x0, GLint destination_y0, GLint destination_x1, GLint destination_y1, GLbitfield mask, GLenum filter), \
+      (source_x0, source_y0, source_x1, source_y1, destination_x0, destination_y0, destination_x1, destination_y1, mask, filter)) \
+    F(void, BufferData, (GLenum target, GLsizeiptr size, const void *data, GLenum usage), (target, size, data, usage)) \
+    F(GLenum, CheckFramebufferStatus, (GLenum target), (target)) \
+    F(void, Clear, (GLbitfield mask), (mask)) \
+    F(void, ClearColor, (GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha), (red, green, blue, alpha)) \
+    F(void, CompileShader, (GLuint shader), (shader)) \
+    F(void, CompressedTexImage2D, \
+      (GLenum target, GLint level, GLenum internal_format, GLsizei width, GLsizei height, GLint border, GLsizei size, const void *data), \
+      (target, level, internal_format, width, height, border, size, data)) \
+    F(GLuint, CreateProgram, (), ()) \
+    F(GLuint, CreateShader, (GLenum type), (type)) \
+    F(void, CullFace, (GLenum mode), (mode)) \
+    F(void, DeleteBuffers, (GLsizei count, const GLuint *buffers), (count, buffers)) \
+    F(void, DeleteFramebuffers, (GLsizei count, const GLuint *framebuffers), (count, framebuffers)) \
+    F(void, DeleteProgram, (GLuint program), (program)) \
+    F(void, DeleteQueries, (GLsizei count, const GLuint *ids), (count, ids)) \
+    F(void, DeleteRenderbuffers, (GLsizei count, const GLuint *renderbuffers), (count, renderbuffers)) \
+    F(void, DeleteShader, (GLuint shader), (shader)) \
+    F(void, DeleteTextures, (GLsizei count, const GLuint *textures), (count, textures)) \
+    F(void, DepthFunc, (GLenum function), (function)) \
+    F(void, DepthMask, (GLboolean flag), (flag)) \
+    F(void, DetachShader, (GLuint program, GLuint shader), (program, shader)) \
+    F(void, Disable, (GLenum capability), (capability)) \
+    F(void, DrawElements, (GLenum mode, GLsizei count, GLenum type, const void *indices), (mode, count, type, indices)) \
+    F(void, Enable, (GLenum capability), (capability)) \
+    F(void, EnableVertexAttribArray, (GLuint index), (index)) \
+    F(void, EndQuery, (GLenum target), (target)) \
+    F(void, FramebufferRenderbuffer, \
+      (GLenum target, GLenum attachment, GLenum renderbuffer_target, GLuint renderbuffer), \
+      (target, attachment, renderbuffer_target, renderbuffer)) \
+    F(void, FramebufferTexture2D, \
+      (GLenum target, GLenum attachment, GLenum texture_target, GLuint texture, GLint level), \
+      (target, attachment, texture_target, texture, level)) \
+    F(void, FrontFace, (GLenum mode), (mode)) \
+    F(void, GenBuffers, (GLsizei count, GLuint *buffers), (count, buffers)) \
+    F(void, GenFramebuffers, (GLsizei count, GLuint *framebuffers), (count, framebuffers)) \
+    F(void, GenQueries, (GLsizei count, GLuint *ids), (count, ids)) \
+    F(void, GenRenderbuffers, (GLsizei count, GLuint *renderbuffers), (count, renderbuffers)) \
+    F(void, GenTextures, (GLsizei count, GLuint *textures), (count, textures)) \
+    F(void, GenerateMipmap, (GLenum target), (target)) \
+    F(GLint, GetAttribLocation, (GLuint program, const GLchar *name), (program, name)) \
+    F(void, GetIntegerv, (GLenum name, GLint *data), (name, data)) \
+    F(void, GetProgramInfoLog, (GLuint program, GLsizei size, GLsizei *length, GLchar *info_log), (program, size, length, info_log)) \
+    F(void, GetProgramiv, (GLuint program, GLenum name, GLint *parameters), (program, name, parameters)) \
+    F(void, GetQueryObjectiv, (GLuint id, GLenum name, GLint *parameters), (id, name, parameters)) \
+    F(void, GetShaderInfoLog, (GLuint shader, GLsizei size, GLsizei *length, GLchar *info_log), (shader, size, length, info_log)) \
+    F(void, GetShaderiv, (GLuint shader, GLenum name, GLint *parameters), (shader, name, parameters)) \
+    F(GLint, GetUniformLocation, (GLuint program, const GLchar *name), (program, name)) \
+    F(void, LineWidth, (GLfloat width), (width)) \
+    F(void, LinkProgram, (GLuint program), (program)) \
+    F(void, PixelStorei, (GLenum name, GLint parameter), (name, parameter)) \
+    F(void, PolygonOffset, (GLfloat factor, GLfloat units), (factor, units)) \
+    F(void, RenderbufferStorage, \
+      (GLenum target, GLenum internal_format, GLsizei width, GLsizei height), \
+      (target, internal_format, width, height)) \
+    F(void, RenderbufferStorageMultisample, \
+      (GLenum target, GLsizei samples, GLenum internal_format, GLsizei width, GLsizei height), \
+      (target, samples, internal_format, width, height)) \
+    F(void, ShaderSource, \
+      (GLuint shader, GLsizei count, const GLchar **strings, const GLint *lengths), \
+      (shader, count, strings, lengths)) \
+    F(void, TexImage2D, \
+      (GLenum target, GLint level, GLint internal_format, GLsizei width, GLsizei height, GLint border, \
+       GLenum format, GLenum type, const void *pixels), \
+      (target, level, internal_format, width, height, border, format, type, pixels)) \
+    F(void, TexParameterf, (GLenum target, GLenum name, GLfloat parameter), (target, name, parameter)) \
+    F(void, TexParameteri, (GLenum target, GLenum name, GLint parameter), (target, name, parameter)) \
+    F(void, TexSubImage2D, \
+      (GLenum target, GLint level, GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, const void *pixels), \
+      (target, level, x, y, width, height, format, type, pixels)) \
+    F(void, Uniform1f, (GLint location, GLfloat value), (location, value)) \
+    F(void, Uniform1i, (GLint location, GLint value), (location, value)) \
+    F(void, Uniform3fv, (GLint location, GLsizei count, const GLfloat *values), (location, count, values)) \
+    F(void, Uniform4fv, (GLint location, GLsizei count, const GLfloat *values), (location, count, values)) \
+    F(void, UniformMatrix3fv, \
+      (GLint location, GLsizei count, GLboolean transpose, const GLfloat *values), \
+      (location, count, transpose, values)) \
+    F(void, UniformMatrix4fv, \
+      (GLint location, GLsizei count, GLboolean transpose, const GLfloat *values), \
+      (location, count, transpose, values)) \
+    F(void, UseProgram, (GLuint program), (program)) \
+    F(void, VertexAttribPointer, \
+      (GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void *pointer), \
+      (index, size, type, normalized, stride, pointer)) \
+    F(void, Viewport, (GLint x, GLint y, GLsizei width, GLsizei height), (x, y, width, height))
+
+#define ASR_GL_EXTENSION_FUNCTIONS(F) \
+    F(void, BindVertexArray, (GLuint array), (array)) \
+    F(void, DeleteVertexArrays, (GLsizei count, const GLuint *arrays), (count, arrays)) \
+    F(void, GenVertexArrays, (GLsizei count, GLuint *arrays), (count, arrays)) \
+    F(void, GetQueryObjectui64v, (GLuint id, GLenum name, GLuint64 *parameters), (id, name, parameters)) \
+    F(void, MaxShaderCompilerThreads, (GLuint count), (count))
+
+#define ASR_GL_FUNCTIONS(F) \
+    ASR_GL_CORE_FUNCTIONS(F) \
+    ASR_GL_EXTENSION_FUNCTIONS(F)
+
+namespace asr::gl
+{
+    enum Capability
+    {
+        TimerQuery,
+        DisjointTimerQuery,
+        FramebufferObject,
+        ParallelShaderCompile
+    };
+
+#define ASR_GL_CALL(return_type, name, parameters, arguments) name##Call,
+    enum Call
+    {
+        ASR_GL_FUNCTIONS(ASR_GL_CALL)
+        CallCount
+    };
+#undef ASR_GL_CALL
+
+    inline const char *get_call_name(Call call)
+    {
+#define ASR_GL_CALL_NAME(return_type, name, parameters, arguments) "gl" #name,
+        static const char *names[] = {
+            ASR_GL_FUNCTIONS(ASR_GL_CALL_NAME)
+        };
+#undef ASR_GL_CALL_NAME
+
+        return call < CallCount ? names[call] : "";
+    }
+
+    /* Receives every GL call of the ES2 classes. The defaults do nothing and return zero, so that a backend
+       only has to implement the calls it cares about. */
+    class Backend
+    {
+    public:
+        Backend() = default;
+
+        Backend(const Backend &other) = delete;
+        Backend& operator=(const Backend &other) = delete;
+
+        virtual ~Backend() = default;
+
+        [[nodiscard]] virtual bool is_supported(Capability capability) const
+        {
+            return false;
+        }
+
+#define ASR_GL_DEFAULT(return_type, name, parameters, arguments) \
+        virtual return_type name parameters { return return_type(); }
+        ASR_GL_FUNCTIONS(ASR_GL_DEFAULT)
+#undef ASR_GL_DEFAULT
+    };
+
+    /* Calls the driver through GLEW. */
+    class GLEWBackend final : public Backend
+    {
+    public:
+        [[nodiscard]] bool is_supported(Capability capability) const final
+        {
+            switch (capability) {
+                case TimerQuery:
+                    return GLEW_ARB_timer_query != 0;
+                case DisjointTimerQuery:
+                    return GLEW_EXT_disjoint_timer_query != 0;
+                case FramebufferObject:
+                    return GLEW_ARB_framebuffer_object != 0;
+                case ParallelShaderCompile:
+#ifdef GLEW_KHR_parallel_shader_compile
+                    return GLEW_KHR_parallel_shader_compile != 0;
+#else
+                    return false;
+#endif
+            }
+
+            return false;
+        }
+
+#define ASR_GL_FORWARD(return_type, name, parameters, arguments) \
+        return_type name parameters final { return gl##name arguments; }
+        ASR_GL_CORE_FUNCTIONS(ASR_GL_FORWARD)
+#undef ASR_GL_FORWARD
+
+        void BindVertexArray(GLuint array) final
+        {
+#ifdef __APPLE__
+            glBindVertexArrayAPPLE(array);
+#else
+            glBindVertexArray(array);
+#endif
+        }
+
+        void DeleteVertexArrays(GLsizei count, const GLuint *arrays) final
+        {
+#ifdef __APPLE__
+            glDeleteVertexArraysAPPLE(count, arrays);
+#else
+            glDeleteVertexArrays(count, arrays);
+#endif
+        }
+
+        void GenVertexArrays(GLsizei count, GLuint *arrays) final
+        {
+#ifdef __APPLE__
+            glGenVertexArraysAPPLE(count, arrays);
+#else
+            glGenVertexArrays(count, arrays);
+#endif
+        }
+
+        void GetQueryObjectui64v(GLuint id, GLenum name, GLuint64 *parameters) final
+        {
+            if (GLEW_ARB_timer_query) {
+                glGetQueryObjectui64v(id, name, parameters);
+            } else {
+                glGetQueryObjectui64vEXT(id, name, parameters);
+            }
+        }
+
+        void MaxShaderCompilerThreads(GLuint count) final
+        {
+#ifdef GLEW_KHR_parallel_shader_compile
+            glMaxShaderCompilerThreadsKHR(count);
+#endif
+        }
+    };
+
+    /* Draws nothing and needs no context. Object names are handed out from a counter and every status query
+       succeeds, so the ES2 classes run their regular paths, which leaves only their own CPU cost to measure. */
+    class NullBackend final : public Backend
+    {
+    public:
+        [[nodiscard]] bool is_supported(Capability capability) const final
+        {
+            return capability == TimerQuery || capability == FramebufferObject;
+        }
+
+        GLenum CheckFramebufferStatus(GLenum target) final
+        {
+            return GL_FRAMEBUFFER_COMPLETE;
+        }
+
+        GLuint CreateProgram() final
+        {
+            return ++_last_name;
+        }
+
+        GLuint CreateShader(GLenum type) final
+        {
+            return ++_last_name;
+        }
+
+        void GenBuffers(GLsizei count, GLuint *buffers) final
+        {
+            _generate_names(count, buffers);
+        }
+
+        void GenFramebuffers(GLsizei count, GLuint *framebuffers) final
+        {
+            _generate_names(count, framebuffers);
+        }
+
+        void GenQueries(GLsizei count, GLuint *ids) final
+        {
+            _generate_names(count, ids);
+        }
+
+        void GenRenderbuffers(GLsizei count, GLuint *renderbuffers) final
+        {
+            _generate_names(count, renderbuffers);
+        }
+
+        void GenTextures(GLsizei count, GLuint *textures) final
+        {
+            _generate_names(count, textures);
+        }
+
+        void GenVertexArrays(GLsizei count, GLuint *arrays) final
+        {
+            _generate_names(count, arrays);
+        }
+
+        /* Attributes are bound to fixed locations, uniforms all share one, which is enough for uploads to go through. */
+        GLint GetAttribLocation(GLuint program, const GLchar *name) final
+        {
+            return 0;
+        }
+
+        GLint GetUniformLocation(GLuint program, const GLchar *name) final
+        {
+            return 0;
+        }
+
+        void GetIntegerv(GLenum name, GLint *data) final
+        {
+            *data = 0;
+        }
+
+        void GetProgramiv(GLuint program, GLenum name, GLint *parameters) final
+        {
+            *parameters = name == GL_INFO_LOG_LENGTH ? 0 : GL_TRUE;
+        }
+
+        void GetShaderiv(GLuint shader, GLenum name, GLint *parameters) final
+        {
+            *parameters = name == GL_INFO_LOG_LENGTH ? 0 : GL_TRUE;
+        }
+
+        void GetProgramInfoLog(GLuint program, GLsizei size, GLsizei *length, GLchar *info_log) final
+        {
+            _write_empty_log(size, length, info_log);
+        }
+
+        void GetShaderInfoLog(GLuint shader, GLsizei size, GLsizei *length, GLchar *info_log) final
+        {
+            _write_empty_log(size, length, info_log);
+        }
+
+        void GetQueryObjectiv(GLuint id, GLenum name, GLint *parameters) final
+        {
+            *parameters = name == GL_QUERY_RESULT_AVAILABLE ? GL_TRUE : 0;
+        }
+
+        void GetQueryObjectui64v(GLuint id, GLenum name, GLuint64 *parameters) final
+        {
+            *parameters = 0;
+        }
+
+    private:
+        GLuint _last_name{0};
+
+        void _generate_names(GLsizei count, GLuint *names)
+        {
+            for (GLsizei i = 0; i < count; ++i) {
+                names[i] = ++_last_name;
+            }
+        }
+
+        static void _write_empty_log(GLsizei size, GLsizei *length, GLchar *info_log)
+        {
+            if (length != nullptr) {
+                *length = 0;
+            }
+            if (size > 0) {
+                info_log[0] = '\0';
+            }
+        }
+    };
+
+    /* Passes every call on to another backend, as a base for backends that intercept a few of them. */
+    class ForwardingBackend : public Backend
+    {
+    public:
+        explicit ForwardingBackend(std::shared_ptr<Backend> backend = nullptr)
+            : _backend{std::move(backend)}
+        {}
+
+        [[nodiscard]] bool is_supported(Capability capability) const override
+        {
+            return _backend->is_supported(capability);
+        }
+
+#define ASR_GL_FORWARD(return_type, name, parameters, arguments) \
+        return_type name parameters override \
+        { \
+            return _backend->name arguments; \
+        }
+        ASR_GL_FUNCTIONS(ASR_GL_FORWARD)
+#undef ASR_GL_FORWARD
+
+    protected:
+        std::shared_ptr<Backend> _backend;
+    };
+
+    /* Counts the calls passed on to another backend and checks a few rules that drivers do not always
+       report, e.g. draws and uniform uploads without a program in use. */
+    class RecordingBackend final : public Backend
+    {
+    public:
+        explicit RecordingBackend(std::shared_ptr<Backend> backend = std::make_shared<NullBackend>())
+            : _backend{std::move(backend)}
+        {}
+
+        [[nodiscard]] bool is_supported(Capability capability) const final
+        {
+            return _backend->is_supported(capability);
+        }
+
+        [[nodiscard]] uint64_t get_call_count(Call call) const
+        {
+            return _call_counts[call];
+        }
+
+        [[nodiscard]] uint64_t get_total_call_count() const
+        {
+            uint64_t total_call_count{0};
+            for (uint64_t call_count : _call_counts) {
+                total_call_count += call_count;
+            }
+
+            return total_call_count;
+        }
+
+        [[nodiscard]] bool is_log_enabled() const
+        {
+            return _log_enabled;
+        }
+
+        /* Keeps the sequence of calls, e.g. to compare the calls of a frame against an expected sequence. */
+        void set_log_enabled(bool log_enabled)
+        {
+            _log_enabled = log_enabled;
+        }
+
+        [[nodiscard]] const std::vector<Call> &get_log() const
+        {
+            return _log;
+        }
+
+        [[nodiscard]] const std::vector<std::string> &get_errors() const
+        {
+            return _errors;
+        }
+
+        void reset()
+        {
+            _call_counts.fill(0);
+            _log.clear();
+            _errors.clear();
+        }
+
+#define ASR_GL_RECORD(return_type, name, parameters, arguments) \
+        return_type name parameters final \
+        { \
+            _record(name##Call); \
+            _observe<name##Call> arguments; \
+            return _backend->name arguments; \
+        }
+        ASR_GL_FUNCTIONS(ASR_GL_RECORD)
+#undef ASR_GL_RECORD
+
+    private:
+        std::shared_ptr<Backend> _backend;
+        std::array<uint64_t, CallCount> _call_counts{};
+        bool _log_enabled{false};
+        std::vector<Call> _log;
+        std::vector<std::string> _errors;
+
+        GLuint _program{0};
+        GLuint _vertex_array{0};
+
+        void _record(Call call)
+        {
+            ++_call_counts[call];
+            if (_log_enabled) {
+                _log.push_back(call);
+            }
+        }
+
+        /* Tracks the bindings that validation depends on. */
+        template<Call call, typename... Arguments>
+        void _observe(const Arguments &...arguments)
+        {
+            if constexpr (call == UseProgramCall) {
+                _program = std::get<0>(std::tie(arguments...));
+            } else if constexpr (call == DeleteProgramCall) {
+                if (_program == std::get<0>(std::tie(arguments...))) {
+                    _program = 0;
+                }
+            } else if constexpr (call == BindVertexArrayCall) {
+                _vertex_array = std::get<0>(std::tie(arguments...));
+            }
+
+            constexpr bool requires_program =
+                call == DrawElementsCall ||
+                call == Uniform1fCall || call == Uniform1iCall || call == Uniform3fvCall || call == Uniform4fvCall ||
+                call == UniformMatrix3fvCall || call == UniformMatrix4fvCall;
+            if constexpr (requires_program) {
+                if (_program == 0) {
+                    _errors.push_back(std::string{get_call_name(call)} + " without a program in use");
+                }
+            }
+            if constexpr (call == DrawElementsCall) {
+                if (_vertex_array == 0) {
+                    _errors.push_back(std::string{get_call_name(call)} + " without a vertex array bound");
+                }
+            }
+        }
+    };
+
+    inline std::shared_ptr<Backend> &_get_backend_storage()
+    {
+        static std::shared_ptr<Backend> backend = std::make_shared<GLEWBackend>();
+        return backend;
+    }
+
+    inline Backend &get_backend()
+    {
+        return *_get_backend_storage();
+    }
+
+    /* Must be called before any GL object is created, since objects do not carry over between backends.
+       Passing nullptr restores the GLEW backend. */
+    inline void set_backend(const std::shared_ptr<Backend> &backend)
+    {
+        _get_backend_storage() = backend ? backend : std::make_shared<GLEWBackend>();
+    }
+
+    inline bool is_supported(Capability capability)
+    {
+        return get_backend().is_supported(capability);
+    }
+
+#define ASR_GL_DISPATCH(return_type, name, parameters, arguments) \
+    inline return_type name parameters { return get_backend().name arguments; }
+    ASR_GL_FUNCTIONS(ASR_GL_DISPATCH)
+#undef ASR_GL_DISPATCH
+}
+
+#endif
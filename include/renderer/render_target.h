@@ -0,0 +1,125 @@
+#ifndef RENDER_TARGET_H
+#define RENDER_TARGET_H
+
+#include "textures/texture.h"
+
+#include <memory>
+
+namespace asr
+{
+    /* An offscreen framebuffer with a color and an optional depth attachment. The color attachment is a
+       regular texture, so anything rendered into the target can be sampled by materials directly. */
+    class RenderTarget
+    {
+    public:
+        enum ColorFormat
+        {
+            RGB8,
+            RGBA8
+        };
+
+        enum DepthFormat
+        {
+            NoDepth,
+            Depth16,
+            Depth24,
+            Depth24Stencil8
+        };
+
+        RenderTarget(
+            unsigned int width, unsigned int height,
+            ColorFormat color_format = RGBA8, DepthFormat depth_format = Depth24, unsigned int sample_count = 1
+        ) : _width{width}, _height{height},
+            _color_format{color_format}, _depth_format{depth_format}, _sample_count{sample_count}
+        {}
+
+        RenderTarget(const RenderTarget &other) = delete;
+        RenderTarget& operator=(const RenderTarget &other) = delete;
+
+        virtual ~RenderTarget() = default;
+
+        [[nodiscard]] unsigned int get_width() const
+        {
+            return _width;
+        }
+
+        [[nodiscard]] unsigned int get_height() const
+        {
+            return _height;
+        }
+
+        void set_size(unsigned int width, unsigned int height)
+        {
+            if (_width != width || _height != height) {
+                _width = width;
+                _height = height;
+                _requires_update = true;
+            }
+        }
+
+        [[nodiscard]] ColorFormat get_color_format() const
+        {
+            return _color_format;
+        }
+
+        void set_color_format(ColorFormat color_format)
+        {
+            if (_color_format != color_format) {
+                _color_format = color_format;
+                _requires_update = true;
+            }
+        }
+
+        [[nodiscard]] DepthFormat get_depth_format() const
+        {
+            return _depth_format;
+        }
+
+        void set_depth_format(DepthFormat depth_format)
+        {
+            if (_depth_format != depth_format) {
+                _depth_format = depth_format;
+                _requires_update = true;
+            }
+        }
+
+        /* More than one sample renders into multisampled storage that is resolved into the color texture
+           after every pass. Falls back to a single sample where multisampled framebuffers are not supported. */
+        [[nodiscard]] unsigned int get_sample_count() const
+        {
+            return _sample_count;
+        }
+
+        void set_sample_count(unsigned int sample_count)
+        {
+            if (_sample_count != sample_count) {
+                _sample_count = sample_count;
+                _requires_update = true;
+            }
+        }
+
+        [[nodiscard]] const std::shared_ptr<Texture> &get_color_texture() const
+        {
+            return _color_texture;
+        }
+
+        /* Makes the target the destination of the following draw calls. */
+        virtual void bind() = 0;
+
+        /* Must be called after the last draw call of a pass, before the color texture is sampled. */
+        virtual void resolve() = 0;
+
+    protected:
+        unsigned int _width;
+        unsigned int _height;
+        ColorFormat _color_format;
+        DepthFormat _depth_format;
+        unsigned int _sample_count;
+
+        std::shared_ptr<Texture> _color_texture;
+
+        bool _requires_update{true};
+    };
+}
+
+#endif
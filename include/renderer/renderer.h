@@ -5,6 +5,7 @@
 
 #include "scene/scene.h"
 #include "window/window.h"
+#include "renderer/render_target.h"
 
 namespace asr
 {
@@ -19,6 +20,8 @@ namespace asr
 
         virtual void render() = 0;
 
+        virtual void render(const std::shared_ptr<Scene> &target_scene, RenderTarget &target) = 0;
+
     protected:
         std::shared_ptr<Scene> scene;
         std::shared_ptr<Window> window;
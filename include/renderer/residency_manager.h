@@ -0,0 +1,176 @@
+#ifndef RESIDENCY_MANAGER_H
+#define RESIDENCY_MANAGER_H
+
+#include "textures/texture.h"
+#include "geometries/geometry.h"
+#include "utilities/gpu_resource.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <algorithm>
+
+namespace asr
+{
+    /* Keeps the video memory of registered textures and geometries within a budget. Resources that were not
+       used since the previous update are evicted in least-recently-used order until the total fits, and are
+       uploaded again the next time they are used. */
+    class ResidencyManager
+    {
+    public:
+        typedef std::function<void(const std::shared_ptr<Texture> &)> reload_callback_type;
+
+        static const size_t DEFAULT_BUDGET{192 * 1024 * 1024};
+
+        struct Usage
+        {
+            size_t budget{0};
+            size_t texture_size{0};
+            size_t geometry_size{0};
+            unsigned int resource_count{0};
+            unsigned int resident_count{0};
+            unsigned long long eviction_count{0};
+
+            [[nodiscard]] size_t get_total_size() const
+            {
+                return texture_size + geometry_size;
+            }
+        };
+
+        explicit ResidencyManager(size_t budget = DEFAULT_BUDGET)
+            : _budget{budget}
+        {}
+
+        ResidencyManager(const ResidencyManager &other) = delete;
+        ResidencyManager& operator=(const ResidencyManager &other) = delete;
+
+        [[nodiscard]] size_t get_budget() const
+        {
+            return _budget;
+        }
+
+        void set_budget(size_t budget)
+        {
+            _budget = budget;
+        }
+
+        [[nodiscard]] const reload_callback_type &get_on_reload() const
+        {
+            return _on_reload;
+        }
+
+        /* Called for an evicted texture without a CPU copy once it is used again, usually with
+           `TextureLoader::reload`. Without it, such textures are never evicted. */
+        void set_on_reload(const reload_callback_type &on_reload)
+        {
+            _on_reload = on_reload;
+        }
+
+        void add(const std::shared_ptr<Texture> &texture)
+        {
+            _entries.push_back(Entry{texture, texture});
+        }
+
+        void add(const std::shared_ptr<Geometry> &geometry)
+        {
+            _entries.push_back(Entry{geometry, std::weak_ptr<Texture>{}});
+        }
+
+        /* Must be called on the render thread once per frame, after rendering. */
+        void update()
+        {
+            _entries.erase(
+                std::remove_if(std::begin(_entries), std::end(_entries), [](const Entry &entry) {
+                    return entry.resource.expired();
+                }),
+                std::end(_entries)
+            );
+
+            size_t total_size{0};
+            std::vector<std::shared_ptr<GPUResource>> candidates;
+            for (auto &entry : _entries) {
+                auto resource = entry.resource.lock();
+                size_t size = resource->get_gpu_size();
+                total_size += size;
+
+                auto texture = entry.texture.lock();
+                if (size > 0) {
+                    entry.reloading = false;
+                } else if (texture && texture->is_reload_requested() && !entry.reloading && _on_reload) {
+                    entry.reloading = true;
+                    _on_reload(texture);
+                }
+
+                if (size > 0 && resource->get_last_use() <= _frame_use_clock && _is_evictable(*resource, texture.get())) {
+                    candidates.push_back(resource);
+                }
+            }
+
+            if (total_size > _budget) {
+                std::sort(std::begin(candidates), std::end(candidates), [](const auto &a, const auto &b) {
+                    return a->get_last_use() < b->get_last_use();
+                });
+                for (const auto &resource : candidates) {
+                    if (total_size <= _budget) {
+                        break;
+                    }
+                    total_size -= resource->get_gpu_size();
+                    resource->evict();
+                    ++_eviction_count;
+                }
+            }
+
+            _frame_use_clock = GPUResource::get_use_clock();
+        }
+
+        [[nodiscard]] Usage get_usage() const
+        {
+            Usage usage;
+            usage.budget = _budget;
+            usage.eviction_count = _eviction_count;
+            for (const auto &entry : _entries) {
+                auto resource = entry.resource.lock();
+                if (!resource) {
+                    continue;
+                }
+
+                size_t size = resource->get_gpu_size();
+                if (entry.texture.expired()) {
+                    usage.geometry_size += size;
+                } else {
+                    usage.texture_size += size;
+                }
+                ++usage.resource_count;
+                if (size > 0) {
+                    ++usage.resident_count;
+                }
+            }
+
+            return usage;
+        }
+
+    private:
+        struct Entry
+        {
+            std::weak_ptr<GPUResource> resource;
+            std::weak_ptr<Texture> texture;
+            bool reloading{false};
+        };
+
+        std::vector<Entry> _entries;
+        size_t _budget;
+        reload_callback_type _on_reload;
+
+        uint64_t _frame_use_clock{0};
+        unsigned long long _eviction_count{0};
+
+        bool _is_evictable(const GPUResource &resource, const Texture *texture) const
+        {
+            return resource.is_restorable() || (texture && !texture->get_source_path().empty() && _on_reload);
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,118 @@
+#ifndef RESOLUTION_SCALER_H
+#define RESOLUTION_SCALER_H
+
+#include <algorithm>
+#include <cmath>
+
+namespace asr
+{
+    /* Picks the fraction of the native resolution to render at from measured frame times. The scale drops
+       quickly when frames take longer than the target time and grows back slowly when there is headroom,
+       waiting a few frames after every change so that the measurements can settle. */
+    class ResolutionScaler
+    {
+    public:
+        explicit ResolutionScaler(float target_frame_time = 1000.0f / 30.0f, float minimum_scale = 0.5f, float maximum_scale = 1.0f)
+            : _target_frame_time{target_frame_time},
+              _minimum_scale{minimum_scale}, _maximum_scale{maximum_scale},
+              _scale{maximum_scale}
+        {}
+
+        /* In milliseconds. */
+        [[nodiscard]] float get_target_frame_time() const
+        {
+            return _target_frame_time;
+        }
+
+        void set_target_frame_time(float target_frame_time)
+        {
+            _target_frame_time = target_frame_time;
+        }
+
+        [[nodiscard]] float get_minimum_scale() const
+        {
+            return _minimum_scale;
+        }
+
+        void set_minimum_scale(float minimum_scale)
+        {
+            _minimum_scale = minimum_scale;
+            _scale = std::clamp(_scale, _minimum_scale, _maximum_scale);
+        }
+
+        [[nodiscard]] float get_maximum_scale() const
+        {
+            return _maximum_scale;
+        }
+
+        void set_maximum_scale(float maximum_scale)
+        {
+            _maximum_scale = maximum_scale;
+            _scale = std::clamp(_scale, _minimum_scale, _maximum_scale);
+        }
+
+        [[nodiscard]] float get_scale() const
+        {
+            return _scale;
+        }
+
+        [[nodiscard]] float get_smoothed_frame_time() const
+        {
+            return _smoothed_frame_time;
+        }
+
+        void reset()
+        {
+            _scale = _maximum_scale;
+            _smoothed_frame_time = 0.0f;
+            _cooldown = 0;
+        }
+
+        /* Takes the time of the last frame in milliseconds. */
+        void update(float frame_time)
+        {
+            if (frame_time <= 0.0f) {
+                return;
+            }
+
+            _smoothed_frame_time = _smoothed_frame_time == 0.0f ?
+                frame_time : _smoothed_frame_time + (frame_time - _smoothed_frame_time) * SMOOTHING;
+            if (_cooldown > 0) {
+                --_cooldown;
+                return;
+            }
+
+            /* The cost of a fill-rate-bound frame grows with the pixel count, i.e. with the square of the scale. */
+            float scale = _scale;
+            float ratio = _target_frame_time / _smoothed_frame_time;
+            if (ratio < 1.0f) {
+                scale *= std::max(std::sqrt(ratio), MAXIMUM_DECREASE);
+            } else if (ratio > HEADROOM) {
+                scale += INCREASE_STEP;
+            }
+            scale = std::clamp(std::round(scale * 100.0f) / 100.0f, _minimum_scale, _maximum_scale);
+
+            if (scale != _scale) {
+                _scale = scale;
+                _cooldown = COOLDOWN_FRAME_COUNT;
+            }
+        }
+
+    private:
+        static constexpr float SMOOTHING{0.1f};
+        static constexpr float HEADROOM{1.2f};
+        static constexpr float MAXIMUM_DECREASE{0.85f};
+        static constexpr float INCREASE_STEP{0.02f};
+        static const unsigned int COOLDOWN_FRAME_COUNT{10};
+
+        float _target_frame_time;
+        float _minimum_scale;
+        float _maximum_scale;
+
+        float _scale;
+        float _smoothed_frame_time{0.0f};
+        unsigned int _cooldown{0};
+    };
+}
+
+#endif
@@ -49,6 +49,36 @@ namespace asr
             _fragment_shader_source = fragment_shader_source;
         }
 
+        [[nodiscard]] const std::string &get_fragment_shader_preamble() const
+        {
+            return _fragment_shader_preamble;
+        }
+
+        void set_fragment_shader_preamble(const std::string &fragment_shader_preamble)
+        {
+            _fragment_shader_preamble = fragment_shader_preamble;
+        }
+
+        [[nodiscard]] const std::string &get_vertex_shader_path() const
+        {
+            return _vertex_shader_path;
+        }
+
+        void set_vertex_shader_path(const std::string &vertex_shader_path)
+        {
+            _vertex_shader_path = vertex_shader_path;
+        }
+
+        [[nodiscard]] const std::string &get_fragment_shader_path() const
+        {
+            return _fragment_shader_path;
+        }
+
+        void set_fragment_shader_path(const std::string &fragment_shader_path)
+        {
+            _fragment_shader_path = fragment_shader_path;
+        }
+
         std::map<std::string, int> &get_attributes()
         {
             return _attributes;
@@ -79,8 +109,22 @@ namespace asr
             return _program != -1;
         }
 
+        [[nodiscard]] bool is_pending() const
+        {
+            return _pending;
+        }
+
+        [[nodiscard]] unsigned int get_revision() const
+        {
+            return _revision;
+        }
+
         virtual void compile() = 0;
 
+        virtual void submit() = 0;
+
+        virtual bool poll(bool wait) = 0;
+
         virtual void cleanup() = 0;
 
         virtual void use() = 0;
@@ -88,11 +132,17 @@ namespace asr
     protected:
         std::string _vertex_shader_source;
         std::string _fragment_shader_source;
+        std::string _fragment_shader_preamble;
+
+        std::string _vertex_shader_path;
+        std::string _fragment_shader_path;
 
         std::map<std::string, int> _attributes;
         std::map<std::string, int> _uniforms;
 
         bool _dead{false};
+        bool _pending{false};
+        unsigned int _revision{0};
         int _program{-1};
     };
 }
@@ -0,0 +1,66 @@
+#ifndef SHADER_COMPILE_QUEUE_H
+#define SHADER_COMPILE_QUEUE_H
+
+#include "renderer/shader.h"
+
+#include <vector>
+#include <memory>
+#include <algorithm>
+
+namespace asr
+{
+    class ShaderCompileQueue
+    {
+    public:
+        void add(const std::shared_ptr<Shader> &shader)
+        {
+            if (shader->is_dead()) {
+                return;
+            }
+            if (std::find(std::begin(_shaders), std::end(_shaders), shader) != std::end(_shaders)) {
+                return;
+            }
+
+            if (!shader->is_pending()) {
+                if (shader->is_compiled()) {
+                    return;
+                }
+                shader->submit();
+            }
+            _shaders.push_back(shader);
+        }
+
+        void poll()
+        {
+            _shaders.erase(
+                std::remove_if(std::begin(_shaders), std::end(_shaders), [](const auto &shader) {
+                    return shader->poll(false);
+                }),
+                std::end(_shaders)
+            );
+        }
+
+        void finish()
+        {
+            for (auto &shader : _shaders) {
+                shader->poll(true);
+            }
+            _shaders.clear();
+        }
+
+        [[nodiscard]] bool is_empty() const
+        {
+            return _shaders.empty();
+        }
+
+        [[nodiscard]] size_t get_pending_count() const
+        {
+            return _shaders.size();
+        }
+
+    private:
+        std::vector<std::shared_ptr<Shader>> _shaders;
+    };
+}
+
+#endif
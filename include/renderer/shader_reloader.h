@@ -0,0 +1,140 @@
+#ifndef SHADER_RELOADER_H
+#define SHADER_RELOADER_H
+
+#include "renderer/shader.h"
+#include "utilities/file_watcher.h"
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <functional>
+#include <algorithm>
+
+namespace asr
+{
+    class ShaderReloader
+    {
+    public:
+        typedef std::function<void(const std::shared_ptr<Shader> &, bool, double)> reload_callback_type;
+
+        void add(const std::shared_ptr<Shader> &shader)
+        {
+            for (const auto &watched_shader : _shaders) {
+                if (watched_shader.lock() == shader) {
+                    return;
+                }
+            }
+
+            _shaders.push_back(shader);
+            _file_watcher.add(shader->get_vertex_shader_path());
+            _file_watcher.add(shader->get_fragment_shader_path());
+        }
+
+        [[nodiscard]] const reload_callback_type &get_on_reload() const
+        {
+            return _on_reload;
+        }
+
+        void set_on_reload(const reload_callback_type &on_reload)
+        {
+            _on_reload = on_reload;
+        }
+
+        void update()
+        {
+            _shaders.erase(
+                std::remove_if(std::begin(_shaders), std::end(_shaders), [](const auto &shader) {
+                    return shader.expired();
+                }),
+                std::end(_shaders)
+            );
+
+            for (const auto &path : _file_watcher.poll()) {
+                std::string source;
+                if (!_read_source(path, source)) {
+                    continue;
+                }
+
+                for (const auto &watched_shader : _shaders) {
+                    auto shader = watched_shader.lock();
+                    if (shader->get_vertex_shader_path() == path) {
+                        shader->set_vertex_shader_source(source);
+                    } else if (shader->get_fragment_shader_path() == path) {
+                        shader->set_fragment_shader_source(source);
+                    } else {
+                        continue;
+                    }
+
+                    /* The current program stays in use until the new one links, so a broken edit never blanks the scene. */
+                    shader->submit();
+                    _pending_reloads.erase(
+                        std::remove_if(std::begin(_pending_reloads), std::end(_pending_reloads), [&](const auto &reload) {
+                            return reload.shader.lock() == shader;
+                        }),
+                        std::end(_pending_reloads)
+                    );
+                    _pending_reloads.push_back(PendingReload{shader, shader->get_revision(), std::chrono::steady_clock::now()});
+                }
+            }
+
+            for (auto reload = std::begin(_pending_reloads); reload != std::end(_pending_reloads);) {
+                auto shader = reload->shader.lock();
+                if (shader && !shader->poll(false)) {
+                    ++reload;
+                    continue;
+                }
+
+                if (shader) {
+                    std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - reload->start_time;
+                    bool succeeded = shader->get_revision() != reload->revision;
+                    if (succeeded) {
+                        std::cout << "Reloaded the shader program ('" << shader->get_vertex_shader_path() << "', '"
+                                  << shader->get_fragment_shader_path() << "') in " << duration.count() << " ms" << std::endl;
+                    } else {
+                        std::cerr << "Failed to reload the shader program ('" << shader->get_vertex_shader_path() << "', '"
+                                  << shader->get_fragment_shader_path() << "'), keeping the previous one" << std::endl;
+                    }
+                    if (_on_reload) {
+                        _on_reload(shader, succeeded, duration.count());
+                    }
+                }
+                reload = _pending_reloads.erase(reload);
+            }
+        }
+
+    private:
+        struct PendingReload
+        {
+            std::weak_ptr<Shader> shader;
+            unsigned int revision;
+            std::chrono::steady_clock::time_point start_time;
+        };
+
+        FileWatcher _file_watcher;
+        std::vector<std::weak_ptr<Shader>> _shaders;
+        std::vector<PendingReload> _pending_reloads;
+
+        reload_callback_type _on_reload;
+
+        static bool _read_source(const std::string &path, std::string &source)
+        {
+            std::ifstream file_stream{path};
+            if (!file_stream.is_open()) {
+                std::cerr << "Failed to open the file: '" << path << "'" << std::endl;
+                return false;
+            }
+
+            std::stringstream string_stream;
+            string_stream << file_stream.rdbuf();
+            source = string_stream.str();
+
+            return true;
+        }
+    };
+}
+
+#endif
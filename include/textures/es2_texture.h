@@ -2,20 +2,53 @@
 #define ES2_TEXTURE_H
 
 #include "textures/texture.h"
+#include "textures/mipmap_generator.h"
+#include "utilities/compressed_image_utilities.h"
+#include "utilities/profiler.h"
+#include "renderer/gl_dispatch.h"
 
 #include <GL/glew.h>
 #define SDL_MAIN_HANDLED
 #include <SDL.h>
 
+#include <cstring>
 #include <vector>
+#include <utility>
+#include <algorithm>
+#include <iostream>
+
+#ifndef GL_ETC1_RGB8_OES
+#define GL_ETC1_RGB8_OES 0x8D64
+#endif
+#ifndef GL_COMPRESSED_RGB8_ETC2
+#define GL_COMPRESSED_RGB8_ETC2 0x9274
+#endif
+#ifndef GL_COMPRESSED_RGBA8_ETC2_EAC
+#define GL_COMPRESSED_RGBA8_ETC2_EAC 0x9278
+#endif
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT3_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT3_EXT 0x83F2
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+#ifndef GL_COMPRESSED_RGBA_ASTC_4x4_KHR
+#define GL_COMPRESSED_RGBA_ASTC_4x4_KHR 0x93B0
+#endif
 
 namespace asr
 {
     class ES2Texture final : public Texture
     {
     public:
-        ES2Texture(const std::vector<uint8_t> &image_data, unsigned int width, unsigned int height, unsigned int channels)
-            : Texture(image_data, width, height, channels)
+        ES2Texture(ImageBuffer image_data, unsigned int width, unsigned int height, unsigned int channels)
+            : Texture(std::move(image_data), width, height, channels)
         {}
 
         ES2Texture(const ES2Texture &other) = delete;
@@ -24,71 +57,101 @@ namespace asr
         ~ES2Texture() final
         {
             if (_texture != 0) {
-                glDeleteTextures(1, &_texture);
+                gl::DeleteTextures(1, &_texture);
             }
         }
 
+        [[nodiscard]] GLuint get_texture_object() const
+        {
+            return _texture;
+        }
+
+        [[nodiscard]] size_t get_gpu_size() const final
+        {
+            return _gpu_size;
+        }
+
+        void evict() final
+        {
+            if (_texture == 0) {
+                return;
+            }
+
+            gl::DeleteTextures(1, &_texture);
+            _texture = 0;
+            _allocated_width = _allocated_height = _allocated_channels = 0;
+            _gpu_size = 0;
+            _evicted = true;
+            _dirty_rectangles.clear();
+            _requires_data_update = true;
+            _requires_params_update = true;
+        }
+
         void update(unsigned int sampler) final
         {
+            if (_evicted && _requires_data_update && _image_data.empty()) {
+                _reload_requested = true;
+                return;
+            }
+
             if (_requires_data_update) {
-                glActiveTexture(GL_TEXTURE0 + sampler);
+                gl::ActiveTexture(GL_TEXTURE0 + sampler);
                 if (_texture == 0) {
-                    glGenTextures(1, &_texture);
-                    glBindTexture(GL_TEXTURE_2D, _texture);
-                    GLint format = _channels == 3 ? GL_RGB : GL_RGBA;
-                    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-                    glTexImage2D(
-                        GL_TEXTURE_2D, 0, format,
-                        static_cast<GLsizei>(_width),
-                        static_cast<GLsizei>(_height),
-                        0, static_cast<GLenum>(format), GL_UNSIGNED_BYTE,
-                        reinterpret_cast<GLvoid *>(_image_data.data())
-                    );
-                } else {
-                    glBindTexture(GL_TEXTURE_2D, _texture);
-                    GLint format = _channels == 3 ? GL_RGB : GL_RGBA;
-                    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-                    glTexSubImage2D(
-                        GL_TEXTURE_2D, 0, 0, 0,
-                        static_cast<GLsizei>(_width),
-                        static_cast<GLsizei>(_height),
-                        static_cast<GLenum>(format), GL_UNSIGNED_BYTE,
-                        reinterpret_cast<GLvoid *>(_image_data.data())
-                    );
+                    gl::GenTextures(1, &_texture);
                 }
-                if (_mipmaps_enabled) {
-                    glGenerateMipmap(GL_TEXTURE_2D);
+                gl::BindTexture(GL_TEXTURE_2D, _texture);
+                gl::PixelStorei(GL_UNPACK_ALIGNMENT, 1);
+                if (_compression != Uncompressed) {
+                    _update_compressed_image_data();
+                } else {
+                    _update_image_data();
                 }
-                glBindTexture(GL_TEXTURE_2D, 0);
+                gl::BindTexture(GL_TEXTURE_2D, 0);
 
+                if (!_image_data_retained) {
+                    _image_data.clear();
+                    _mipmap_levels.clear();
+                }
+                _dirty_rectangles.clear();
+                _evicted = false;
                 _requires_data_update = false;
+            } else if (!_dirty_rectangles.empty()) {
+                gl::ActiveTexture(GL_TEXTURE0 + sampler);
+                gl::BindTexture(GL_TEXTURE_2D, _texture);
+                gl::PixelStorei(GL_UNPACK_ALIGNMENT, 1);
+                _update_dirty_rectangles();
+                gl::BindTexture(GL_TEXTURE_2D, 0);
+
+                _dirty_rectangles.clear();
             }
 
             if (_requires_params_update) {
-                glActiveTexture(GL_TEXTURE0 + sampler);
-                glBindTexture(GL_TEXTURE_2D, _texture);
+                gl::ActiveTexture(GL_TEXTURE0 + sampler);
+                gl::BindTexture(GL_TEXTURE_2D, _texture);
 
-                glTexParameteri(
+                gl::TexParameteri(
                     GL_TEXTURE_2D, GL_TEXTURE_WRAP_S,
                     _convert_wrap_mode_to_es2_texture_wrap_mode(_wrap_mode_s)
                 );
-                glTexParameteri(
+                gl::TexParameteri(
                     GL_TEXTURE_2D, GL_TEXTURE_WRAP_T,
                     _convert_wrap_mode_to_es2_texture_wrap_mode(_wrap_mode_t)
                 );
-                glTexParameteri(
+                gl::TexParameteri(
                     GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER,
                     _convert_filter_type_to_es2_texture_filter_type(_magnification_filter)
                 );
-                glTexParameteri(
+                gl::TexParameteri(
                     GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,
-                    _convert_filter_type_to_es2_texture_filter_type(_minification_filter)
+                    _convert_filter_type_to_es2_texture_filter_type(
+                        _mipmaps_missing ? _get_base_level_filter_type(_minification_filter) : _minification_filter
+                    )
                 );
-                glTexParameterf(
+                gl::TexParameterf(
                     GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, static_cast<GLfloat>(_anisotropy)
                 );
 
-                glBindTexture(GL_TEXTURE_2D, 0);
+                gl::BindTexture(GL_TEXTURE_2D, 0);
 
                 _requires_params_update = false;
             }
@@ -96,14 +159,211 @@ namespace asr
 
         void use(unsigned int sampler) final
         {
+            mark_used();
             if (_texture != 0) {
-                glActiveTexture(GL_TEXTURE0 + sampler);
-                glBindTexture(GL_TEXTURE_2D, _texture);
+                gl::ActiveTexture(GL_TEXTURE0 + sampler);
+                gl::BindTexture(GL_TEXTURE_2D, _texture);
             }
         }
 
+        static bool is_compression_supported(Compression compression)
+        {
+            static const std::vector<GLint> supported_formats = []() {
+                GLint format_count{0};
+                gl::GetIntegerv(GL_NUM_COMPRESSED_TEXTURE_FORMATS, &format_count);
+                std::vector<GLint> formats(static_cast<size_t>(std::max(format_count, 0)));
+                if (!formats.empty()) {
+                    gl::GetIntegerv(GL_COMPRESSED_TEXTURE_FORMATS, formats.data());
+                }
+                return formats;
+            }();
+
+            GLenum format = _convert_compression_to_es2_texture_format(compression);
+            return std::find(std::begin(supported_formats), std::end(supported_formats), static_cast<GLint>(format)) !=
+                   std::end(supported_formats);
+        }
+
     private:
         GLuint _texture{0};
+        unsigned int _allocated_width{0};
+        unsigned int _allocated_height{0};
+        unsigned int _allocated_channels{0};
+        std::vector<uint8_t> _rectangle_buffer;
+        size_t _gpu_size{0};
+        bool _evicted{false};
+        bool _mipmaps_missing{false};
+
+        void _update_image_data()
+        {
+            _set_mipmaps_missing(false);
+            if (_mipmap_generator && _mipmaps_enabled && _mipmap_levels.empty() && !_image_data.empty()) {
+                _mipmap_levels = _mipmap_generator->generate(_image_data.data(), _width, _height, _channels);
+            }
+
+            GLint format = _channels == 3 ? GL_RGB : GL_RGBA;
+            if (_allocated_width != _width || _allocated_height != _height || _allocated_channels != _channels) {
+                gl::TexImage2D(
+                    GL_TEXTURE_2D, 0, format,
+                    static_cast<GLsizei>(_width),
+                    static_cast<GLsizei>(_height),
+                    0, static_cast<GLenum>(format), GL_UNSIGNED_BYTE,
+                    _image_data.empty() ? nullptr : reinterpret_cast<const GLvoid *>(_image_data.data())
+                );
+                _allocated_width = _width;
+                _allocated_height = _height;
+                _allocated_channels = _channels;
+            } else if (!_image_data.empty()) {
+                gl::TexSubImage2D(
+                    GL_TEXTURE_2D, 0, 0, 0,
+                    static_cast<GLsizei>(_width),
+                    static_cast<GLsizei>(_height),
+                    static_cast<GLenum>(format), GL_UNSIGNED_BYTE,
+                    reinterpret_cast<const GLvoid *>(_image_data.data())
+                );
+            }
+
+            Profiler::count(Profiler::UploadedBytes, _image_data.size());
+
+            _gpu_size = static_cast<size_t>(_width) * _height * _channels;
+            if (!_mipmap_levels.empty()) {
+                for (size_t i = 0; i < _mipmap_levels.size(); ++i) {
+                    const auto &level = _mipmap_levels[i];
+                    _gpu_size += static_cast<size_t>(level.width) * level.height * _channels;
+                    Profiler::count(Profiler::UploadedBytes, level.image_data.size());
+                    gl::TexImage2D(
+                        GL_TEXTURE_2D, static_cast<GLint>(i + 1), format,
+                        static_cast<GLsizei>(level.width),
+                        static_cast<GLsizei>(level.height),
+                        0, static_cast<GLenum>(format), GL_UNSIGNED_BYTE,
+                        reinterpret_cast<const GLvoid *>(level.image_data.data())
+                    );
+                }
+            } else if (_mipmaps_enabled) {
+                gl::GenerateMipmap(GL_TEXTURE_2D);
+                _gpu_size += _gpu_size / 3;
+            }
+        }
+
+        void _update_dirty_rectangles()
+        {
+            if (_compression != Uncompressed || _image_data.empty() ||
+                _allocated_width != _width || _allocated_height != _height || _allocated_channels != _channels) {
+                _update_image_data();
+                return;
+            }
+
+            for (const auto &rectangle : _dirty_rectangles) {
+                _update_rectangle(0, _image_data.data(), _width, rectangle);
+            }
+
+            if (!_mipmap_levels.empty()) {
+                /* Levels that came without a generator, e.g. from a texture loader, are refiltered with the default one. */
+                static const MipmapGenerator default_mipmap_generator;
+                const MipmapGenerator &mipmap_generator = _mipmap_generator ? *_mipmap_generator : default_mipmap_generator;
+                for (const auto &rectangle : _dirty_rectangles) {
+                    std::vector<Rectangle> level_rectangles = mipmap_generator.update(
+                        _image_data.data(), _width, _height, _channels, rectangle, _mipmap_levels
+                    );
+                    for (size_t i = 0; i < level_rectangles.size(); ++i) {
+                        const auto &level = _mipmap_levels[i];
+                        _update_rectangle(static_cast<GLint>(i + 1), level.image_data.data(), level.width, level_rectangles[i]);
+                    }
+                }
+            } else if (_mipmaps_enabled) {
+                gl::GenerateMipmap(GL_TEXTURE_2D);
+            }
+        }
+
+        /* ES 2.0 has no GL_UNPACK_ROW_LENGTH, so rectangles narrower than the image are packed into a scratch buffer first. */
+        void _update_rectangle(GLint level, const uint8_t *image_data, unsigned int width, const Rectangle &rectangle)
+        {
+            GLenum format = _channels == 3 ? GL_RGB : GL_RGBA;
+            size_t row_size = static_cast<size_t>(rectangle.width) * _channels;
+            const uint8_t *source = image_data + (static_cast<size_t>(rectangle.y) * width + rectangle.x) * _channels;
+            if (rectangle.width != width) {
+                _rectangle_buffer.resize(row_size * rectangle.height);
+                for (unsigned int row = 0; row < rectangle.height; ++row) {
+                    std::memcpy(
+                        _rectangle_buffer.data() + row * row_size,
+                        source + static_cast<size_t>(row) * width * _channels,
+                        row_size
+                    );
+                }
+                source = _rectangle_buffer.data();
+            }
+
+            gl::TexSubImage2D(
+                GL_TEXTURE_2D, level,
+                static_cast<GLint>(rectangle.x),
+                static_cast<GLint>(rectangle.y),
+                static_cast<GLsizei>(rectangle.width),
+                static_cast<GLsizei>(rectangle.height),
+                format, GL_UNSIGNED_BYTE,
+                reinterpret_cast<const GLvoid *>(source)
+            );
+            Profiler::count(Profiler::UploadedBytes, row_size * rectangle.height);
+        }
+
+        void _update_compressed_image_data()
+        {
+            /* Compressed levels are always specified from scratch, so the next uncompressed upload reallocates. */
+            _allocated_width = _allocated_height = _allocated_channels = 0;
+            _gpu_size = 0;
+            if (_image_data.empty()) {
+                return;
+            }
+
+            if (is_compression_supported(_compression)) {
+                GLenum format = _convert_compression_to_es2_texture_format(_compression);
+                gl::CompressedTexImage2D(
+                    GL_TEXTURE_2D, 0, format,
+                    static_cast<GLsizei>(_width),
+                    static_cast<GLsizei>(_height),
+                    0, static_cast<GLsizei>(_image_data.size()),
+                    reinterpret_cast<const GLvoid *>(_image_data.data())
+                );
+                _gpu_size = _image_data.size();
+                _set_mipmaps_missing(_mipmap_levels.empty());
+                for (size_t i = 0; i < _mipmap_levels.size(); ++i) {
+                    const auto &level = _mipmap_levels[i];
+                    _gpu_size += level.image_data.size();
+                    gl::CompressedTexImage2D(
+                        GL_TEXTURE_2D, static_cast<GLint>(i + 1), format,
+                        static_cast<GLsizei>(level.width),
+                        static_cast<GLsizei>(level.height),
+                        0, static_cast<GLsizei>(level.image_data.size()),
+                        reinterpret_cast<const GLvoid *>(level.image_data.data())
+                    );
+                }
+                Profiler::count(Profiler::UploadedBytes, _gpu_size);
+
+                return;
+            }
+
+            /* The GPU can not sample this format. Texture loaders decode such images on their threads, so this is
+               only reached by textures set up directly. They are decoded once and kept as RGBA from then on. */
+            ImageBuffer pixels;
+            std::vector<MipmapLevel> pixel_mipmap_levels;
+            if (!compressed_image_utilities::decompress_image(
+                _compression, _image_data, _width, _height, _mipmap_levels, pixels, pixel_mipmap_levels
+            )) {
+                std::cerr << "The compressed texture format is not supported by the GPU and can not be decoded" << std::endl;
+                return;
+            }
+            set_image(std::move(pixels), _width, _height, 4);
+            _mipmap_levels = std::move(pixel_mipmap_levels);
+            _update_image_data();
+        }
+
+        /* Compressed images can not have their mipmaps generated on the GPU, so without levels of their own
+           they are sampled from the base level only instead of being incomplete. */
+        void _set_mipmaps_missing(bool mipmaps_missing)
+        {
+            if (_mipmaps_missing != mipmaps_missing) {
+                _mipmaps_missing = mipmaps_missing;
+                _requires_params_update = true;
+            }
+        }
 
         static GLint _convert_wrap_mode_to_es2_texture_wrap_mode(Texture::WrapMode wrap_mode)
         {
@@ -119,6 +379,32 @@ namespace asr
             return GL_REPEAT;
         }
 
+        static GLenum _convert_compression_to_es2_texture_format(Texture::Compression compression)
+        {
+            switch (compression) {
+                case Uncompressed:
+                    break;
+                case ETC1:
+                    return GL_ETC1_RGB8_OES;
+                case ETC2RGB:
+                    return GL_COMPRESSED_RGB8_ETC2;
+                case ETC2RGBA:
+                    return GL_COMPRESSED_RGBA8_ETC2_EAC;
+                case DXT1:
+                    return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+                case DXT1A:
+                    return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+                case DXT3:
+                    return GL_COMPRESSED_RGBA_S3TC_DXT3_EXT;
+                case DXT5:
+                    return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+                case ASTC4x4:
+                    return GL_COMPRESSED_RGBA_ASTC_4x4_KHR;
+            }
+
+            return GL_RGBA;
+        }
+
         static GLint _convert_filter_type_to_es2_texture_filter_type(Texture::FilterType filter)
         {
             switch (filter) {
@@ -138,6 +424,22 @@ namespace asr
 
             return GL_NEAREST;
         }
+
+        static Texture::FilterType _get_base_level_filter_type(Texture::FilterType filter)
+        {
+            switch (filter) {
+                case Nearest:
+                case NearestMipmapNearest:
+                case NearestMipmapLinear:
+                    return Nearest;
+                case Linear:
+                case LinearMipmapNearest:
+                case LinearMipmapLinear:
+                    return Linear;
+            }
+
+            return filter;
+        }
     };
 }
 
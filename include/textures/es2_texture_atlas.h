@@ -0,0 +1,25 @@
+#ifndef ES2_TEXTURE_ATLAS_H
+#define ES2_TEXTURE_ATLAS_H
+
+#include "textures/texture_atlas.h"
+#include "textures/es2_texture.h"
+
+#include <memory>
+#include <utility>
+
+namespace asr
+{
+    class ES2TextureAtlas final : public TextureAtlas
+    {
+    public:
+        using TextureAtlas::TextureAtlas;
+
+    protected:
+        std::shared_ptr<Texture> _create_page(ImageBuffer image_data, unsigned int width, unsigned int height) final
+        {
+            return std::make_shared<ES2Texture>(std::move(image_data), width, height, 4);
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef ES2_TEXTURE_LOADER_H
+#define ES2_TEXTURE_LOADER_H
+
+#include "textures/texture_loader.h"
+#include "textures/es2_texture.h"
+
+#include <memory>
+#include <utility>
+
+namespace asr
+{
+    class ES2TextureLoader final : public TextureLoader
+    {
+    public:
+        using TextureLoader::TextureLoader;
+
+    protected:
+        std::shared_ptr<Texture> _create_texture(
+            ImageBuffer image_data, unsigned int width, unsigned int height, unsigned int channels
+        ) final
+        {
+            return std::make_shared<ES2Texture>(std::move(image_data), width, height, channels);
+        }
+
+        bool _is_compression_supported(Texture::Compression compression) final
+        {
+            return ES2Texture::is_compression_supported(compression);
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,585 @@
+#ifndef MIPMAP_GENERATOR_H
+#define MIPMAP_GENERATOR_H
+
+#include "textures/texture.h"
+#include "utilities/image_buffer.h"
+#include "utilities/thread_pool.h"
+
+#include <cstdint>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <array>
+#include <fstream>
+#include <filesystem>
+#include <system_error>
+#include <algorithm>
+#include <utility>
+#include <thread>
+#include <functional>
+
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define ASR_MIPMAP_GENERATOR_SSE
+#endif
+
+namespace asr
+{
+    /* Builds mipmap chains on the CPU, so textures do not depend on glGenerateMipmap. Every level is
+       filtered from the previous one in linear light with a separable kernel, rows split across the thread pool.
+       Chains can also be refreshed for a changed rectangle only. */
+    class MipmapGenerator
+    {
+    public:
+        enum Filter
+        {
+            Box,
+            Kaiser,
+            Lanczos
+        };
+
+        explicit MipmapGenerator(
+            Filter filter = Kaiser, bool gamma_correction_enabled = true,
+            ThreadPool &thread_pool = ThreadPool::get_shared_instance()
+        )
+            : _filter{filter}, _gamma_correction_enabled{gamma_correction_enabled}, _thread_pool{thread_pool}
+        {}
+
+        MipmapGenerator(const MipmapGenerator &other) = delete;
+        MipmapGenerator& operator=(const MipmapGenerator &other) = delete;
+
+        [[nodiscard]] Filter get_filter() const
+        {
+            return _filter;
+        }
+
+        void set_filter(Filter filter)
+        {
+            _filter = filter;
+        }
+
+        [[nodiscard]] bool is_gamma_correction_enabled() const
+        {
+            return _gamma_correction_enabled;
+        }
+
+        void set_gamma_correction_enabled(bool gamma_correction_enabled)
+        {
+            _gamma_correction_enabled = gamma_correction_enabled;
+        }
+
+        [[nodiscard]] bool is_cache_enabled() const
+        {
+            return _cache_enabled;
+        }
+
+        void set_cache_enabled(bool cache_enabled)
+        {
+            _cache_enabled = cache_enabled;
+        }
+
+        /* Returns the levels after the first one, down to 1x1. */
+        [[nodiscard]] std::vector<Texture::MipmapLevel> generate(
+            const uint8_t *image_data, unsigned int width, unsigned int height, unsigned int channels
+        ) const
+        {
+            std::vector<Texture::MipmapLevel> levels;
+            if (image_data == nullptr || width == 0 || height == 0 || channels == 0) {
+                return levels;
+            }
+
+            const uint8_t *source = image_data;
+            unsigned int source_width = width, source_height = height;
+            while (source_width > 1 || source_height > 1) {
+                unsigned int level_width = std::max(1u, source_width / 2);
+                unsigned int level_height = std::max(1u, source_height / 2);
+
+                std::vector<uint8_t> level(static_cast<size_t>(level_width) * level_height * channels);
+                _downsample(
+                    source, source_width, source_height, level.data(), level_width, level_height, channels,
+                    Texture::Rectangle{0, 0, level_width, level_height}
+                );
+                levels.push_back(Texture::MipmapLevel{std::move(level), level_width, level_height});
+
+                source = levels.back().image_data.data();
+                source_width = level_width;
+                source_height = level_height;
+            }
+
+            return levels;
+        }
+
+        /* Refilters only the part of every level that depends on `rectangle` of the base image and
+           returns the rectangle that changed on each level. */
+        std::vector<Texture::Rectangle> update(
+            const uint8_t *image_data, unsigned int width, unsigned int height, unsigned int channels,
+            const Texture::Rectangle &rectangle, std::vector<Texture::MipmapLevel> &levels
+        ) const
+        {
+            std::vector<Texture::Rectangle> rectangles;
+
+            const uint8_t *source = image_data;
+            unsigned int source_width = width, source_height = height;
+            Texture::Rectangle source_rectangle = rectangle;
+            for (auto &level : levels) {
+                Contributions horizontal = _calculate_contributions(source_width, level.width);
+                Contributions vertical = _calculate_contributions(source_height, level.height);
+
+                Texture::Rectangle level_rectangle{};
+                _get_affected_range(horizontal, source_width, source_rectangle.x, source_rectangle.width, level_rectangle.x, level_rectangle.width);
+                _get_affected_range(vertical, source_height, source_rectangle.y, source_rectangle.height, level_rectangle.y, level_rectangle.height);
+                if (level_rectangle.width == 0 || level_rectangle.height == 0) {
+                    break;
+                }
+
+                _downsample(
+                    source, source_width, source_height, level.image_data.data(), level.width, level.height, channels,
+                    level_rectangle
+                );
+                rectangles.push_back(level_rectangle);
+
+                source = level.image_data.data();
+                source_width = level.width;
+                source_height = level.height;
+                source_rectangle = level_rectangle;
+            }
+
+            return rectangles;
+        }
+
+        /* Same as `generate`, but reuses the chain stored next to the source file by an earlier call when
+           the cache is enabled and the source has not changed since. */
+        [[nodiscard]] std::vector<Texture::MipmapLevel> generate(
+            const std::string &source_path,
+            const uint8_t *image_data, unsigned int width, unsigned int height, unsigned int channels
+        ) const
+        {
+            std::vector<Texture::MipmapLevel> levels;
+            if (_cache_enabled && _read_cache(source_path, width, height, channels, levels)) {
+                return levels;
+            }
+
+            levels = generate(image_data, width, height, channels);
+            if (_cache_enabled) {
+                _write_cache(source_path, width, height, channels, levels);
+            }
+
+            return levels;
+        }
+
+        void generate(Texture &texture) const
+        {
+            if (texture.is_compressed()) {
+                return;
+            }
+
+            const auto &image_data = texture.get_image_data();
+            texture.set_mipmap_levels(
+                generate(image_data.data(), texture.get_width(), texture.get_height(), texture.get_channels())
+            );
+        }
+
+        static std::string get_cache_path(const std::string &source_path)
+        {
+            return source_path + ".mipmaps";
+        }
+
+    private:
+        /* Source taps and normalized weights of one output pixel along one axis. */
+        struct Contributions
+        {
+            std::vector<int> first_taps;
+            std::vector<int> tap_counts;
+            std::vector<float> weights;
+            size_t taps_per_pixel;
+        };
+
+        Filter _filter;
+        bool _gamma_correction_enabled;
+        bool _cache_enabled{false};
+
+        ThreadPool &_thread_pool;
+
+        static constexpr char CACHE_MAGIC[8]{'A', 'S', 'R', 'M', 'I', 'P', 'S', '1'};
+
+        [[nodiscard]] float _get_filter_radius() const
+        {
+            return _filter == Box ? 0.5f : 3.0f;
+        }
+
+        [[nodiscard]] float _evaluate_filter(float x) const
+        {
+            x = std::fabs(x);
+            switch (_filter) {
+                case Box:
+                    return x <= 0.5f ? 1.0f : 0.0f;
+                case Kaiser: {
+                    const float ALPHA{4.0f};
+                    float radius = _get_filter_radius();
+                    if (x >= radius) {
+                        return 0.0f;
+                    }
+                    float t = x / radius;
+                    return _sinc(x) * _bessel_i0(ALPHA * std::sqrt(1.0f - t * t)) / _bessel_i0(ALPHA);
+                }
+                case Lanczos: {
+                    float radius = _get_filter_radius();
+                    return x < radius ? _sinc(x) * _sinc(x / radius) : 0.0f;
+                }
+            }
+
+            return 0.0f;
+        }
+
+        [[nodiscard]] Contributions _calculate_contributions(unsigned int source_size, unsigned int destination_size) const
+        {
+            float scale = static_cast<float>(source_size) / static_cast<float>(destination_size);
+            float support = _get_filter_radius() * std::max(1.0f, scale);
+
+            Contributions contributions;
+            contributions.taps_per_pixel = static_cast<size_t>(std::ceil(support * 2.0f)) + 2;
+            contributions.first_taps.resize(destination_size);
+            contributions.tap_counts.resize(destination_size);
+            contributions.weights.assign(destination_size * contributions.taps_per_pixel, 0.0f);
+
+            for (unsigned int i = 0; i < destination_size; ++i) {
+                float center = (static_cast<float>(i) + 0.5f) * scale - 0.5f;
+                int first = static_cast<int>(std::floor(center - support));
+                int last = static_cast<int>(std::ceil(center + support));
+                last = std::min(last, first + static_cast<int>(contributions.taps_per_pixel) - 1);
+
+                float *weights = &contributions.weights[i * contributions.taps_per_pixel];
+                float total{0.0f};
+                for (int tap = first; tap <= last; ++tap) {
+                    float weight = _evaluate_filter((static_cast<float>(tap) - center) / std::max(1.0f, scale));
+                    weights[tap - first] = weight;
+                    total += weight;
+                }
+                if (total != 0.0f) {
+                    for (int tap = first; tap <= last; ++tap) {
+                        weights[tap - first] /= total;
+                    }
+                }
+
+                contributions.first_taps[i] = first;
+                contributions.tap_counts[i] = last - first + 1;
+            }
+
+            return contributions;
+        }
+
+        static void _get_range(
+            const Contributions &contributions, unsigned int source_size, unsigned int begin, unsigned int count,
+            unsigned int &first_tap, unsigned int &last_tap
+        )
+        {
+            int last = static_cast<int>(source_size) - 1;
+            first_tap = static_cast<unsigned int>(std::clamp(contributions.first_taps[begin], 0, last));
+            unsigned int end = begin + count - 1;
+            last_tap = static_cast<unsigned int>(
+                std::clamp(contributions.first_taps[end] + contributions.tap_counts[end] - 1, 0, last)
+            );
+        }
+
+        /* Finds the output pixels whose taps reach into [begin, begin + count) of the source. */
+        static void _get_affected_range(
+            const Contributions &contributions, unsigned int source_size, unsigned int begin, unsigned int count,
+            unsigned int &affected_begin, unsigned int &affected_count
+        )
+        {
+            int last = static_cast<int>(source_size) - 1;
+            int first_affected{-1}, last_affected{-1};
+            for (size_t i = 0; i < contributions.first_taps.size(); ++i) {
+                int first_tap = std::clamp(contributions.first_taps[i], 0, last);
+                int last_tap = std::clamp(contributions.first_taps[i] + contributions.tap_counts[i] - 1, 0, last);
+                if (last_tap >= static_cast<int>(begin) && first_tap < static_cast<int>(begin + count)) {
+                    if (first_affected < 0) {
+                        first_affected = static_cast<int>(i);
+                    }
+                    last_affected = static_cast<int>(i);
+                }
+            }
+
+            affected_begin = first_affected < 0 ? 0 : static_cast<unsigned int>(first_affected);
+            affected_count = first_affected < 0 ? 0 : static_cast<unsigned int>(last_affected - first_affected + 1);
+        }
+
+        /* Filters the `rectangle` of the destination level from the source level. Only the source pixels
+           under the filter footprint are converted to linear floats. */
+        void _downsample(
+            const uint8_t *source, unsigned int source_width, unsigned int source_height,
+            uint8_t *destination, unsigned int destination_width, unsigned int destination_height,
+            unsigned int channels, const Texture::Rectangle &rectangle
+        ) const
+        {
+            Contributions horizontal = _calculate_contributions(source_width, destination_width);
+            Contributions vertical = _calculate_contributions(source_height, destination_height);
+
+            unsigned int first_column, last_column, first_row, last_row;
+            _get_range(horizontal, source_width, rectangle.x, rectangle.width, first_column, last_column);
+            _get_range(vertical, source_height, rectangle.y, rectangle.height, first_row, last_row);
+            unsigned int window_width = last_column - first_column + 1;
+            unsigned int window_height = last_row - first_row + 1;
+
+            std::vector<float> intermediate(static_cast<size_t>(rectangle.width) * window_height * channels);
+            _thread_pool.parallel_for(0, window_height, 16, [&](size_t begin, size_t end) {
+                std::vector<float> window_row(static_cast<size_t>(window_width) * channels);
+                for (size_t row = begin; row < end; ++row) {
+                    const uint8_t *source_row = source + ((first_row + row) * source_width + first_column) * channels;
+                    for (size_t i = 0; i < window_row.size(); ++i) {
+                        window_row[i] = _to_linear(source_row[i], static_cast<unsigned int>(i % channels), channels);
+                    }
+
+                    float *intermediate_row = &intermediate[row * rectangle.width * channels];
+                    for (unsigned int x = 0; x < rectangle.width; ++x) {
+                        _filter_pixel(
+                            horizontal, rectangle.x + x, source_width, channels,
+                            [&](int tap) { return &window_row[static_cast<size_t>(tap - static_cast<int>(first_column)) * channels]; },
+                            intermediate_row + static_cast<size_t>(x) * channels
+                        );
+                    }
+                }
+            });
+
+            _thread_pool.parallel_for(0, rectangle.height, 16, [&](size_t begin, size_t end) {
+                std::vector<float> pixel(channels);
+                for (size_t y = begin; y < end; ++y) {
+                    uint8_t *destination_row = destination + ((rectangle.y + y) * destination_width + rectangle.x) * channels;
+                    for (unsigned int x = 0; x < rectangle.width; ++x) {
+                        _filter_pixel(
+                            vertical, rectangle.y + static_cast<unsigned int>(y), source_height, channels,
+                            [&](int tap) {
+                                return &intermediate[((static_cast<size_t>(tap) - first_row) * rectangle.width + x) * channels];
+                            },
+                            pixel.data()
+                        );
+                        for (unsigned int c = 0; c < channels; ++c) {
+                            destination_row[static_cast<size_t>(x) * channels + c] = _to_encoded(pixel[c], c, channels);
+                        }
+                    }
+                }
+            });
+        }
+
+        template<typename PixelAccessor>
+        static void _filter_pixel(
+            const Contributions &contributions, unsigned int index, unsigned int source_size, unsigned int channels,
+            PixelAccessor pixel, float *result
+        )
+        {
+            int first = contributions.first_taps[index];
+            int count = contributions.tap_counts[index];
+            const float *weights = &contributions.weights[index * contributions.taps_per_pixel];
+            int last_tap = static_cast<int>(source_size) - 1;
+
+#ifdef ASR_MIPMAP_GENERATOR_SSE
+            if (channels == 4) {
+                __m128 sum = _mm_setzero_ps();
+                for (int i = 0; i < count; ++i) {
+                    const float *value = pixel(std::clamp(first + i, 0, last_tap));
+                    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(value), _mm_set1_ps(weights[i])));
+                }
+                _mm_storeu_ps(result, sum);
+                return;
+            }
+#endif
+
+            std::fill(result, result + channels, 0.0f);
+            for (int i = 0; i < count; ++i) {
+                const float *value = pixel(std::clamp(first + i, 0, last_tap));
+                for (unsigned int c = 0; c < channels; ++c) {
+                    result[c] += value[c] * weights[i];
+                }
+            }
+        }
+
+        [[nodiscard]] float _to_linear(uint8_t value, unsigned int channel, unsigned int channels) const
+        {
+            static const std::array<float, 256> SRGB_TO_LINEAR = []() {
+                std::array<float, 256> table{};
+                for (size_t i = 0; i < table.size(); ++i) {
+                    float value = static_cast<float>(i) / 255.0f;
+                    table[i] = value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+                }
+                return table;
+            }();
+
+            return _is_gamma_encoded(channel, channels) ? SRGB_TO_LINEAR[value] : static_cast<float>(value) / 255.0f;
+        }
+
+        [[nodiscard]] uint8_t _to_encoded(float value, unsigned int channel, unsigned int channels) const
+        {
+            static const std::array<uint8_t, 4096> LINEAR_TO_SRGB = []() {
+                std::array<uint8_t, 4096> table{};
+                for (size_t i = 0; i < table.size(); ++i) {
+                    float value = static_cast<float>(i) / static_cast<float>(table.size() - 1);
+                    value = value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+                    table[i] = static_cast<uint8_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 255.0f));
+                }
+                return table;
+            }();
+
+            value = std::clamp(value, 0.0f, 1.0f);
+            return _is_gamma_encoded(channel, channels) ?
+                LINEAR_TO_SRGB[static_cast<size_t>(value * static_cast<float>(LINEAR_TO_SRGB.size() - 1) + 0.5f)] :
+                static_cast<uint8_t>(std::lround(value * 255.0f));
+        }
+
+        /* Alpha is stored linearly, the color channels are sRGB encoded. */
+        [[nodiscard]] bool _is_gamma_encoded(unsigned int channel, unsigned int channels) const
+        {
+            bool has_alpha = channels == 2 || channels == 4;
+            return _gamma_correction_enabled && !(has_alpha && channel == channels - 1);
+        }
+
+        static float _sinc(float x)
+        {
+            if (x == 0.0f) {
+                return 1.0f;
+            }
+            float pi_x = static_cast<float>(M_PI) * x;
+
+            return std::sin(pi_x) / pi_x;
+        }
+
+        static float _bessel_i0(float x)
+        {
+            float sum{1.0f}, term{1.0f};
+            float half_x_squared = x * x * 0.25f;
+            for (int k = 1; k < 32 && term > sum * 1e-8f; ++k) {
+                term *= half_x_squared / static_cast<float>(k * k);
+                sum += term;
+            }
+
+            return sum;
+        }
+
+        static bool _get_source_stamp(const std::string &source_path, uint64_t &size, int64_t &modification_time)
+        {
+            std::error_code error;
+            size = static_cast<uint64_t>(std::filesystem::file_size(source_path, error));
+            if (error) {
+                return false;
+            }
+            modification_time = static_cast<int64_t>(
+                std::filesystem::last_write_time(source_path, error).time_since_epoch().count()
+            );
+
+            return !error;
+        }
+
+        template<typename Value>
+        static bool _read_value(std::istream &stream, Value &value)
+        {
+            return static_cast<bool>(stream.read(reinterpret_cast<char *>(&value), sizeof(Value)));
+        }
+
+        template<typename Value>
+        static void _write_value(std::ostream &stream, const Value &value)
+        {
+            stream.write(reinterpret_cast<const char *>(&value), sizeof(Value));
+        }
+
+        bool _read_cache(
+            const std::string &source_path, unsigned int width, unsigned int height, unsigned int channels,
+            std::vector<Texture::MipmapLevel> &levels
+        ) const
+        {
+            uint64_t source_size;
+            int64_t source_modification_time;
+            if (!_get_source_stamp(source_path, source_size, source_modification_time)) {
+                return false;
+            }
+
+            std::ifstream file_stream{get_cache_path(source_path), std::ios::binary};
+            if (!file_stream.is_open()) {
+                return false;
+            }
+
+            char magic[sizeof(CACHE_MAGIC)];
+            uint32_t filter, gamma_correction_enabled, cached_width, cached_height, cached_channels, level_count;
+            uint64_t cached_source_size;
+            int64_t cached_source_modification_time;
+            if (!file_stream.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), CACHE_MAGIC) ||
+                !_read_value(file_stream, filter) || !_read_value(file_stream, gamma_correction_enabled) ||
+                !_read_value(file_stream, cached_width) || !_read_value(file_stream, cached_height) ||
+                !_read_value(file_stream, cached_channels) || !_read_value(file_stream, cached_source_size) ||
+                !_read_value(file_stream, cached_source_modification_time) || !_read_value(file_stream, level_count)) {
+                return false;
+            }
+            if (filter != static_cast<uint32_t>(_filter) || gamma_correction_enabled != (_gamma_correction_enabled ? 1u : 0u) ||
+                cached_width != width || cached_height != height || cached_channels != channels ||
+                cached_source_size != source_size || cached_source_modification_time != source_modification_time) {
+                return false;
+            }
+
+            levels.clear();
+            unsigned int level_width = width, level_height = height;
+            for (uint32_t i = 0; i < level_count; ++i) {
+                level_width = std::max(1u, level_width / 2);
+                level_height = std::max(1u, level_height / 2);
+
+                std::vector<uint8_t> data(static_cast<size_t>(level_width) * level_height * channels);
+                if (!file_stream.read(reinterpret_cast<char *>(data.data()), static_cast<std::streamsize>(data.size()))) {
+                    levels.clear();
+                    return false;
+                }
+                levels.push_back(Texture::MipmapLevel{std::move(data), level_width, level_height});
+            }
+
+            return true;
+        }
+
+        void _write_cache(
+            const std::string &source_path, unsigned int width, unsigned int height, unsigned int channels,
+            const std::vector<Texture::MipmapLevel> &levels
+        ) const
+        {
+            uint64_t source_size;
+            int64_t source_modification_time;
+            if (!_get_source_stamp(source_path, source_size, source_modification_time)) {
+                return;
+            }
+
+            /* Written under a temporary name and renamed, so a concurrent reader never sees a partial file. */
+            std::string cache_path = get_cache_path(source_path);
+            std::string temporary_path = cache_path + ".tmp" + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+            {
+                std::ofstream file_stream{temporary_path, std::ios::binary | std::ios::trunc};
+                if (!file_stream.is_open()) {
+                    return;
+                }
+
+                file_stream.write(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+                _write_value(file_stream, static_cast<uint32_t>(_filter));
+                _write_value(file_stream, static_cast<uint32_t>(_gamma_correction_enabled ? 1 : 0));
+                _write_value(file_stream, static_cast<uint32_t>(width));
+                _write_value(file_stream, static_cast<uint32_t>(height));
+                _write_value(file_stream, static_cast<uint32_t>(channels));
+                _write_value(file_stream, source_size);
+                _write_value(file_stream, source_modification_time);
+                _write_value(file_stream, static_cast<uint32_t>(levels.size()));
+                for (const auto &level : levels) {
+                    file_stream.write(
+                        reinterpret_cast<const char *>(level.image_data.data()),
+                        static_cast<std::streamsize>(level.image_data.size())
+                    );
+                }
+                if (!file_stream) {
+                    file_stream.close();
+                    std::error_code error;
+                    std::filesystem::remove(temporary_path, error);
+                    return;
+                }
+            }
+
+            std::error_code error;
+            std::filesystem::rename(temporary_path, cache_path, error);
+            if (error) {
+                std::filesystem::remove(temporary_path, error);
+            }
+        }
+    };
+}
+
+#endif
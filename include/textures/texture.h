@@ -1,15 +1,24 @@
 #ifndef TEXTURE_H
 #define TEXTURE_H
 
+#include "utilities/image_buffer.h"
+#include "utilities/gpu_resource.h"
+
 #include <glm/glm.hpp>
 
 #include <cstdint>
+#include <cstring>
+#include <string>
 #include <vector>
+#include <memory>
+#include <algorithm>
 #include <utility>
 
 namespace asr
 {
-    class Texture
+    class MipmapGenerator;
+
+    class Texture : public GPUResource
     {
     public:
         enum Mode
@@ -38,23 +47,215 @@ namespace asr
             LinearMipmapLinear
         };
 
-        Texture(std::vector<uint8_t> image_data, unsigned int width, unsigned int height, unsigned int channels)
+        enum Compression
+        {
+            Uncompressed,
+            ETC1,
+            ETC2RGB,
+            ETC2RGBA,
+            DXT1,
+            DXT1A,
+            DXT3,
+            DXT5,
+            ASTC4x4
+        };
+
+        struct Rectangle
+        {
+            unsigned int x;
+            unsigned int y;
+            unsigned int width;
+            unsigned int height;
+        };
+
+        struct MipmapLevel
+        {
+            ImageBuffer image_data;
+            unsigned int width;
+            unsigned int height;
+        };
+
+        Texture(ImageBuffer image_data, unsigned int width, unsigned int height, unsigned int channels)
             : _image_data{std::move(image_data)}, _width{width}, _height{height}, _channels{channels}
         {}
 
         virtual ~Texture() = default;
 
-        [[nodiscard]] const std::vector<uint8_t> &get_image_data() const
+        [[nodiscard]] const ImageBuffer &get_image_data() const
         {
             return _image_data;
         }
 
-        void set_image_data(const std::vector<uint8_t> &image_data)
+        /* Changes made through this reference are uploaded after calling `set_requires_data_update(true)`, or
+           `add_dirty_rectangle` for the changed part only. */
+        [[nodiscard]] ImageBuffer &get_image_data()
+        {
+            return _image_data;
+        }
+
+        void set_image_data(ImageBuffer image_data)
+        {
+            _image_data = std::move(image_data);
+            _dirty_rectangles.clear();
+            _reload_requested = false;
+            _requires_data_update = true;
+        }
+
+        void set_image(ImageBuffer image_data, unsigned int width, unsigned int height, unsigned int channels)
+        {
+            _image_data = std::move(image_data);
+            _width = width;
+            _height = height;
+            _channels = channels;
+            _compression = Uncompressed;
+            _mipmap_levels.clear();
+            _dirty_rectangles.clear();
+            _reload_requested = false;
+            _requires_data_update = true;
+        }
+
+        /* Replaces the image with a block-compressed payload. `mipmap_levels` holds the levels after the
+           first one in the same compression, smallest last. */
+        void set_compressed_image(
+            Compression compression, ImageBuffer image_data, unsigned int width, unsigned int height,
+            std::vector<MipmapLevel> mipmap_levels = {}
+        )
+        {
+            _image_data = std::move(image_data);
+            _width = width;
+            _height = height;
+            _channels = compression == ETC1 || compression == ETC2RGB || compression == DXT1 ? 3 : 4;
+            _compression = compression;
+            _mipmap_levels = std::move(mipmap_levels);
+            _dirty_rectangles.clear();
+            _reload_requested = false;
+            _requires_data_update = true;
+        }
+
+        /* Copies tightly packed pixels with the texture's channel count into a rectangle of the image. Only
+           that rectangle is uploaded on the next update. */
+        void write_image_data(unsigned int x, unsigned int y, unsigned int width, unsigned int height, const uint8_t *image_data)
+        {
+            if (_compression != Uncompressed || _image_data.empty() || x >= _width || y >= _height) {
+                return;
+            }
+
+            unsigned int clipped_width = std::min(width, _width - x);
+            unsigned int clipped_height = std::min(height, _height - y);
+            for (unsigned int row = 0; row < clipped_height; ++row) {
+                std::memcpy(
+                    _image_data.data() + ((static_cast<size_t>(y) + row) * _width + x) * _channels,
+                    image_data + static_cast<size_t>(row) * width * _channels,
+                    static_cast<size_t>(clipped_width) * _channels
+                );
+            }
+            add_dirty_rectangle(x, y, clipped_width, clipped_height);
+        }
+
+        /* Marks a rectangle changed through `get_image_data` for upload. Overlapping rectangles are merged. */
+        void add_dirty_rectangle(unsigned int x, unsigned int y, unsigned int width, unsigned int height)
+        {
+            if (x >= _width || y >= _height) {
+                return;
+            }
+            Rectangle rectangle{x, y, std::min(width, _width - x), std::min(height, _height - y)};
+            if (rectangle.width == 0 || rectangle.height == 0) {
+                return;
+            }
+
+            for (auto dirty_rectangle = std::begin(_dirty_rectangles); dirty_rectangle != std::end(_dirty_rectangles);) {
+                if (rectangle.x > dirty_rectangle->x + dirty_rectangle->width || dirty_rectangle->x > rectangle.x + rectangle.width ||
+                    rectangle.y > dirty_rectangle->y + dirty_rectangle->height || dirty_rectangle->y > rectangle.y + rectangle.height) {
+                    ++dirty_rectangle;
+                    continue;
+                }
+                rectangle = _get_bounding_rectangle(rectangle, *dirty_rectangle);
+                dirty_rectangle = _dirty_rectangles.erase(dirty_rectangle);
+            }
+            _dirty_rectangles.push_back(rectangle);
+
+            if (_dirty_rectangles.size() > MAX_DIRTY_RECTANGLES) {
+                for (size_t i = 1; i < _dirty_rectangles.size(); ++i) {
+                    _dirty_rectangles[0] = _get_bounding_rectangle(_dirty_rectangles[0], _dirty_rectangles[i]);
+                }
+                _dirty_rectangles.resize(1);
+            }
+        }
+
+        [[nodiscard]] const std::vector<Rectangle> &get_dirty_rectangles() const
+        {
+            return _dirty_rectangles;
+        }
+
+        [[nodiscard]] const std::shared_ptr<MipmapGenerator> &get_mipmap_generator() const
+        {
+            return _mipmap_generator;
+        }
+
+        /* When set, mipmaps are built on the CPU instead of with the driver, and a dirty rectangle refilters
+           only the part of each level it affects. */
+        void set_mipmap_generator(const std::shared_ptr<MipmapGenerator> &mipmap_generator)
         {
-            _image_data = image_data;
+            _mipmap_generator = mipmap_generator;
             _requires_data_update = true;
         }
 
+        [[nodiscard]] Compression get_compression() const
+        {
+            return _compression;
+        }
+
+        [[nodiscard]] bool is_compressed() const
+        {
+            return _compression != Uncompressed;
+        }
+
+        /* Precomputed levels after the first one. When present, they are uploaded instead of generating mipmaps. */
+        [[nodiscard]] const std::vector<MipmapLevel> &get_mipmap_levels() const
+        {
+            return _mipmap_levels;
+        }
+
+        void set_mipmap_levels(std::vector<MipmapLevel> mipmap_levels)
+        {
+            _mipmap_levels = std::move(mipmap_levels);
+            _dirty_rectangles.clear();
+            _requires_data_update = true;
+        }
+
+        /* When disabled, the pixels are released from CPU memory as soon as they have been uploaded. */
+        [[nodiscard]] bool is_image_data_retained() const
+        {
+            return _image_data_retained;
+        }
+
+        void set_image_data_retained(bool image_data_retained)
+        {
+            _image_data_retained = image_data_retained;
+        }
+
+        [[nodiscard]] const std::string &get_source_path() const
+        {
+            return _source_path;
+        }
+
+        /* The file the image was loaded from, used to load it again when it was evicted without a CPU copy. */
+        void set_source_path(const std::string &source_path)
+        {
+            _source_path = source_path;
+        }
+
+        /* Set when an evicted texture without a CPU copy was used and has to be loaded again from its source path. */
+        [[nodiscard]] bool is_reload_requested() const
+        {
+            return _reload_requested;
+        }
+
+        [[nodiscard]] bool is_restorable() const override
+        {
+            return !_image_data.empty();
+        }
+
         [[nodiscard]] unsigned int get_width() const
         {
             return _width;
@@ -240,7 +441,14 @@ namespace asr
         bool _enabled{true};
         bool _requires_params_update{true};
         bool _requires_data_update{true};
-        std::vector<uint8_t> _image_data;
+        ImageBuffer _image_data;
+        bool _image_data_retained{true};
+        Compression _compression{Uncompressed};
+        std::vector<MipmapLevel> _mipmap_levels;
+        std::shared_ptr<MipmapGenerator> _mipmap_generator;
+        std::vector<Rectangle> _dirty_rectangles;
+        std::string _source_path;
+        bool _reload_requested{false};
 
         unsigned int _width;
         unsigned int _height;
@@ -256,6 +464,21 @@ namespace asr
 
         bool _transformation_enabled{false};
         glm::mat4 _transformation_matrix{1.0f};
+
+    private:
+        static const size_t MAX_DIRTY_RECTANGLES{16};
+
+        static Rectangle _get_bounding_rectangle(const Rectangle &first, const Rectangle &second)
+        {
+            unsigned int x = std::min(first.x, second.x);
+            unsigned int y = std::min(first.y, second.y);
+
+            return Rectangle{
+                x, y,
+                std::max(first.x + first.width, second.x + second.width) - x,
+                std::max(first.y + first.height, second.y + second.height) - y
+            };
+        }
     };
 }
 
@@ -0,0 +1,323 @@
+#ifndef TEXTURE_ATLAS_H
+#define TEXTURE_ATLAS_H
+
+#include "textures/texture.h"
+#include "textures/texture_view.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <limits>
+#include <algorithm>
+
+namespace asr
+{
+    /* Bottom-left skyline rectangle packer. */
+    class SkylinePacker
+    {
+    public:
+        SkylinePacker(unsigned int width, unsigned int height)
+            : _width{width}, _height{height}, _skyline{Node{0, 0, width}}
+        {}
+
+        [[nodiscard]] unsigned int get_width() const
+        {
+            return _width;
+        }
+
+        [[nodiscard]] unsigned int get_height() const
+        {
+            return _height;
+        }
+
+        [[nodiscard]] unsigned long long get_used_area() const
+        {
+            return _used_area;
+        }
+
+        bool pack(unsigned int width, unsigned int height, unsigned int &x, unsigned int &y)
+        {
+            if (width == 0 || height == 0 || width > _width || height > _height) {
+                return false;
+            }
+
+            size_t best_index{_skyline.size()};
+            unsigned int best_y{std::numeric_limits<unsigned int>::max()};
+            unsigned int best_node_width{std::numeric_limits<unsigned int>::max()};
+            for (size_t i = 0; i < _skyline.size(); ++i) {
+                unsigned int node_y;
+                if (!_fits(i, width, height, node_y)) {
+                    continue;
+                }
+                if (node_y < best_y || (node_y == best_y && _skyline[i].width < best_node_width)) {
+                    best_index = i;
+                    best_y = node_y;
+                    best_node_width = _skyline[i].width;
+                }
+            }
+            if (best_index == _skyline.size()) {
+                return false;
+            }
+
+            x = _skyline[best_index].x;
+            y = best_y;
+            _add_node(best_index, Node{x, y + height, width});
+            _used_area += static_cast<unsigned long long>(width) * height;
+
+            return true;
+        }
+
+    private:
+        struct Node
+        {
+            unsigned int x;
+            unsigned int y;
+            unsigned int width;
+        };
+
+        unsigned int _width;
+        unsigned int _height;
+        std::vector<Node> _skyline;
+        unsigned long long _used_area{0};
+
+        bool _fits(size_t index, unsigned int width, unsigned int height, unsigned int &y) const
+        {
+            unsigned int x = _skyline[index].x;
+            if (x + width > _width) {
+                return false;
+            }
+
+            y = 0;
+            unsigned int remaining_width = width;
+            for (size_t i = index; remaining_width > 0; ++i) {
+                if (i == _skyline.size()) {
+                    return false;
+                }
+                y = std::max(y, _skyline[i].y);
+                if (y + height > _height) {
+                    return false;
+                }
+                remaining_width -= std::min(remaining_width, _skyline[i].width);
+            }
+
+            return true;
+        }
+
+        void _add_node(size_t index, const Node &node)
+        {
+            _skyline.insert(std::begin(_skyline) + static_cast<std::ptrdiff_t>(index), node);
+
+            for (size_t i = index + 1; i < _skyline.size();) {
+                const Node &previous = _skyline[i - 1];
+                Node &current = _skyline[i];
+                if (current.x >= previous.x + previous.width) {
+                    break;
+                }
+
+                unsigned int shrink = previous.x + previous.width - current.x;
+                if (current.width <= shrink) {
+                    _skyline.erase(std::begin(_skyline) + static_cast<std::ptrdiff_t>(i));
+                } else {
+                    current.x += shrink;
+                    current.width -= shrink;
+                    break;
+                }
+            }
+
+            for (size_t i = 0; i + 1 < _skyline.size();) {
+                if (_skyline[i].y == _skyline[i + 1].y) {
+                    _skyline[i].width += _skyline[i + 1].width;
+                    _skyline.erase(std::begin(_skyline) + static_cast<std::ptrdiff_t>(i + 1));
+                } else {
+                    ++i;
+                }
+            }
+        }
+    };
+
+    /* Packs many images into a few shared RGBA pages. Images can be added at any time; each one
+       is addressed through a region whose transformation matrix maps [0, 1] texture coordinates
+       into its rectangle on the page. */
+    class TextureAtlas
+    {
+    public:
+        struct Region
+        {
+            unsigned int page;
+            unsigned int x;
+            unsigned int y;
+            unsigned int width;
+            unsigned int height;
+            glm::vec4 uv_rectangle;
+
+            [[nodiscard]] glm::mat4 get_transformation_matrix() const
+            {
+                glm::mat4 matrix{1.0f};
+                matrix[0][0] = uv_rectangle.z - uv_rectangle.x;
+                matrix[1][1] = uv_rectangle.w - uv_rectangle.y;
+                matrix[3][0] = uv_rectangle.x;
+                matrix[3][1] = uv_rectangle.y;
+
+                return matrix;
+            }
+        };
+
+        explicit TextureAtlas(unsigned int page_size = 2048, unsigned int padding = 1)
+            : _page_size{page_size}, _padding{padding}
+        {}
+
+        TextureAtlas(const TextureAtlas &other) = delete;
+        TextureAtlas& operator=(const TextureAtlas &other) = delete;
+
+        virtual ~TextureAtlas() = default;
+
+        [[nodiscard]] unsigned int get_page_size() const
+        {
+            return _page_size;
+        }
+
+        [[nodiscard]] unsigned int get_padding() const
+        {
+            return _padding;
+        }
+
+        [[nodiscard]] const std::vector<std::shared_ptr<Texture>> &get_pages() const
+        {
+            return _pages;
+        }
+
+        [[nodiscard]] size_t get_region_count() const
+        {
+            return _regions.size();
+        }
+
+        [[nodiscard]] float get_occupancy() const
+        {
+            if (_packers.empty()) {
+                return 0.0f;
+            }
+
+            unsigned long long used_area{0};
+            for (const auto &packer : _packers) {
+                used_area += packer.get_used_area();
+            }
+
+            return static_cast<float>(used_area) /
+                   (static_cast<float>(_page_size) * static_cast<float>(_page_size) * static_cast<float>(_packers.size()));
+        }
+
+        [[nodiscard]] bool find(const std::string &key, Region &region) const
+        {
+            auto entry = _regions.find(key);
+            if (entry == std::end(_regions)) {
+                return false;
+            }
+            region = entry->second;
+
+            return true;
+        }
+
+        /* Copies an RGB or RGBA image into the first page with room for it, opening a new page when none has.
+           Adding a key that is already present returns the existing region. */
+        bool insert(
+            const std::string &key, const uint8_t *image_data,
+            unsigned int width, unsigned int height, unsigned int channels, Region &region
+        )
+        {
+            if (find(key, region)) {
+                return true;
+            }
+            if (!(channels == 3 || channels == 4)) {
+                return false;
+            }
+
+            unsigned int padded_width = width + 2 * _padding;
+            unsigned int padded_height = height + 2 * _padding;
+            unsigned int x, y;
+            size_t page = 0;
+            for (; page < _packers.size(); ++page) {
+                if (_packers[page].pack(padded_width, padded_height, x, y)) {
+                    break;
+                }
+            }
+            if (page == _packers.size()) {
+                SkylinePacker packer{_page_size, _page_size};
+                if (!packer.pack(padded_width, padded_height, x, y)) {
+                    return false;
+                }
+                _packers.push_back(packer);
+                _pages.push_back(_create_page(
+                    std::vector<uint8_t>(static_cast<size_t>(_page_size) * _page_size * 4, 0), _page_size, _page_size
+                ));
+            }
+
+            _copy_with_padding(*_pages[page], image_data, width, height, channels, x, y);
+
+            float page_size = static_cast<float>(_page_size);
+            region = Region{
+                static_cast<unsigned int>(page), x + _padding, y + _padding, width, height,
+                glm::vec4{
+                    static_cast<float>(x + _padding) / page_size,
+                    static_cast<float>(y + _padding) / page_size,
+                    static_cast<float>(x + _padding + width) / page_size,
+                    static_cast<float>(y + _padding + height) / page_size
+                }
+            };
+            _regions[key] = region;
+
+            return true;
+        }
+
+        /* Creates a texture that samples only the region. Every texture created for the same page shares its storage. */
+        [[nodiscard]] std::shared_ptr<Texture> create_texture(const Region &region) const
+        {
+            auto texture = std::make_shared<TextureView>(_pages.at(region.page));
+            texture->set_transformation_enabled(true);
+            texture->set_transformation_matrix(region.get_transformation_matrix());
+
+            return texture;
+        }
+
+    protected:
+        virtual std::shared_ptr<Texture> _create_page(ImageBuffer image_data, unsigned int width, unsigned int height) = 0;
+
+    private:
+        unsigned int _page_size;
+        unsigned int _padding;
+
+        std::vector<SkylinePacker> _packers;
+        std::vector<std::shared_ptr<Texture>> _pages;
+        std::map<std::string, Region> _regions;
+
+        /* The border pixels are repeated into the padding so that filtering never picks up a neighbour. */
+        void _copy_with_padding(
+            Texture &page, const uint8_t *image_data,
+            unsigned int width, unsigned int height, unsigned int channels,
+            unsigned int x, unsigned int y
+        )
+        {
+            uint8_t *page_data = page.get_image_data().data();
+            unsigned int padded_width = width + 2 * _padding;
+            unsigned int padded_height = height + 2 * _padding;
+            for (unsigned int row = 0; row < padded_height; ++row) {
+                unsigned int source_row = std::min(height - 1, row > _padding ? row - _padding : 0);
+                uint8_t *destination = page_data + ((static_cast<size_t>(y) + row) * _page_size + x) * 4;
+                for (unsigned int column = 0; column < padded_width; ++column) {
+                    unsigned int source_column = std::min(width - 1, column > _padding ? column - _padding : 0);
+                    const uint8_t *source = image_data + (static_cast<size_t>(source_row) * width + source_column) * channels;
+                    destination[column * 4 + 0] = source[0];
+                    destination[column * 4 + 1] = source[1];
+                    destination[column * 4 + 2] = source[2];
+                    destination[column * 4 + 3] = channels == 4 ? source[3] : 255;
+                }
+            }
+            page.add_dirty_rectangle(x, y, padded_width, padded_height);
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,327 @@
+#ifndef TEXTURE_LOADER_H
+#define TEXTURE_LOADER_H
+
+#include "textures/texture.h"
+#include "textures/mipmap_generator.h"
+#include "utilities/utilities.h"
+#include "utilities/compressed_image_utilities.h"
+#include "utilities/thread_pool.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <functional>
+#include <iostream>
+#include <utility>
+
+namespace asr
+{
+    class TextureLoader
+    {
+    public:
+        typedef std::function<void(const std::string &, const std::string &)> error_callback_type;
+
+        static const size_t DEFAULT_UPLOAD_BUDGET{16 * 1024 * 1024};
+
+        explicit TextureLoader(ThreadPool &thread_pool = ThreadPool::get_shared_instance())
+            : _thread_pool{thread_pool}, _completions{std::make_shared<CompletionQueue>()}
+        {}
+
+        TextureLoader(const TextureLoader &other) = delete;
+        TextureLoader& operator=(const TextureLoader &other) = delete;
+
+        virtual ~TextureLoader() = default;
+
+        /* Returns a placeholder texture right away. The image is decoded on the thread pool and
+           uploaded into the same texture object by a later call to `update`. KTX, KTX2 and DDS files
+           keep their block compression and mipmap levels, unless the GPU can not sample their format,
+           in which case they are decoded to RGBA on the thread pool as well. */
+        std::shared_ptr<Texture> load(const std::string &path)
+        {
+            std::shared_ptr<Texture> texture = _create_placeholder_texture();
+            texture->set_image_data_retained(_image_data_retained);
+            texture->set_source_path(path);
+            _enqueue(texture, path);
+
+            return texture;
+        }
+
+        /* Like `load`, but for an encoded image that is already in memory, e.g. one embedded in a model file.
+           Such textures can not be reloaded, so their image data should stay retained. `name` is used in errors. */
+        std::shared_ptr<Texture> load(const std::string &name, std::vector<uint8_t> encoded_image)
+        {
+            std::shared_ptr<Texture> texture = _create_placeholder_texture();
+            texture->set_image_data_retained(true);
+            _enqueue(texture, name, std::make_shared<std::vector<uint8_t>>(std::move(encoded_image)));
+
+            return texture;
+        }
+
+        /* Decodes the source file of a texture again, e.g. after it was evicted without a CPU copy. Like
+           with `load`, the pixels are uploaded by a later call to `update`. */
+        void reload(const std::shared_ptr<Texture> &texture)
+        {
+            if (!texture->get_source_path().empty()) {
+                _enqueue(texture, texture->get_source_path());
+            }
+        }
+
+        /* Must be called on the render thread, usually once per frame. Uploads decoded images until the
+           byte budget is spent, but always at least one, so a single large image can not stall loading. */
+        void update()
+        {
+            size_t uploaded_bytes{0};
+            bool uploaded_any{false};
+            for (;;) {
+                Completion completion;
+                {
+                    std::lock_guard<std::mutex> lock{_completions->mutex};
+                    if (_completions->queue.empty()) {
+                        break;
+                    }
+
+                    size_t size = _completions->queue.front().get_size();
+                    if (uploaded_any && uploaded_bytes + size > _upload_budget) {
+                        break;
+                    }
+                    completion = std::move(_completions->queue.front());
+                    _completions->queue.pop_front();
+                }
+                --_pending_count;
+
+                if (!completion.succeeded) {
+                    _report_error(completion.path, completion.error);
+                    continue;
+                }
+
+                auto texture = completion.texture.lock();
+                if (!texture) {
+                    continue;
+                }
+
+                uploaded_bytes += completion.get_size();
+                uploaded_any = true;
+
+                if (completion.compressed) {
+                    auto &image = completion.compressed_image;
+                    texture->set_compressed_image(
+                        image.compression, std::move(image.image_data), image.width, image.height, std::move(image.mipmap_levels)
+                    );
+                } else {
+                    auto &[image_data, width, height, channels] = completion.image;
+                    texture->set_image(std::move(image_data), width, height, channels);
+                    if (!completion.mipmap_levels.empty()) {
+                        texture->set_mipmap_levels(std::move(completion.mipmap_levels));
+                    }
+                }
+                texture->update(0);
+            }
+        }
+
+        [[nodiscard]] unsigned int get_pending_count() const
+        {
+            return _pending_count;
+        }
+
+        [[nodiscard]] bool is_idle() const
+        {
+            return _pending_count == 0;
+        }
+
+        [[nodiscard]] size_t get_upload_budget() const
+        {
+            return _upload_budget;
+        }
+
+        void set_upload_budget(size_t upload_budget)
+        {
+            _upload_budget = upload_budget;
+        }
+
+        [[nodiscard]] bool is_image_data_retained() const
+        {
+            return _image_data_retained;
+        }
+
+        void set_image_data_retained(bool image_data_retained)
+        {
+            _image_data_retained = image_data_retained;
+        }
+
+        [[nodiscard]] const std::shared_ptr<MipmapGenerator> &get_mipmap_generator() const
+        {
+            return _mipmap_generator;
+        }
+
+        /* When set, mipmaps of uncompressed images are built on the decoding thread and uploaded with the image. */
+        void set_mipmap_generator(const std::shared_ptr<MipmapGenerator> &mipmap_generator)
+        {
+            _mipmap_generator = mipmap_generator;
+        }
+
+        [[nodiscard]] const glm::vec4 &get_placeholder_color() const
+        {
+            return _placeholder_color;
+        }
+
+        void set_placeholder_color(const glm::vec4 &placeholder_color)
+        {
+            _placeholder_color = placeholder_color;
+        }
+
+        [[nodiscard]] const error_callback_type &get_on_error() const
+        {
+            return _on_error;
+        }
+
+        void set_on_error(const error_callback_type &on_error)
+        {
+            _on_error = on_error;
+        }
+
+    protected:
+        virtual std::shared_ptr<Texture> _create_texture(
+            ImageBuffer image_data, unsigned int width, unsigned int height, unsigned int channels
+        ) = 0;
+
+        /* Called on the render thread. */
+        virtual bool _is_compression_supported(Texture::Compression compression) = 0;
+
+    private:
+        struct Completion
+        {
+            std::weak_ptr<Texture> texture;
+            std::string path;
+            bool succeeded{false};
+            bool compressed{false};
+            file_utilities::image_data_type image;
+            std::vector<Texture::MipmapLevel> mipmap_levels;
+            compressed_image_utilities::CompressedImage compressed_image;
+            std::string error;
+
+            [[nodiscard]] size_t get_size() const
+            {
+                size_t size = compressed ? compressed_image.image_data.size() : std::get<0>(image).size();
+                for (const auto &level : compressed ? compressed_image.mipmap_levels : mipmap_levels) {
+                    size += level.image_data.size();
+                }
+
+                return size;
+            }
+        };
+
+        /* Shared with the decoding tasks so that the loader can be destroyed while they still run. */
+        struct CompletionQueue
+        {
+            std::mutex mutex;
+            std::deque<Completion> queue;
+        };
+
+        ThreadPool &_thread_pool;
+        std::shared_ptr<CompletionQueue> _completions;
+        unsigned int _pending_count{0};
+
+        size_t _upload_budget{DEFAULT_UPLOAD_BUDGET};
+        glm::vec4 _placeholder_color{1.0f, 0.0f, 1.0f, 1.0f};
+        bool _image_data_retained{true};
+        std::shared_ptr<MipmapGenerator> _mipmap_generator;
+
+        error_callback_type _on_error;
+
+        std::shared_ptr<Texture> _create_placeholder_texture()
+        {
+            return _create_texture(
+                std::vector<uint8_t>{
+                    static_cast<uint8_t>(_placeholder_color.r * 255.0f),
+                    static_cast<uint8_t>(_placeholder_color.g * 255.0f),
+                    static_cast<uint8_t>(_placeholder_color.b * 255.0f),
+                    static_cast<uint8_t>(_placeholder_color.a * 255.0f)
+                },
+                1, 1, 4
+            );
+        }
+
+        /* Decodes `encoded_image` instead of the file at `path` if it is given. */
+        void _enqueue(
+            const std::shared_ptr<Texture> &texture, const std::string &path,
+            std::shared_ptr<const std::vector<uint8_t>> encoded_image = nullptr
+        ) {
+            std::weak_ptr<Texture> weak_texture = texture;
+            std::shared_ptr<CompletionQueue> completions = _completions;
+            ++_pending_count;
+            std::shared_ptr<MipmapGenerator> mipmap_generator = _mipmap_generator;
+
+            /* GPU capabilities can only be queried here, so the decoding task gets the supported formats up front. */
+            std::vector<bool> supported_compressions(Texture::ASTC4x4 + 1, true);
+            if (!encoded_image && compressed_image_utilities::is_compressed_image_file(path)) {
+                for (size_t i = Texture::ETC1; i < supported_compressions.size(); ++i) {
+                    supported_compressions[i] = _is_compression_supported(static_cast<Texture::Compression>(i));
+                }
+            }
+
+            _thread_pool.submit([path, encoded_image, weak_texture, completions, mipmap_generator, supported_compressions]() {
+                Completion completion{weak_texture, path};
+                if (weak_texture.expired()) {
+                    completion.error = "The texture was released before loading: '" + path + "'";
+                } else if (encoded_image) {
+                    completion.succeeded = file_utilities::decode_image_data(
+                        encoded_image->data(), encoded_image->size(), path, completion.image, completion.error
+                    );
+                    if (completion.succeeded && mipmap_generator) {
+                        const auto &[image_data, width, height, channels] = completion.image;
+                        completion.mipmap_levels = mipmap_generator->generate(image_data.data(), width, height, channels);
+                    }
+                } else if (compressed_image_utilities::is_compressed_image_file(path)) {
+                    completion.compressed = true;
+                    completion.succeeded = compressed_image_utilities::decode_compressed_image_file(
+                        path, completion.compressed_image, completion.error
+                    );
+                    auto &compressed_image = completion.compressed_image;
+                    if (completion.succeeded && !supported_compressions[compressed_image.compression]) {
+                        completion.compressed = false;
+                        ImageBuffer pixels;
+                        completion.succeeded = compressed_image_utilities::decompress_image(
+                            compressed_image.compression, compressed_image.image_data, compressed_image.width, compressed_image.height,
+                            compressed_image.mipmap_levels, pixels, completion.mipmap_levels
+                        );
+                        if (!completion.succeeded) {
+                            completion.error = "The compressed texture format is not supported by the GPU and can not be decoded: '" + path + "'";
+                        } else {
+                            completion.image = std::make_tuple(std::move(pixels), compressed_image.width, compressed_image.height, 4u);
+                            if (completion.mipmap_levels.empty() && mipmap_generator) {
+                                const auto &[image_data, width, height, channels] = completion.image;
+                                completion.mipmap_levels = mipmap_generator->generate(path, image_data.data(), width, height, channels);
+                            }
+                        }
+                        compressed_image = compressed_image_utilities::CompressedImage{};
+                    }
+                } else {
+                    completion.succeeded = file_utilities::decode_image_file(path, completion.image, completion.error);
+                    if (completion.succeeded && mipmap_generator) {
+                        const auto &[image_data, width, height, channels] = completion.image;
+                        completion.mipmap_levels = mipmap_generator->generate(path, image_data.data(), width, height, channels);
+                    }
+                }
+
+                std::lock_guard<std::mutex> lock{completions->mutex};
+                completions->queue.push_back(std::move(completion));
+            });
+        }
+
+        void _report_error(const std::string &path, const std::string &error)
+        {
+            if (_on_error) {
+                _on_error(path, error);
+            } else {
+                std::cerr << error << std::endl;
+            }
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef TEXTURE_VIEW_H
+#define TEXTURE_VIEW_H
+
+#include "textures/texture.h"
+
+#include <memory>
+
+namespace asr
+{
+    /* Shares the storage of another texture while keeping its own mode and transformation matrix, so
+       several materials can sample different parts of one texture without rebinding. Sampling parameters
+       and image data belong to the viewed texture. */
+    class TextureView final : public Texture
+    {
+    public:
+        explicit TextureView(const std::shared_ptr<Texture> &texture)
+            : Texture(ImageBuffer{}, texture->get_width(), texture->get_height(), texture->get_channels()),
+              _texture{texture}
+        {
+            _mode = texture->get_mode();
+            _requires_data_update = false;
+            _requires_params_update = false;
+        }
+
+        [[nodiscard]] const std::shared_ptr<Texture> &get_texture() const
+        {
+            return _texture;
+        }
+
+        /* The storage belongs to the viewed texture, which is budgeted on its own. */
+        [[nodiscard]] size_t get_gpu_size() const final
+        {
+            return 0;
+        }
+
+        void evict() final
+        {}
+
+        void update(unsigned int sampler) final
+        {
+            _texture->update(sampler);
+        }
+
+        void use(unsigned int sampler) final
+        {
+            _texture->use(sampler);
+        }
+
+    private:
+        std::shared_ptr<Texture> _texture;
+    };
+}
+
+#endif
@@ -0,0 +1,695 @@
+#ifndef COMPRESSED_IMAGE_UTILITIES_H
+#define COMPRESSED_IMAGE_UTILITIES_H
+
+#include "textures/texture.h"
+#include "utilities/image_buffer.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <cctype>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <utility>
+
+namespace asr::compressed_image_utilities
+{
+    struct CompressedImage
+    {
+        Texture::Compression compression{Texture::Uncompressed};
+        unsigned int width{0};
+        unsigned int height{0};
+        ImageBuffer image_data;
+        std::vector<Texture::MipmapLevel> mipmap_levels;
+    };
+
+    static unsigned int get_block_size(Texture::Compression compression)
+    {
+        switch (compression) {
+            case Texture::ETC1:
+            case Texture::ETC2RGB:
+            case Texture::DXT1:
+            case Texture::DXT1A:
+                return 8;
+            case Texture::ETC2RGBA:
+            case Texture::DXT3:
+            case Texture::DXT5:
+            case Texture::ASTC4x4:
+                return 16;
+            case Texture::Uncompressed:
+                break;
+        }
+
+        return 0;
+    }
+
+    static size_t get_compressed_size(Texture::Compression compression, unsigned int width, unsigned int height)
+    {
+        size_t horizontal_blocks = (static_cast<size_t>(width) + 3) / 4;
+        size_t vertical_blocks = (static_cast<size_t>(height) + 3) / 4;
+
+        return horizontal_blocks * vertical_blocks * get_block_size(compression);
+    }
+
+    static bool is_compressed_image_file(const std::string &path)
+    {
+        std::string extension = path.substr(std::min(path.size(), path.find_last_of('.')));
+        std::transform(std::begin(extension), std::end(extension), std::begin(extension), [](unsigned char c) {
+            return static_cast<char>(std::tolower(c));
+        });
+
+        return extension == ".ktx" || extension == ".ktx2" || extension == ".dds";
+    }
+
+    namespace detail
+    {
+        static uint32_t read_uint32(const uint8_t *data)
+        {
+            return static_cast<uint32_t>(data[0]) | static_cast<uint32_t>(data[1]) << 8 |
+                   static_cast<uint32_t>(data[2]) << 16 | static_cast<uint32_t>(data[3]) << 24;
+        }
+
+        static uint64_t read_uint64(const uint8_t *data)
+        {
+            return static_cast<uint64_t>(read_uint32(data)) | static_cast<uint64_t>(read_uint32(data + 4)) << 32;
+        }
+
+        static bool read_bytes(std::istream &stream, uint64_t offset, size_t size, std::vector<uint8_t> &bytes)
+        {
+            stream.seekg(0, std::ios::end);
+            auto stream_size = static_cast<uint64_t>(stream.tellg());
+            if (offset > stream_size || size > stream_size - offset) {
+                return false;
+            }
+
+            bytes.resize(size);
+            stream.seekg(static_cast<std::streamoff>(offset));
+
+            return static_cast<bool>(stream.read(reinterpret_cast<char *>(bytes.data()), static_cast<std::streamsize>(size)));
+        }
+
+        static bool add_level(CompressedImage &image, unsigned int level, std::vector<uint8_t> data, std::string &error)
+        {
+            unsigned int width = std::max(1u, image.width >> level);
+            unsigned int height = std::max(1u, image.height >> level);
+            if (data.size() < get_compressed_size(image.compression, width, height)) {
+                error = "The mipmap level " + std::to_string(level) + " is truncated";
+                return false;
+            }
+
+            if (level == 0) {
+                image.image_data = std::move(data);
+            } else {
+                image.mipmap_levels.push_back(Texture::MipmapLevel{std::move(data), width, height});
+            }
+
+            return true;
+        }
+
+        static Texture::Compression convert_gl_format_to_compression(uint32_t format)
+        {
+            switch (format) {
+                case 0x8D64: return Texture::ETC1;      /* GL_ETC1_RGB8_OES */
+                case 0x9274:                            /* GL_COMPRESSED_RGB8_ETC2 */
+                case 0x9275: return Texture::ETC2RGB;   /* GL_COMPRESSED_SRGB8_ETC2 */
+                case 0x9278:                            /* GL_COMPRESSED_RGBA8_ETC2_EAC */
+                case 0x9279: return Texture::ETC2RGBA;  /* GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC */
+                case 0x83F0: return Texture::DXT1;      /* GL_COMPRESSED_RGB_S3TC_DXT1_EXT */
+                case 0x83F1: return Texture::DXT1A;     /* GL_COMPRESSED_RGBA_S3TC_DXT1_EXT */
+                case 0x83F2: return Texture::DXT3;      /* GL_COMPRESSED_RGBA_S3TC_DXT3_EXT */
+                case 0x83F3: return Texture::DXT5;      /* GL_COMPRESSED_RGBA_S3TC_DXT5_EXT */
+                case 0x93B0:                            /* GL_COMPRESSED_RGBA_ASTC_4x4_KHR */
+                case 0x93D0: return Texture::ASTC4x4;   /* GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR */
+                default: return Texture::Uncompressed;
+            }
+        }
+
+        static Texture::Compression convert_vk_format_to_compression(uint32_t format)
+        {
+            switch (format) {
+                case 131: case 132: return Texture::DXT1;      /* VK_FORMAT_BC1_RGB_* */
+                case 133: case 134: return Texture::DXT1A;     /* VK_FORMAT_BC1_RGBA_* */
+                case 135: case 136: return Texture::DXT3;      /* VK_FORMAT_BC2_* */
+                case 137: case 138: return Texture::DXT5;      /* VK_FORMAT_BC3_* */
+                case 147: case 148: return Texture::ETC2RGB;   /* VK_FORMAT_ETC2_R8G8B8_* */
+                case 151: case 152: return Texture::ETC2RGBA;  /* VK_FORMAT_ETC2_R8G8B8A8_* */
+                case 157: case 158: return Texture::ASTC4x4;   /* VK_FORMAT_ASTC_4x4_* */
+                default: return Texture::Uncompressed;
+            }
+        }
+
+        static bool read_ktx(std::istream &stream, CompressedImage &image, std::string &error)
+        {
+            std::vector<uint8_t> header;
+            if (!read_bytes(stream, 0, 64, header)) {
+                error = "The KTX header is truncated";
+                return false;
+            }
+            if (read_uint32(&header[12]) != 0x04030201) {
+                error = "Big-endian KTX files are not supported";
+                return false;
+            }
+
+            uint32_t gl_type = read_uint32(&header[16]);
+            uint32_t gl_internal_format = read_uint32(&header[28]);
+            image.width = read_uint32(&header[36]);
+            image.height = std::max(1u, read_uint32(&header[40]));
+            uint32_t depth = read_uint32(&header[44]);
+            uint32_t array_elements = read_uint32(&header[48]);
+            uint32_t faces = read_uint32(&header[52]);
+            uint32_t levels = std::max(1u, read_uint32(&header[56]));
+            uint32_t key_value_data_size = read_uint32(&header[60]);
+
+            image.compression = convert_gl_format_to_compression(gl_internal_format);
+            if (gl_type != 0 || image.compression == Texture::Uncompressed) {
+                error = "Unsupported KTX internal format " + std::to_string(gl_internal_format);
+                return false;
+            }
+            if (depth > 1 || array_elements > 0 || faces != 1) {
+                error = "Only 2D KTX textures are supported";
+                return false;
+            }
+
+            uint64_t offset = 64 + static_cast<uint64_t>(key_value_data_size);
+            for (unsigned int level = 0; level < levels; ++level) {
+                std::vector<uint8_t> size_data;
+                if (!read_bytes(stream, offset, 4, size_data)) {
+                    error = "The KTX mipmap level " + std::to_string(level) + " is truncated";
+                    return false;
+                }
+                uint32_t size = read_uint32(size_data.data());
+
+                std::vector<uint8_t> data;
+                if (!read_bytes(stream, offset + 4, size, data) || !add_level(image, level, std::move(data), error)) {
+                    if (error.empty()) {
+                        error = "The KTX mipmap level " + std::to_string(level) + " is truncated";
+                    }
+                    return false;
+                }
+                offset += 4 + ((static_cast<uint64_t>(size) + 3) & ~static_cast<uint64_t>(3));
+            }
+
+            return true;
+        }
+
+        static bool read_ktx2(std::istream &stream, CompressedImage &image, std::string &error)
+        {
+            std::vector<uint8_t> header;
+            if (!read_bytes(stream, 0, 80, header)) {
+                error = "The KTX2 header is truncated";
+                return false;
+            }
+
+            uint32_t vk_format = read_uint32(&header[12]);
+            image.width = read_uint32(&header[20]);
+            image.height = std::max(1u, read_uint32(&header[24]));
+            uint32_t depth = read_uint32(&header[28]);
+            uint32_t layers = read_uint32(&header[32]);
+            uint32_t faces = read_uint32(&header[36]);
+            uint32_t levels = std::max(1u, read_uint32(&header[40]));
+            uint32_t supercompression_scheme = read_uint32(&header[44]);
+
+            if (supercompression_scheme != 0) {
+                error = "Supercompressed KTX2 files are not supported";
+                return false;
+            }
+            image.compression = convert_vk_format_to_compression(vk_format);
+            if (image.compression == Texture::Uncompressed) {
+                error = "Unsupported KTX2 format " + std::to_string(vk_format);
+                return false;
+            }
+            if (depth > 1 || layers > 1 || faces != 1) {
+                error = "Only 2D KTX2 textures are supported";
+                return false;
+            }
+
+            std::vector<uint8_t> level_index;
+            if (!read_bytes(stream, 80, static_cast<size_t>(levels) * 24, level_index)) {
+                error = "The KTX2 level index is truncated";
+                return false;
+            }
+            for (unsigned int level = 0; level < levels; ++level) {
+                uint64_t offset = read_uint64(&level_index[level * 24]);
+                uint64_t size = read_uint64(&level_index[level * 24 + 8]);
+
+                std::vector<uint8_t> data;
+                if (!read_bytes(stream, offset, static_cast<size_t>(size), data) || !add_level(image, level, std::move(data), error)) {
+                    if (error.empty()) {
+                        error = "The KTX2 mipmap level " + std::to_string(level) + " is truncated";
+                    }
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        static bool read_dds(std::istream &stream, CompressedImage &image, std::string &error)
+        {
+            std::vector<uint8_t> header;
+            if (!read_bytes(stream, 0, 128, header)) {
+                error = "The DDS header is truncated";
+                return false;
+            }
+
+            image.height = std::max(1u, read_uint32(&header[12]));
+            image.width = read_uint32(&header[16]);
+            uint32_t levels = std::max(1u, read_uint32(&header[28]));
+            uint32_t pixel_format_flags = read_uint32(&header[80]);
+            uint32_t four_cc = read_uint32(&header[84]);
+            uint32_t caps2 = read_uint32(&header[112]);
+
+            const uint32_t DDPF_ALPHAPIXELS{0x1};
+            const uint32_t DDSCAPS2_CUBEMAP{0x200};
+            const uint32_t DDSCAPS2_VOLUME{0x200000};
+            if (caps2 & (DDSCAPS2_CUBEMAP | DDSCAPS2_VOLUME)) {
+                error = "Only 2D DDS textures are supported";
+                return false;
+            }
+
+            uint64_t offset = 128;
+            if (four_cc == read_uint32(reinterpret_cast<const uint8_t *>("DXT1"))) {
+                image.compression = pixel_format_flags & DDPF_ALPHAPIXELS ? Texture::DXT1A : Texture::DXT1;
+            } else if (four_cc == read_uint32(reinterpret_cast<const uint8_t *>("DXT3"))) {
+                image.compression = Texture::DXT3;
+            } else if (four_cc == read_uint32(reinterpret_cast<const uint8_t *>("DXT5"))) {
+                image.compression = Texture::DXT5;
+            } else if (four_cc == read_uint32(reinterpret_cast<const uint8_t *>("DX10"))) {
+                std::vector<uint8_t> extended_header;
+                if (!read_bytes(stream, 128, 20, extended_header)) {
+                    error = "The DDS DX10 header is truncated";
+                    return false;
+                }
+                offset += 20;
+
+                uint32_t dxgi_format = read_uint32(&extended_header[0]);
+                uint32_t array_size = read_uint32(&extended_header[12]);
+                switch (dxgi_format) {
+                    case 71: case 72: image.compression = Texture::DXT1; break;   /* DXGI_FORMAT_BC1_* */
+                    case 74: case 75: image.compression = Texture::DXT3; break;   /* DXGI_FORMAT_BC2_* */
+                    case 77: case 78: image.compression = Texture::DXT5; break;   /* DXGI_FORMAT_BC3_* */
+                    default:
+                        error = "Unsupported DXGI format " + std::to_string(dxgi_format);
+                        return false;
+                }
+                if (array_size > 1) {
+                    error = "DDS texture arrays are not supported";
+                    return false;
+                }
+            } else {
+                error = "Unsupported DDS pixel format";
+                return false;
+            }
+
+            for (unsigned int level = 0; level < levels; ++level) {
+                size_t size = get_compressed_size(
+                    image.compression, std::max(1u, image.width >> level), std::max(1u, image.height >> level)
+                );
+
+                std::vector<uint8_t> data;
+                if (!read_bytes(stream, offset, size, data) || !add_level(image, level, std::move(data), error)) {
+                    if (error.empty()) {
+                        error = "The DDS mipmap level " + std::to_string(level) + " is truncated";
+                    }
+                    return false;
+                }
+                offset += size;
+            }
+
+            return true;
+        }
+
+        static uint8_t clamp_to_byte(int value)
+        {
+            return static_cast<uint8_t>(std::clamp(value, 0, 255));
+        }
+
+        static void decode_rgb565(uint16_t color, int rgb[3])
+        {
+            int r = (color >> 11) & 0x1F, g = (color >> 5) & 0x3F, b = color & 0x1F;
+            rgb[0] = (r << 3) | (r >> 2);
+            rgb[1] = (g << 2) | (g >> 4);
+            rgb[2] = (b << 3) | (b >> 2);
+        }
+
+        /* Writes a 4x4 block of RGBA texels in row-major order. */
+        static void decompress_dxt_color_block(const uint8_t *block, bool three_color_mode_allowed, uint8_t texels[16][4])
+        {
+            uint16_t color0 = static_cast<uint16_t>(block[0] | block[1] << 8);
+            uint16_t color1 = static_cast<uint16_t>(block[2] | block[3] << 8);
+
+            int palette[4][4];
+            decode_rgb565(color0, palette[0]);
+            decode_rgb565(color1, palette[1]);
+            palette[0][3] = palette[1][3] = 255;
+            if (color0 > color1 || !three_color_mode_allowed) {
+                for (int c = 0; c < 3; ++c) {
+                    palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+                    palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+                }
+                palette[2][3] = palette[3][3] = 255;
+            } else {
+                for (int c = 0; c < 3; ++c) {
+                    palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+                    palette[3][c] = 0;
+                }
+                palette[2][3] = 255;
+                palette[3][3] = 0;
+            }
+
+            uint32_t indices = read_uint32(block + 4);
+            for (int i = 0; i < 16; ++i) {
+                const int *color = palette[(indices >> (2 * i)) & 0x3];
+                for (int c = 0; c < 4; ++c) {
+                    texels[i][c] = static_cast<uint8_t>(color[c]);
+                }
+            }
+        }
+
+        static void decompress_dxt5_alpha_block(const uint8_t *block, uint8_t texels[16][4])
+        {
+            int palette[8];
+            palette[0] = block[0];
+            palette[1] = block[1];
+            if (palette[0] > palette[1]) {
+                for (int i = 1; i < 7; ++i) {
+                    palette[i + 1] = ((7 - i) * palette[0] + i * palette[1]) / 7;
+                }
+            } else {
+                for (int i = 1; i < 5; ++i) {
+                    palette[i + 1] = ((5 - i) * palette[0] + i * palette[1]) / 5;
+                }
+                palette[6] = 0;
+                palette[7] = 255;
+            }
+
+            uint64_t indices = read_uint64(block) >> 16;
+            for (int i = 0; i < 16; ++i) {
+                texels[i][3] = static_cast<uint8_t>(palette[(indices >> (3 * i)) & 0x7]);
+            }
+        }
+
+        /* Handles both ETC1 and ETC2 RGB blocks, ETC1 being the ETC2 subset without the T, H and planar modes. */
+        static void decompress_etc2_color_block(const uint8_t *block, uint8_t texels[16][4])
+        {
+            static const int MODIFIERS[8][2]{{2, 8}, {5, 17}, {9, 29}, {13, 42}, {18, 60}, {24, 80}, {33, 106}, {47, 183}};
+            static const int DISTANCES[8]{3, 6, 11, 16, 23, 32, 41, 64};
+
+            uint64_t bits{0};
+            for (int i = 0; i < 8; ++i) {
+                bits = bits << 8 | block[i];
+            }
+            auto field = [bits](int high, int low) {
+                return static_cast<int>((bits >> low) & ((uint64_t{1} << (high - low + 1)) - 1));
+            };
+            auto extend = [](int value, int bit_count) {
+                return (value << (8 - bit_count)) | (value >> (2 * bit_count - 8));
+            };
+            auto pixel_index = [bits](int x, int y) {
+                int i = x * 4 + y;
+                return static_cast<int>(((bits >> (16 + i)) & 0x1) << 1 | ((bits >> i) & 0x1));
+            };
+            auto write = [&texels](int x, int y, int r, int g, int b) {
+                uint8_t *texel = texels[y * 4 + x];
+                texel[0] = clamp_to_byte(r);
+                texel[1] = clamp_to_byte(g);
+                texel[2] = clamp_to_byte(b);
+                texel[3] = 255;
+            };
+
+            int base[2][3];
+            bool differential = field(33, 33) != 0;
+            if (differential) {
+                int r = field(63, 59) + ((field(58, 56) ^ 4) - 4);
+                int g = field(55, 51) + ((field(50, 48) ^ 4) - 4);
+                int b = field(47, 43) + ((field(42, 40) ^ 4) - 4);
+
+                if (r < 0 || r > 31 || g < 0 || g > 31 || b < 0 || b > 31) {
+                    int paint[4][3];
+                    if (r < 0 || r > 31) {
+                        int first[3]{extend(field(60, 59) << 2 | field(57, 56), 4), extend(field(55, 52), 4), extend(field(51, 48), 4)};
+                        int second[3]{extend(field(47, 44), 4), extend(field(43, 40), 4), extend(field(39, 36), 4)};
+                        int distance = DISTANCES[field(35, 34) << 1 | field(32, 32)];
+                        for (int c = 0; c < 3; ++c) {
+                            paint[0][c] = first[c];
+                            paint[1][c] = second[c] + distance;
+                            paint[2][c] = second[c];
+                            paint[3][c] = second[c] - distance;
+                        }
+                    } else if (g < 0 || g > 31) {
+                        int first[3]{
+                            extend(field(62, 59), 4),
+                            extend(field(58, 56) << 1 | field(52, 52), 4),
+                            extend(field(51, 51) << 3 | field(49, 47), 4)
+                        };
+                        int second[3]{extend(field(46, 43), 4), extend(field(42, 39), 4), extend(field(38, 35), 4)};
+                        int ordering = (first[0] << 16 | first[1] << 8 | first[2]) >= (second[0] << 16 | second[1] << 8 | second[2]) ? 1 : 0;
+                        int distance = DISTANCES[field(34, 34) << 2 | field(32, 32) << 1 | ordering];
+                        for (int c = 0; c < 3; ++c) {
+                            paint[0][c] = first[c] + distance;
+                            paint[1][c] = first[c] - distance;
+                            paint[2][c] = second[c] + distance;
+                            paint[3][c] = second[c] - distance;
+                        }
+                    } else {
+                        int origin[3]{
+                            extend(field(62, 57), 6),
+                            extend(field(56, 56) << 6 | field(54, 49), 7),
+                            extend(field(48, 48) << 5 | field(44, 43) << 3 | field(41, 39), 6)
+                        };
+                        int horizontal[3]{
+                            extend(field(38, 34) << 1 | field(32, 32), 6), extend(field(31, 25), 7), extend(field(24, 19), 6)
+                        };
+                        int vertical[3]{extend(field(18, 13), 6), extend(field(12, 6), 7), extend(field(5, 0), 6)};
+                        for (int y = 0; y < 4; ++y) {
+                            for (int x = 0; x < 4; ++x) {
+                                int color[3];
+                                for (int c = 0; c < 3; ++c) {
+                                    color[c] = (x * (horizontal[c] - origin[c]) + y * (vertical[c] - origin[c]) + 4 * origin[c] + 2) >> 2;
+                                }
+                                write(x, y, color[0], color[1], color[2]);
+                            }
+                        }
+                        return;
+                    }
+
+                    for (int y = 0; y < 4; ++y) {
+                        for (int x = 0; x < 4; ++x) {
+                            const int *color = paint[pixel_index(x, y)];
+                            write(x, y, color[0], color[1], color[2]);
+                        }
+                    }
+                    return;
+                }
+
+                base[0][0] = extend(field(63, 59), 5);
+                base[0][1] = extend(field(55, 51), 5);
+                base[0][2] = extend(field(47, 43), 5);
+                base[1][0] = extend(r, 5);
+                base[1][1] = extend(g, 5);
+                base[1][2] = extend(b, 5);
+            } else {
+                base[0][0] = extend(field(63, 60), 4);
+                base[0][1] = extend(field(55, 52), 4);
+                base[0][2] = extend(field(47, 44), 4);
+                base[1][0] = extend(field(59, 56), 4);
+                base[1][1] = extend(field(51, 48), 4);
+                base[1][2] = extend(field(43, 40), 4);
+            }
+
+            int tables[2]{field(39, 37), field(36, 34)};
+            bool flipped = field(32, 32) != 0;
+            for (int y = 0; y < 4; ++y) {
+                for (int x = 0; x < 4; ++x) {
+                    int subblock = flipped ? (y >= 2 ? 1 : 0) : (x >= 2 ? 1 : 0);
+                    int index = pixel_index(x, y);
+                    int modifier = MODIFIERS[tables[subblock]][index & 0x1];
+                    if (index & 0x2) {
+                        modifier = -modifier;
+                    }
+                    write(x, y, base[subblock][0] + modifier, base[subblock][1] + modifier, base[subblock][2] + modifier);
+                }
+            }
+        }
+
+        static void decompress_eac_alpha_block(const uint8_t *block, uint8_t texels[16][4])
+        {
+            static const int MODIFIERS[16][8]{
+                {-3, -6, -9, -15, 2, 5, 8, 14}, {-3, -7, -10, -13, 2, 6, 9, 12},
+                {-2, -5, -8, -13, 1, 4, 7, 12}, {-2, -4, -6, -13, 1, 3, 5, 12},
+                {-3, -6, -8, -12, 2, 5, 7, 11}, {-3, -7, -9, -11, 2, 6, 8, 10},
+                {-4, -7, -8, -11, 3, 6, 7, 10}, {-3, -5, -8, -11, 2, 4, 7, 10},
+                {-2, -6, -8, -10, 1, 5, 7, 9}, {-2, -5, -8, -10, 1, 4, 7, 9},
+                {-2, -4, -8, -10, 1, 3, 7, 9}, {-2, -5, -7, -10, 1, 4, 6, 9},
+                {-3, -4, -7, -10, 2, 3, 6, 9}, {-1, -2, -3, -10, 0, 1, 2, 9},
+                {-4, -6, -8, -9, 3, 5, 7, 8}, {-3, -5, -7, -9, 2, 4, 6, 8}
+            };
+
+            int base = block[0];
+            int multiplier = block[1] >> 4;
+            const int *modifiers = MODIFIERS[block[1] & 0xF];
+
+            uint64_t indices{0};
+            for (int i = 2; i < 8; ++i) {
+                indices = indices << 8 | block[i];
+            }
+            for (int x = 0; x < 4; ++x) {
+                for (int y = 0; y < 4; ++y) {
+                    int i = x * 4 + y;
+                    int index = static_cast<int>((indices >> (45 - 3 * i)) & 0x7);
+                    texels[y * 4 + x][3] = clamp_to_byte(base + modifiers[index] * multiplier);
+                }
+            }
+        }
+
+        static bool decompress_block(Texture::Compression compression, const uint8_t *block, uint8_t texels[16][4])
+        {
+            switch (compression) {
+                case Texture::DXT1:
+                    decompress_dxt_color_block(block, true, texels);
+                    for (int i = 0; i < 16; ++i) {
+                        texels[i][3] = 255;
+                    }
+                    return true;
+                case Texture::DXT1A:
+                    decompress_dxt_color_block(block, true, texels);
+                    return true;
+                case Texture::DXT3:
+                    decompress_dxt_color_block(block + 8, false, texels);
+                    for (int i = 0; i < 16; ++i) {
+                        int alpha = (block[i / 2] >> (4 * (i % 2))) & 0xF;
+                        texels[i][3] = static_cast<uint8_t>(alpha << 4 | alpha);
+                    }
+                    return true;
+                case Texture::DXT5:
+                    decompress_dxt_color_block(block + 8, false, texels);
+                    decompress_dxt5_alpha_block(block, texels);
+                    return true;
+                case Texture::ETC1:
+                case Texture::ETC2RGB:
+                    decompress_etc2_color_block(block, texels);
+                    return true;
+                case Texture::ETC2RGBA:
+                    decompress_etc2_color_block(block + 8, texels);
+                    decompress_eac_alpha_block(block, texels);
+                    return true;
+                case Texture::ASTC4x4:
+                case Texture::Uncompressed:
+                    break;
+            }
+
+            return false;
+        }
+    }
+
+    /* Decodes a compressed image into tightly packed RGBA pixels. It is the fallback for GPUs without
+       support for the format. ASTC is not handled. */
+    static bool decompress_image(
+        Texture::Compression compression, const uint8_t *data, size_t size,
+        unsigned int width, unsigned int height, std::vector<uint8_t> &pixels
+    )
+    {
+        unsigned int block_size = get_block_size(compression);
+        if (compression == Texture::ASTC4x4 || block_size == 0 || size < get_compressed_size(compression, width, height)) {
+            return false;
+        }
+
+        pixels.resize(static_cast<size_t>(width) * height * 4);
+        unsigned int horizontal_blocks = (width + 3) / 4;
+        for (unsigned int block_y = 0; block_y < (height + 3) / 4; ++block_y) {
+            for (unsigned int block_x = 0; block_x < horizontal_blocks; ++block_x) {
+                uint8_t texels[16][4];
+                const uint8_t *block = data + (static_cast<size_t>(block_y) * horizontal_blocks + block_x) * block_size;
+                detail::decompress_block(compression, block, texels);
+
+                for (unsigned int y = 0; y < 4 && block_y * 4 + y < height; ++y) {
+                    for (unsigned int x = 0; x < 4 && block_x * 4 + x < width; ++x) {
+                        uint8_t *pixel = &pixels[((static_cast<size_t>(block_y) * 4 + y) * width + block_x * 4 + x) * 4];
+                        std::copy(texels[y * 4 + x], texels[y * 4 + x] + 4, pixel);
+                    }
+                }
+            }
+        }
+
+        return true;
+    }
+
+    /* Decodes a compressed image and its mipmap levels into RGBA pixels and levels. */
+    static bool decompress_image(
+        Texture::Compression compression, const ImageBuffer &image_data, unsigned int width, unsigned int height,
+        const std::vector<Texture::MipmapLevel> &mipmap_levels,
+        ImageBuffer &pixels, std::vector<Texture::MipmapLevel> &pixel_mipmap_levels
+    )
+    {
+        std::vector<uint8_t> level_pixels;
+        if (!decompress_image(compression, image_data.data(), image_data.size(), width, height, level_pixels)) {
+            return false;
+        }
+        pixels = std::move(level_pixels);
+
+        pixel_mipmap_levels.clear();
+        for (const auto &level : mipmap_levels) {
+            if (!decompress_image(compression, level.image_data.data(), level.image_data.size(), level.width, level.height, level_pixels)) {
+                return false;
+            }
+            pixel_mipmap_levels.push_back(Texture::MipmapLevel{std::move(level_pixels), level.width, level.height});
+            level_pixels = std::vector<uint8_t>{};
+        }
+
+        return true;
+    }
+
+    static bool decode_compressed_image_file(const std::string &path, CompressedImage &image, std::string &error)
+    {
+        static const uint8_t KTX_IDENTIFIER[12]{0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n'};
+        static const uint8_t KTX2_IDENTIFIER[12]{0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+
+        std::ifstream file_stream{path, std::ios::binary};
+        if (!file_stream.is_open()) {
+            error = "Failed to open the file: '" + path + "'";
+            return false;
+        }
+
+        std::vector<uint8_t> identifier;
+        if (!detail::read_bytes(file_stream, 0, 12, identifier)) {
+            error = "Invalid compressed image file: '" + path + "'";
+            return false;
+        }
+
+        image = CompressedImage{};
+        error.clear();
+        bool succeeded;
+        if (std::equal(std::begin(KTX_IDENTIFIER), std::end(KTX_IDENTIFIER), identifier.data())) {
+            succeeded = detail::read_ktx(file_stream, image, error);
+        } else if (std::equal(std::begin(KTX2_IDENTIFIER), std::end(KTX2_IDENTIFIER), identifier.data())) {
+            succeeded = detail::read_ktx2(file_stream, image, error);
+        } else if (std::equal(identifier.data(), identifier.data() + 4, reinterpret_cast<const uint8_t *>("DDS "))) {
+            succeeded = detail::read_dds(file_stream, image, error);
+        } else {
+            error = "Unknown compressed image container";
+            succeeded = false;
+        }
+
+        if (!succeeded) {
+            error += ": '" + path + "'";
+        }
+
+        return succeeded;
+    }
+
+    static CompressedImage read_compressed_image_file(const std::string &path)
+    {
+        CompressedImage image;
+        std::string error;
+        if (!decode_compressed_image_file(path, image, error)) {
+            std::cerr << error << std::endl;
+            std::exit(-1);
+        }
+
+        return image;
+    }
+}
+
+#endif
@@ -0,0 +1,155 @@
+#ifndef FILE_WATCHER_H
+#define FILE_WATCHER_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <chrono>
+#include <filesystem>
+#include <system_error>
+#include <algorithm>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <climits>
+#endif
+
+namespace asr
+{
+    class FileWatcher
+    {
+    public:
+        explicit FileWatcher(std::chrono::milliseconds polling_interval = std::chrono::milliseconds{500})
+            : _polling_interval{polling_interval}
+        {
+#ifdef __linux__
+            _inotify_descriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+        }
+
+        FileWatcher(const FileWatcher &other) = delete;
+        FileWatcher& operator=(const FileWatcher &other) = delete;
+
+        ~FileWatcher()
+        {
+#ifdef __linux__
+            if (_inotify_descriptor != -1) {
+                close(_inotify_descriptor);
+            }
+#endif
+        }
+
+        [[nodiscard]] bool is_using_notifications() const
+        {
+#ifdef __linux__
+            return _inotify_descriptor != -1;
+#else
+            return false;
+#endif
+        }
+
+        void add(const std::string &path)
+        {
+            if (path.empty() || _modification_times.count(path) > 0) {
+                return;
+            }
+            _modification_times[path] = _get_modification_time(path);
+
+#ifdef __linux__
+            if (_inotify_descriptor != -1) {
+                /* Editors often save through a rename, so the parent directory is watched instead of the file. */
+                std::filesystem::path file_path{path};
+                std::string directory = file_path.has_parent_path() ? file_path.parent_path().string() : ".";
+                int watch_descriptor = inotify_add_watch(
+                    _inotify_descriptor, directory.c_str(),
+                    IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_MODIFY
+                );
+                if (watch_descriptor != -1) {
+                    _watched_directories[watch_descriptor] = directory;
+                }
+            }
+#endif
+        }
+
+        void remove(const std::string &path)
+        {
+            _modification_times.erase(path);
+        }
+
+        std::vector<std::string> poll()
+        {
+            std::set<std::string> candidates;
+
+#ifdef __linux__
+            if (_inotify_descriptor != -1) {
+                alignas(struct inotify_event) char buffer[sizeof(struct inotify_event) + NAME_MAX + 1];
+                ssize_t length;
+                while ((length = read(_inotify_descriptor, buffer, sizeof(buffer))) > 0) {
+                    for (char *pointer = buffer; pointer < buffer + length;) {
+                        const auto *event = reinterpret_cast<const struct inotify_event *>(pointer);
+                        pointer += sizeof(struct inotify_event) + event->len;
+
+                        auto directory = _watched_directories.find(event->wd);
+                        if (directory == _watched_directories.end() || event->len == 0) {
+                            continue;
+                        }
+                        std::filesystem::path changed_path = std::filesystem::path{directory->second} / event->name;
+                        for (const auto &entry : _modification_times) {
+                            if (std::filesystem::path{entry.first}.lexically_normal() == changed_path.lexically_normal()) {
+                                candidates.insert(entry.first);
+                            }
+                        }
+                    }
+                }
+            }
+#endif
+
+            if (!is_using_notifications()) {
+                auto now = std::chrono::steady_clock::now();
+                if (now - _last_poll_time < _polling_interval) {
+                    return {};
+                }
+                _last_poll_time = now;
+
+                for (const auto &entry : _modification_times) {
+                    candidates.insert(entry.first);
+                }
+            }
+
+            std::vector<std::string> changed_paths;
+            for (const auto &path : candidates) {
+                auto modification_time = _get_modification_time(path);
+                if (modification_time != _modification_times[path]) {
+                    _modification_times[path] = modification_time;
+                    changed_paths.push_back(path);
+                }
+            }
+
+            return changed_paths;
+        }
+
+    private:
+        std::chrono::milliseconds _polling_interval;
+        std::chrono::steady_clock::time_point _last_poll_time{};
+
+        std::map<std::string, std::filesystem::file_time_type> _modification_times;
+
+#ifdef __linux__
+        int _inotify_descriptor{-1};
+        std::map<int, std::string> _watched_directories;
+#endif
+
+        static std::filesystem::file_time_type _get_modification_time(const std::string &path)
+        {
+            std::error_code error;
+            auto modification_time = std::filesystem::last_write_time(path, error);
+
+            return error ? std::filesystem::file_time_type{} : modification_time;
+        }
+    };
+}
+
+#endif
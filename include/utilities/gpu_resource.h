@@ -0,0 +1,53 @@
+#ifndef GPU_RESOURCE_H
+#define GPU_RESOURCE_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace asr
+{
+    /* Common interface of objects that own GPU memory, used to keep them within a memory budget. */
+    class GPUResource
+    {
+    public:
+        virtual ~GPUResource() = default;
+
+        /* The number of bytes the resource currently occupies in video memory. */
+        [[nodiscard]] virtual size_t get_gpu_size() const = 0;
+
+        [[nodiscard]] bool is_resident() const
+        {
+            return get_gpu_size() > 0;
+        }
+
+        /* Whether the resource still has the CPU data to upload itself again after eviction. */
+        [[nodiscard]] virtual bool is_restorable() const = 0;
+
+        /* Releases the video memory. The next update uploads the CPU data again. */
+        virtual void evict() = 0;
+
+        /* A stamp that grows every time any resource is used, so resources can be ordered by their last use. */
+        [[nodiscard]] uint64_t get_last_use() const
+        {
+            return _last_use;
+        }
+
+        [[nodiscard]] static uint64_t get_use_clock()
+        {
+            return _use_clock;
+        }
+
+        /* Called whenever the resource is bound for drawing, or is drawn by a recorded command buffer. */
+        void mark_used()
+        {
+            _last_use = ++_use_clock;
+        }
+
+    private:
+        uint64_t _last_use{0};
+
+        inline static uint64_t _use_clock{0};
+    };
+}
+
+#endif
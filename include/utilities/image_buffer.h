@@ -0,0 +1,123 @@
+#ifndef IMAGE_BUFFER_H
+#define IMAGE_BUFFER_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <utility>
+
+namespace asr
+{
+    /* Move-only pixel storage. It either owns a vector or adopts a buffer allocated by a decoder
+       together with the function that frees it, so decoded pixels reach the GPU without being copied. */
+    class ImageBuffer
+    {
+    public:
+        typedef void (*deleter_type)(void *);
+
+        ImageBuffer() = default;
+
+        ImageBuffer(std::vector<uint8_t> data) // NOLINT(google-explicit-constructor)
+            : _storage{std::move(data)}, _data{_storage.data()}, _size{_storage.size()}
+        {}
+
+        ImageBuffer(uint8_t *data, size_t size, deleter_type deleter)
+            : _data{data}, _size{size}, _deleter{deleter}
+        {}
+
+        ImageBuffer(const ImageBuffer &other) = delete;
+        ImageBuffer& operator=(const ImageBuffer &other) = delete;
+
+        ImageBuffer(ImageBuffer &&other) noexcept
+        {
+            _take(other);
+        }
+
+        ImageBuffer& operator=(ImageBuffer &&other) noexcept
+        {
+            if (this != &other) {
+                clear();
+                _take(other);
+            }
+
+            return *this;
+        }
+
+        ~ImageBuffer()
+        {
+            clear();
+        }
+
+        [[nodiscard]] const uint8_t *data() const
+        {
+            return _data;
+        }
+
+        [[nodiscard]] uint8_t *data()
+        {
+            return _data;
+        }
+
+        [[nodiscard]] size_t size() const
+        {
+            return _size;
+        }
+
+        [[nodiscard]] bool empty() const
+        {
+            return _size == 0;
+        }
+
+        [[nodiscard]] const uint8_t *begin() const
+        {
+            return _data;
+        }
+
+        [[nodiscard]] const uint8_t *end() const
+        {
+            return _data + _size;
+        }
+
+        uint8_t &operator[](size_t index)
+        {
+            return _data[index];
+        }
+
+        const uint8_t &operator[](size_t index) const
+        {
+            return _data[index];
+        }
+
+        void clear()
+        {
+            if (_deleter && _data) {
+                _deleter(_data);
+            }
+            std::vector<uint8_t>{}.swap(_storage);
+            _data = nullptr;
+            _size = 0;
+            _deleter = nullptr;
+        }
+
+    private:
+        std::vector<uint8_t> _storage;
+        uint8_t *_data{nullptr};
+        size_t _size{0};
+        deleter_type _deleter{nullptr};
+
+        void _take(ImageBuffer &other)
+        {
+            _storage = std::move(other._storage);
+            _data = other._deleter ? other._data : _storage.data();
+            _size = other._size;
+            _deleter = other._deleter;
+
+            other._storage.clear();
+            other._data = nullptr;
+            other._size = 0;
+            other._deleter = nullptr;
+        }
+    };
+}
+
+#endif
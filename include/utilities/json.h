@@ -0,0 +1,406 @@
+#ifndef JSON_H
+#define JSON_H
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <utility>
+
+namespace asr
+{
+    /* A parsed JSON document, enough to read asset files such as glTF. Missing members and out of range
+       elements read as null values, so that optional properties can be read without checks. */
+    class JSONValue
+    {
+    public:
+        enum Type
+        {
+            Null,
+            Boolean,
+            Number,
+            String,
+            Array,
+            Object
+        };
+
+        static bool parse(const char *data, size_t size, JSONValue &value, std::string &error)
+        {
+            Parser parser{data, data + size, error};
+            parser.skip_whitespace();
+            if (!parser.parse_value(value, 0)) {
+                return false;
+            }
+            parser.skip_whitespace();
+            if (parser.position != parser.end) {
+                return parser.fail("Unexpected data after the JSON value");
+            }
+
+            return true;
+        }
+
+        [[nodiscard]] Type get_type() const
+        {
+            return _type;
+        }
+
+        [[nodiscard]] bool is_null() const
+        {
+            return _type == Null;
+        }
+
+        [[nodiscard]] bool is_number() const
+        {
+            return _type == Number;
+        }
+
+        [[nodiscard]] bool is_string() const
+        {
+            return _type == String;
+        }
+
+        [[nodiscard]] bool is_array() const
+        {
+            return _type == Array;
+        }
+
+        [[nodiscard]] bool is_object() const
+        {
+            return _type == Object;
+        }
+
+        [[nodiscard]] bool get_boolean(bool default_value = false) const
+        {
+            return _type == Boolean ? _boolean : default_value;
+        }
+
+        [[nodiscard]] double get_number(double default_value = 0.0) const
+        {
+            return _type == Number ? _number : default_value;
+        }
+
+        [[nodiscard]] float get_float(float default_value = 0.0f) const
+        {
+            return _type == Number ? static_cast<float>(_number) : default_value;
+        }
+
+        /* Numbers that are no non-negative integers read as `default_value`, which suits indices into arrays. */
+        [[nodiscard]] size_t get_index(size_t default_value = SIZE_MAX) const
+        {
+            if (_type != Number || _number < 0.0 || _number != static_cast<double>(static_cast<uint64_t>(_number))) {
+                return default_value;
+            }
+
+            return static_cast<size_t>(_number);
+        }
+
+        [[nodiscard]] const std::string &get_string() const
+        {
+            return _string;
+        }
+
+        /* The number of elements of arrays or members of objects. */
+        [[nodiscard]] size_t size() const
+        {
+            return _values.size();
+        }
+
+        [[nodiscard]] const JSONValue &operator[](size_t index) const
+        {
+            return index < _values.size() ? _values[index] : _get_null();
+        }
+
+        [[nodiscard]] const JSONValue &operator[](const std::string &key) const
+        {
+            for (size_t i = 0; i < _keys.size(); ++i) {
+                if (_keys[i] == key) {
+                    return _values[i];
+                }
+            }
+
+            return _get_null();
+        }
+
+        [[nodiscard]] bool has(const std::string &key) const
+        {
+            return !(*this)[key].is_null();
+        }
+
+        [[nodiscard]] const std::vector<std::string> &get_keys() const
+        {
+            return _keys;
+        }
+
+        [[nodiscard]] const std::vector<JSONValue> &get_values() const
+        {
+            return _values;
+        }
+
+    private:
+        /* Deeper documents are rejected instead of overflowing the stack. */
+        static const unsigned int MAXIMUM_DEPTH{256};
+
+        Type _type{Null};
+        bool _boolean{false};
+        double _number{0.0};
+        std::string _string;
+        std::vector<std::string> _keys;
+        std::vector<JSONValue> _values;
+
+        static const JSONValue &_get_null()
+        {
+            static const JSONValue null_value;
+            return null_value;
+        }
+
+        struct Parser
+        {
+            const char *position;
+            const char *end;
+            std::string &error;
+
+            bool fail(const std::string &message)
+            {
+                error = message;
+                return false;
+            }
+
+            void skip_whitespace()
+            {
+                while (position < end && (*position == ' ' || *position == '\t' || *position == '\n' || *position == '\r')) {
+                    ++position;
+                }
+            }
+
+            bool consume(const char *literal)
+            {
+                size_t length = std::strlen(literal);
+                if (static_cast<size_t>(end - position) < length || std::strncmp(position, literal, length) != 0) {
+                    return false;
+                }
+                position += length;
+
+                return true;
+            }
+
+            bool parse_value(JSONValue &value, unsigned int depth)
+            {
+                if (depth > MAXIMUM_DEPTH) {
+                    return fail("The JSON value is nested too deeply");
+                }
+                if (position == end) {
+                    return fail("Unexpected end of the JSON data");
+                }
+
+                switch (*position) {
+                    case '{':
+                        return parse_object(value, depth);
+                    case '[':
+                        return parse_array(value, depth);
+                    case '"':
+                        value._type = String;
+                        return parse_string(value._string);
+                    case 't':
+                    case 'f':
+                        value._type = Boolean;
+                        value._boolean = *position == 't';
+                        return consume(value._boolean ? "true" : "false") || fail("Invalid JSON literal");
+                    case 'n':
+                        value._type = Null;
+                        return consume("null") || fail("Invalid JSON literal");
+                    default:
+                        return parse_number(value);
+                }
+            }
+
+            bool parse_object(JSONValue &value, unsigned int depth)
+            {
+                value._type = Object;
+                ++position;
+                skip_whitespace();
+                if (position < end && *position == '}') {
+                    ++position;
+                    return true;
+                }
+
+                for (;;) {
+                    skip_whitespace();
+                    if (position == end || *position != '"') {
+                        return fail("Expected a JSON object key");
+                    }
+                    std::string key;
+                    if (!parse_string(key)) {
+                        return false;
+                    }
+                    skip_whitespace();
+                    if (position == end || *position != ':') {
+                        return fail("Expected ':' after a JSON object key");
+                    }
+                    ++position;
+                    skip_whitespace();
+
+                    value._keys.push_back(std::move(key));
+                    value._values.emplace_back();
+                    if (!parse_value(value._values.back(), depth + 1)) {
+                        return false;
+                    }
+
+                    skip_whitespace();
+                    if (position < end && *position == ',') {
+                        ++position;
+                    } else if (position < end && *position == '}') {
+                        ++position;
+                        return true;
+                    } else {
+                        return fail("Expected ',' or '}' in a JSON object");
+                    }
+                }
+            }
+
+            bool parse_array(JSONValue &value, unsigned int depth)
+            {
+                value._type = Array;
+                ++position;
+                skip_whitespace();
+                if (position < end && *position == ']') {
+                    ++position;
+                    return true;
+                }
+
+                for (;;) {
+                    skip_whitespace();
+                    value._values.emplace_back();
+                    if (!parse_value(value._values.back(), depth + 1)) {
+                        return false;
+                    }
+
+                    skip_whitespace();
+                    if (position < end && *position == ',') {
+                        ++position;
+                    } else if (position < end && *position == ']') {
+                        ++position;
+                        return true;
+                    } else {
+                        return fail("Expected ',' or ']' in a JSON array");
+                    }
+                }
+            }
+
+            bool parse_hex(uint32_t &code_point)
+            {
+                if (end - position < 4) {
+                    return fail("Invalid JSON string escape");
+                }
+                code_point = 0;
+                for (int i = 0; i < 4; ++i) {
+                    char character = *position++;
+                    code_point <<= 4u;
+                    if (character >= '0' && character <= '9') {
+                        code_point |= static_cast<uint32_t>(character - '0');
+                    } else if (character >= 'a' && character <= 'f') {
+                        code_point |= static_cast<uint32_t>(character - 'a' + 10);
+                    } else if (character >= 'A' && character <= 'F') {
+                        code_point |= static_cast<uint32_t>(character - 'A' + 10);
+                    } else {
+                        return fail("Invalid JSON string escape");
+                    }
+                }
+
+                return true;
+            }
+
+            static void append_utf8(std::string &string, uint32_t code_point)
+            {
+                if (code_point < 0x80u) {
+                    string += static_cast<char>(code_point);
+                } else if (code_point < 0x800u) {
+                    string += static_cast<char>(0xC0u | (code_point >> 6u));
+                    string += static_cast<char>(0x80u | (code_point & 0x3Fu));
+                } else if (code_point < 0x10000u) {
+                    string += static_cast<char>(0xE0u | (code_point >> 12u));
+                    string += static_cast<char>(0x80u | ((code_point >> 6u) & 0x3Fu));
+                    string += static_cast<char>(0x80u | (code_point & 0x3Fu));
+                } else {
+                    string += static_cast<char>(0xF0u | (code_point >> 18u));
+                    string += static_cast<char>(0x80u | ((code_point >> 12u) & 0x3Fu));
+                    string += static_cast<char>(0x80u | ((code_point >> 6u) & 0x3Fu));
+                    string += static_cast<char>(0x80u | (code_point & 0x3Fu));
+                }
+            }
+
+            bool parse_string(std::string &string)
+            {
+                ++position;
+                for (;;) {
+                    const char *run = position;
+                    while (position < end && *position != '"' && *position != '\\') {
+                        ++position;
+                    }
+                    string.append(run, position);
+                    if (position == end) {
+                        return fail("Unterminated JSON string");
+                    }
+                    if (*position++ == '"') {
+                        return true;
+                    }
+                    if (position == end) {
+                        return fail("Unterminated JSON string");
+                    }
+
+                    char escape = *position++;
+                    switch (escape) {
+                        case '"': string += '"'; break;
+                        case '\\': string += '\\'; break;
+                        case '/': string += '/'; break;
+                        case 'b': string += '\b'; break;
+                        case 'f': string += '\f'; break;
+                        case 'n': string += '\n'; break;
+                        case 'r': string += '\r'; break;
+                        case 't': string += '\t'; break;
+                        case 'u': {
+                            uint32_t code_point;
+                            if (!parse_hex(code_point)) {
+                                return false;
+                            }
+                            if (code_point >= 0xD800u && code_point < 0xDC00u && consume("\\u")) {
+                                uint32_t low_surrogate;
+                                if (!parse_hex(low_surrogate)) {
+                                    return false;
+                                }
+                                code_point = 0x10000u + ((code_point - 0xD800u) << 10u) + (low_surrogate - 0xDC00u);
+                            }
+                            append_utf8(string, code_point);
+                            break;
+                        }
+                        default:
+                            return fail("Invalid JSON string escape");
+                    }
+                }
+            }
+
+            bool parse_number(JSONValue &value)
+            {
+                const char *start = position;
+                while (position < end && std::strchr("+-0123456789.eE", *position) != nullptr && *position != '\0') {
+                    ++position;
+                }
+                if (start == position) {
+                    return fail("Unexpected character in the JSON data");
+                }
+
+                std::string number{start, position};
+                char *number_end = nullptr;
+                value._type = Number;
+                value._number = std::strtod(number.c_str(), &number_end);
+                if (number_end != number.c_str() + number.size()) {
+                    return fail("Invalid JSON number '" + number + "'");
+                }
+
+                return true;
+            }
+        };
+    };
+}
+
+#endif
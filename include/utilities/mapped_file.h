@@ -0,0 +1,107 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstdint>
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <memory>
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace asr
+{
+    /* A read-only file mapped into memory. Pages are read in by the system when they are first touched, so
+       handing ranges of the file to the GPU costs no more than reading it. Platforms without mmap read the
+       whole file into memory instead. */
+    class MappedFile
+    {
+    public:
+        static std::shared_ptr<MappedFile> open(const std::string &path, std::string &error)
+        {
+            std::shared_ptr<MappedFile> file{new MappedFile};
+#if defined(__unix__) || defined(__APPLE__)
+            int descriptor = ::open(path.c_str(), O_RDONLY);
+            if (descriptor == -1) {
+                error = "Failed to open '" + path + "': " + std::strerror(errno);
+                return nullptr;
+            }
+
+            struct stat status{};
+            if (fstat(descriptor, &status) == -1) {
+                error = "Failed to read the size of '" + path + "': " + std::strerror(errno);
+                ::close(descriptor);
+                return nullptr;
+            }
+            file->_size = static_cast<size_t>(status.st_size);
+
+            if (file->_size > 0) {
+                void *data = mmap(nullptr, file->_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+                if (data == MAP_FAILED) {
+                    error = "Failed to map '" + path + "': " + std::strerror(errno);
+                    ::close(descriptor);
+                    return nullptr;
+                }
+                file->_data = static_cast<const uint8_t *>(data);
+                file->_mapped = true;
+                madvise(data, file->_size, MADV_SEQUENTIAL);
+            }
+            ::close(descriptor);
+#else
+            std::ifstream stream{path, std::ios::binary | std::ios::ate};
+            if (!stream) {
+                error = "Failed to open '" + path + "'";
+                return nullptr;
+            }
+            file->_size = static_cast<size_t>(stream.tellg());
+            file->_buffer.reset(new uint8_t[file->_size]);
+            stream.seekg(0);
+            if (!stream.read(reinterpret_cast<char *>(file->_buffer.get()), static_cast<std::streamsize>(file->_size))) {
+                error = "Failed to read '" + path + "'";
+                return nullptr;
+            }
+            file->_data = file->_buffer.get();
+#endif
+
+            return file;
+        }
+
+        MappedFile(const MappedFile &other) = delete;
+        MappedFile& operator=(const MappedFile &other) = delete;
+
+        ~MappedFile()
+        {
+#if defined(__unix__) || defined(__APPLE__)
+            if (_mapped) {
+                munmap(const_cast<uint8_t *>(_data), _size);
+            }
+#endif
+        }
+
+        [[nodiscard]] const uint8_t *get_data() const
+        {
+            return _data;
+        }
+
+        [[nodiscard]] size_t get_size() const
+        {
+            return _size;
+        }
+
+    private:
+        const uint8_t *_data{nullptr};
+        size_t _size{0};
+        bool _mapped{false};
+        std::unique_ptr<uint8_t[]> _buffer;
+
+        MappedFile() = default;
+    };
+}
+
+#endif
@@ -0,0 +1,392 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include "utilities/trace_recorder.h"
+
+#include <imgui.h>
+
+#include <cstdint>
+#include <cstring>
+#include <array>
+#include <vector>
+#include <chrono>
+#include <memory>
+#include <functional>
+#include <algorithm>
+
+namespace asr
+{
+    /* Collects CPU scopes, GPU pass times and counters of every rendered frame. Recording is off until
+       enabled, and then costs two clock reads per scope. The renderer ends a frame after every swap, which
+       starts the next one, so work done by the application between two frames is attributed to the later. */
+    class Profiler
+    {
+    public:
+        enum Counter
+        {
+            DrawCalls,
+            StateChanges,
+            UniformUploads,
+            Triangles,
+            UploadedBytes,
+            SavedTriangles,
+            CounterCount
+        };
+
+        struct ScopeStatistics
+        {
+            const char *name;
+            unsigned int depth;
+            float cpu_time;
+            unsigned int call_count;
+        };
+
+        struct GPUScopeStatistics
+        {
+            const char *name;
+            float gpu_time;
+        };
+
+        struct FrameStatistics
+        {
+            unsigned long long frame_index{0};
+            float cpu_time{0.0f};
+            float gpu_time{0.0f};
+            std::array<uint64_t, CounterCount> counters{};
+            std::vector<ScopeStatistics> scopes;
+            std::vector<GPUScopeStatistics> gpu_scopes;
+        };
+
+        /* Measures the enclosing block. `name` must outlive the profiler, e.g. be a string literal. */
+        class Scope
+        {
+        public:
+            explicit Scope(const char *name)
+                : _profiler{get_shared_instance()}, _active{_profiler.is_enabled()}
+            {
+                if (_active) {
+                    _profiler.begin_scope(name);
+                }
+            }
+
+            Scope(const Scope &other) = delete;
+            Scope& operator=(const Scope &other) = delete;
+
+            ~Scope()
+            {
+                if (_active) {
+                    _profiler.end_scope();
+                }
+            }
+
+        private:
+            Profiler &_profiler;
+            bool _active;
+        };
+
+        static constexpr size_t FRAME_HISTORY_SIZE{120};
+
+        Profiler() = default;
+
+        Profiler(const Profiler &other) = delete;
+        Profiler& operator=(const Profiler &other) = delete;
+
+        static Profiler &get_shared_instance()
+        {
+            static Profiler profiler;
+            return profiler;
+        }
+
+        static void count(Counter counter, uint64_t amount = 1)
+        {
+            Profiler &profiler = get_shared_instance();
+            if (profiler._enabled) {
+                profiler._counters[counter] += amount;
+            }
+        }
+
+        static const char *get_counter_name(Counter counter)
+        {
+            switch (counter) {
+                case DrawCalls:
+                    return "Draw Calls";
+                case StateChanges:
+                    return "State Changes";
+                case UniformUploads:
+                    return "Uniform Uploads";
+                case Triangles:
+                    return "Triangles";
+                case UploadedBytes:
+                    return "Uploaded Bytes";
+                case SavedTriangles:
+                    return "Saved Triangles";
+                case CounterCount:
+                    break;
+            }
+
+            return "";
+        }
+
+        [[nodiscard]] bool is_enabled() const
+        {
+            return _enabled;
+        }
+
+        void set_enabled(bool enabled)
+        {
+            _enabled = enabled;
+            _begin_frame();
+        }
+
+        [[nodiscard]] bool is_overlay_enabled() const
+        {
+            return _overlay_enabled;
+        }
+
+        /* Shows the last frame in an ImGui window, drawn by the renderer before every swap. */
+        void set_overlay_enabled(bool overlay_enabled)
+        {
+            _overlay_enabled = overlay_enabled;
+        }
+
+        [[nodiscard]] const std::shared_ptr<TraceRecorder> &get_trace_recorder() const
+        {
+            return _trace_recorder;
+        }
+
+        /* Every frame recorded while the profiler is enabled is also added to the recorder. */
+        void set_trace_recorder(const std::shared_ptr<TraceRecorder> &trace_recorder)
+        {
+            _trace_recorder = trace_recorder;
+        }
+
+        /* In milliseconds, zero disables spike detection. */
+        [[nodiscard]] float get_spike_threshold() const
+        {
+            return _spike_threshold;
+        }
+
+        void set_spike_threshold(float spike_threshold)
+        {
+            _spike_threshold = spike_threshold;
+        }
+
+        /* Called with a frame whose CPU or GPU time exceeds the spike threshold, e.g. to save the trace recorder.
+           After a call, spikes are ignored until the recorder has filled up with frames that followed it. */
+        void set_on_spike(const std::function<void(const FrameStatistics &)> &on_spike)
+        {
+            _on_spike = on_spike;
+        }
+
+        /* The last completed frame. */
+        [[nodiscard]] const FrameStatistics &get_frame_statistics() const
+        {
+            return _frame_statistics;
+        }
+
+        /* CPU times of the recent frames in milliseconds, oldest first. */
+        [[nodiscard]] std::vector<float> get_frame_time_history() const
+        {
+            std::vector<float> frame_times;
+            frame_times.reserve(_frame_time_history_size);
+            for (size_t i = 0; i < _frame_time_history_size; ++i) {
+                size_t index = (_frame_time_history_next + FRAME_HISTORY_SIZE - _frame_time_history_size + i) % FRAME_HISTORY_SIZE;
+                frame_times.push_back(_frame_time_history[index]);
+            }
+
+            return frame_times;
+        }
+
+        void end_frame()
+        {
+            if (!_enabled) {
+                return;
+            }
+
+            while (!_open_events.empty()) {
+                end_scope();
+            }
+
+            FrameStatistics &statistics = _frame_statistics;
+            statistics.frame_index = _frame_index++;
+            statistics.cpu_time = _to_milliseconds(clock_type::now() - _frame_begin);
+            statistics.counters = _counters;
+            statistics.gpu_scopes = _gpu_scopes;
+            statistics.gpu_time = 0.0f;
+            for (const auto &gpu_scope : _gpu_scopes) {
+                statistics.gpu_time += gpu_scope.gpu_time;
+            }
+
+            /* Repeated scopes, e.g. one per mesh, are merged by name and depth in the order they first appear. */
+            statistics.scopes.clear();
+            for (const auto &event : _events) {
+                auto scope = std::find_if(std::begin(statistics.scopes), std::end(statistics.scopes), [&](const auto &scope) {
+                    return scope.depth == event.depth && std::strcmp(scope.name, event.name) == 0;
+                });
+                float cpu_time = _to_milliseconds(event.end - event.begin);
+                if (scope == std::end(statistics.scopes)) {
+                    statistics.scopes.push_back(ScopeStatistics{event.name, event.depth, cpu_time, 1});
+                } else {
+                    scope->cpu_time += cpu_time;
+                    ++scope->call_count;
+                }
+            }
+
+            _frame_time_history[_frame_time_history_next] = statistics.cpu_time;
+            _frame_time_history_next = (_frame_time_history_next + 1) % FRAME_HISTORY_SIZE;
+            _frame_time_history_size = std::min(_frame_time_history_size + 1, FRAME_HISTORY_SIZE);
+
+            if (_trace_recorder) {
+                _record_frame(*_trace_recorder);
+            }
+
+            size_t spike_cooldown = _trace_recorder ? _trace_recorder->get_frame_capacity() : FRAME_HISTORY_SIZE;
+            if (_frames_since_spike < spike_cooldown) {
+                ++_frames_since_spike;
+            }
+            if (_on_spike && _spike_threshold > 0.0f && _frames_since_spike >= spike_cooldown &&
+                std::max(statistics.cpu_time, statistics.gpu_time) > _spike_threshold) {
+                _frames_since_spike = 0;
+                _on_spike(statistics);
+            }
+
+            _begin_frame();
+        }
+
+        void begin_scope(const char *name)
+        {
+            if (!_enabled) {
+                return;
+            }
+
+            auto now = clock_type::now();
+            _open_events.push_back(_events.size());
+            _events.push_back(Event{name, static_cast<unsigned int>(_open_events.size() - 1), now, now});
+        }
+
+        void end_scope()
+        {
+            if (!_enabled || _open_events.empty()) {
+                return;
+            }
+
+            _events[_open_events.back()].end = clock_type::now();
+            _open_events.pop_back();
+        }
+
+        /* Reported by the renderer backend, usually a few frames after the pass ran on the GPU. */
+        void add_gpu_time(const char *name, float gpu_time)
+        {
+            if (_enabled) {
+                _gpu_scopes.push_back(GPUScopeStatistics{name, gpu_time});
+            }
+        }
+
+        void draw_overlay() const
+        {
+            const FrameStatistics &statistics = _frame_statistics;
+
+            ImGui::SetNextWindowPos(ImVec2(10, 10));
+            ImGui::SetNextWindowBgAlpha(0.6f);
+            ImGui::Begin(
+                "Profiler", nullptr,
+                ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_AlwaysAutoResize |
+                ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoFocusOnAppearing | ImGuiWindowFlags_NoNav
+            );
+            ImGui::Text("CPU: %.2f ms  GPU: %.2f ms", statistics.cpu_time, statistics.gpu_time);
+            std::vector<float> frame_times = get_frame_time_history();
+            if (!frame_times.empty()) {
+                ImGui::PlotLines("##frame_times", frame_times.data(), static_cast<int>(frame_times.size()), 0, nullptr, 0.0f, 33.3f, ImVec2(240, 40));
+            }
+            ImGui::Separator();
+            for (const auto &scope : statistics.scopes) {
+                ImGui::Text("%*s%s: %.3f ms (%u)", static_cast<int>(scope.depth * 2), "", scope.name, scope.cpu_time, scope.call_count);
+            }
+            if (!statistics.gpu_scopes.empty()) {
+                ImGui::Separator();
+                for (const auto &gpu_scope : statistics.gpu_scopes) {
+                    ImGui::Text("GPU %s: %.3f ms", gpu_scope.name, gpu_scope.gpu_time);
+                }
+            }
+            ImGui::Separator();
+            for (size_t counter = 0; counter < CounterCount; ++counter) {
+                ImGui::Text(
+                    "%s: %llu", get_counter_name(static_cast<Counter>(counter)),
+                    static_cast<unsigned long long>(statistics.counters[counter])
+                );
+            }
+            ImGui::End();
+        }
+
+    private:
+        typedef std::chrono::steady_clock clock_type;
+
+        struct Event
+        {
+            const char *name;
+            unsigned int depth;
+            clock_type::time_point begin;
+            clock_type::time_point end;
+        };
+
+        bool _enabled{false};
+        bool _overlay_enabled{false};
+
+        std::vector<Event> _events;
+        std::vector<size_t> _open_events;
+        std::array<uint64_t, CounterCount> _counters{};
+        std::vector<GPUScopeStatistics> _gpu_scopes;
+        clock_type::time_point _frame_begin;
+        unsigned long long _frame_index{0};
+
+        FrameStatistics _frame_statistics;
+
+        std::shared_ptr<TraceRecorder> _trace_recorder;
+        float _spike_threshold{0.0f};
+        std::function<void(const FrameStatistics &)> _on_spike;
+        /* Starts past any cooldown, so that spikes while starting up and loading are reported as well. */
+        size_t _frames_since_spike{SIZE_MAX};
+
+        std::array<float, FRAME_HISTORY_SIZE> _frame_time_history{};
+        size_t _frame_time_history_next{0};
+        size_t _frame_time_history_size{0};
+
+        void _record_frame(TraceRecorder &trace_recorder) const
+        {
+            TraceRecorder::Frame &frame = trace_recorder.record_frame();
+            frame.index = _frame_statistics.frame_index;
+            frame.begin = trace_recorder.get_timestamp(_frame_begin);
+            frame.duration = static_cast<double>(_frame_statistics.cpu_time) * 1000.0;
+            for (const auto &event : _events) {
+                double begin = trace_recorder.get_timestamp(event.begin);
+                frame.scopes.push_back(TraceRecorder::Scope{
+                    event.name, event.depth, begin, trace_recorder.get_timestamp(event.end) - begin
+                });
+            }
+            for (const auto &gpu_scope : _gpu_scopes) {
+                frame.gpu_scopes.push_back(TraceRecorder::GPUScope{
+                    gpu_scope.name, static_cast<double>(gpu_scope.gpu_time) * 1000.0
+                });
+            }
+            for (size_t counter = 0; counter < CounterCount; ++counter) {
+                frame.counters.emplace_back(get_counter_name(static_cast<Counter>(counter)), _counters[counter]);
+            }
+        }
+
+        void _begin_frame()
+        {
+            _events.clear();
+            _open_events.clear();
+            _counters.fill(0);
+            _gpu_scopes.clear();
+            _frame_begin = clock_type::now();
+        }
+
+        static float _to_milliseconds(clock_type::duration duration)
+        {
+            return std::chrono::duration<float, std::milli>(duration).count();
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,173 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <atomic>
+#include <exception>
+#include <algorithm>
+#include <type_traits>
+
+namespace asr
+{
+    class ThreadPool
+    {
+    public:
+        explicit ThreadPool(unsigned int thread_count = std::max(1u, std::thread::hardware_concurrency()))
+        {
+            for (unsigned int i = 0; i < thread_count; ++i) {
+                _threads.emplace_back([this]() { _work(); });
+            }
+        }
+
+        ThreadPool(const ThreadPool &other) = delete;
+        ThreadPool& operator=(const ThreadPool &other) = delete;
+
+        ~ThreadPool()
+        {
+            {
+                std::lock_guard<std::mutex> lock{_mutex};
+                _stopping = true;
+            }
+            _condition.notify_all();
+
+            for (auto &thread : _threads) {
+                thread.join();
+            }
+        }
+
+        static ThreadPool &get_shared_instance()
+        {
+            static ThreadPool shared_instance;
+            return shared_instance;
+        }
+
+        [[nodiscard]] unsigned int get_thread_count() const
+        {
+            return static_cast<unsigned int>(_threads.size());
+        }
+
+        template<typename Task>
+        auto submit(Task &&task) -> std::future<std::invoke_result_t<std::decay_t<Task>>>
+        {
+            typedef std::invoke_result_t<std::decay_t<Task>> result_type;
+
+            auto packaged_task = std::make_shared<std::packaged_task<result_type()>>(std::forward<Task>(task));
+            std::future<result_type> result = packaged_task->get_future();
+            {
+                std::lock_guard<std::mutex> lock{_mutex};
+                _tasks.emplace_back([packaged_task]() { (*packaged_task)(); });
+            }
+            _condition.notify_one();
+
+            return result;
+        }
+
+        /* Splits [begin, end) into chunks of at least `grain` items and calls body(chunk_begin, chunk_end) for each.
+           The calling thread runs every chunk that no pool thread has started, but never unrelated tasks, so nested
+           calls from pool threads do not deadlock and the render thread is not held up by e.g. texture decoding.
+           The first exception of a chunk is rethrown after all chunks have finished. */
+        template<typename Body>
+        void parallel_for(size_t begin, size_t end, size_t grain, Body &&body)
+        {
+            if (begin >= end) {
+                return;
+            }
+
+            size_t count = end - begin;
+            size_t max_chunks = static_cast<size_t>(get_thread_count()) + 1;
+            size_t chunk_count = std::max<size_t>(1, std::min(max_chunks, count / std::max<size_t>(1, grain)));
+            if (chunk_count == 1) {
+                body(begin, end);
+                return;
+            }
+
+            auto group = std::make_shared<ChunkGroup>();
+            group->chunk_count = chunk_count;
+            size_t chunk_size = (count + chunk_count - 1) / chunk_count;
+            /* Helpers that start after all chunks were taken return without touching `body`, which may be gone by then. */
+            auto run_chunks = [group, begin, end, chunk_size, body_pointer = &body]() {
+                for (size_t chunk = group->next_chunk++; chunk < group->chunk_count; chunk = group->next_chunk++) {
+                    size_t chunk_begin = begin + chunk * chunk_size;
+                    std::exception_ptr exception;
+                    if (chunk_begin < end) {
+                        try {
+                            (*body_pointer)(chunk_begin, std::min(end, chunk_begin + chunk_size));
+                        } catch (...) {
+                            exception = std::current_exception();
+                        }
+                    }
+
+                    std::lock_guard<std::mutex> lock{group->mutex};
+                    if (exception && !group->exception) {
+                        group->exception = exception;
+                    }
+                    if (++group->finished_chunks == group->chunk_count) {
+                        group->condition.notify_all();
+                    }
+                }
+            };
+
+            {
+                std::lock_guard<std::mutex> lock{_mutex};
+                for (size_t i = 1; i < chunk_count; ++i) {
+                    _tasks.emplace_back(run_chunks);
+                }
+            }
+            _condition.notify_all();
+            run_chunks();
+
+            std::unique_lock<std::mutex> lock{group->mutex};
+            group->condition.wait(lock, [&group]() { return group->finished_chunks == group->chunk_count; });
+            if (group->exception) {
+                std::rethrow_exception(group->exception);
+            }
+        }
+
+    private:
+        /* The chunks of one `parallel_for`, taken in order by the caller and the helper tasks. */
+        struct ChunkGroup
+        {
+            std::atomic<size_t> next_chunk{0};
+            size_t chunk_count{0};
+
+            std::mutex mutex;
+            std::condition_variable condition;
+            size_t finished_chunks{0};
+            std::exception_ptr exception;
+        };
+
+        std::vector<std::thread> _threads;
+        std::deque<std::function<void()>> _tasks;
+
+        std::mutex _mutex;
+        std::condition_variable _condition;
+        bool _stopping{false};
+
+        void _work()
+        {
+            for (;;) {
+                std::function<void()> task;
+                {
+                    std::unique_lock<std::mutex> lock{_mutex};
+                    _condition.wait(lock, [this]() { return _stopping || !_tasks.empty(); });
+                    if (_stopping && _tasks.empty()) {
+                        return;
+                    }
+                    task = std::move(_tasks.front());
+                    _tasks.pop_front();
+                }
+
+                task();
+            }
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,333 @@
+#ifndef TRACE_RECORDER_H
+#define TRACE_RECORDER_H
+
+#include <cstdint>
+#include <cctype>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <utility>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+
+namespace asr
+{
+    /* Keeps the scopes and counters of the last few frames in a ring buffer, so that a hitch can be written
+       out as a trace after it has happened. Traces are written in the Chrome trace event JSON format, which
+       chrome://tracing and the Perfetto UI open, or as a Perfetto protobuf trace. */
+    class TraceRecorder
+    {
+    public:
+        typedef std::chrono::steady_clock clock_type;
+
+        /* Times are in microseconds since the recorder was created. */
+        struct Scope
+        {
+            const char *name;
+            unsigned int depth;
+            double begin;
+            double duration;
+        };
+
+        /* GPU results arrive a few frames late and carry no timestamps, so they are laid out back to back
+           from the beginning of the frame they were read in. */
+        struct GPUScope
+        {
+            const char *name;
+            double duration;
+        };
+
+        struct Frame
+        {
+            unsigned long long index{0};
+            double begin{0.0};
+            double duration{0.0};
+            std::vector<Scope> scopes;
+            std::vector<GPUScope> gpu_scopes;
+            std::vector<std::pair<const char *, uint64_t>> counters;
+        };
+
+        static const size_t DEFAULT_FRAME_CAPACITY{300};
+
+        explicit TraceRecorder(size_t frame_capacity = DEFAULT_FRAME_CAPACITY)
+            : _frames(std::max(frame_capacity, static_cast<size_t>(1))), _epoch{clock_type::now()}
+        {}
+
+        [[nodiscard]] size_t get_frame_capacity() const
+        {
+            return _frames.size();
+        }
+
+        [[nodiscard]] size_t get_frame_count() const
+        {
+            return _frame_count;
+        }
+
+        /* The `index`-th recorded frame, oldest first. */
+        [[nodiscard]] const Frame &get_frame(size_t index) const
+        {
+            return _frames[(_next_frame + _frames.size() - _frame_count + index) % _frames.size()];
+        }
+
+        [[nodiscard]] double get_timestamp(clock_type::time_point time) const
+        {
+            return std::chrono::duration<double, std::micro>(time - _epoch).count();
+        }
+
+        /* Returns the slot of the newest frame to be filled in, reusing the storage of the oldest one. */
+        Frame &record_frame()
+        {
+            Frame &frame = _frames[_next_frame];
+            frame.scopes.clear();
+            frame.gpu_scopes.clear();
+            frame.counters.clear();
+
+            _next_frame = (_next_frame + 1) % _frames.size();
+            _frame_count = std::min(_frame_count + 1, _frames.size());
+
+            return frame;
+        }
+
+        void clear()
+        {
+            _next_frame = 0;
+            _frame_count = 0;
+        }
+
+        void write_chrome_trace(std::ostream &stream) const
+        {
+            std::ios::fmtflags flags = stream.flags();
+            std::streamsize precision = stream.precision();
+            stream << std::fixed << std::setprecision(3);
+
+            stream << R"({"displayTimeUnit":"ms","traceEvents":[)";
+            stream << R"({"name":"thread_name","ph":"M","pid":1,"tid":)" << CPU_THREAD << R"(,"args":{"name":"CPU"}},)";
+            stream << R"({"name":"thread_name","ph":"M","pid":1,"tid":)" << GPU_THREAD << R"(,"args":{"name":"GPU"}})";
+            for (size_t i = 0; i < _frame_count; ++i) {
+                const Frame &frame = get_frame(i);
+                stream << R"(,{"name":"Frame","ph":"X","pid":1,"tid":)" << CPU_THREAD
+                       << R"(,"ts":)" << frame.begin << R"(,"dur":)" << frame.duration
+                       << R"(,"args":{"index":)" << frame.index << "}}";
+                for (const auto &scope : frame.scopes) {
+                    stream << R"(,{"name":")" << _escape(scope.name) << R"(","ph":"X","pid":1,"tid":)" << CPU_THREAD
+                           << R"(,"ts":)" << scope.begin << R"(,"dur":)" << scope.duration << "}";
+                }
+                double gpu_begin = frame.begin;
+                for (const auto &gpu_scope : frame.gpu_scopes) {
+                    stream << R"(,{"name":")" << _escape(gpu_scope.name) << R"(","ph":"X","pid":1,"tid":)" << GPU_THREAD
+                           << R"(,"ts":)" << gpu_begin << R"(,"dur":)" << gpu_scope.duration << "}";
+                    gpu_begin += gpu_scope.duration;
+                }
+                for (const auto &counter : frame.counters) {
+                    stream << R"(,{"name":")" << _escape(counter.first) << R"(","ph":"C","pid":1,"ts":)" << frame.begin
+                           << R"(,"args":{"value":)" << counter.second << "}}";
+                }
+            }
+            stream << "]}";
+
+            stream.flags(flags);
+            stream.precision(precision);
+        }
+
+        void write_perfetto_trace(std::ostream &stream) const
+        {
+            std::string trace;
+
+            _write_track_descriptor(trace, CPU_TRACK, "CPU", false);
+            _write_track_descriptor(trace, GPU_TRACK, "GPU", false);
+            std::vector<const char *> counter_names;
+            for (size_t i = 0; i < _frame_count; ++i) {
+                for (const auto &counter : get_frame(i).counters) {
+                    auto name = std::find(std::begin(counter_names), std::end(counter_names), counter.first);
+                    if (name == std::end(counter_names)) {
+                        _write_track_descriptor(trace, COUNTER_TRACK + counter_names.size(), counter.first, true);
+                        counter_names.push_back(counter.first);
+                    }
+                }
+            }
+
+            for (size_t i = 0; i < _frame_count; ++i) {
+                const Frame &frame = get_frame(i);
+
+                /* Scopes are stored in the order they began, so closing every open scope at the same or a deeper
+                   level before the next one begins keeps the slices of a track properly nested. */
+                std::vector<double> open_scope_ends;
+                _write_slice(trace, CPU_TRACK, SliceBegin, frame.begin, "Frame");
+                open_scope_ends.push_back(frame.begin + frame.duration);
+                for (const auto &scope : frame.scopes) {
+                    while (open_scope_ends.size() > scope.depth + 1) {
+                        _write_slice(trace, CPU_TRACK, SliceEnd, open_scope_ends.back(), nullptr);
+                        open_scope_ends.pop_back();
+                    }
+                    _write_slice(trace, CPU_TRACK, SliceBegin, scope.begin, scope.name);
+                    open_scope_ends.push_back(scope.begin + scope.duration);
+                }
+                while (!open_scope_ends.empty()) {
+                    _write_slice(trace, CPU_TRACK, SliceEnd, open_scope_ends.back(), nullptr);
+                    open_scope_ends.pop_back();
+                }
+
+                double gpu_begin = frame.begin;
+                for (const auto &gpu_scope : frame.gpu_scopes) {
+                    _write_slice(trace, GPU_TRACK, SliceBegin, gpu_begin, gpu_scope.name);
+                    gpu_begin += gpu_scope.duration;
+                    _write_slice(trace, GPU_TRACK, SliceEnd, gpu_begin, nullptr);
+                }
+
+                for (const auto &counter : frame.counters) {
+                    auto name = std::find(std::begin(counter_names), std::end(counter_names), counter.first);
+                    std::string event;
+                    _write_varint_field(event, TRACK_EVENT_TYPE_FIELD, Counter);
+                    _write_varint_field(event, TRACK_EVENT_TRACK_UUID_FIELD, COUNTER_TRACK + (name - std::begin(counter_names)));
+                    _write_varint_field(event, TRACK_EVENT_COUNTER_VALUE_FIELD, counter.second);
+                    _write_track_event(trace, frame.begin, event);
+                }
+            }
+
+            stream.write(trace.data(), static_cast<std::streamsize>(trace.size()));
+        }
+
+        /* The format is picked by the extension: `.json` for Chrome trace events, `.pftrace` or
+           `.perfetto-trace` for Perfetto protobuf traces. */
+        [[nodiscard]] bool save(const std::string &path, std::string &error) const
+        {
+            std::string extension = path.substr(std::min(path.size(), path.find_last_of('.') + 1));
+            std::transform(std::begin(extension), std::end(extension), std::begin(extension), [](unsigned char character) {
+                return static_cast<char>(std::tolower(character));
+            });
+            bool perfetto = extension == "pftrace" || extension == "perfetto-trace";
+            if (!perfetto && extension != "json") {
+                error = "Unsupported trace file format (only JSON and Perfetto files are supported): '" + path + "'";
+                return false;
+            }
+
+            std::ofstream file_stream{path, std::ios::binary | std::ios::trunc};
+            if (!file_stream) {
+                error = "Failed to write the file: '" + path + "'";
+                return false;
+            }
+            if (perfetto) {
+                write_perfetto_trace(file_stream);
+            } else {
+                write_chrome_trace(file_stream);
+            }
+            if (!file_stream) {
+                error = "Failed to write the file: '" + path + "'";
+                return false;
+            }
+
+            return true;
+        }
+
+    private:
+        static const int CPU_THREAD{1};
+        static const int GPU_THREAD{2};
+
+        static const uint64_t CPU_TRACK{1};
+        static const uint64_t GPU_TRACK{2};
+        static const uint64_t COUNTER_TRACK{16};
+        static const uint64_t SEQUENCE_ID{1};
+
+        /* Field numbers and enumerators of the Perfetto trace protos that are written. */
+        static const uint32_t TRACE_PACKET_FIELD{1};
+        static const uint32_t PACKET_TIMESTAMP_FIELD{8};
+        static const uint32_t PACKET_SEQUENCE_ID_FIELD{10};
+        static const uint32_t PACKET_TRACK_EVENT_FIELD{11};
+        static const uint32_t PACKET_TRACK_DESCRIPTOR_FIELD{60};
+        static const uint32_t TRACK_DESCRIPTOR_UUID_FIELD{1};
+        static const uint32_t TRACK_DESCRIPTOR_NAME_FIELD{2};
+        static const uint32_t TRACK_DESCRIPTOR_COUNTER_FIELD{8};
+        static const uint32_t TRACK_EVENT_TYPE_FIELD{9};
+        static const uint32_t TRACK_EVENT_TRACK_UUID_FIELD{11};
+        static const uint32_t TRACK_EVENT_NAME_FIELD{23};
+        static const uint32_t TRACK_EVENT_COUNTER_VALUE_FIELD{30};
+
+        enum TrackEventType
+        {
+            SliceBegin = 1,
+            SliceEnd = 2,
+            Counter = 4
+        };
+
+        std::vector<Frame> _frames;
+        size_t _next_frame{0};
+        size_t _frame_count{0};
+        clock_type::time_point _epoch;
+
+        static std::string _escape(const char *text)
+        {
+            std::string escaped;
+            for (const char *character = text; *character != '\0'; ++character) {
+                if (*character == '"' || *character == '\\') {
+                    escaped += '\\';
+                }
+                if (static_cast<unsigned char>(*character) >= 0x20) {
+                    escaped += *character;
+                }
+            }
+
+            return escaped;
+        }
+
+        static void _write_varint(std::string &output, uint64_t value)
+        {
+            while (value >= 0x80) {
+                output += static_cast<char>((value & 0x7F) | 0x80);
+                value >>= 7;
+            }
+            output += static_cast<char>(value);
+        }
+
+        static void _write_varint_field(std::string &output, uint32_t field, uint64_t value)
+        {
+            _write_varint(output, static_cast<uint64_t>(field) << 3);
+            _write_varint(output, value);
+        }
+
+        static void _write_bytes_field(std::string &output, uint32_t field, const std::string &value)
+        {
+            _write_varint(output, (static_cast<uint64_t>(field) << 3) | 2);
+            _write_varint(output, value.size());
+            output += value;
+        }
+
+        static void _write_track_descriptor(std::string &trace, uint64_t uuid, const char *name, bool counter)
+        {
+            std::string descriptor;
+            _write_varint_field(descriptor, TRACK_DESCRIPTOR_UUID_FIELD, uuid);
+            _write_bytes_field(descriptor, TRACK_DESCRIPTOR_NAME_FIELD, name);
+            if (counter) {
+                _write_bytes_field(descriptor, TRACK_DESCRIPTOR_COUNTER_FIELD, std::string{});
+            }
+
+            std::string packet;
+            _write_varint_field(packet, PACKET_SEQUENCE_ID_FIELD, SEQUENCE_ID);
+            _write_bytes_field(packet, PACKET_TRACK_DESCRIPTOR_FIELD, descriptor);
+            _write_bytes_field(trace, TRACE_PACKET_FIELD, packet);
+        }
+
+        static void _write_slice(std::string &trace, uint64_t track, TrackEventType type, double time, const char *name)
+        {
+            std::string event;
+            _write_varint_field(event, TRACK_EVENT_TYPE_FIELD, type);
+            _write_varint_field(event, TRACK_EVENT_TRACK_UUID_FIELD, track);
+            if (name != nullptr) {
+                _write_bytes_field(event, TRACK_EVENT_NAME_FIELD, name);
+            }
+            _write_track_event(trace, time, event);
+        }
+
+        /* Perfetto timestamps are in nanoseconds. */
+        static void _write_track_event(std::string &trace, double time, const std::string &event)
+        {
+            std::string packet;
+            _write_varint_field(packet, PACKET_TIMESTAMP_FIELD, static_cast<uint64_t>(std::max(time, 0.0) * 1000.0));
+            _write_varint_field(packet, PACKET_SEQUENCE_ID_FIELD, SEQUENCE_ID);
+            _write_bytes_field(packet, PACKET_TRACK_EVENT_FIELD, event);
+            _write_bytes_field(trace, TRACE_PACKET_FIELD, packet);
+        }
+    };
+}
+
+#endif
@@ -3,9 +3,15 @@
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include "stb_image_write.h"
+
+#include "utilities/image_buffer.h"
 
 #include <tuple>
 #include <string>
+#include <cctype>
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <cstdlib>
@@ -14,7 +20,7 @@
 
 namespace asr::file_utilities
 {
-    typedef std::tuple<std::vector<uint8_t>, unsigned int, unsigned int, unsigned int> image_data_type;
+    typedef std::tuple<ImageBuffer, unsigned int, unsigned int, unsigned int> image_data_type;
 
     static std::string read_text_file(const std::string &path)
     {
@@ -30,26 +36,113 @@ namespace asr::file_utilities
         return string_stream.str();
     }
 
-    static image_data_type read_image_file(const std::string &path)
+    static bool _adopt_decoded_image(
+        uint8_t *image_data, int image_width, int image_height, int bytes_per_pixel,
+        const std::string &name, image_data_type &image, std::string &error
+    ) {
+        /* stb keeps its failure reason in a global, which is not safe to read while other threads decode. */
+        if (!image_data) {
+            error = "Failed to open the file: '" + name + "'";
+            return false;
+        }
+        if (!(bytes_per_pixel == 3 || bytes_per_pixel == 4)) {
+            stbi_image_free(image_data);
+            error = "Invalid image file format (only RGB and RGBA files are supported): '" + name + "'";
+            return false;
+        }
+
+        /* The decoded buffer is adopted as is and freed by stb once the texture no longer needs it. */
+        image = std::make_tuple(
+            ImageBuffer{
+                image_data,
+                static_cast<size_t>(image_width) * static_cast<size_t>(image_height) * static_cast<size_t>(bytes_per_pixel),
+                stbi_image_free
+            },
+            static_cast<unsigned int>(image_width),
+            static_cast<unsigned int>(image_height),
+            static_cast<unsigned int>(bytes_per_pixel)
+        );
+
+        return true;
+    }
+
+    static bool decode_image_file(const std::string &path, image_data_type &image, std::string &error)
     {
         int image_width, image_height;
         int bytes_per_pixel;
 
         auto image_data = static_cast<uint8_t *>(stbi_load(path.c_str(), &image_width, &image_height, &bytes_per_pixel, 0));
-        if (!image_data) {
-            std::cerr << "Failed to open the file: '" << path << "'" << std::endl;
+        return _adopt_decoded_image(image_data, image_width, image_height, bytes_per_pixel, path, image, error);
+    }
+
+    /* Decodes an image file that is already in memory, e.g. one embedded in a model. `name` is used in errors. */
+    static bool decode_image_data(
+        const uint8_t *data, size_t size, const std::string &name, image_data_type &image, std::string &error
+    ) {
+        int image_width{0}, image_height{0};
+        int bytes_per_pixel{0};
+
+        auto image_data = static_cast<uint8_t *>(stbi_load_from_memory(
+            data, static_cast<int>(size), &image_width, &image_height, &bytes_per_pixel, 0
+        ));
+        return _adopt_decoded_image(image_data, image_width, image_height, bytes_per_pixel, name, image, error);
+    }
+
+    static image_data_type read_image_file(const std::string &path)
+    {
+        image_data_type image;
+        std::string error;
+        if (!decode_image_file(path, image, error)) {
+            std::cerr << error << std::endl;
             std::exit(-1);
         }
-        if (!(bytes_per_pixel == 3 || bytes_per_pixel == 4)) {
-            std::cerr << "Invalid image file format (only RGB and RGBA files are supported): '" << path << "'"
-                      << std::endl;
-            std::exit(-1);
+
+        return image;
+    }
+
+    /* The format is picked from the extension: PNG, JPG, BMP or TGA. Rows are expected top to bottom. */
+    static bool encode_image_file(
+        const std::string &path, const uint8_t *image_data,
+        unsigned int width, unsigned int height, unsigned int channels, std::string &error
+    )
+    {
+        std::string extension = path.substr(std::min(path.size(), path.find_last_of('.') + 1));
+        std::transform(std::begin(extension), std::end(extension), std::begin(extension), [](unsigned char character) {
+            return static_cast<char>(std::tolower(character));
+        });
+
+        int image_width = static_cast<int>(width), image_height = static_cast<int>(height);
+        int bytes_per_pixel = static_cast<int>(channels);
+        int result{0};
+        if (extension == "png") {
+            result = stbi_write_png(path.c_str(), image_width, image_height, bytes_per_pixel, image_data, image_width * bytes_per_pixel);
+        } else if (extension == "jpg" || extension == "jpeg") {
+            result = stbi_write_jpg(path.c_str(), image_width, image_height, bytes_per_pixel, image_data, 90);
+        } else if (extension == "bmp") {
+            result = stbi_write_bmp(path.c_str(), image_width, image_height, bytes_per_pixel, image_data);
+        } else if (extension == "tga") {
+            result = stbi_write_tga(path.c_str(), image_width, image_height, bytes_per_pixel, image_data);
+        } else {
+            error = "Unsupported image file format (only PNG, JPG, BMP and TGA files are supported): '" + path + "'";
+            return false;
+        }
+        if (result == 0) {
+            error = "Failed to write the file: '" + path + "'";
+            return false;
         }
 
-        std::vector<uint8_t> result{image_data, image_data + image_height * image_width * bytes_per_pixel};
-        stbi_image_free(image_data);
+        return true;
+    }
 
-        return std::make_tuple(result, image_width, image_height, bytes_per_pixel);
+    static void write_image_file(
+        const std::string &path, const uint8_t *image_data, unsigned int width, unsigned int height, unsigned int channels
+    )
+    {
+        std::string error;
+        if (!encode_image_file(path, image_data, width, height, channels, error)) {
+            std::cerr << error << std::endl;
+            std::exit(-1);
+        }
     }
 }
 
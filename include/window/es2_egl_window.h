@@ -0,0 +1,315 @@
+#ifndef ES2_EGL_WINDOW_H
+#define ES2_EGL_WINDOW_H
+
+#include "window/window.h"
+
+#include <GL/glew.h>
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <imgui.h>
+#include <vendor/imgui_impl_opengl.h>
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <deque>
+#include <utility>
+#include <functional>
+#include <iostream>
+#include <cstdlib>
+
+#ifndef EGL_PLATFORM_SURFACELESS_MESA
+#define EGL_PLATFORM_SURFACELESS_MESA 0x31DD
+#endif
+
+namespace asr
+{
+    /* A window without a display. Frames are rendered into a framebuffer object on an EGL context that
+       needs neither X nor a GPU (Mesa's software rasterizer is used when there is none), and are handed
+       to `on_frame` after `swap`. Readback goes through pixel buffer objects a few frames behind, so
+       rendering is not stalled waiting for the pixels. */
+    class ES2EGLWindow final : public Window
+    {
+    public:
+        typedef std::function<void(const uint8_t *, unsigned int, unsigned int, unsigned long long)> frame_callback_type;
+
+        static const size_t READBACK_BUFFER_COUNT{3};
+
+        ES2EGLWindow(const std::string &name, unsigned int width, unsigned int height)
+            : Window{name, width, height}
+        {
+            const char *client_extensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+            auto get_platform_display = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+                eglGetProcAddress("eglGetPlatformDisplayEXT")
+            );
+            if (client_extensions != nullptr && std::strstr(client_extensions, "EGL_MESA_platform_surfaceless") != nullptr &&
+                get_platform_display != nullptr) {
+                _display = get_platform_display(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+            }
+            if (_display == EGL_NO_DISPLAY) {
+                _display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+            }
+            if (_display == EGL_NO_DISPLAY || eglInitialize(_display, nullptr, nullptr) != EGL_TRUE) {
+                std::cerr << "Failed to initialize an EGL display." << std::endl;
+                std::exit(-1);
+            }
+            if (eglBindAPI(EGL_OPENGL_API) != EGL_TRUE) {
+                std::cerr << "The EGL display does not support OpenGL." << std::endl;
+                std::exit(-1);
+            }
+
+            const EGLint config_attributes[]{
+                EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+                EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+                EGL_RED_SIZE, 8,
+                EGL_GREEN_SIZE, 8,
+                EGL_BLUE_SIZE, 8,
+                EGL_ALPHA_SIZE, 8,
+                EGL_NONE
+            };
+            EGLConfig config;
+            EGLint config_count{0};
+            if (eglChooseConfig(_display, config_attributes, &config, 1, &config_count) != EGL_TRUE || config_count == 0) {
+                std::cerr << "Failed to find a suitable EGL configuration." << std::endl;
+                std::exit(-1);
+            }
+
+            _context = eglCreateContext(_display, config, EGL_NO_CONTEXT, nullptr);
+            if (_context == EGL_NO_CONTEXT) {
+                std::cerr << "Failed to create an EGL context." << std::endl;
+                std::exit(-1);
+            }
+
+            /* Everything is drawn into the framebuffer object, so a surface is only created for drivers
+               that can not make a context current without one. */
+            const char *display_extensions = eglQueryString(_display, EGL_EXTENSIONS);
+            if (display_extensions == nullptr || std::strstr(display_extensions, "EGL_KHR_surfaceless_context") == nullptr) {
+                const EGLint surface_attributes[]{EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE};
+                _surface = eglCreatePbufferSurface(_display, config, surface_attributes);
+            }
+            if (eglMakeCurrent(_display, _surface, _surface, _context) != EGL_TRUE) {
+                std::cerr << "Failed to make the EGL context current." << std::endl;
+                std::exit(-1);
+            }
+
+            /* glewInit also loads GLX, which is not available without an X display. */
+            glewExperimental = GL_TRUE;
+            if (glewContextInit() != GLEW_OK) {
+                std::cerr << "Failed to initialize the OpenGL loader." << std::endl;
+                std::exit(-1);
+            }
+
+            _create_framebuffer();
+            if (GLEW_VERSION_2_1 || GLEW_ARB_pixel_buffer_object) {
+                _pixel_buffers.resize(READBACK_BUFFER_COUNT);
+                glGenBuffers(static_cast<GLsizei>(_pixel_buffers.size()), _pixel_buffers.data());
+                for (auto pixel_buffer : _pixel_buffers) {
+                    glBindBuffer(GL_PIXEL_PACK_BUFFER, pixel_buffer);
+                    glBufferData(GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(_get_frame_size()), nullptr, GL_STREAM_READ);
+                }
+                glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            }
+
+            IMGUI_CHECKVERSION();
+            ImGui::CreateContext();
+            _io = &ImGui::GetIO();
+            _io->IniFilename = nullptr;
+            _io->DisplaySize = ImVec2{static_cast<float>(_width), static_cast<float>(_height)};
+            ImGui_ImplOpenGL3_Init("#version 120");
+
+            _on_exit = [&]() { exit(0); };
+            _on_key_down = [&](int key) { };
+            _on_late_keys_down = [&](const uint8_t *keys) { };
+            _on_mouse_move = [&](int x, int y, int x_rel, int y_rel) { };
+            _on_mouse_down = [&](int button, int x, int y) { };
+        }
+
+        ES2EGLWindow(const ES2EGLWindow &other) = delete;
+        ES2EGLWindow& operator=(const ES2EGLWindow &other) = delete;
+
+        ~ES2EGLWindow() final
+        {
+            finish();
+
+            ImGui_ImplOpenGL3_Shutdown();
+            ImGui::DestroyContext();
+
+            if (!_pixel_buffers.empty()) {
+                glDeleteBuffers(static_cast<GLsizei>(_pixel_buffers.size()), _pixel_buffers.data());
+            }
+            glDeleteRenderbuffers(1, &_depth_renderbuffer);
+            glDeleteRenderbuffers(1, &_color_renderbuffer);
+            glDeleteFramebuffers(1, &_framebuffer);
+
+            eglMakeCurrent(_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+            if (_surface != EGL_NO_SURFACE) {
+                eglDestroySurface(_display, _surface);
+            }
+            eglDestroyContext(_display, _context);
+            eglTerminate(_display);
+        }
+
+        [[nodiscard]] unsigned int get_framebuffer() const final
+        {
+            return _framebuffer;
+        }
+
+        [[nodiscard]] unsigned long long get_frame_index() const
+        {
+            return _frame_index;
+        }
+
+        [[nodiscard]] const frame_callback_type &get_on_frame() const
+        {
+            return _on_frame;
+        }
+
+        /* Receives the RGBA pixels of every presented frame, top row first, along with the frame's index.
+           Frames arrive in order but may lag a few swaps behind until `finish` is called. */
+        void set_on_frame(const frame_callback_type &on_frame)
+        {
+            _on_frame = on_frame;
+        }
+
+        void poll() final
+        {
+            ImGui_ImplOpenGL3_NewFrame();
+            _io->DisplaySize = ImVec2{static_cast<float>(_width), static_cast<float>(_height)};
+            _io->DeltaTime = 1.0f / 60.0f;
+            ImGui::NewFrame();
+        }
+
+        /* Never waits for a vertical blank, so frames are produced as fast as they can be rendered. */
+        void swap() final
+        {
+            ImGui::Render();
+            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+
+            if (_on_frame) {
+                if (_pixel_buffers.empty()) {
+                    _read_pixels(_pixels);
+                    _on_frame(_pixels.data(), _width, _height, _frame_index);
+                } else {
+                    if (_pending_frames.size() == _pixel_buffers.size()) {
+                        _deliver_pending_frame();
+                    }
+
+                    GLuint pixel_buffer = _pixel_buffers[_frame_index % _pixel_buffers.size()];
+                    glBindFramebuffer(GL_FRAMEBUFFER, _framebuffer);
+                    glBindBuffer(GL_PIXEL_PACK_BUFFER, pixel_buffer);
+                    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+                    glReadPixels(
+                        0, 0, static_cast<GLsizei>(_width), static_cast<GLsizei>(_height),
+                        GL_RGBA, GL_UNSIGNED_BYTE, nullptr
+                    );
+                    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+                    _pending_frames.emplace_back(pixel_buffer, _frame_index);
+                }
+            }
+            glFlush();
+
+            ++_frame_index;
+        }
+
+        /* Hands every frame still being read back to `on_frame`. */
+        void finish()
+        {
+            while (!_pending_frames.empty()) {
+                _deliver_pending_frame();
+            }
+        }
+
+        /* Reads the current contents of the framebuffer right away, top row first. */
+        void read_pixels(std::vector<uint8_t> &pixels)
+        {
+            _read_pixels(pixels);
+        }
+
+    private:
+        EGLDisplay _display{EGL_NO_DISPLAY};
+        EGLContext _context{EGL_NO_CONTEXT};
+        EGLSurface _surface{EGL_NO_SURFACE};
+        ImGuiIO *_io{nullptr};
+
+        GLuint _framebuffer{0};
+        GLuint _color_renderbuffer{0};
+        GLuint _depth_renderbuffer{0};
+
+        std::vector<GLuint> _pixel_buffers;
+        std::deque<std::pair<GLuint, unsigned long long>> _pending_frames;
+        std::vector<uint8_t> _pixels;
+        unsigned long long _frame_index{0};
+
+        frame_callback_type _on_frame;
+
+        [[nodiscard]] size_t _get_frame_size() const
+        {
+            return static_cast<size_t>(_width) * _height * 4;
+        }
+
+        void _create_framebuffer()
+        {
+            glGenRenderbuffers(1, &_color_renderbuffer);
+            glBindRenderbuffer(GL_RENDERBUFFER, _color_renderbuffer);
+            glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, static_cast<GLsizei>(_width), static_cast<GLsizei>(_height));
+
+            glGenRenderbuffers(1, &_depth_renderbuffer);
+            glBindRenderbuffer(GL_RENDERBUFFER, _depth_renderbuffer);
+            glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, static_cast<GLsizei>(_width), static_cast<GLsizei>(_height));
+            glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+            glGenFramebuffers(1, &_framebuffer);
+            glBindFramebuffer(GL_FRAMEBUFFER, _framebuffer);
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, _color_renderbuffer);
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, _depth_renderbuffer);
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_STENCIL_ATTACHMENT, GL_RENDERBUFFER, _depth_renderbuffer);
+            if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+                std::cerr << "Failed to create the offscreen framebuffer." << std::endl;
+                std::exit(-1);
+            }
+        }
+
+        void _read_pixels(std::vector<uint8_t> &pixels)
+        {
+            std::vector<uint8_t> rows(_get_frame_size());
+            glBindFramebuffer(GL_FRAMEBUFFER, _framebuffer);
+            glPixelStorei(GL_PACK_ALIGNMENT, 1);
+            glReadPixels(
+                0, 0, static_cast<GLsizei>(_width), static_cast<GLsizei>(_height),
+                GL_RGBA, GL_UNSIGNED_BYTE, rows.data()
+            );
+            _flip_rows(rows.data(), pixels);
+        }
+
+        void _deliver_pending_frame()
+        {
+            auto [pixel_buffer, frame_index] = _pending_frames.front();
+            _pending_frames.pop_front();
+
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, pixel_buffer);
+            const auto *rows = static_cast<const uint8_t *>(glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY));
+            if (rows != nullptr) {
+                _flip_rows(rows, _pixels);
+                glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+            }
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+            if (rows != nullptr && _on_frame) {
+                _on_frame(_pixels.data(), _width, _height, frame_index);
+            }
+        }
+
+        /* OpenGL returns the bottom row first. */
+        void _flip_rows(const uint8_t *rows, std::vector<uint8_t> &pixels) const
+        {
+            size_t row_size = static_cast<size_t>(_width) * 4;
+            pixels.resize(_get_frame_size());
+            for (unsigned int row = 0; row < _height; ++row) {
+                std::memcpy(pixels.data() + row * row_size, rows + (static_cast<size_t>(_height) - 1 - row) * row_size, row_size);
+            }
+        }
+    };
+}
+
+#endif
@@ -79,6 +79,12 @@ namespace asr
             _on_mouse_down = on_mouse_down;
         }
 
+        /* The framebuffer object that the window presents, 0 for the default framebuffer. */
+        [[nodiscard]] virtual unsigned int get_framebuffer() const
+        {
+            return 0;
+        }
+
         virtual void poll() = 0;
 
         virtual void swap() = 0;
@@ -12,8 +12,8 @@
     box_material->set_face_culling_enabled(false);
     auto[image1_data, image1_width, image1_height, image1_channels] = file_utilities::read_image_file("data/images/room_cubemap.png");
     auto[image1_normals_data, image1_normals_width, image1_normals_height, image1_normals_channels] = file_utilities::read_image_file("data/images/room_normalmap.png");
-    auto box_texture1 = std::make_shared<ES2Texture>(image1_data, image1_width, image1_height, image1_channels);
-    auto box_texture1_normals = std::make_shared<ES2Texture>(image1_normals_data, image1_normals_width, image1_normals_height, image1_normals_channels);
+    auto box_texture1 = std::make_shared<ES2Texture>(std::move(image1_data), image1_width, image1_height, image1_channels);
+    auto box_texture1_normals = std::make_shared<ES2Texture>(std::move(image1_normals_data), image1_normals_width, image1_normals_height, image1_normals_channels);
     box_material->set_texture_1(box_texture1);
     box_material->set_texture_1_normals(box_texture1_normals);
     box_material->set_ambient_color(glm::vec3{0.1f});
@@ -0,0 +1,78 @@
+#include "asr.h"
+
+[[noreturn]] int main()
+{
+    using namespace asr;
+
+    auto window = std::make_shared<ES2SDLWindow>("asr");
+
+    static const int GRID_SIZE{10};
+
+    auto material = std::make_shared<ES2PhongMaterial>();
+    material->set_specular_exponent(30.0f);
+
+    auto[plane_indices, plane_vertices] = geometry_generators::generate_plane_geometry_data(500.0f, 500.0f, 10, 10);
+    auto plane = std::make_shared<Mesh>(std::make_shared<ES2Geometry>(plane_indices, plane_vertices), material);
+    plane->set_y(-2.0f);
+    plane->set_rotation_x(-static_cast<float>(M_PI) * 0.5f);
+
+    auto[sphere_indices, sphere_vertices] = geometry_generators::generate_sphere_geometry_data(0.8f, 100, 100);
+    auto sphere_geometry = std::make_shared<ES2Geometry>(sphere_indices, sphere_vertices);
+
+    std::vector<std::shared_ptr<Object>> objects{plane};
+    for (int i = 0; i < GRID_SIZE; ++i) {
+        for (int j = 0; j < GRID_SIZE; ++j) {
+            auto sphere = std::make_shared<Mesh>(sphere_geometry, material);
+            sphere->set_x((static_cast<float>(i) - GRID_SIZE * 0.5f) * 2.0f);
+            sphere->set_z(-static_cast<float>(j) * 2.0f);
+            objects.push_back(sphere);
+        }
+    }
+    auto scene = std::make_shared<Scene>(objects);
+
+    auto point_light = std::make_shared<PointLight>();
+    point_light->set_y(4.0f);
+    scene->get_root()->add_child(point_light);
+    scene->get_point_lights().push_back(point_light);
+
+    auto camera = scene->get_camera();
+    camera->set_y(5.0f);
+    camera->set_z(10.0f);
+    camera->set_rotation_x(-0.5f);
+
+    static const float TARGET_FRAME_TIME_DIFF{1.0f};
+
+    ES2Renderer renderer(scene, window);
+    ResolutionScaler &resolution_scaler = renderer.get_resolution_scaler();
+    resolution_scaler.set_target_frame_time(1000.0f / 60.0f);
+    renderer.set_dynamic_resolution_enabled(true);
+
+    window->set_on_key_down([&](int key) {
+        switch (key) {
+            case SDLK_r: renderer.set_dynamic_resolution_enabled(!renderer.is_dynamic_resolution_enabled()); break;
+            case SDLK_EQUALS: resolution_scaler.set_target_frame_time(resolution_scaler.get_target_frame_time() + TARGET_FRAME_TIME_DIFF); break;
+            case SDLK_MINUS: resolution_scaler.set_target_frame_time(std::max(1.0f, resolution_scaler.get_target_frame_time() - TARGET_FRAME_TIME_DIFF)); break;
+            case SDLK_ESCAPE: exit(0);
+            default: break;
+        }
+    });
+
+    float point_light_angle = 0.0f;
+    for (;;) {
+        window->poll();
+
+        ImGui::SetNextWindowPos(ImVec2(10, 10));
+        ImGui::Begin("Resolution", nullptr, ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_AlwaysAutoResize);
+        ImGui::Text("Dynamic resolution: %s (R)", renderer.is_dynamic_resolution_enabled() ? "on" : "off");
+        ImGui::Text("Target frame time: %.0f ms (+/-)", resolution_scaler.get_target_frame_time());
+        ImGui::Text("Scale: %.2f", resolution_scaler.get_scale());
+        ImGui::Text("Frame time: %.2f ms", resolution_scaler.get_smoothed_frame_time());
+        ImGui::End();
+
+        point_light->set_x(cosf(point_light_angle) * 8.0f);
+        point_light->set_z(sinf(point_light_angle) * 8.0f - GRID_SIZE);
+        point_light_angle += 0.01f;
+
+        renderer.render();
+    }
+}
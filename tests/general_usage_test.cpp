@@ -23,17 +23,19 @@ public:
         Dead
     };
 
-    Enemy(const glm::vec3 &position, float size, float speed, const enemy_sprite_data_type& enemy_sprite_data)
+    Enemy(const glm::vec3 &position, float size, float speed, const enemy_sprite_data_type& enemy_sprite_data, TextureAtlas &texture_atlas)
         : _position{position}, _speed(speed)
     {
         const auto&[sprite_file, sprite_frame_count, first_dying_state_sprite_frame] = enemy_sprite_data;
 
-        auto[image_data, image_width, image_height, image_channels] = file_utilities::read_image_file(sprite_file);
-        _texture = std::make_shared<ES2Texture>(image_data, image_width, image_height, image_channels);
-        _texture->set_minification_filter(Texture::FilterType::Nearest);
-        _texture->set_magnification_filter(Texture::FilterType::Nearest);
+        TextureAtlas::Region region{};
+        if (!texture_atlas.find(sprite_file, region)) {
+            auto[image_data, image_width, image_height, image_channels] = file_utilities::read_image_file(sprite_file);
+            texture_atlas.insert(sprite_file, image_data.data(), image_width, image_height, image_channels, region);
+        }
+        _texture = texture_atlas.create_texture(region);
         _texture->set_mode(Texture::Mode::Modulation);
-        _texture->set_transformation_enabled(true);
+        _region_matrix = region.get_transformation_matrix();
         _set_texture_frames(sprite_frame_count);
         _set_first_dying_texture_frame(first_dying_state_sprite_frame);
 
@@ -126,7 +128,8 @@ private:
     int _update_request{0};
     int _update_rate{10};
 
-    std::shared_ptr<ES2Texture> _texture;
+    std::shared_ptr<Texture> _texture;
+    glm::mat4 _region_matrix{1.0f};
     unsigned int _texture_frame{0};
     unsigned int _texture_frames{1};
     unsigned int _first_dying_texture_frame{0};
@@ -134,18 +137,21 @@ private:
     void _set_texture_frame(unsigned int texture_frame)
     {
         _texture_frame = texture_frame;
-        glm::mat4 matrix = _texture->get_transformation_matrix();
-        matrix[3][0] = static_cast<float>(_texture_frame) / static_cast<float>(_texture_frames);
-        _texture->set_transformation_matrix(matrix);
+        _update_texture_transformation_matrix();
     }
 
     void _set_texture_frames(unsigned int texture_frames)
     {
         _texture_frames = texture_frames;
-        glm::mat4 matrix = _texture->get_transformation_matrix();
-        matrix[0][0] = 1.0f / static_cast<float>(_texture_frames);
-        matrix[3][0] = static_cast<float>(_texture_frame) / static_cast<float>(_texture_frames);
-        _texture->set_transformation_matrix(matrix);
+        _update_texture_transformation_matrix();
+    }
+
+    void _update_texture_transformation_matrix()
+    {
+        glm::mat4 frame_matrix{1.0f};
+        frame_matrix[0][0] = 1.0f / static_cast<float>(_texture_frames);
+        frame_matrix[3][0] = static_cast<float>(_texture_frame) / static_cast<float>(_texture_frames);
+        _texture->set_transformation_matrix(_region_matrix * frame_matrix);
     }
 
     void _set_first_dying_texture_frame(unsigned int first_dying_texture_frame)
@@ -163,16 +169,19 @@ public:
         Shooting
     };
 
-    Gun(const glm::vec3 &position, float gun_size, const glm::vec2 &target, const gun_sprite_data_type& gun_sprite_data) : _target{target}
+    Gun(const glm::vec3 &position, float gun_size, const glm::vec2 &target, const gun_sprite_data_type& gun_sprite_data, TextureAtlas &texture_atlas)
+        : _target{target}
     {
         const auto&[sprite_file, sprite_frame_count] = gun_sprite_data;
 
-        auto[image2_data, image2_width, image2_height, image2_channels] = file_utilities::read_image_file(sprite_file);
-        _texture = std::make_shared<ES2Texture>(image2_data, image2_width, image2_height, image2_channels);
-        _texture->set_minification_filter(Texture::FilterType::Nearest);
-        _texture->set_magnification_filter(Texture::FilterType::Nearest);
+        TextureAtlas::Region region{};
+        if (!texture_atlas.find(sprite_file, region)) {
+            auto[image2_data, image2_width, image2_height, image2_channels] = file_utilities::read_image_file(sprite_file);
+            texture_atlas.insert(sprite_file, image2_data.data(), image2_width, image2_height, image2_channels, region);
+        }
+        _texture = texture_atlas.create_texture(region);
         _texture->set_mode(Texture::Mode::Modulation);
-        _texture->set_transformation_enabled(true);
+        _region_matrix = region.get_transformation_matrix();
         _set_texture_frames(sprite_frame_count);
 
         auto[overlay_indices, overlay_vertices] = geometry_generators::generate_plane_geometry_data(2, 2, 1, 1);
@@ -247,26 +256,29 @@ private:
     int _update_request{0};
     int _update_rate{7};
 
-    std::shared_ptr<ES2Texture> _texture;
+    std::shared_ptr<Texture> _texture;
+    glm::mat4 _region_matrix{1.0f};
     unsigned int _texture_frame{0};
     unsigned int _texture_frames{1};
 
     void _set_texture_frame(unsigned int texture_frame)
     {
         _texture_frame = texture_frame;
-        glm::mat4 matrix = _texture->get_transformation_matrix();
-        matrix[3][0] = static_cast<float>(_texture_frame) / static_cast<float>(_texture_frames);
-        _texture->set_transformation_matrix(matrix);
+        _update_texture_transformation_matrix();
     }
 
     void _set_texture_frames(unsigned int texture_frames)
     {
         _texture_frames = texture_frames;
+        _update_texture_transformation_matrix();
+    }
 
-        glm::mat4 matrix = _texture->get_transformation_matrix();
-        matrix[0][0] = 1.0f / static_cast<float>(_texture_frames);
-        matrix[3][0] = static_cast<float>(_texture_frame) / static_cast<float>(_texture_frames);
-        _texture->set_transformation_matrix(matrix);
+    void _update_texture_transformation_matrix()
+    {
+        glm::mat4 frame_matrix{1.0f};
+        frame_matrix[0][0] = 1.0f / static_cast<float>(_texture_frames);
+        frame_matrix[3][0] = static_cast<float>(_texture_frame) / static_cast<float>(_texture_frames);
+        _texture->set_transformation_matrix(_region_matrix * frame_matrix);
     }
 };
 
@@ -306,6 +318,10 @@ int main(int argc, char **argv)
     room_ground->set_position(glm::vec3(0.0f, -2.5f, 0.0f));
     room_ground->set_rotation(glm::vec3(-M_PI / 2.0f, 0.0f, 0.0f));
 
+    // Sprites
+
+    ES2TextureAtlas sprite_atlas;
+
     // Monsters
 
     float enemies_size = 9;
@@ -320,10 +336,10 @@ int main(int argc, char **argv)
         );
 
     glm::vec3 enemy1_position{-5.0f, 1.5f, 0.0f};
-    auto enemy1 = std::make_shared<Enemy>(enemy1_position, enemies_size, enemies_speed, enemies_sprite_data);
+    auto enemy1 = std::make_shared<Enemy>(enemy1_position, enemies_size, enemies_speed, enemies_sprite_data, sprite_atlas);
 
     glm::vec3 enemy2_position{5.0f, 1.5f, 0.0f};
-    auto enemy2 = std::make_shared<Enemy>(enemy2_position, enemies_size, enemies_speed, enemies_sprite_data);
+    auto enemy2 = std::make_shared<Enemy>(enemy2_position, enemies_size, enemies_speed, enemies_sprite_data, sprite_atlas);
 
     std::vector<std::shared_ptr<Enemy>> enemies{enemy1, enemy2};
 
@@ -335,7 +351,12 @@ int main(int argc, char **argv)
     int gun_sprite_frames = 6;
     std::tuple gun_sprite_data = std::make_tuple("data/images/gun.png", gun_sprite_frames);
 
-    auto gun = std::make_shared<Gun>(gun_position, gun_size, gun_target, gun_sprite_data);
+    auto gun = std::make_shared<Gun>(gun_position, gun_size, gun_target, gun_sprite_data, sprite_atlas);
+
+    for (const auto &page : sprite_atlas.get_pages()) {
+        page->set_minification_filter(Texture::FilterType::Nearest);
+        page->set_magnification_filter(Texture::FilterType::Nearest);
+    }
 
     // Lamps
 
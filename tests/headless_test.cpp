@@ -0,0 +1,51 @@
+#include "asr.h"
+#include "window/es2_egl_window.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+
+/* Frames go to the directory given as the first argument, or to the temporary directory. */
+int main(int argc, char **argv)
+{
+    using namespace asr;
+
+    static const unsigned int FRAME_COUNT{120};
+
+    const std::filesystem::path frame_directory = argc > 1 ? std::filesystem::path{argv[1]} : std::filesystem::temp_directory_path();
+
+    auto window = std::make_shared<ES2EGLWindow>("asr", 640, 480);
+    window->set_on_frame([&frame_directory](const uint8_t *pixels, unsigned int width, unsigned int height, unsigned long long frame_index) {
+        char name[32];
+        std::snprintf(name, sizeof(name), "frame_%04llu.png", frame_index);
+        file_utilities::write_image_file((frame_directory / name).string(), pixels, width, height, 4);
+    });
+
+    auto[triangle_indices, triangle_vertices] = geometry_generators::generate_triangle_geometry_data(4.0f);
+    auto triangle_geometry = std::make_shared<ES2Geometry>(triangle_indices, triangle_vertices);
+    triangle_geometry->get_mutable_vertices()[0].color = glm::vec4{1.0f, 0.0f, 0.0f, 1.0f};
+    triangle_geometry->get_mutable_vertices()[1].color = glm::vec4{0.0f, 1.0f, 0.0f, 1.0f};
+    triangle_geometry->get_mutable_vertices()[2].color = glm::vec4{0.0f, 0.0f, 1.0f, 1.0f};
+    auto triangle_material = std::make_shared<ES2ConstantMaterial>();
+    triangle_material->set_face_culling_enabled(false);
+    auto triangle = std::make_shared<Mesh>(triangle_geometry, triangle_material);
+
+    std::vector<std::shared_ptr<Object>> objects{triangle};
+    auto scene = std::make_shared<Scene>(objects);
+    auto camera = scene->get_camera();
+    camera->set_z(5.0f);
+
+    ES2Renderer renderer(scene, window);
+    renderer.finish_shader_compilation();
+    for (unsigned int frame = 0; frame < FRAME_COUNT; ++frame) {
+        window->poll();
+
+        triangle->add_to_rotation_z(-0.05f);
+
+        renderer.render();
+    }
+    window->finish();
+    std::cout << "Saved " << FRAME_COUNT << " frames to '" << frame_directory.string() << "'" << std::endl;
+
+    return 0;
+}
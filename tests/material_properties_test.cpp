@@ -10,7 +10,7 @@
     auto plane1_geometry = std::make_shared<ES2Geometry>(plane1_indices, plane1_vertices);
     auto plane1_material = std::make_shared<ES2PhongMaterial>();
     auto[image1_data, image1_width, image1_height, image1_channels] = file_utilities::read_image_file("data/images/checkerboard.png");
-    auto texture1 = std::make_shared<ES2Texture>(image1_data, image1_width, image1_height, image1_channels);
+    auto texture1 = std::make_shared<ES2Texture>(std::move(image1_data), image1_width, image1_height, image1_channels);
     plane1_material->set_texture_1(texture1);
     auto plane1 = std::make_shared<Mesh>(plane1_geometry, plane1_material);
     plane1->set_position(glm::vec3(0.0f, 0.0f, -10.0f));
@@ -32,7 +32,7 @@
     sphere1_material->set_specular_exponent(40.f);
     sphere1_material->set_transparent(true);
     auto[image2_data, image2_width, image2_height, image2_channels] = file_utilities::read_image_file("data/images/checkerboard.png");
-    auto texture2 = std::make_shared<ES2Texture>(image2_data, image2_width, image2_height, image2_channels);
+    auto texture2 = std::make_shared<ES2Texture>(std::move(image2_data), image2_width, image2_height, image2_channels);
     sphere1_material->set_texture_1(texture2);
     auto sphere1 = std::make_shared<Mesh>(sphere1_geometry, sphere1_material);
     sphere1->set_position(glm::vec3(0.0f, 0.0f, 0.0f));
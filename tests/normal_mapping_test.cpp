@@ -12,8 +12,8 @@
     auto plane1_material = std::make_shared<ES2PhongMaterial>();
     auto[image1_data, image1_width, image1_height, image1_channels] = file_utilities::read_image_file("data/images/bricks.png");
     auto[image1_normals_data, image1_normals_width, image1_normals_height, image1_normals_channels] = file_utilities::read_image_file("data/images/bricks_normals.png");
-    auto texture1 = std::make_shared<ES2Texture>(image1_data, image1_width, image1_height, image1_channels);
-    auto texture1_normals = std::make_shared<ES2Texture>(image1_normals_data, image1_normals_width, image1_normals_height, image1_normals_channels);
+    auto texture1 = std::make_shared<ES2Texture>(std::move(image1_data), image1_width, image1_height, image1_channels);
+    auto texture1_normals = std::make_shared<ES2Texture>(std::move(image1_normals_data), image1_normals_width, image1_normals_height, image1_normals_channels);
     plane1_material->set_texture_1(texture1);
     plane1_material->set_texture_1_normals(texture1_normals);
     plane1_material->set_specular_exponent(50.0f);
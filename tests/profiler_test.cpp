@@ -0,0 +1,85 @@
+#include "asr.h"
+
+#include <filesystem>
+
+[[noreturn]] int main()
+{
+    using namespace asr;
+
+    auto window = std::make_shared<ES2SDLWindow>("asr");
+
+    static const int GRID_SIZE{12};
+
+    auto [box_indices, box_vertices] = geometry_generators::generate_box_geometry_data(1.0f, 1.0f, 1.0f, 1, 1, 1);
+    auto box_geometry = std::make_shared<ES2Geometry>(box_indices, box_vertices);
+
+    std::vector<std::shared_ptr<Mesh>> boxes;
+    std::vector<std::shared_ptr<Object>> objects;
+    for (int i = 0; i < GRID_SIZE; ++i) {
+        for (int j = 0; j < GRID_SIZE; ++j) {
+            auto material = std::make_shared<ES2PhongMaterial>();
+            material->set_diffuse_color(glm::vec4{
+                static_cast<float>(i) / GRID_SIZE, static_cast<float>(j) / GRID_SIZE, 0.5f, 1.0f
+            });
+
+            auto box = std::make_shared<Mesh>(box_geometry, material);
+            box->set_position(glm::vec3{
+                (static_cast<float>(i) - GRID_SIZE * 0.5f) * 2.0f, (static_cast<float>(j) - GRID_SIZE * 0.5f) * 2.0f, 0.0f
+            });
+            box->set_scale(glm::vec3{0.8f});
+            boxes.push_back(box);
+            objects.push_back(box);
+        }
+    }
+    auto scene = std::make_shared<Scene>(objects);
+
+    auto point_light = std::make_shared<PointLight>();
+    point_light->set_z(10.0f);
+    scene->get_point_lights().push_back(point_light);
+
+    auto camera = scene->get_camera();
+    camera->set_z(30.0f);
+
+    /* Traces go to the temporary directory instead of wherever the demo is started. */
+    const std::filesystem::path trace_directory = std::filesystem::temp_directory_path();
+    auto save_trace = [](Profiler &profiler, const std::filesystem::path &path) {
+        std::string error;
+        if (profiler.get_trace_recorder()->save(path.string(), error)) {
+            std::cout << "Saved the trace to '" << path.string() << "'" << std::endl;
+        } else {
+            std::cerr << error << std::endl;
+        }
+    };
+
+    Profiler &profiler = Profiler::get_shared_instance();
+    profiler.set_trace_recorder(std::make_shared<TraceRecorder>());
+    profiler.set_spike_threshold(50.0f);
+    profiler.set_on_spike([&](const Profiler::FrameStatistics &statistics) {
+        save_trace(profiler, trace_directory / ("asr_spike_" + std::to_string(statistics.frame_index) + ".json"));
+    });
+
+    window->set_on_key_down([&](int key) {
+        switch (key) {
+            case SDLK_p: {
+                profiler.set_enabled(!profiler.is_enabled());
+                profiler.set_overlay_enabled(profiler.is_enabled());
+                break;
+            }
+            case SDLK_t: save_trace(profiler, trace_directory / "asr_trace.pftrace"); break;
+            case SDLK_ESCAPE: exit(0);
+            default: break;
+        }
+    });
+
+    ES2Renderer renderer(scene, window);
+    for (;;) {
+        window->poll();
+
+        for (const auto &box : boxes) {
+            box->add_to_rotation_y(0.01f);
+            box->add_to_rotation_x(0.005f);
+        }
+
+        renderer.render();
+    }
+}
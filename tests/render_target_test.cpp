@@ -0,0 +1,48 @@
+#include "asr.h"
+
+[[noreturn]] int main()
+{
+    using namespace asr;
+
+    auto window = std::make_shared<ES2SDLWindow>("asr");
+
+    auto[triangle_indices, triangle_vertices] = geometry_generators::generate_triangle_geometry_data(4.0f);
+    auto triangle_geometry = std::make_shared<ES2Geometry>(triangle_indices, triangle_vertices);
+    triangle_geometry->get_mutable_vertices()[0].color = glm::vec4{1.0f, 0.0f, 0.0f, 1.0f};
+    triangle_geometry->get_mutable_vertices()[1].color = glm::vec4{0.0f, 1.0f, 0.0f, 1.0f};
+    triangle_geometry->get_mutable_vertices()[2].color = glm::vec4{0.0f, 0.0f, 1.0f, 1.0f};
+    auto triangle_material = std::make_shared<ES2ConstantMaterial>();
+    triangle_material->set_face_culling_enabled(false);
+    auto triangle = std::make_shared<Mesh>(triangle_geometry, triangle_material);
+
+    /* The monitor shows a second scene, drawn with 4x MSAA into an offscreen target that is resolved into a texture. */
+    auto monitor_triangle = std::make_shared<Mesh>(triangle_geometry, triangle_material);
+    std::vector<std::shared_ptr<Object>> monitor_objects{monitor_triangle};
+    auto monitor_scene = std::make_shared<Scene>(monitor_objects);
+    monitor_scene->set_clear_color(glm::vec4{0.2f, 0.2f, 0.2f, 1.0f});
+    monitor_scene->get_camera()->set_z(5.0f);
+    ES2RenderTarget monitor_target(512, 512, RenderTarget::RGBA8, RenderTarget::Depth24, 4);
+
+    auto[monitor_indices, monitor_vertices] = geometry_generators::generate_plane_geometry_data(1.5f, 1.5f, 1, 1);
+    auto monitor_geometry = std::make_shared<ES2Geometry>(monitor_indices, monitor_vertices);
+    auto monitor_material = std::make_shared<ES2ConstantMaterial>();
+    monitor_material->set_texture_1(monitor_target.get_color_texture());
+    auto monitor = std::make_shared<Mesh>(monitor_geometry, monitor_material);
+    monitor->set_position(glm::vec3{2.0f, 1.25f, 0.0f});
+
+    std::vector<std::shared_ptr<Object>> objects{triangle, monitor};
+    auto scene = std::make_shared<Scene>(objects);
+    auto camera = scene->get_camera();
+    camera->set_z(5.0f);
+
+    ES2Renderer renderer(scene, window);
+    for (;;) {
+        window->poll();
+
+        triangle->add_to_rotation_z(-0.01f); // no dt in this version ;( handle it yourself
+        monitor_triangle->add_to_rotation_z(0.02f);
+
+        renderer.render(monitor_scene, monitor_target);
+        renderer.render();
+    }
+}
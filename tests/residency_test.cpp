@@ -0,0 +1,84 @@
+#include "asr.h"
+
+[[noreturn]] int main()
+{
+    using namespace asr;
+
+    auto window = std::make_shared<ES2SDLWindow>("asr");
+
+    static const size_t BUDGET{24 * 1024 * 1024};
+    static const unsigned int GROUP_COUNT{4};
+    static const unsigned int PLANETS_PER_GROUP{6};
+    static const std::string PLANET_IMAGES[]{
+        "data/images/sun.jpg", "data/images/venus.jpg", "data/images/earth.jpg", "data/images/moon.jpg"
+    };
+
+    /* Textures keep no CPU copy, so evicted ones are decoded again by the loader once their group is shown. */
+    ES2TextureLoader texture_loader;
+    texture_loader.set_image_data_retained(false);
+    ResidencyManager residency_manager{BUDGET};
+    residency_manager.set_on_reload([&](const auto &texture) { texture_loader.reload(texture); });
+
+    auto [sphere_indices, sphere_vertices] = geometry_generators::generate_sphere_geometry_data(1.0f, 20, 20);
+    auto sphere_geometry = std::make_shared<ES2Geometry>(sphere_indices, sphere_vertices);
+
+    std::vector<std::shared_ptr<Object>> groups;
+    for (unsigned int i = 0; i < GROUP_COUNT; ++i) {
+        auto group = std::make_shared<Object>();
+        for (unsigned int j = 0; j < PLANETS_PER_GROUP; ++j) {
+            auto texture = texture_loader.load(PLANET_IMAGES[(i + j) % 4]);
+            residency_manager.add(texture);
+
+            auto material = std::make_shared<ES2ConstantMaterial>();
+            material->set_texture_1(texture);
+
+            auto planet = std::make_shared<Mesh>(sphere_geometry, material);
+            planet->set_x((static_cast<float>(j) - static_cast<float>(PLANETS_PER_GROUP - 1) * 0.5f) * 2.5f);
+            group->add_child(planet);
+        }
+        groups.push_back(group);
+    }
+
+    unsigned int shown_group{0};
+    auto scene = std::make_shared<Scene>(std::vector<std::shared_ptr<Object>>{groups[shown_group]});
+
+    auto camera = scene->get_camera();
+    camera->set_z(12.0f);
+
+    window->set_on_key_down([&](int key) {
+        switch (key) {
+            case SDLK_SPACE: {
+                scene->get_root()->remove_child(groups[shown_group]);
+                shown_group = (shown_group + 1) % GROUP_COUNT;
+                scene->get_root()->add_child(groups[shown_group]);
+                break;
+            }
+            case SDLK_ESCAPE: exit(0);
+            default: break;
+        }
+    });
+
+    ES2Renderer renderer(scene, window);
+    for (;;) {
+        window->poll();
+
+        ResidencyManager::Usage usage = residency_manager.get_usage();
+        ImGui::SetNextWindowPos(ImVec2(10, 10));
+        ImGui::Begin("Residency", nullptr, ImGuiWindowFlags_NoResize | ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoMove);
+        ImGui::Text("Group %u of %u (space shows the next one)", shown_group + 1, GROUP_COUNT);
+        ImGui::Text("Budget: %.1f MB", static_cast<double>(usage.budget) / (1024.0 * 1024.0));
+        ImGui::Text("Textures: %.1f MB", static_cast<double>(usage.texture_size) / (1024.0 * 1024.0));
+        ImGui::Text("Resident: %u of %u", usage.resident_count, usage.resource_count);
+        ImGui::Text("Evictions: %llu", usage.eviction_count);
+        ImGui::Text("Pending textures: %u", texture_loader.get_pending_count());
+        ImGui::End();
+
+        for (const auto &planet : groups[shown_group]->get_children()) {
+            planet->add_to_rotation_y(0.01f);
+        }
+
+        texture_loader.update();
+        renderer.render();
+        residency_manager.update();
+    }
+}
@@ -0,0 +1,82 @@
+#include "asr.h"
+
+[[noreturn]] int main()
+{
+    using namespace asr;
+
+    auto window = std::make_shared<ES2SDLWindow>("asr");
+
+    ES2TextureLoader texture_loader;
+    texture_loader.set_mipmap_generator(std::make_shared<MipmapGenerator>());
+    auto ground_texture = texture_loader.load("data/images/checkerboard.png");
+    auto wall_texture   = texture_loader.load("data/images/city.jpg");
+    auto earth_texture  = texture_loader.load("data/images/earth.jpg");
+    for (const auto &texture : {ground_texture, wall_texture, earth_texture}) {
+        texture->set_minification_filter(Texture::FilterType::LinearMipmapLinear);
+        texture->set_magnification_filter(Texture::FilterType::Linear);
+        texture->set_mipmaps_enabled(true);
+    }
+    ground_texture->set_transformation_enabled(true);
+    glm::mat4 ground_texture_matrix{1.0f};
+    ground_texture_matrix[0][0] = ground_texture_matrix[1][1] = 20.0f;
+    ground_texture->set_transformation_matrix(ground_texture_matrix);
+
+    auto ground_material = std::make_shared<ES2ConstantMaterial>();
+    auto wall_material   = std::make_shared<ES2ConstantMaterial>();
+    auto earth_material  = std::make_shared<ES2ConstantMaterial>();
+    ground_material->set_texture_1(ground_texture);
+    wall_material->set_texture_1(wall_texture);
+    earth_material->set_texture_1(earth_texture);
+
+    auto [ground_indices, ground_vertices] = geometry_generators::generate_plane_geometry_data(200.0f, 200.0f, 1, 1);
+    auto ground = std::make_shared<Mesh>(std::make_shared<ES2Geometry>(ground_indices, ground_vertices), ground_material);
+    ground->set_y(-2.0f);
+    ground->set_rotation_x(-static_cast<float>(M_PI) * 0.5f);
+
+    auto [wall_indices, wall_vertices] = geometry_generators::generate_plane_geometry_data(16.0f, 9.0f, 1, 1);
+    auto wall = std::make_shared<Mesh>(std::make_shared<ES2Geometry>(wall_indices, wall_vertices), wall_material);
+    wall->set_position(glm::vec3{0.0f, 2.5f, -30.0f});
+
+    auto [sphere_indices, sphere_vertices] = geometry_generators::generate_sphere_geometry_data(1.0f, 32, 32);
+    auto earth = std::make_shared<Mesh>(std::make_shared<ES2Geometry>(sphere_indices, sphere_vertices), earth_material);
+
+    std::vector<std::shared_ptr<Object>> objects{ground, wall, earth};
+    auto scene = std::make_shared<Scene>(objects);
+
+    auto camera = scene->get_camera();
+    camera->set_position(glm::vec3{0.0f, 0.0f, 6.0f});
+
+    static const float CAMERA_SPEED{0.3f};
+    static const float CAMERA_ROT_SPEED{0.01f};
+    static const glm::vec4 FORWARD{0.0f, 0.0f, 1.0f, 0.0f};
+
+    window->set_on_key_down([&](int key) {
+        switch (key) {
+            case SDLK_w: camera->add_to_rotation_x(-CAMERA_ROT_SPEED); break;
+            case SDLK_a: camera->add_to_rotation_y(CAMERA_ROT_SPEED); break;
+            case SDLK_s: camera->add_to_rotation_x(CAMERA_ROT_SPEED); break;
+            case SDLK_d: camera->add_to_rotation_y(-CAMERA_ROT_SPEED); break;
+            case SDLK_e: camera->add_to_y(CAMERA_ROT_SPEED); break;
+            case SDLK_q: camera->add_to_y(-CAMERA_ROT_SPEED); break;
+            case SDLK_UP: camera->add_to_position(-glm::vec3(camera->get_model_matrix() * FORWARD * CAMERA_SPEED)); break;
+            case SDLK_DOWN: camera->add_to_position(glm::vec3(camera->get_model_matrix() * FORWARD * CAMERA_SPEED)); break;
+            case SDLK_ESCAPE: exit(0);
+            default: break;
+        }
+    });
+
+    ES2Renderer renderer(scene, window);
+    for (;;) {
+        window->poll();
+
+        ImGui::SetNextWindowPos(ImVec2(10, 10));
+        ImGui::Begin("Texture Streaming", nullptr, ImGuiWindowFlags_NoResize | ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoMove);
+        ImGui::Text("Pending textures: %u", texture_loader.get_pending_count());
+        ImGui::End();
+
+        earth->add_to_rotation_y(0.01f);
+
+        texture_loader.update();
+        renderer.render();
+    }
+}
@@ -10,7 +10,7 @@
     auto plane1_geometry = std::make_shared<ES2Geometry>(plane1_indices, plane1_vertices);
     auto plane1_material = std::make_shared<ES2PhongMaterial>();
     auto[image1_data, image1_width, image1_height, image1_channels] = file_utilities::read_image_file("data/images/city.jpg");
-    auto texture1 = std::make_shared<ES2Texture>(image1_data, image1_width, image1_height, image1_channels);
+    auto texture1 = std::make_shared<ES2Texture>(std::move(image1_data), image1_width, image1_height, image1_channels);
     plane1_material->set_texture_1(texture1);
     plane1_material->set_specular_exponent(20.0f);
     auto plane1 = std::make_shared<Mesh>(plane1_geometry, plane1_material);
@@ -20,8 +20,8 @@
     auto plane2_material = std::make_shared<ES2PhongMaterial>();
     auto[image2_data, image2_width, image2_height, image2_channels] = file_utilities::read_image_file("data/images/checkerboard.png");
     auto[image3_data, image3_width, image3_height, image3_channels] = file_utilities::read_image_file("data/images/city.jpg");
-    auto texture2 = std::make_shared<ES2Texture>(image2_data, image2_width, image2_height, image2_channels);
-    auto texture3 = std::make_shared<ES2Texture>(image3_data, image3_width, image3_height, image3_channels);
+    auto texture2 = std::make_shared<ES2Texture>(std::move(image2_data), image2_width, image2_height, image2_channels);
+    auto texture3 = std::make_shared<ES2Texture>(std::move(image3_data), image3_width, image3_height, image3_channels);
     plane2_material->set_texture_1(texture2);
     plane2_material->set_texture_2(texture3);
     plane2_material->set_specular_exponent(20.0f);
@@ -11,10 +11,10 @@
     auto [earth_image, earth_image_width, earth_image_height, earth_image_depth] = file_utilities::read_image_file("data/images/earth.jpg");
     auto [moon_image,  moon_image_width,  moon_image_height,  moon_image_depth]  = file_utilities::read_image_file("data/images/moon.jpg");
 
-    auto sun_texture   = std::make_shared<ES2Texture>(sun_image,   sun_image_width,   sun_image_height,   sun_image_depth);
-    auto venus_texture = std::make_shared<ES2Texture>(venus_image, venus_image_width, venus_image_height, venus_image_depth);
-    auto earth_texture = std::make_shared<ES2Texture>(earth_image, earth_image_width, earth_image_height, earth_image_depth);
-    auto moon_texture  = std::make_shared<ES2Texture>(moon_image,  moon_image_width,  moon_image_height,  moon_image_depth);
+    auto sun_texture   = std::make_shared<ES2Texture>(std::move(sun_image),   sun_image_width,   sun_image_height,   sun_image_depth);
+    auto venus_texture = std::make_shared<ES2Texture>(std::move(venus_image), venus_image_width, venus_image_height, venus_image_depth);
+    auto earth_texture = std::make_shared<ES2Texture>(std::move(earth_image), earth_image_width, earth_image_height, earth_image_depth);
+    auto moon_texture  = std::make_shared<ES2Texture>(std::move(moon_image),  moon_image_width,  moon_image_height,  moon_image_depth);
 
     auto sun_material   = std::make_shared<ES2ConstantMaterial>();
     auto venus_material = std::make_shared<ES2ConstantMaterial>();
@@ -8,9 +8,9 @@
 
     auto[triangle_indices, triangle_vertices] = geometry_generators::generate_triangle_geometry_data(4.0f);
     auto triangle_geometry = std::make_shared<ES2Geometry>(triangle_indices, triangle_vertices);
-    triangle_geometry->get_vertices()[0].color = glm::vec4{1.0f, 0.0f, 0.0f, 1.0f};
-    triangle_geometry->get_vertices()[1].color = glm::vec4{0.0f, 1.0f, 0.0f, 1.0f};
-    triangle_geometry->get_vertices()[2].color = glm::vec4{0.0f, 0.0f, 1.0f, 1.0f};
+    triangle_geometry->get_mutable_vertices()[0].color = glm::vec4{1.0f, 0.0f, 0.0f, 1.0f};
+    triangle_geometry->get_mutable_vertices()[1].color = glm::vec4{0.0f, 1.0f, 0.0f, 1.0f};
+    triangle_geometry->get_mutable_vertices()[2].color = glm::vec4{0.0f, 0.0f, 1.0f, 1.0f};
     auto triangle_material = std::make_shared<ES2ConstantMaterial>();
     triangle_material->set_face_culling_enabled(false);
     auto triangle = std::make_shared<Mesh>(triangle_geometry, triangle_material);
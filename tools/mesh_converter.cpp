@@ -0,0 +1,243 @@
+#include "asr.h"
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <utility>
+#include <functional>
+#include <unordered_set>
+#include <cctype>
+#include <cstring>
+#include <cstdlib>
+#include <iostream>
+#include <algorithm>
+
+using namespace asr;
+
+typedef std::pair<std::vector<unsigned int>, std::vector<Vertex>> geometry_data_type;
+
+struct ConvertedMesh
+{
+    Geometry::Type type;
+    geometry_data_type geometry_data;
+};
+
+/* The converter only needs the geometry data of imported models, so the importer creates objects without GPU
+   state and does not load textures. */
+class ConverterGeometry final : public Geometry
+{
+public:
+    using Geometry::Geometry;
+
+    [[nodiscard]] size_t get_gpu_size() const final
+    {
+        return 0;
+    }
+
+    void evict() final
+    {}
+
+    void update(const Material &material) final
+    {}
+
+    void use() final
+    {}
+};
+
+class ConverterMaterial final : public PhongMaterial
+{
+public:
+    void update(std::shared_ptr<Scene> scene, std::shared_ptr<Mesh> mesh) final
+    {}
+
+    void use() final
+    {}
+};
+
+class ConverterTexture final : public Texture
+{
+public:
+    using Texture::Texture;
+
+    [[nodiscard]] size_t get_gpu_size() const final
+    {
+        return 0;
+    }
+
+    void evict() final
+    {}
+
+    void update(unsigned int sampler) final
+    {}
+
+    void use(unsigned int sampler) final
+    {}
+};
+
+class ConverterTextureLoader final : public TextureLoader
+{
+protected:
+    std::shared_ptr<Texture> _create_texture(
+        ImageBuffer image_data, unsigned int width, unsigned int height, unsigned int channels
+    ) final
+    {
+        return std::make_shared<ConverterTexture>(std::move(image_data), width, height, channels);
+    }
+
+    bool _is_compression_supported(Texture::Compression compression) final
+    {
+        return true;
+    }
+};
+
+class ConverterModelImporter final : public ModelImporter
+{
+public:
+    using ModelImporter::ModelImporter;
+
+protected:
+    std::shared_ptr<Geometry> _create_geometry(std::vector<unsigned int> indices, std::vector<Vertex> vertices) final
+    {
+        return std::make_shared<ConverterGeometry>(std::move(indices), std::move(vertices));
+    }
+
+    std::shared_ptr<PhongMaterial> _create_phong_material() final
+    {
+        return std::make_shared<ConverterMaterial>();
+    }
+};
+
+static bool has_extension(const std::string &path, const std::string &extension)
+{
+    return path.size() >= extension.size() &&
+           std::equal(std::rbegin(extension), std::rend(extension), std::rbegin(path), [](char a, char b) {
+               return std::tolower(a) == std::tolower(b);
+           });
+}
+
+/* Reads one mesh for every distinct geometry of an OBJ or glTF model. Node transforms are not applied. */
+static bool read_model_file(const std::string &path, std::vector<ConvertedMesh> &meshes, std::string &error)
+{
+    ConverterTextureLoader texture_loader;
+    ConverterModelImporter importer{texture_loader};
+    importer.set_texture_loading_enabled(false);
+    std::shared_ptr<Object> model;
+    if (!importer.import(path, model, error)) {
+        return false;
+    }
+
+    std::unordered_set<const Geometry *> converted_geometries;
+    std::function<void(const std::shared_ptr<Object> &)> add_object;
+    add_object = [&](const std::shared_ptr<Object> &object) {
+        if (auto mesh = std::dynamic_pointer_cast<Mesh>(object)) {
+            const std::shared_ptr<Geometry> &geometry = mesh->get_geometry();
+            if (geometry && converted_geometries.insert(geometry.get()).second) {
+                meshes.push_back(ConvertedMesh{geometry->get_type(), {geometry->get_indices(), geometry->get_vertices()}});
+            }
+        }
+        for (const auto &child : object->get_children()) {
+            add_object(child);
+        }
+    };
+    add_object(model);
+
+    return true;
+}
+
+static bool read_mesh_file(const std::string &path, std::vector<ConvertedMesh> &meshes, std::string &error)
+{
+    std::shared_ptr<MappedFile> file = MappedFile::open(path, error);
+    if (!file) {
+        return false;
+    }
+
+    std::vector<mesh_file::MeshView> views;
+    if (!mesh_file::read(file->get_data(), file->get_size(), views, error)) {
+        return false;
+    }
+    for (const auto &view : views) {
+        meshes.push_back(ConvertedMesh{
+            view.type,
+            {
+                std::vector<unsigned int>(view.indices, view.indices + view.index_count),
+                std::vector<Vertex>(view.vertices, view.vertices + view.vertex_count)
+            }
+        });
+    }
+
+    return true;
+}
+
+/* Converts OBJ, glTF or other asr mesh files into asr mesh files. With --simplify, triangle lists are reduced
+   to the given fraction of their triangles first. They are reordered for the vertex cache, overdraw and vertex
+   fetches unless --no-optimize is given.
+   Usage: mesh_converter [--no-optimize] [--simplify <ratio>] <input.obj|input.gltf|input.glb|input.asrm> <output.asrm> */
+int main(int argc, char **argv)
+{
+    bool optimize{true};
+    float simplification_ratio{1.0f};
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--no-optimize") == 0) {
+            optimize = false;
+        } else if (std::strcmp(argv[i], "--simplify") == 0 && i + 1 < argc) {
+            simplification_ratio = std::strtof(argv[++i], nullptr);
+            if (!(simplification_ratio > 0.0f && simplification_ratio <= 1.0f)) {
+                paths.clear();
+                break;
+            }
+        } else if (argv[i][0] != '-') {
+            paths.emplace_back(argv[i]);
+        } else {
+            paths.clear();
+            break;
+        }
+    }
+    if (paths.size() != 2) {
+        std::cerr << "Usage: " << argv[0] << " [--no-optimize] [--simplify <ratio>] <input.obj|input.gltf|input.glb|input.asrm> <output.asrm>" << std::endl;
+        return -1;
+    }
+    const std::string &input_path = paths[0], &output_path = paths[1];
+
+    std::vector<ConvertedMesh> meshes;
+    std::string error;
+    bool read = has_extension(input_path, ".asrm") ?
+        read_mesh_file(input_path, meshes, error) :
+        read_model_file(input_path, meshes, error);
+    if (!read) {
+        std::cerr << error << std::endl;
+        return -1;
+    }
+
+    GeometrySimplifier simplifier;
+    std::vector<mesh_file::MeshView> views;
+    for (size_t i = 0; i < meshes.size(); ++i) {
+        auto &[type, geometry_data] = meshes[i];
+        if (simplification_ratio < 1.0f && type == Geometry::Triangles) {
+            size_t triangle_count = geometry_data.first.size() / 3;
+            auto target_triangle_count = static_cast<size_t>(static_cast<float>(triangle_count) * simplification_ratio);
+            geometry_data = simplifier.simplify(geometry_data.first, geometry_data.second, target_triangle_count);
+            std::cerr << "Mesh " << i << ": " << triangle_count << " -> " << geometry_data.first.size() / 3 << " triangles" << std::endl;
+        }
+        if (optimize && type == Geometry::Triangles) {
+            auto report = geometry_optimizers::optimize_geometry_data(geometry_data);
+            std::cerr << "Mesh " << i << ": ACMR " << report.acmr_before << " -> " << report.acmr_after << std::endl;
+        }
+
+        mesh_file::MeshView view{
+            type,
+            geometry_data.first.data(), geometry_data.first.size(),
+            geometry_data.second.data(), geometry_data.second.size(),
+            glm::vec3{0.0f}, glm::vec3{0.0f}
+        };
+        mesh_file::calculate_bounds(view);
+        views.push_back(view);
+    }
+
+    if (!mesh_file::write(output_path, views, error)) {
+        std::cerr << error << std::endl;
+        return -1;
+    }
+
+    return 0;
+}